@@ -178,6 +178,10 @@ class RequestBuilder {
                 grpLevel.setMaxGroups(LOOKAHEAD + frame.state.max + offset);
                 frame.state.max = null;
             }
+            if (frame.state.approximate && grpLevel.getPrecision() > 0) {
+                grpLevel.setApproximateGroups((int)grpLevel.getPrecision());
+            }
+            frame.state.approximate = false;
             frame.grouping.getLevels().add(grpLevel);
         }
         String label = frame.astNode.getLabel();
@@ -204,6 +208,7 @@ class RequestBuilder {
         resolveMax(frame);
         resolveOrderBy(frame);
         resolvePrecision(frame);
+        resolveApproximate(frame);
         resolveWhere(frame);
     }
 
@@ -305,6 +310,12 @@ class RequestBuilder {
         }
     }
 
+    private void resolveApproximate(BuildFrame frame) {
+        if (frame.astNode.containsHint("approximate")) {
+            frame.state.approximate = true;
+        }
+    }
+
     private void resolveWhere(BuildFrame frame) {
         String where = frame.astNode.getWhere();
         if (where != null) {
@@ -385,6 +396,7 @@ class RequestBuilder {
         String label = null;
         Integer max = null;
         Integer precision = null;
+        boolean approximate = false;
 
         BuildState() {
             // empty
@@ -399,6 +411,7 @@ class RequestBuilder {
             label = obj.label;
             max = obj.max;
             precision = obj.precision;
+            approximate = obj.approximate;
         }
     }
 }
@@ -177,6 +177,16 @@ public class RequestBuilderTestCase {
                               "[false, false]");
     }
 
+    @Test
+    public void requireThatApproximateGroupsIsSupported() {
+        assertApproximateGroups("all(group(foo) max(5) each(output(count())))", "[[0]]");
+        assertApproximateGroups("all(group(foo) max(5) hint(approximate) each(output(count())))", "[[6]]");
+        assertApproximateGroups("all(group(foo) precision(100) hint(approximate) each(output(count())))", "[[100]]");
+        assertApproximateGroups("all(group(foo) hint(approximate) each(output(count())))", "[[0]]");
+        assertApproximateGroups("all(group(foo) max(5) hint(approximate) each(group(bar) each(output(count()))))",
+                                "[[6, 0]]");
+    }
+
     @Test
     public void requireThatThereCanBeOnlyOneBuildCall() {
         RequestBuilder builder = new RequestBuilder(0);
@@ -770,6 +780,10 @@ public class RequestBuilderTestCase {
         assertOutput(request, new ForceSinglePassWriter(), expectedOutput);
     }
 
+    private static void assertApproximateGroups(String request, String expectedOutput) {
+        assertOutput(request, new ApproximateGroupsWriter(), expectedOutput);
+    }
+
     private static void assertOutput(String request, OutputWriter writer, String expectedOutput) {
         RequestTest ret = new RequestTest();
         ret.request = request;
@@ -951,4 +965,20 @@ public class RequestBuilderTestCase {
             return ret.toString();
         }
     }
+
+    private static class ApproximateGroupsWriter implements OutputWriter {
+
+        @Override
+        public String write(List<Grouping> groupingList, GroupingTransform transform) {
+            List<String> ret = new LinkedList<>();
+            for (Grouping grouping : groupingList) {
+                List<Integer> levels = new LinkedList<>();
+                for (GroupingLevel level : grouping.getLevels()) {
+                    levels.add(level.getApproximateGroups());
+                }
+                ret.add(levels.toString());
+            }
+            return ret.toString();
+        }
+    }
 }
@@ -911,6 +911,23 @@ TEST(DocumentTest, testBogusserialize)
     }
 }
 
+TEST(DocumentTest, document_id_can_be_read_without_deserializing_fields)
+{
+    TestDocRepo test_repo;
+    Document doc(*test_repo.getDocumentType("testdoctype1"), DocumentId("id:ns:testdoctype1::1"));
+    doc.setValue("headerval", IntFieldValue(42));
+    nbostream stream = doc.serialize();
+    EXPECT_EQ(doc.getId(), Document::getIdFromSerialized(stream));
+
+    try {
+        nbostream bogus("aoifjweprjwoejr203r+2+4r823++!", 100);
+        Document::getIdFromSerialized(bogus);
+        FAIL() << "Failed to throw exception reading id from bogus data";
+    } catch (DeserializeException& e) {
+        EXPECT_THAT(e.what(), HasSubstr("Unrecognized serialization version"));
+    }
+}
+
 TEST(DocumentTest, testCRC32)
 {
     TestDocRepo test_repo;
@@ -275,6 +275,27 @@ void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & o
     }
 }
 
+DocumentId
+Document::getIdFromSerialized(vespalib::nbostream & os) {
+    uint16_t version(0);
+    uint32_t dataSize(0);
+    try {
+        os >> version >> dataSize;
+    } catch (const IllegalStateException &e) {
+        throw DeserializeException(vespalib::string("Buffer out of bounds: ") + e.what());
+    }
+    if (version != getNewestSerializationVersion()) {
+        throw DeserializeException(make_string("Unrecognized serialization version %d", version), VESPA_STRLOC);
+    }
+    size_t idLen = strnlen(os.peek(), os.size());
+    if (idLen == os.size()) {
+        throw DeserializeException("Document id is not terminated", VESPA_STRLOC);
+    }
+    DocumentId id(vespalib::stringref(os.peek(), idLen));
+    os.adjustReadPos(idLen + 1);
+    return id;
+}
+
 void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & header, vespalib::nbostream & body) {
     deserializeHeader(repo, header);
     deserializeBody(repo, body);
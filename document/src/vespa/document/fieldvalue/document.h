@@ -44,6 +44,11 @@ public:
     static constexpr uint16_t getNewestSerializationVersion() { return 8; }
     static const DataType & verifyDocumentType(const DataType *type);
     static void verifyIdAndType(const DocumentId & id, const DataType *type);
+    /**
+     * Reads only the document id from the start of a serialized document,
+     * without deserializing any of its fields.
+     */
+    static DocumentId getIdFromSerialized(vespalib::nbostream & os);
 
     Document();
     Document(const Document&);
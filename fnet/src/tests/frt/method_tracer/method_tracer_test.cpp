@@ -0,0 +1,170 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/fnet/frt/method_tracer.h>
+#include <vespa/fnet/frt/supervisor.h>
+#include <vespa/fnet/frt/target.h>
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/fnet/transport.h>
+#include <thread>
+#include <vector>
+
+using fnet::frt::MethodTracer;
+using fnet::frt::TraceHistogram;
+using vespalib::Slime;
+
+MethodTracer::Sample make_sample(const char *name, uint64_t handler_ns, bool error = false) {
+    MethodTracer::Sample sample;
+    sample.set_method(name, strlen(name));
+    sample.queue_ns = 10;
+    sample.handler_ns = handler_ns;
+    sample.socket_ns = 0;
+    sample.bytes_in = 100;
+    sample.bytes_out = 200;
+    sample.error = error;
+    return sample;
+}
+
+TEST("require that histogram buckets are powers of two") {
+    EXPECT_EQUAL(TraceHistogram::bucket_of(0), 0u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(1), 1u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(2), 2u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(3), 2u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(4), 3u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(1023), 10u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(1024), 11u);
+    EXPECT_EQUAL(TraceHistogram::bucket_of(UINT64_MAX), TraceHistogram::num_buckets - 1);
+}
+
+TEST("require that histogram quantiles are bounded by bucket limits and max") {
+    TraceHistogram hist;
+    EXPECT_EQUAL(hist.quantile(0.5), 0u);
+    for (uint64_t i = 1; i <= 100; ++i) {
+        hist.add(i);
+    }
+    EXPECT_EQUAL(hist.count(), 100u);
+    EXPECT_EQUAL(hist.sum(), 5050u);
+    EXPECT_EQUAL(hist.max(), 100u);
+    EXPECT_EQUAL(hist.quantile(0.5), 63u);
+    EXPECT_EQUAL(hist.quantile(0.99), 100u);
+    EXPECT_EQUAL(hist.quantile(0.0), 1u);
+}
+
+TEST("require that samples are aggregated per method") {
+    MethodTracer tracer;
+    tracer.record(make_sample("foo", 1000));
+    tracer.record(make_sample("foo", 3000, true));
+    tracer.record(make_sample("bar", 5));
+    auto stats = tracer.stats();
+    ASSERT_EQUAL(stats.size(), 2u);
+    const auto &foo = stats["foo"];
+    EXPECT_EQUAL(foo.errors, 1u);
+    EXPECT_EQUAL(foo.handler_ns.count(), 2u);
+    EXPECT_EQUAL(foo.handler_ns.sum(), 4000u);
+    EXPECT_EQUAL(foo.bytes_out.sum(), 400u);
+    EXPECT_EQUAL(stats["bar"].handler_ns.max(), 5u);
+    EXPECT_EQUAL(tracer.dropped(), 0u);
+}
+
+TEST("require that long method names are truncated") {
+    vespalib::string name(100, 'x');
+    auto sample = make_sample(name.c_str(), 1);
+    EXPECT_EQUAL(vespalib::string(sample.method), name.substr(0, MethodTracer::Sample::max_name_len));
+}
+
+TEST("require that threads forget the rings of destroyed tracers") {
+    size_t before = MethodTracer::num_thread_rings();
+    for (size_t i = 0; i < 100; ++i) {
+        MethodTracer tracer;
+        tracer.record(make_sample("foo", 1));
+        EXPECT_EQUAL(MethodTracer::num_thread_rings(), before + 1);
+        EXPECT_EQUAL(tracer.stats()["foo"].handler_ns.count(), 1u);
+    }
+    EXPECT_EQUAL(MethodTracer::num_thread_rings(), before);
+}
+
+TEST("require that rings are drained by the recording thread when half full") {
+    MethodTracer tracer;
+    for (size_t i = 0; i < 10 * MethodTracer::ring_size; ++i) {
+        tracer.record(make_sample("foo", 1));
+    }
+    EXPECT_EQUAL(tracer.dropped(), 0u);
+    EXPECT_EQUAL(tracer.stats()["foo"].handler_ns.count(), 10 * MethodTracer::ring_size);
+}
+
+TEST("require that samples from multiple threads are all accounted for") {
+    MethodTracer tracer;
+    constexpr size_t num_threads = 4;
+    constexpr size_t per_thread = 20000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&tracer]() {
+                                 for (size_t i = 0; i < per_thread; ++i) {
+                                     tracer.record(make_sample("foo", i));
+                                 }
+                             });
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        tracer.stats();
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQUAL(tracer.stats()["foo"].handler_ns.count() + tracer.dropped(), num_threads * per_thread);
+}
+
+TEST("require that statistics can be rendered as slime") {
+    MethodTracer tracer;
+    tracer.record(make_sample("foo", 1000));
+    Slime slime;
+    tracer.to_slime(slime.setObject(), false);
+    EXPECT_EQUAL(slime.get()["dropped_samples"].asLong(), 0);
+    EXPECT_EQUAL(slime.get()["methods"]["foo"]["handler_ns"]["count"].asLong(), 1);
+    EXPECT_EQUAL(slime.get()["methods"]["foo"]["bytes_in"]["max"].asLong(), 100);
+    EXPECT_FALSE(slime.get()["methods"]["foo"]["handler_ns"]["buckets"].valid());
+    Slime full;
+    tracer.to_slime(full.setObject(), true);
+    EXPECT_EQUAL(full.get()["methods"]["foo"]["handler_ns"]["buckets"].entries(), 1u);
+}
+
+struct Server : FRT_Invokable {
+    fnet::frt::StandaloneFRT frt;
+    Server() : frt(TransportConfig().measure_socket_time(true)) {
+        frt.supervisor().EnableTracing();
+        FRT_ReflectionBuilder rb(&frt.supervisor());
+        rb.DefineMethod("inc", "i", "i", FRT_METHOD(Server::rpc_inc), this);
+        ASSERT_TRUE(frt.supervisor().Listen(0));
+    }
+    void rpc_inc(FRT_RPCRequest *req) {
+        req->GetReturn()->AddInt32(req->GetParams()->GetValue(0)._intval32 + 1);
+    }
+};
+
+TEST("require that incoming requests are traced by the supervisor") {
+    Server server;
+    fnet::frt::StandaloneFRT client;
+    FRT_Target *target = client.supervisor().GetTarget(server.frt.supervisor().GetListenPort());
+    for (int i = 0; i < 10; ++i) {
+        FRT_RPCRequest *req = client.supervisor().AllocRPCRequest();
+        req->SetMethodName("inc");
+        req->GetParams()->AddInt32(i);
+        target->InvokeSync(req, 60.0);
+        EXPECT_TRUE(!req->IsError());
+        req->SubRef();
+    }
+    FRT_RPCRequest *req = client.supervisor().AllocRPCRequest();
+    req->SetMethodName("no.such.method");
+    target->InvokeSync(req, 60.0);
+    EXPECT_EQUAL(req->GetErrorCode(), uint32_t(FRTE_RPC_NO_SUCH_METHOD));
+    req->SubRef();
+    target->SubRef();
+    auto stats = server.frt.supervisor().GetTracer()->stats();
+    ASSERT_EQUAL(stats.size(), 1u);
+    const auto &inc = stats["inc"];
+    EXPECT_EQUAL(inc.errors, 0u);
+    EXPECT_EQUAL(inc.handler_ns.count(), 10u);
+    EXPECT_LESS(0u, inc.bytes_in.max());
+    EXPECT_LESS(0u, inc.bytes_out.max());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
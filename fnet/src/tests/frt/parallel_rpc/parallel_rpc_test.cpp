@@ -18,8 +18,8 @@ struct Rpc : FRT_Invokable {
     FastOS_ThreadPool thread_pool;
     FNET_Transport    transport;
     FRT_Supervisor    orb;
-    Rpc(CryptoEngine::SP crypto, size_t num_threads, bool drop_empty)
-        : thread_pool(128_Ki), transport(TransportConfig(num_threads).crypto(std::move(crypto)).drop_empty_buffers(drop_empty)), orb(&transport) {}
+    Rpc(CryptoEngine::SP crypto, size_t num_threads, bool drop_empty, bool io_uring)
+        : thread_pool(128_Ki), transport(TransportConfig(num_threads).crypto(std::move(crypto)).drop_empty_buffers(drop_empty).use_io_uring(io_uring)), orb(&transport) {}
     void start() {
         ASSERT_TRUE(transport.Start(&thread_pool));
     }
@@ -38,7 +38,7 @@ struct Rpc : FRT_Invokable {
 
 struct Server : Rpc {
     uint32_t port;
-    Server(CryptoEngine::SP crypto, size_t num_threads, bool drop_empty = false) : Rpc(std::move(crypto), num_threads, drop_empty), port(listen()) {
+    Server(CryptoEngine::SP crypto, size_t num_threads, bool drop_empty = false, bool io_uring = false) : Rpc(std::move(crypto), num_threads, drop_empty, io_uring), port(listen()) {
         init_rpc();
         start();
     }
@@ -58,7 +58,7 @@ struct Server : Rpc {
 
 struct Client : Rpc {
     uint32_t port;
-    Client(CryptoEngine::SP crypto, size_t num_threads, const Server &server, bool drop_empty = false) : Rpc(std::move(crypto), num_threads, drop_empty), port(server.port) {
+    Client(CryptoEngine::SP crypto, size_t num_threads, const Server &server, bool drop_empty = false, bool io_uring = false) : Rpc(std::move(crypto), num_threads, drop_empty, io_uring), port(server.port) {
         start();
     }
     FRT_Target *connect() { return Rpc::connect(port); }
@@ -163,6 +163,12 @@ TEST_MT_FFF("parallel rpc with 8/8 transport threads and num_cores user threads
 TEST_MT_FFF("parallel rpc with 8/8 transport threads and num_cores user threads (tls encryption + drop empty buffers)",
             getNumThreads(), Server(tls_crypto, 8, true), Client(tls_crypto, 8, f1, true), Result(num_threads)) { perform_test(thread_id, f2, f3); }
 
+TEST_MT_FFF("parallel rpc with 8/8 transport threads and num_cores user threads (no encryption + io_uring)",
+            getNumThreads(), Server(null_crypto, 8, false, true), Client(null_crypto, 8, f1, false, true), Result(num_threads)) { perform_test(thread_id, f2, f3, true); }
+
+TEST_MT_FFF("parallel rpc with 8/8 transport threads and num_cores user threads (tls encryption + io_uring)",
+            getNumThreads(), Server(tls_crypto, 8, false, true), Client(tls_crypto, 8, f1, false, true), Result(num_threads)) { perform_test(thread_id, f2, f3); }
+
 //-----------------------------------------------------------------------------
 
 int main(int argc, char **argv) {
@@ -3,6 +3,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <vespa/vespalib/net/crypto_engine.h>
+#include <vespa/vespalib/net/shm_crypto_engine.h>
 #include <vespa/vespalib/net/tls/tls_crypto_engine.h>
 #include <vespa/vespalib/test/make_tls_options_for_testing.h>
 #include <vespa/vespalib/test/time_tracer.h>
@@ -19,6 +20,7 @@ using vespalib::test::TimeTracer;
 CryptoEngine::SP null_crypto = std::make_shared<NullCryptoEngine>();
 CryptoEngine::SP xor_crypto = std::make_shared<XorCryptoEngine>();
 CryptoEngine::SP tls_crypto = std::make_shared<vespalib::TlsCryptoEngine>(vespalib::test::make_tls_options_for_testing());
+CryptoEngine::SP shm_crypto = std::make_shared<ShmCryptoEngine>(null_crypto);
 
 TT_Tag req_tag("request");
 
@@ -153,4 +155,10 @@ TEST_F("^^^-- rpc with tls encryption", Fixture(tls_crypto)) {
     benchmark_rpc(f1, true);
 }
 
+TEST_F("^^^-- rpc with shared memory transport", Fixture(shm_crypto)) {
+    fprintf(stderr, "vvv-- rpc with shared memory transport\n");
+    benchmark_rpc(f1, false);
+    benchmark_rpc(f1, true);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -7,7 +7,10 @@
 #include <vespa/fnet/frt/target.h>
 #include <vespa/fnet/frt/rpcrequest.h>
 #include <vespa/fnet/frt/invoker.h>
+#include <vespa/fnet/frt/request_pool.h>
 #include <mutex>
+#include <set>
+#include <vector>
 #include <condition_variable>
 
 using vespalib::SocketSpec;
@@ -201,6 +204,8 @@ public:
                         FRT_METHOD(TestRPC::RPC_GetValue), this);
         rb.DefineMethod("test", "iibb", "i",
                         FRT_METHOD(TestRPC::RPC_Test), this);
+        rb.DefineMethod("echoData", "xxx", "xxx",
+                        FRT_METHOD(TestRPC::RPC_EchoData), this);
     }
 
     void RPC_Test(FRT_RPCRequest *req)
@@ -223,6 +228,14 @@ public:
         }
     }
 
+    void RPC_EchoData(FRT_RPCRequest *req)
+    {
+        FRT_Values &param = *req->GetParams();
+        for (uint32_t i = 0; i < param.GetNumValues(); ++i) {
+            req->GetReturn()->AddData(param[i]._data._buf, param[i]._data._len);
+        }
+    }
+
     void RPC_Inc(FRT_RPCRequest *req)
     {
         req->GetReturn()->AddInt32(req->GetParams()->GetValue(0)._intval32 + 1);
@@ -421,6 +434,168 @@ TEST_F("require that parameters can be echoed as return values", Fixture()) {
     EXPECT_TRUE(req.get().GetParams()->Equals(req.get().GetReturn()));
 }
 
+TEST_F("require that large data values are written intact by reference", Fixture()) {
+    // the large values are written directly from request memory instead of being copied into the output buffer
+    std::vector<uint32_t> sizes = {100, 64 * 1024 + 3, 3 * 1024 * 1024 + 7};
+    MyReq req("echoData");
+    for (uint32_t size: sizes) {
+        char *data = req.get().GetParams()->AddData(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            data[i] = char(i * 31 + size);
+        }
+    }
+    f1.target().InvokeSync(req.borrow(), timeout);
+    ASSERT_TRUE(!req.get().IsError());
+    // shared blobs in the parameters are discarded once sent, so check the echo against the pattern
+    FRT_Values &ret = *req.get().GetReturn();
+    ASSERT_EQUAL(ret.GetNumValues(), sizes.size());
+    for (size_t v = 0; v < sizes.size(); ++v) {
+        uint32_t size = sizes[v];
+        ASSERT_EQUAL(ret[v]._data._len, size);
+        bool intact = true;
+        for (uint32_t i = 0; i < size; ++i) {
+            intact = intact && (ret[v]._data._buf[i] == char(i * 31 + size));
+        }
+        EXPECT_TRUE(intact);
+    }
+}
+
+TEST_F("require that requests following data overflowing the ring are delivered", Fixture()) {
+    // with small shared memory rings, the large values are sent on the socket
+    for (uint32_t i = 0; i < 8; ++i) {
+        uint32_t size = 64 * 1024 + i;
+        MyReq large("echoData");
+        char *data = large.get().GetParams()->AddData(size);
+        for (uint32_t j = 0; j < size; ++j) {
+            data[j] = char(j * 31 + i);
+        }
+        large.get().GetParams()->AddData("a", 1);
+        large.get().GetParams()->AddData("b", 1);
+        f1.target().InvokeSync(large.borrow(), timeout);
+        ASSERT_TRUE(!large.get().IsError());
+        ASSERT_EQUAL(large.get().GetReturn()->GetNumValues(), 3u);
+        EXPECT_EQUAL((*large.get().GetReturn())[0]._data._len, size);
+        MyReq small("echoData");
+        small.get().GetParams()->AddData("small", 5);
+        small.get().GetParams()->AddData("a", 1);
+        small.get().GetParams()->AddData("b", 1);
+        f1.target().InvokeSync(small.borrow(), timeout);
+        ASSERT_TRUE(!small.get().IsError());
+        FRT_Values &ret = *small.get().GetReturn();
+        ASSERT_EQUAL(ret.GetNumValues(), 3u);
+        EXPECT_EQUAL(vespalib::string(ret[0]._data._buf, ret[0]._data._len), vespalib::string("small"));
+    }
+}
+
+TEST_F("require that batch invocation works", Fixture()) {
+    fnet::frt::RequestPool pool;
+    std::vector<FRT_RPCRequest *> reqs;
+    for (uint32_t i = 0; i < 32; ++i) {
+        FRT_RPCRequest *req = pool.alloc();
+        req->SetMethodName("inc");
+        req->GetParams()->AddInt32(i * 10);
+        reqs.push_back(req);
+    }
+    f1.target().InvokeBatchSync(reqs.data(), reqs.size(), timeout);
+    for (uint32_t i = 0; i < reqs.size(); ++i) {
+        MyReq req(reqs[i]);
+        EXPECT_EQUAL(req.get_int_ret(), i * 10 + 1);
+    }
+}
+
+TEST_F("require that batch invocation reports results per request", Fixture()) {
+    std::vector<FRT_RPCRequest *> reqs;
+    std::vector<uint32_t> errors = {FRTE_NO_ERROR, 1234, FRTE_NO_ERROR, 5678};
+    for (uint32_t i = 0; i < errors.size(); ++i) {
+        reqs.push_back(MyReq(i, false, errors[i], 0).steal());
+    }
+    reqs.push_back(MyReq("bogus").steal());
+    RequestLatch result;
+    f1.target().InvokeBatch(reqs.data(), reqs.size(), timeout, &result);
+    std::set<FRT_RPCRequest *> seen;
+    for (uint32_t i = 0; i < reqs.size(); ++i) {
+        seen.insert(result.read());
+    }
+    EXPECT_EQUAL(seen.size(), reqs.size());
+    for (uint32_t i = 0; i < errors.size(); ++i) {
+        MyReq req(reqs[i]);
+        EXPECT_EQUAL(req.get().GetErrorCode(), errors[i]);
+        if (errors[i] == FRTE_NO_ERROR) {
+            EXPECT_EQUAL(req.get_int_ret(), i);
+        }
+    }
+    MyReq bogus(reqs.back());
+    EXPECT_EQUAL(bogus.get().GetErrorCode(), FRTE_RPC_NO_SUCH_METHOD);
+}
+
+TEST_F("require that batch invocation on a bad target gives connection errors", Fixture()) {
+    MyReq req1("frt.rpc.ping");
+    MyReq req2("frt.rpc.ping");
+    FRT_RPCRequest *reqs[] = { req1.borrow(), req2.borrow() };
+    {
+        FRT_Target *bad_target = f1.make_bad_target();
+        bad_target->InvokeBatchSync(reqs, 2, timeout);
+        bad_target->SubRef();
+    }
+    EXPECT_EQUAL(req1.get().GetErrorCode(), FRTE_RPC_CONNECTION);
+    EXPECT_EQUAL(req2.get().GetErrorCode(), FRTE_RPC_CONNECTION);
+}
+
+TEST("require that request pool recycles successful requests only") {
+    fnet::frt::RequestPool pool(1);
+    FRT_RPCRequest *req1 = pool.alloc();
+    FRT_RPCRequest *req2 = pool.alloc();
+    EXPECT_TRUE(req1 != req2);
+    req1->SetMethodName("foo");
+    req2->SetError(FRTE_RPC_CONNECTION);
+    pool.release(req2);
+    EXPECT_EQUAL(pool.size(), 0u);
+    pool.release(req1);
+    EXPECT_EQUAL(pool.size(), 1u);
+    FRT_RPCRequest *req3 = pool.alloc();
+    EXPECT_EQUAL(req3, req1);
+    EXPECT_EQUAL(req3->GetMethodNameLen(), 0u);
+    EXPECT_EQUAL(pool.size(), 0u);
+    pool.release(req3);
+}
+
+TEST_F("measure batch invocation throughput", Fixture()) {
+    fnet::frt::RequestPool pool;
+    std::vector<FRT_RPCRequest *> reqs(16);
+    BenchmarkTimer single_timer(1.0);
+    while (single_timer.has_budget()) {
+        single_timer.before();
+        for (FRT_RPCRequest *&req: reqs) {
+            req = pool.alloc();
+            req->SetMethodName("inc");
+            req->GetParams()->AddInt32(1);
+            f1.target().InvokeSync(req, timeout);
+        }
+        single_timer.after();
+        for (FRT_RPCRequest *req: reqs) {
+            ASSERT_TRUE(!req->IsError());
+            pool.release(req);
+        }
+    }
+    BenchmarkTimer batch_timer(1.0);
+    while (batch_timer.has_budget()) {
+        batch_timer.before();
+        for (FRT_RPCRequest *&req: reqs) {
+            req = pool.alloc();
+            req->SetMethodName("inc");
+            req->GetParams()->AddInt32(1);
+        }
+        f1.target().InvokeBatchSync(reqs.data(), reqs.size(), timeout);
+        batch_timer.after();
+        for (FRT_RPCRequest *req: reqs) {
+            ASSERT_TRUE(!req->IsError());
+            pool.release(req);
+        }
+    }
+    fprintf(stderr, "16 sequential invocations: %1.3f ms, one batch of 16: %1.3f ms\n",
+            single_timer.min_time() * 1000.0, batch_timer.min_time() * 1000.0);
+}
+
 TEST_MAIN() {
     crypto = my_crypto_engine();
     TEST_RUN_ALL();
@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/vespalib/net/crypto_engine.h>
+#include <vespa/vespalib/net/shm_crypto_engine.h>
 #include <vespa/vespalib/net/tls/tls_crypto_engine.h>
 #include <vespa/vespalib/net/tls/maybe_tls_crypto_engine.h>
 #include <vespa/vespalib/test/make_tls_options_for_testing.h>
@@ -26,6 +27,12 @@ vespalib::CryptoEngine::SP my_crypto_engine() {
         fprintf(stderr, "crypto engine: null client, mixed server\n");
         auto tls = std::make_shared<vespalib::TlsCryptoEngine>(vespalib::test::make_tls_options_for_testing());
         return std::make_shared<vespalib::MaybeTlsCryptoEngine>(std::move(tls), false);
+    } else if (engine == "shm") {
+        fprintf(stderr, "crypto engine: shared memory (null fallback)\n");
+        return std::make_shared<vespalib::ShmCryptoEngine>(std::make_shared<vespalib::NullCryptoEngine>());
+    } else if (engine == "shm_small") {
+        fprintf(stderr, "crypto engine: shared memory with small rings (null fallback)\n");
+        return std::make_shared<vespalib::ShmCryptoEngine>(std::make_shared<vespalib::NullCryptoEngine>(), 4096);
     }
     TEST_FATAL(("invalid crypto engine: " + engine).c_str());
     abort();
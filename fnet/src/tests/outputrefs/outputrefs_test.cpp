@@ -0,0 +1,134 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/fnet/outputrefs.h>
+#include <vespa/fnet/databuffer.h>
+#include <vespa/fnet/packet.h>
+#include <sys/uio.h>
+#include <string>
+
+struct MyPacket : public FNET_Packet {
+    int &freed;
+    explicit MyPacket(int &freed_in) : freed(freed_in) {}
+    void Free() override { ++freed; }
+    uint32_t GetPCODE() override { return 0; }
+    uint32_t GetLength() override { return 0; }
+    void Encode(FNET_DataBuffer *) override {}
+    bool Decode(FNET_DataBuffer *, uint32_t) override { return true; }
+};
+
+std::string flatten(const struct iovec *iov, int cnt) {
+    std::string str;
+    for (int i = 0; i < cnt; ++i) {
+        str.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return str;
+}
+
+// write (at most) 'len' bytes of the current output stream into 'dst'
+void write(FNET_OutputRefs &refs, FNET_DataBuffer &buf, size_t len, std::string &dst) {
+    struct iovec iov[FNET_OutputRefs::MAX_IOV];
+    std::string str = flatten(iov, refs.FillIOVec(buf, iov, FNET_OutputRefs::MAX_IOV));
+    len = std::min(len, str.size());
+    dst.append(str.data(), len);
+    refs.Consume(buf, len);
+}
+
+TEST("require that buffer data and references are interleaved in stream order") {
+    std::string a("aaaa"), b("bbbbbb");
+    FNET_DataBuffer buf;
+    FNET_OutputRefs refs;
+    buf.WriteBytes("hdr1", 4);
+    refs.AddRef(buf, a.data(), a.size());
+    buf.WriteBytes("hdr2", 4);
+    refs.AddRef(buf, b.data(), b.size());
+    refs.AddRef(buf, a.data(), a.size());
+    buf.WriteBytes("tail", 4);
+    EXPECT_EQUAL(refs.GetRefCnt(), 3u);
+    EXPECT_EQUAL(refs.GetRefLen(), 14u);
+    struct iovec iov[FNET_OutputRefs::MAX_IOV];
+    int cnt = refs.FillIOVec(buf, iov, FNET_OutputRefs::MAX_IOV);
+    EXPECT_EQUAL(cnt, 6);
+    EXPECT_EQUAL(flatten(iov, cnt), std::string("hdr1aaaahdr2bbbbbbaaaatail"));
+    EXPECT_EQUAL(flatten(iov, refs.FillIOVec(buf, iov, 3)), std::string("hdr1aaaahdr2"));
+}
+
+TEST("require that partial writes pick up where they left off") {
+    std::string a("0123456789"), b("abcdefghij");
+    std::string expect = std::string("xx") + a + "yyy" + b + "z";
+    for (size_t step = 1; step <= expect.size(); ++step) {
+        FNET_DataBuffer buf;
+        FNET_OutputRefs refs;
+        buf.WriteBytes("xx", 2);
+        refs.AddRef(buf, a.data(), a.size());
+        buf.WriteBytes("yyy", 3);
+        refs.AddRef(buf, b.data(), b.size());
+        buf.WriteBytes("z", 1);
+        std::string written;
+        while (written.size() < expect.size()) {
+            write(refs, buf, step, written);
+        }
+        EXPECT_EQUAL(written, expect);
+        EXPECT_TRUE(refs.IsEmpty());
+        EXPECT_EQUAL(refs.GetRefLen(), 0u);
+        EXPECT_EQUAL(buf.GetDataLen(), 0u);
+    }
+}
+
+TEST("require that positions survive output buffer data being consumed between packets") {
+    std::string a("AAAA");
+    FNET_DataBuffer buf;
+    FNET_OutputRefs refs;
+    std::string written;
+    buf.WriteBytes("first", 5);
+    write(refs, buf, 3, written);
+    buf.WriteBytes("second", 6);
+    refs.AddRef(buf, a.data(), a.size());
+    buf.WriteBytes("third", 5);
+    write(refs, buf, 100, written);
+    EXPECT_EQUAL(written, std::string("firstsecondAAAAthird"));
+}
+
+TEST("require that owners are freed when their last reference is written") {
+    std::string a("aaaa"), b("bbbb");
+    int freed1 = 0;
+    int freed2 = 0;
+    MyPacket p1(freed1), p2(freed2);
+    FNET_DataBuffer buf;
+    FNET_OutputRefs refs;
+    std::string written;
+    refs.AddRef(buf, a.data(), a.size());
+    refs.AddRef(buf, b.data(), b.size());
+    refs.SetOwner(&p1);
+    buf.WriteBytes("--", 2);
+    refs.AddRef(buf, a.data(), a.size());
+    refs.SetOwner(&p2);
+    write(refs, buf, 7, written);
+    EXPECT_EQUAL(freed1, 0);
+    write(refs, buf, 1, written);
+    EXPECT_EQUAL(freed1, 1);
+    write(refs, buf, 5, written);
+    EXPECT_EQUAL(freed2, 0);
+    write(refs, buf, 1, written);
+    EXPECT_EQUAL(freed2, 1);
+    EXPECT_EQUAL(written, std::string("aaaabbbb--aaaa"));
+}
+
+TEST("require that discarding references frees their owners") {
+    std::string a("aaaa");
+    int freed = 0;
+    MyPacket p1(freed), p2(freed);
+    FNET_DataBuffer buf;
+    {
+        FNET_OutputRefs refs;
+        refs.AddRef(buf, a.data(), a.size());
+        refs.SetOwner(&p1);
+        refs.Discard();
+        EXPECT_EQUAL(freed, 1);
+        EXPECT_TRUE(refs.IsEmpty());
+        refs.AddRef(buf, a.data(), a.size());
+        refs.SetOwner(&p2);
+    }
+    EXPECT_EQUAL(freed, 2);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -17,6 +17,8 @@ public:
     uint32_t  _maxOutputBufferSize;
     bool      _tcpNoDelay;
     bool      _drop_empty_buffers;
+    bool      _use_io_uring;
+    bool      _measure_socket_time;
 
     FNET_Config();
 };
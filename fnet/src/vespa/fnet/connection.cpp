@@ -10,6 +10,7 @@
 #include "transport_thread.h"
 #include "transport.h"
 #include <vespa/vespalib/net/socket_spec.h>
+#include <sys/uio.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".fnet");
@@ -141,6 +142,9 @@ FNET_Connection::SetState(State state)
             guard.lock();
             _flags._discarding = false;
         }
+        guard.unlock();
+        _outputRefs.Discard();
+        guard.lock();
 
         BeforeCallback(guard, nullptr);
         toDelete = _channels.Broadcast(&FNET_ControlPacket::ChannelLost);
@@ -303,6 +307,22 @@ FNET_Connection::handle_packets()
     return !broken;
 }
 
+void
+FNET_Connection::SocketTime::add(vespalib::duration elapsed, ssize_t res)
+{
+    nanos.store(nanos.load(std::memory_order_relaxed) + vespalib::count_ns(elapsed), std::memory_order_relaxed);
+    if (res > 0) {
+        bytes.store(bytes.load(std::memory_order_relaxed) + res, std::memory_order_relaxed);
+    }
+}
+
+double
+FNET_Connection::SocketTime::nanos_per_byte() const
+{
+    uint64_t my_bytes = bytes.load(std::memory_order_relaxed);
+    return (my_bytes > 0) ? (double(nanos.load(std::memory_order_relaxed)) / my_bytes) : 0.0;
+}
+
 bool
 FNET_Connection::Read()
 {
@@ -311,10 +331,13 @@ FNET_Connection::Read()
     bool     broken      = false; // is this conn broken ?
     int      my_errno    = 0;     // sample and preserve errno
     ssize_t  res;                 // single read result
+    vespalib::steady_time start;  // start of socket operation
 
     _input.EnsureFree(chunk_size);
+    start = socket_time_start();
     res = _socket->read(_input.GetFree(), _input.GetFreeLen());
     my_errno = errno;
+    add_socket_time(_readTime, start, res);
     readCnt++;
 
     while (res > 0) {
@@ -325,8 +348,10 @@ FNET_Connection::Read()
             goto done_read;
         }
         _input.EnsureFree(chunk_size);
+        start = socket_time_start();
         res = _socket->read(_input.GetFree(), _input.GetFreeLen());
         my_errno = errno;
+        add_socket_time(_readTime, start, res);
         readCnt++;
     }
 
@@ -334,8 +359,10 @@ done_read:
 
     while ((res > 0) && !broken) { // drain input pipeline
         _input.EnsureFree(chunk_size);
+        start = socket_time_start();
         res = _socket->drain(_input.GetFree(), _input.GetFreeLen());
         my_errno = errno;
+        add_socket_time(_readTime, start, res);
         if (res > 0) {
             _input.FreeToData((uint32_t)res);
             broken = !handle_packets();
@@ -383,55 +410,72 @@ FNET_Connection::Write()
     bool     broken         = false; // is this conn broken ?
     int      my_errno       = 0;     // sample and preserve errno
     ssize_t  res;                    // single write result
+    vespalib::steady_time start;     // start of socket operation
 
     FNET_Packet     *packet;
     FNET_Context     context;
+    struct iovec     iov[FNET_OutputRefs::MAX_IOV];
 
     do {
 
-        // fill output buffer
+        // fill output buffer, large packet data is referenced rather than copied
 
-        while (_output.GetDataLen() < chunk_size) {
+        while (_output.GetDataLen() + _outputRefs.GetRefLen() < chunk_size) {
             if (_myQueue.IsEmpty_NoLock())
                 break;
 
             packet = _myQueue.DequeuePacket_NoLock(&context);
             if (packet->IsRegularPacket()) { // ignore non-regular packets
-                _streamer->Encode(packet, context._value.INT, &_output);
+                size_t refCnt = _outputRefs.GetRefCnt();
+                _streamer->EncodeWithRefs(packet, context._value.INT, &_output, _outputRefs);
+                if (_outputRefs.GetRefCnt() > refCnt) {
+                    _outputRefs.SetOwner(packet); // freed when written
+                    continue;
+                }
             }
             packet->Free();
         }
 
-        if (_output.GetDataLen() == 0) {
+        if (_output.GetDataLen() == 0 && _outputRefs.IsEmpty()) {
             res = 0;
             break;
         }
 
         // write data
 
-        res = _socket->write(_output.GetData(), _output.GetDataLen());
+        start = socket_time_start();
+        if (_outputRefs.IsEmpty()) {
+            res = _socket->write(_output.GetData(), _output.GetDataLen());
+        } else {
+            int iovcnt = _outputRefs.FillIOVec(_output, iov, FNET_OutputRefs::MAX_IOV);
+            res = _socket->writev(iov, iovcnt);
+        }
         my_errno = errno;
+        add_socket_time(_writeTime, start, res);
         writeCnt++;
         if (res > 0) {
-            _output.DataToDead((uint32_t)res);
+            _outputRefs.Consume(_output, res);
             _output.resetIfEmpty();
         }
     } while (res > 0 &&
              _output.GetDataLen() == 0 &&
+             _outputRefs.IsEmpty() &&
              !_myQueue.IsEmpty_NoLock() &&
              writeCnt < FNET_WRITE_REDO);
 
-    if ((_output.GetDataLen() > 0)) {
+    if ((_output.GetDataLen() > 0) || !_outputRefs.IsEmpty()) {
         ++my_write_work;
     }
 
     if (res >= 0) { // flush output pipeline
+        start = socket_time_start();
         res = _socket->flush();
         my_errno = errno;
         while (res > 0) {
             res = _socket->flush();
             my_errno = errno;
         }
+        add_socket_time(_writeTime, start, 0); // time only, the bytes were counted when written
     }
 
     if (_flags._drop_empty_buffers) {
@@ -495,8 +539,11 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _queue(256),
       _myQueue(256),
       _output(0),
+      _outputRefs(),
       _channels(),
       _callbackTarget(nullptr),
+      _readTime(),
+      _writeTime(),
       _cleanup(nullptr)
 {
     assert(_socket && (_socket->get_fd() >= 0));
@@ -529,8 +576,11 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _queue(256),
       _myQueue(256),
       _output(0),
+      _outputRefs(),
       _channels(),
       _callbackTarget(nullptr),
+      _readTime(),
+      _writeTime(),
       _cleanup(nullptr)
 {
     if (adminHandler != nullptr) {
@@ -719,6 +769,32 @@ FNET_Connection::PostPacket(FNET_Packet *packet, uint32_t chid)
 }
 
 
+bool
+FNET_Connection::PostPackets(FNET_PacketQueue_NoLock &packets)
+{
+    uint32_t writeWork;
+
+    std::unique_lock<std::mutex> guard(_ioc_lock);
+    if (_state >= FNET_CLOSING) {
+        if (_flags._discarding) {
+            packets.FlushPackets_NoLock(&_queue);
+        } else {
+            guard.unlock();
+            packets.DiscardPackets_NoLock(); // discard packets
+        }
+        return false;     // connection is down
+    }
+    writeWork = _writeWork;
+    _writeWork += packets.FlushPackets_NoLock(&_queue);
+    if ((writeWork == 0) && (_writeWork > 0) && (_state == FNET_CONNECTED)) {
+        AddRef_NoLock();
+        guard.unlock();
+        Owner()->EnableWrite(this, /* needRef = */ false);
+    }
+    return true;
+}
+
+
 void
 FNET_Connection::Sync()
 {
@@ -8,6 +8,7 @@
 #include "context.h"
 #include "channellookup.h"
 #include "packetqueue.h"
+#include "outputrefs.h"
 #include <vespa/vespalib/net/socket_handle.h>
 #include <vespa/vespalib/net/async_resolver.h>
 #include <vespa/vespalib/net/crypto_socket.h>
@@ -76,7 +77,8 @@ private:
             _discarding(false),
             _framed(false),
             _handshake_work_pending(false),
-            _drop_empty_buffers(cfg._drop_empty_buffers)
+            _drop_empty_buffers(cfg._drop_empty_buffers),
+            _measure_socket_time(cfg._measure_socket_time)
         { }
         bool _gotheader;
         bool _inCallback;
@@ -85,6 +87,15 @@ private:
         bool _framed;
         bool _handshake_work_pending;
         bool _drop_empty_buffers;
+        bool _measure_socket_time;
+    };
+    // written by the transport thread only, read by anyone
+    struct SocketTime {
+        std::atomic<uint64_t> nanos;
+        std::atomic<uint64_t> bytes;
+        SocketTime() noexcept : nanos(0), bytes(0) {}
+        void add(vespalib::duration elapsed, ssize_t res);
+        double nanos_per_byte() const;
     };
     struct ResolveHandler : public vespalib::AsyncResolver::ResultHandler {
         FNET_Connection *connection;
@@ -111,8 +122,11 @@ private:
     FNET_PacketQueue_NoLock  _queue;           // outer output queue
     FNET_PacketQueue_NoLock  _myQueue;         // inner output queue
     FNET_DataBuffer          _output;          // output buffer
+    FNET_OutputRefs          _outputRefs;      // packet memory to write after/between output buffer data
     FNET_ChannelLookup       _channels;        // channel 'DB'
     FNET_Channel            *_callbackTarget;  // target of current callback
+    SocketTime               _readTime;        // time spent reading from the socket
+    SocketTime               _writeTime;       // time spent writing to the socket
 
     FNET_IConnectionCleanupHandler *_cleanup;  // cleanup handler
 
@@ -121,6 +135,15 @@ private:
     FNET_Connection(const FNET_Connection &);
     FNET_Connection &operator=(const FNET_Connection &);
 
+    vespalib::steady_time socket_time_start() const {
+        return _flags._measure_socket_time ? vespalib::steady_clock::now() : vespalib::steady_time();
+    }
+    void add_socket_time(SocketTime &time, vespalib::steady_time start, ssize_t res) {
+        if (_flags._measure_socket_time) {
+            time.add(vespalib::steady_clock::now() - start, res);
+        }
+    }
+
 
     /**
      * Get next ID that may be used for multiplexing on this connection.
@@ -474,6 +497,20 @@ public:
     bool PostPacket(FNET_Packet *packet, uint32_t chid);
 
 
+    /**
+     * Post all packets in the given queue on the output queue at
+     * once. This takes the connection lock and wakes the transport
+     * thread only once, and the packets will be written together
+     * (typically with a single system call). The context of each
+     * packet must be its channel id. The given queue will be empty
+     * afterwards. NOTE: packet handover (caller TO invoked object).
+     *
+     * @return false if connection was down, true otherwise.
+     * @param packets the packets to queue for sending.
+     **/
+    bool PostPackets(FNET_PacketQueue_NoLock &packets);
+
+
     /**
      * Sync with this connection. When this method is invoked it will
      * block until all packets currently posted on this connection is
@@ -524,6 +561,18 @@ public:
      */
     uint32_t getInputBufferSize() const { return _input.GetBufSize(); }
 
+    /**
+     * @return average nanoseconds spent in the socket per byte read,
+     *         0 unless socket time is measured (see FNET_Config)
+     **/
+    double socket_read_nanos_per_byte() const { return _readTime.nanos_per_byte(); }
+
+    /**
+     * @return average nanoseconds spent in the socket per byte written,
+     *         0 unless socket time is measured (see FNET_Config)
+     **/
+    double socket_write_nanos_per_byte() const { return _writeTime.nanos_per_byte(); }
+
     /**
      * @return the total number of connection objects
      **/
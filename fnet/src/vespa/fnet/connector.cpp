@@ -36,6 +36,9 @@ FNET_Connector::Close()
 {
     detach_selector();
     _ioc_socket_fd = -1;
+    if (_server_socket.valid()) {
+        Owner()->owner().server_closed(GetPortNumber());
+    }
     _server_socket = vespalib::ServerSocket();
 }
 
@@ -2,7 +2,10 @@
 
 #include "invoker.h"
 #include "supervisor.h"
+#include "method_tracer.h"
 #include <vespa/fnet/channel.h>
+#include <vespa/fnet/connection.h>
+#include <cstring>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".fnet.frt.invoker");
@@ -40,13 +43,47 @@ FRT_SingleReqWait::RequestDone(FRT_RPCRequest *req)
 }
 
 
+FRT_BatchReqWait::FRT_BatchReqWait(uint32_t cnt)
+    : _lock(),
+      _cond(),
+      _pending(cnt)
+{ }
+
+FRT_BatchReqWait::~FRT_BatchReqWait() = default;
+
+void
+FRT_BatchReqWait::WaitAll()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (_pending > 0) {
+        _cond.wait(guard);
+    }
+}
+
+
+void
+FRT_BatchReqWait::RequestDone(FRT_RPCRequest *req)
+{
+    (void) req;
+    std::lock_guard<std::mutex> guard(_lock);
+    assert(_pending > 0);
+    if (--_pending == 0) {
+        _cond.notify_all();
+    }
+}
+
+
 FRT_RPCInvoker::FRT_RPCInvoker(FRT_Supervisor *supervisor,
                                FRT_RPCRequest *req,
                                bool noReply)
     : _req(req),
       _method(supervisor->GetReflectionManager()
               ->LookupMethod(req->GetMethodName())),
-      _noReply(noReply)
+      _noReply(noReply),
+      _tracer(nullptr),
+      _invokeTime(),
+      _queueTime(),
+      _bytesIn(0)
 {
     if (LOG_WOULD_LOG(debug)) {
         std::string methodName(_req->GetMethodName(), _req->GetMethodNameLen());
@@ -64,6 +101,33 @@ FRT_RPCInvoker::FRT_RPCInvoker(FRT_Supervisor *supervisor,
     req->SetReturnHandler(this);
 }
 
+void
+FRT_RPCInvoker::StartTrace(fnet::frt::MethodTracer *tracer, vespalib::duration queueTime, uint32_t bytesIn)
+{
+    _tracer = tracer;
+    _invokeTime = vespalib::steady_clock::now();
+    _queueTime = queueTime;
+    _bytesIn = bytesIn;
+}
+
+void
+FRT_RPCInvoker::RecordTrace()
+{
+    fnet::frt::MethodTracer::Sample sample;
+    uint32_t bytesOut = _req->GetReturn()->GetLength();
+    FNET_Connection *conn = GetConnection();
+    // samples are keyed by registered methods only, to bound the number of keys
+    sample.set_method(_method->GetName(), strlen(_method->GetName()));
+    sample.queue_ns = vespalib::count_ns(_queueTime);
+    sample.handler_ns = vespalib::count_ns(vespalib::steady_clock::now() - _invokeTime);
+    sample.socket_ns = uint64_t(_bytesIn * conn->socket_read_nanos_per_byte() +
+                                bytesOut * conn->socket_write_nanos_per_byte());
+    sample.bytes_in = _bytesIn;
+    sample.bytes_out = bytesOut;
+    sample.error = _req->IsError();
+    _tracer->record(sample);
+}
+
 bool FRT_RPCInvoker::Invoke()
 {
     bool detached = false;
@@ -87,6 +151,9 @@ FRT_RPCInvoker::HandleDone(bool freeChannel)
     {
         _req->SetError(FRTE_RPC_WRONG_RETURN);
     }
+    if ((_tracer != nullptr) && (_method != nullptr)) {
+        RecordTrace();
+    }
     if (LOG_WOULD_LOG(debug)) {
         std::string methodName(_req->GetMethodName(), _req->GetMethodNameLen());
         LOG(debug, "invoke(server) done: '%s': '%s'",
@@ -5,11 +5,13 @@
 #include "rpcrequest.h"
 #include <vespa/fnet/task.h>
 #include <vespa/fnet/ipackethandler.h>
+#include <vespa/vespalib/util/time.h>
 #include <mutex>
 #include <condition_variable>
 
 class FRT_Method;
 class FRT_Supervisor;
+namespace fnet::frt { class MethodTracer; }
 //-----------------------------------------------------------------------------
 
 class FRT_IRequestWait
@@ -44,6 +46,27 @@ public:
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Waits for a given number of requests to complete, typically all
+ * requests invoked together with FRT_Supervisor::InvokeBatch.
+ **/
+class FRT_BatchReqWait : public FRT_IRequestWait
+{
+private:
+    std::mutex              _lock;
+    std::condition_variable _cond;
+    uint32_t                _pending;
+
+public:
+    explicit FRT_BatchReqWait(uint32_t cnt);
+    ~FRT_BatchReqWait() override;
+
+    void WaitAll();
+    void RequestDone(FRT_RPCRequest *req) override;
+};
+
+//-----------------------------------------------------------------------------
+
 class FRT_ITimeoutHandler
 {
 public:
@@ -61,13 +84,19 @@ public:
 class FRT_RPCInvoker : public FRT_IReturnHandler
 {
 private:
-    FRT_RPCRequest *_req;
-    FRT_Method     *_method;
-    bool            _noReply;
+    FRT_RPCRequest            *_req;
+    FRT_Method                *_method;
+    bool                       _noReply;
+    fnet::frt::MethodTracer   *_tracer;
+    vespalib::steady_time      _invokeTime;
+    vespalib::duration         _queueTime;
+    uint32_t                   _bytesIn;
 
     FRT_RPCInvoker(const FRT_RPCInvoker &);
     FRT_RPCInvoker &operator=(const FRT_RPCInvoker &);
 
+    void RecordTrace();
+
 public:
     FRT_RPCInvoker(FRT_Supervisor *supervisor,
                    FRT_RPCRequest *req,
@@ -75,6 +104,15 @@ public:
 
     void ForceMethod(FRT_Method *method) { _method = method; }
 
+    /**
+     * Record a trace sample for this request when it is done.
+     *
+     * @param tracer where to record the sample
+     * @param queueTime time spent waiting in the transport thread
+     * @param bytesIn size of the request packet
+     **/
+    void StartTrace(fnet::frt::MethodTracer *tracer, vespalib::duration queueTime, uint32_t bytesIn);
+
     FRT_RPCRequest *GetRequest() { return _req; }
 
     void HandleDone(bool freeChannel);
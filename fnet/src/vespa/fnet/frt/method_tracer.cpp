@@ -0,0 +1,267 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "method_tracer.h"
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/data/memory.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace fnet::frt {
+
+namespace {
+
+std::atomic<uint64_t> next_tracer_id(1);
+
+// ids of all tracers that have not been destroyed yet
+std::mutex live_tracers_lock;
+std::set<uint64_t> live_tracers;
+// bumped whenever a tracer is destroyed
+std::atomic<uint64_t> tracer_destroy_epoch(0);
+
+struct RingRef {
+    uint64_t tracer;
+    void    *ring;
+};
+
+// rings of the current thread, one per live tracer it has recorded into
+struct ThreadRings {
+    uint64_t             epoch = 0;
+    std::vector<RingRef> refs;
+    void prune() {
+        uint64_t current = tracer_destroy_epoch.load(std::memory_order_acquire);
+        if (epoch == current) {
+            return;
+        }
+        std::lock_guard guard(live_tracers_lock);
+        std::erase_if(refs, [](const RingRef &ref) { return !live_tracers.contains(ref.tracer); });
+        epoch = current;
+    }
+};
+thread_local ThreadRings my_rings;
+
+uint64_t bucket_limit(size_t idx) {
+    return (idx == 0) ? 0 : ((idx >= 64) ? UINT64_MAX : ((uint64_t(1) << idx) - 1));
+}
+
+}
+
+TraceHistogram::TraceHistogram()
+    : _buckets(),
+      _count(0),
+      _sum(0),
+      _max(0)
+{
+}
+
+size_t
+TraceHistogram::bucket_of(uint64_t value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    size_t idx = 64 - __builtin_clzl(value);
+    return std::min(idx, num_buckets - 1);
+}
+
+void
+TraceHistogram::add(uint64_t value)
+{
+    ++_buckets[bucket_of(value)];
+    ++_count;
+    _sum += value;
+    _max = std::max(_max, value);
+}
+
+uint64_t
+TraceHistogram::quantile(double q) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+    uint64_t wanted = std::max(uint64_t(1), uint64_t(q * _count + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= wanted) {
+            return std::min(bucket_limit(i), _max);
+        }
+    }
+    return _max;
+}
+
+void
+TraceHistogram::to_slime(vespalib::slime::Cursor &obj, bool full) const
+{
+    obj.setLong("count", _count);
+    obj.setDouble("average", (_count > 0) ? (double(_sum) / _count) : 0.0);
+    obj.setLong("p50", quantile(0.5));
+    obj.setLong("p90", quantile(0.9));
+    obj.setLong("p99", quantile(0.99));
+    obj.setLong("p999", quantile(0.999));
+    obj.setLong("max", _max);
+    if (full) {
+        vespalib::slime::Cursor &buckets = obj.setArray("buckets");
+        for (size_t i = 0; i < num_buckets; ++i) {
+            if (_buckets[i] > 0) {
+                vespalib::slime::Cursor &bucket = buckets.addObject();
+                bucket.setLong("limit", bucket_limit(i));
+                bucket.setLong("count", _buckets[i]);
+            }
+        }
+    }
+}
+
+void
+MethodTracer::Sample::set_method(const char *name, size_t len)
+{
+    len = std::min(len, max_name_len);
+    memcpy(method, name, len);
+    method[len] = '\0';
+}
+
+MethodTracer::MethodStats::MethodStats()
+    : errors(0),
+      queue_ns(),
+      handler_ns(),
+      socket_ns(),
+      bytes_in(),
+      bytes_out()
+{
+}
+
+void
+MethodTracer::MethodStats::add(const Sample &sample)
+{
+    if (sample.error) {
+        ++errors;
+    }
+    queue_ns.add(sample.queue_ns);
+    handler_ns.add(sample.handler_ns);
+    socket_ns.add(sample.socket_ns);
+    bytes_in.add(sample.bytes_in);
+    bytes_out.add(sample.bytes_out);
+}
+
+MethodTracer::MethodTracer()
+    : _id(next_tracer_id.fetch_add(1, std::memory_order_relaxed)),
+      _lock(),
+      _rings(),
+      _stats()
+{
+    std::lock_guard guard(live_tracers_lock);
+    live_tracers.insert(_id);
+}
+
+MethodTracer::~MethodTracer()
+{
+    {
+        std::lock_guard guard(live_tracers_lock);
+        live_tracers.erase(_id);
+    }
+    // makes threads drop their references to our rings the next time they record
+    tracer_destroy_epoch.fetch_add(1, std::memory_order_release);
+}
+
+MethodTracer::Ring &
+MethodTracer::my_ring()
+{
+    my_rings.prune();
+    for (const RingRef &ref: my_rings.refs) {
+        if (ref.tracer == _id) {
+            return *static_cast<Ring *>(ref.ring);
+        }
+    }
+    std::lock_guard guard(_lock);
+    _rings.push_back(std::make_unique<Ring>());
+    my_rings.refs.push_back(RingRef{_id, _rings.back().get()});
+    return *_rings.back();
+}
+
+void
+MethodTracer::drain(Ring &ring) const
+{
+    uint32_t head = ring.head.load(std::memory_order_acquire);
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        const Sample &sample = ring.slots[tail % ring_size];
+        _stats[vespalib::string(sample.method)].add(sample);
+    }
+    ring.tail.store(tail, std::memory_order_release);
+}
+
+void
+MethodTracer::drain_all() const
+{
+    for (const auto &ring: _rings) {
+        drain(*ring);
+    }
+}
+
+void
+MethodTracer::record(const Sample &sample)
+{
+    Ring &ring = my_ring();
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    uint32_t used = head - ring.tail.load(std::memory_order_acquire);
+    if (used >= (ring_size / 2)) {
+        std::unique_lock guard(_lock, std::try_to_lock);
+        if (guard.owns_lock()) {
+            drain_all();
+            used = 0;
+        }
+    }
+    if (used >= ring_size) {
+        ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    ring.slots[head % ring_size] = sample;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+MethodTracer::StatsMap
+MethodTracer::stats() const
+{
+    std::lock_guard guard(_lock);
+    drain_all();
+    return _stats;
+}
+
+uint64_t
+MethodTracer::dropped() const
+{
+    std::lock_guard guard(_lock);
+    uint64_t sum = 0;
+    for (const auto &ring: _rings) {
+        sum += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+size_t
+MethodTracer::num_thread_rings()
+{
+    my_rings.prune();
+    return my_rings.refs.size();
+}
+
+void
+MethodTracer::to_slime(vespalib::slime::Cursor &obj, bool full) const
+{
+    uint64_t num_dropped = dropped();
+    StatsMap snapshot = stats();
+    obj.setLong("dropped_samples", num_dropped);
+    vespalib::slime::Cursor &methods = obj.setObject("methods");
+    for (const auto &entry: snapshot) {
+        const MethodStats &s = entry.second;
+        vespalib::slime::Cursor &method = methods.setObject(vespalib::Memory(entry.first));
+        method.setLong("errors", s.errors);
+        s.queue_ns.to_slime(method.setObject("queue_ns"), full);
+        s.handler_ns.to_slime(method.setObject("handler_ns"), full);
+        s.socket_ns.to_slime(method.setObject("socket_ns"), full);
+        s.bytes_in.to_slime(method.setObject("bytes_in"), full);
+        s.bytes_out.to_slime(method.setObject("bytes_out"), full);
+    }
+}
+
+}
@@ -0,0 +1,149 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vespalib::slime { struct Cursor; }
+
+namespace fnet::frt {
+
+/**
+ * Histogram with power-of-two sized buckets. Bucket 0 counts the
+ * value 0 and bucket i counts values in [2^(i-1), 2^i).
+ **/
+class TraceHistogram
+{
+public:
+    static constexpr size_t num_buckets = 48;
+private:
+    std::array<uint64_t, num_buckets> _buckets;
+    uint64_t _count;
+    uint64_t _sum;
+    uint64_t _max;
+public:
+    TraceHistogram();
+    static size_t bucket_of(uint64_t value);
+    void add(uint64_t value);
+    uint64_t count() const { return _count; }
+    uint64_t sum() const { return _sum; }
+    uint64_t max() const { return _max; }
+    uint64_t bucket(size_t idx) const { return _buckets[idx]; }
+    // upper bound of the bucket holding the value at the given quantile
+    uint64_t quantile(double q) const;
+    void to_slime(vespalib::slime::Cursor &obj, bool full) const;
+};
+
+/**
+ * Low overhead tracing of incoming RPC requests, aggregated per
+ * method. Enable it with FRT_Supervisor::EnableTracing.
+ *
+ * For each request handled by the supervisor we record the time it
+ * waited in the transport thread before being invoked (measured from
+ * when the event loop woke up), the time until the method returned
+ * (including any time spent detached), the sizes of parameters and
+ * return values and the estimated time the connection spent in its
+ * socket layer (TLS encryption/decryption and system calls) on the
+ * bytes of the request and its reply. The socket time is only known
+ * when the transport measures it (see TransportConfig::measure_socket_time).
+ *
+ * Samples are written into a per thread ring buffer owned by the
+ * tracer without taking any locks. Threads forget the rings of a
+ * tracer once it has been destroyed. Rings are drained into the per
+ * method histograms when the state is inspected, or by the recording
+ * thread itself (if the aggregation lock is free) once its ring is
+ * half full. Samples are dropped (and counted) when a ring is full.
+ **/
+class MethodTracer
+{
+public:
+    struct Sample {
+        static constexpr size_t max_name_len = 63;
+        char     method[max_name_len + 1];
+        uint64_t queue_ns;
+        uint64_t handler_ns;
+        uint64_t socket_ns;
+        uint32_t bytes_in;
+        uint32_t bytes_out;
+        bool     error;
+        void set_method(const char *name, size_t len);
+    };
+
+    struct MethodStats {
+        uint64_t       errors;
+        TraceHistogram queue_ns;
+        TraceHistogram handler_ns;
+        TraceHistogram socket_ns;
+        TraceHistogram bytes_in;
+        TraceHistogram bytes_out;
+        MethodStats();
+        void add(const Sample &sample);
+    };
+    using StatsMap = std::map<vespalib::string, MethodStats>;
+
+    static constexpr uint32_t ring_size = 1024;
+
+private:
+    // single producer (the owning thread), single consumer (whoever holds _lock)
+    struct Ring {
+        std::atomic<uint32_t> head;
+        std::atomic<uint32_t> tail;
+        std::atomic<uint64_t> dropped;
+        std::array<Sample, ring_size> slots;
+        Ring() noexcept : head(0), tail(0), dropped(0), slots() {}
+    };
+
+    const uint64_t                     _id;
+    mutable std::mutex                 _lock;
+    std::vector<std::unique_ptr<Ring>> _rings;
+    mutable StatsMap                   _stats;
+
+    Ring &my_ring();
+    void drain(Ring &ring) const;
+    void drain_all() const;
+
+public:
+    MethodTracer();
+    MethodTracer(const MethodTracer &) = delete;
+    MethodTracer &operator=(const MethodTracer &) = delete;
+    ~MethodTracer();
+
+    /**
+     * Record a sample from the calling thread. Lock-free unless the
+     * ring of the calling thread needs draining and nobody else is
+     * aggregating.
+     **/
+    void record(const Sample &sample);
+
+    /**
+     * Obtain a copy of the aggregated per method statistics,
+     * including all samples recorded before this call.
+     **/
+    StatsMap stats() const;
+
+    /**
+     * Number of samples dropped due to full ring buffers.
+     **/
+    uint64_t dropped() const;
+
+    /**
+     * Number of rings the calling thread currently refers to, one
+     * per live tracer it has recorded into.
+     **/
+    static size_t num_thread_rings();
+
+    /**
+     * Render the aggregated statistics as an object with one child
+     * object per method. Histogram buckets are only included if full
+     * is true.
+     **/
+    void to_slime(vespalib::slime::Cursor &obj, bool full) const;
+};
+
+}
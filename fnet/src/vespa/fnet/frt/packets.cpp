@@ -36,8 +36,15 @@ FRT_RPCRequestPacket::GetLength()
 }
 
 
+uint32_t
+FRT_RPCRequestPacket::GetRefLength()
+{
+    return _req->GetParams()->GetRefLength();
+}
+
+
 void
-FRT_RPCRequestPacket::Encode(FNET_DataBuffer *dst)
+FRT_RPCRequestPacket::EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -48,13 +55,13 @@ FRT_RPCRequestPacket::Encode(FNET_DataBuffer *dst)
         dst->WriteBytesFast(&tmp, sizeof(tmp));
         dst->WriteBytesFast(_req->GetMethodName(),
                             _req->GetMethodNameLen());
-        _req->GetParams()->EncodeCopy(dst);
+        _req->GetParams()->EncodeCopy(dst, refs);
     } else {
         assert(packet_endian == FNET_Info::ENDIAN_BIG);
         dst->WriteInt32Fast(_req->GetMethodNameLen());
         dst->WriteBytesFast(_req->GetMethodName(),
                             _req->GetMethodNameLen());
-        _req->GetParams()->EncodeBig(dst);
+        _req->GetParams()->EncodeBig(dst, refs);
     }
 }
 
@@ -118,18 +125,25 @@ FRT_RPCReplyPacket::GetLength()
 }
 
 
+uint32_t
+FRT_RPCReplyPacket::GetRefLength()
+{
+    return _req->GetReturn()->GetRefLength();
+}
+
+
 void
-FRT_RPCReplyPacket::Encode(FNET_DataBuffer *dst)
+FRT_RPCReplyPacket::EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
     uint32_t host_endian = FNET_Info::GetEndian();
 
     if (packet_endian == host_endian) {
-        _req->GetReturn()->EncodeCopy(dst);
+        _req->GetReturn()->EncodeCopy(dst, refs);
     } else {
         assert(packet_endian == FNET_Info::ENDIAN_BIG);
-        _req->GetReturn()->EncodeBig(dst);
+        _req->GetReturn()->EncodeBig(dst, refs);
     }
 }
 
@@ -177,7 +191,7 @@ FRT_RPCErrorPacket::GetLength()
 
 
 void
-FRT_RPCErrorPacket::Encode(FNET_DataBuffer *dst)
+FRT_RPCErrorPacket::EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *)
 {
     uint32_t packet_endian = ((_flags & FLAG_FRT_RPC_LITTLE_ENDIAN) != 0)
                              ? FNET_Info::ENDIAN_LITTLE : FNET_Info::ENDIAN_BIG;
@@ -34,6 +34,9 @@ protected:
     FRT_RPCPacket(const FRT_RPCPacket &);
     FRT_RPCPacket &operator=(const FRT_RPCPacket &);
 
+    // both encode methods end up here, refs is nullptr when everything should be copied
+    virtual void EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs) = 0;
+
 public:
     FRT_RPCPacket(FRT_RPCRequest *req, uint32_t flags, bool ownsRef)
         : _req(req),
@@ -46,6 +49,8 @@ public:
 
     ~FRT_RPCPacket();
     void Free() override;
+    void Encode(FNET_DataBuffer *dst) override { EncodeValues(dst, nullptr); }
+    void EncodeWithRefs(FNET_DataBuffer *dst, FNET_OutputRefs &refs) override { EncodeValues(dst, &refs); }
 };
 
 
@@ -59,7 +64,8 @@ public:
 
     uint32_t GetPCODE() override;
     uint32_t GetLength() override;
-    void Encode(FNET_DataBuffer *dst) override;
+    uint32_t GetRefLength() override;
+    void EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs) override;
     bool Decode(FNET_DataBuffer *src, uint32_t len) override;
     vespalib::string Print(uint32_t indent = 0) override;
 };
@@ -75,7 +81,8 @@ public:
 
     uint32_t GetPCODE() override;
     uint32_t GetLength() override;
-    void Encode(FNET_DataBuffer *dst) override;
+    uint32_t GetRefLength() override;
+    void EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs) override;
     bool Decode(FNET_DataBuffer *src, uint32_t len) override;
     vespalib::string Print(uint32_t indent = 0) override;
 };
@@ -91,7 +98,7 @@ public:
 
     uint32_t GetPCODE() override;
     uint32_t GetLength() override;
-    void Encode(FNET_DataBuffer *dst) override;
+    void EncodeValues(FNET_DataBuffer *dst, FNET_OutputRefs *refs) override;
     bool Decode(FNET_DataBuffer *src, uint32_t len) override;
     vespalib::string Print(uint32_t indent = 0) override;
 };
@@ -0,0 +1,56 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "request_pool.h"
+#include "rpcrequest.h"
+
+namespace fnet::frt {
+
+RequestPool::RequestPool(size_t max_size)
+    : _lock(),
+      _free(),
+      _max_size(max_size)
+{
+}
+
+RequestPool::~RequestPool()
+{
+    for (FRT_RPCRequest *req: _free) {
+        req->SubRef();
+    }
+}
+
+FRT_RPCRequest *
+RequestPool::alloc()
+{
+    {
+        std::lock_guard guard(_lock);
+        if (!_free.empty()) {
+            FRT_RPCRequest *req = _free.back();
+            _free.pop_back();
+            return req;
+        }
+    }
+    return new FRT_RPCRequest();
+}
+
+void
+RequestPool::release(FRT_RPCRequest *req)
+{
+    if (req->Recycle()) {
+        std::lock_guard guard(_lock);
+        if (_free.size() < _max_size) {
+            _free.push_back(req);
+            return;
+        }
+    }
+    req->SubRef();
+}
+
+size_t
+RequestPool::size()
+{
+    std::lock_guard guard(_lock);
+    return _free.size();
+}
+
+} // namespace fnet::frt
@@ -0,0 +1,39 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+class FRT_RPCRequest;
+
+namespace fnet::frt {
+
+/**
+ * Pool of recycled RPC requests, letting clients issuing many
+ * invocations avoid allocating a new request (and its stash) for
+ * each of them. Requests are obtained with alloc and given back with
+ * release instead of calling SubRef. Requests that are still
+ * referenced elsewhere or that failed are not recycled (see
+ * FRT_RPCRequest::Recycle), and at most max_size requests are kept
+ * in the pool. Thread-safe.
+ **/
+class RequestPool
+{
+private:
+    std::mutex                    _lock;
+    std::vector<FRT_RPCRequest *> _free;
+    size_t                        _max_size;
+
+public:
+    explicit RequestPool(size_t max_size = 1024);
+    RequestPool(const RequestPool &) = delete;
+    RequestPool &operator=(const RequestPool &) = delete;
+    ~RequestPool();
+
+    FRT_RPCRequest *alloc();
+    void release(FRT_RPCRequest *req);
+    size_t size();
+};
+
+} // namespace fnet::frt
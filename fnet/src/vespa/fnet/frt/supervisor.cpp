@@ -3,6 +3,7 @@
 #include "supervisor.h"
 #include "invoker.h"
 #include "target.h"
+#include "method_tracer.h"
 #include <vespa/fnet/channel.h>
 #include <vespa/fnet/transport.h>
 #include <vespa/fnet/transport_thread.h>
@@ -18,7 +19,9 @@ FRT_Supervisor::FRT_Supervisor(FNET_Transport *transport)
       _reflectionManager(),
       _rpcHooks(&_reflectionManager),
       _connHooks(*this),
-      _methodMismatchHook()
+      _methodMismatchHook(),
+      _tracer_owner(),
+      _tracer(nullptr)
 {
     _rpcHooks.InitRPC(this);
 }
@@ -31,6 +34,20 @@ FRT_Supervisor::~FRT_Supervisor()
     }
 }
 
+fnet::frt::MethodTracer &
+FRT_Supervisor::EnableTracing()
+{
+    fnet::frt::MethodTracer *tracer = _tracer.load(std::memory_order_acquire);
+    if (tracer == nullptr) {
+        auto fresh = std::make_unique<fnet::frt::MethodTracer>();
+        if (_tracer.compare_exchange_strong(tracer, fresh.get(), std::memory_order_acq_rel)) {
+            tracer = fresh.get();
+            _tracer_owner = std::move(fresh);
+        }
+    }
+    return *tracer;
+}
+
 FNET_Scheduler *
 FRT_Supervisor::GetScheduler() { return _transport->GetScheduler(); }
 
@@ -147,6 +164,33 @@ void
 FRT_Supervisor::InvokeAsync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter)
 {
     uint32_t chid;
+    FNET_Packet *packet = StartInvoke(scheduler, conn, req, timeout, waiter, chid);
+    if (packet != nullptr) {
+        conn->PostPacket(packet, chid);
+    }
+}
+
+
+void
+FRT_Supervisor::InvokeBatch(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest **reqs, uint32_t cnt, double timeout, FRT_IRequestWait *waiter)
+{
+    FNET_PacketQueue_NoLock packets(cnt);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        uint32_t chid;
+        FNET_Packet *packet = StartInvoke(scheduler, conn, reqs[i], timeout, waiter, chid);
+        if (packet != nullptr) {
+            packets.QueuePacket_NoLock(packet, FNET_Context(chid));
+        }
+    }
+    if (!packets.IsEmpty_NoLock()) {
+        conn->PostPackets(packets);
+    }
+}
+
+
+FNET_Packet *
+FRT_Supervisor::StartInvoke(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter, uint32_t &chid)
+{
     FNET_Packet *packet = req->CreateRequestPacket(true);
     FRT_RPCAdapter *adapter = &req->getStash().create<FRT_RPCAdapter>(scheduler.ptr, req, waiter);
     FNET_Channel *ch = (conn == nullptr)? nullptr : conn->OpenChannel(adapter, FNET_Context((void *)req), &chid);
@@ -156,13 +200,13 @@ FRT_Supervisor::InvokeAsync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_R
         packet->Free();
         req->SetError(FRTE_RPC_CONNECTION);
         adapter->ScheduleNow();
-        return;
+        return nullptr;
     }
     constexpr double ONE_YEAR_S = 3600*24*365;
     if (timeout > 0.0 && timeout < ONE_YEAR_S) {
         adapter->Schedule(timeout);
     }
-    conn->PostPacket(packet, chid);
+    return packet;
 }
 
 
@@ -175,6 +219,15 @@ FRT_Supervisor::InvokeSync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RP
 }
 
 
+void
+FRT_Supervisor::InvokeBatchSync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest **reqs, uint32_t cnt, double timeout)
+{
+    FRT_BatchReqWait waiter(cnt);
+    InvokeBatch(scheduler, conn, reqs, cnt, timeout, &waiter);
+    waiter.WaitAll();
+}
+
+
 bool
 FRT_Supervisor::InitAdminChannel(FNET_Channel *channel)
 {
@@ -215,6 +268,10 @@ FRT_Supervisor::HandlePacket(FNET_Packet *packet, FNET_Context context)
         req->SetError(FRTE_RPC_BAD_REQUEST);
     }
     invoker = &req->getStash().create<FRT_RPCInvoker>(this, req, noReply);
+    if (auto *tracer = _tracer.load(std::memory_order_acquire)) {
+        FNET_TransportThread *thread = invoker->GetConnection()->Owner();
+        invoker->StartTrace(tracer, thread->current_time() - thread->event_loop_time(), packet->GetLength());
+    }
     packet->Free();
 
     if (req->IsError()) {
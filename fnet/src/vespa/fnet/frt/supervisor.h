@@ -9,6 +9,7 @@
 #include <vespa/fnet/ipackethandler.h>
 #include <vespa/fnet/connection.h>
 #include <vespa/fnet/simplepacketstreamer.h>
+#include <atomic>
 
 class TransportConfig;
 class FNET_Transport;
@@ -19,6 +20,7 @@ class FRT_RPCInvoker;
 class FRT_IRequestWait;
 
 namespace vespalib { struct CryptoEngine; }
+namespace fnet::frt { class MethodTracer; }
 
 
 class FRT_Supervisor : public FNET_IServerAdapter,
@@ -74,6 +76,8 @@ private:
     RPCHooks                      _rpcHooks;
     ConnHooks                     _connHooks;
     std::unique_ptr<FRT_Method>   _methodMismatchHook;
+    std::unique_ptr<fnet::frt::MethodTracer> _tracer_owner;
+    std::atomic<fnet::frt::MethodTracer *>   _tracer;
 
 public:
     explicit FRT_Supervisor(FNET_Transport *transport);
@@ -100,6 +104,17 @@ public:
     void SetSessionFiniHook(FRT_METHOD_PT  method, FRT_Invokable *handler);
     void SetMethodMismatchHook(FRT_METHOD_PT  method, FRT_Invokable *handler);
 
+    /**
+     * Start tracing incoming requests per method. May be called
+     * while transport threads are serving requests. Calling it more
+     * than once returns the same tracer, which lives as long as the
+     * supervisor.
+     *
+     * @return the tracer holding the collected statistics
+     **/
+    fnet::frt::MethodTracer &EnableTracing();
+    fnet::frt::MethodTracer *GetTracer() { return _tracer.load(std::memory_order_acquire); }
+
     struct SchedulerPtr {
         FNET_Scheduler *ptr;
         SchedulerPtr(FNET_Scheduler *scheduler)
@@ -113,7 +128,20 @@ public:
     static void InvokeSync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout);
     static void InvokeAsync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter);
 
+    /**
+     * Invoke several requests on the same connection at once. Each
+     * request gets its own channel, timeout and callback to the
+     * waiter (as with InvokeAsync), but all request packets are
+     * posted together; they are written to the socket back to back
+     * and will typically arrive at the server in a single read.
+     **/
+    static void InvokeBatch(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest **reqs, uint32_t cnt, double timeout, FRT_IRequestWait *waiter);
+    static void InvokeBatchSync(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest **reqs, uint32_t cnt, double timeout);
+
+private:
+    static FNET_Packet *StartInvoke(SchedulerPtr scheduler, FNET_Connection *conn, FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter, uint32_t &chid);
 
+public:
     // FNET ServerAdapter Interface
     bool InitAdminChannel(FNET_Channel *channel) override;
     bool InitChannel(FNET_Channel *channel, uint32_t pcode) override;
@@ -28,3 +28,13 @@ void
 FRT_Target::InvokeSync(FRT_RPCRequest *req, double timeout) {
     FRT_Supervisor::InvokeSync(_scheduler, _conn, req, timeout);
 }
+
+void
+FRT_Target::InvokeBatch(FRT_RPCRequest **reqs, uint32_t cnt, double timeout, FRT_IRequestWait *waiter) {
+    FRT_Supervisor::InvokeBatch(_scheduler, _conn, reqs, cnt, timeout, waiter);
+}
+
+void
+FRT_Target::InvokeBatchSync(FRT_RPCRequest **reqs, uint32_t cnt, double timeout) {
+    FRT_Supervisor::InvokeBatchSync(_scheduler, _conn, reqs, cnt, timeout);
+}
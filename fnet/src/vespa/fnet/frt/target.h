@@ -46,4 +46,8 @@ public:
     void InvokeAsync(FRT_RPCRequest *req, double timeout, FRT_IRequestWait *waiter);
     void InvokeVoid(FRT_RPCRequest *req);
     void InvokeSync(FRT_RPCRequest *req, double timeout);
+
+    // invoke several requests at once, see FRT_Supervisor::InvokeBatch
+    void InvokeBatch(FRT_RPCRequest **reqs, uint32_t cnt, double timeout, FRT_IRequestWait *waiter);
+    void InvokeBatchSync(FRT_RPCRequest **reqs, uint32_t cnt, double timeout);
 };
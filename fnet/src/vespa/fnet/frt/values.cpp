@@ -2,6 +2,7 @@
 
 #include "values.h"
 #include <vespa/fnet/databuffer.h>
+#include <vespa/fnet/outputrefs.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/stash.h>
 #include <vespa/vespalib/data/databuffer.h>
@@ -26,6 +27,19 @@ char * copyData(char *dst, const void *src, size_t len) {
     return dst;
 }
 
+bool isRefSize(uint32_t len) {
+    return (len >= FNET_OutputRefs::MIN_REF_SIZE);
+}
+
+// Data values stay put until the owning request is freed, so large ones may be written by reference
+void writeData(FNET_DataBuffer *dst, FNET_OutputRefs *refs, const char *buf, uint32_t len) {
+    if ((refs != nullptr) && isRefSize(len)) {
+        refs->AddRef(*dst, buf, len);
+    } else {
+        dst->WriteBytesFast(buf, len);
+    }
+}
+
 using vespalib::alloc::Alloc;
 class LocalBlob : public FRT_ISharedBlob
 {
@@ -489,6 +503,30 @@ FRT_Values::GetLength()
 }
 
 
+uint32_t
+FRT_Values::GetRefLength()
+{
+    // must match the data values written by reference in EncodeCopy/EncodeBig
+    uint32_t len = 0;
+    for (uint32_t i = 0; i < _numValues; i++) {
+        if (_typeString[i] == FRT_VALUE_DATA) {
+            if (fnet::isRefSize(_values[i]._data._len)) {
+                len += _values[i]._data._len;
+            }
+        } else if (_typeString[i] == FRT_VALUE_DATA_ARRAY) {
+            uint32_t       num = _values[i]._data_array._len;
+            FRT_DataValue *pt  = _values[i]._data_array._pt;
+            for (; num > 0; num--, pt++) {
+                if (fnet::isRefSize(pt->_len)) {
+                    len += pt->_len;
+                }
+            }
+        }
+    }
+    return len;
+}
+
+
 bool
 FRT_Values::DecodeCopy(FNET_DataBuffer *src, uint32_t len)
 {
@@ -1231,7 +1269,7 @@ error:
 
 
 void
-FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
+FRT_Values::EncodeCopy(FNET_DataBuffer *dst, FNET_OutputRefs *refs)
 {
     uint32_t numValues = _numValues;
     const char *p = _typeString;
@@ -1348,8 +1386,8 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
 
         case FRT_VALUE_DATA:
             dst->WriteBytesFast(&(_values[i]._data._len), sizeof(uint32_t));
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            fnet::writeData(dst, refs, _values[i]._data._buf,
+                            _values[i]._data._len);
             break;
 
         case FRT_VALUE_DATA_ARRAY:
@@ -1360,7 +1398,7 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
             dst->WriteBytesFast(&len, sizeof(len));
             for (; len > 0; len--, pt++) {
                 dst->WriteBytesFast(&(pt->_len), sizeof(uint32_t));
-                dst->WriteBytesFast(pt->_buf, pt->_len);
+                fnet::writeData(dst, refs, pt->_buf, pt->_len);
             }
         }
         break;
@@ -1373,7 +1411,7 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
 
 
 void
-FRT_Values::EncodeBig(FNET_DataBuffer *dst)
+FRT_Values::EncodeBig(FNET_DataBuffer *dst, FNET_OutputRefs *refs)
 {
     uint32_t numValues = _numValues;
     const char *p = _typeString;
@@ -1495,8 +1533,8 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
 
         case FRT_VALUE_DATA:
             dst->WriteInt32Fast(_values[i]._data._len);
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            fnet::writeData(dst, refs, _values[i]._data._buf,
+                            _values[i]._data._len);
             break;
 
         case FRT_VALUE_DATA_ARRAY:
@@ -1507,7 +1545,7 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
             dst->WriteInt32Fast(len);
             for (; len > 0; len--, pt++) {
                 dst->WriteInt32Fast(pt->_len);
-                dst->WriteBytesFast(pt->_buf, pt->_len);
+                fnet::writeData(dst, refs, pt->_buf, pt->_len);
             }
         }
         break;
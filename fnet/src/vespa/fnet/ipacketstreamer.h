@@ -6,6 +6,7 @@
 
 class FNET_DataBuffer;
 class FNET_Packet;
+class FNET_OutputRefs;
 
 /**
  * Class used to do custom streaming of packets on network
@@ -81,5 +82,23 @@ public:
      **/
     virtual void Encode(FNET_Packet *packet, uint32_t chid,
                         FNET_DataBuffer *dst) = 0;
+
+    /**
+     * This method is called to stream a packet to the given
+     * databuffer, allowing the packet to reference its own memory in
+     * 'refs' rather than copying it (see @ref
+     * FNET_Packet::EncodeWithRefs). The default implementation copies
+     * everything.
+     *
+     * @param packet the packet to stream
+     * @param chid channel id for packet
+     * @param dst the target buffer for streaming
+     * @param refs where to add references to packet memory
+     **/
+    virtual void EncodeWithRefs(FNET_Packet *packet, uint32_t chid,
+                                FNET_DataBuffer *dst, FNET_OutputRefs &)
+    {
+        Encode(packet, chid, dst);
+    }
 };
 
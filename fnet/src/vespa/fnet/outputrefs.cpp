@@ -0,0 +1,114 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "outputrefs.h"
+#include "databuffer.h"
+#include "packet.h"
+#include <algorithm>
+#include <cassert>
+#include <sys/uio.h>
+
+FNET_OutputRefs::FNET_OutputRefs()
+    : _refs(),
+      _consumed(0),
+      _frontDone(0),
+      _pendingRefs(0)
+{
+}
+
+
+FNET_OutputRefs::~FNET_OutputRefs()
+{
+    Discard();
+}
+
+
+void
+FNET_OutputRefs::AddRef(FNET_DataBuffer &dst, const char *data, uint32_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    _refs.push_back(Ref{_consumed + dst.GetDataLen(), data, len, nullptr});
+    _pendingRefs += len;
+}
+
+
+void
+FNET_OutputRefs::SetOwner(FNET_Packet *packet)
+{
+    assert(!_refs.empty() && _refs.back()._owner == nullptr);
+    _refs.back()._owner = packet;
+}
+
+
+int
+FNET_OutputRefs::FillIOVec(FNET_DataBuffer &src, struct iovec *iov, int maxcnt) const
+{
+    int      cnt = 0;
+    uint64_t pos = _consumed;
+    uint64_t end = _consumed + src.GetDataLen();
+    for (size_t i = 0; (i < _refs.size()) && (cnt < maxcnt); ++i) {
+        const Ref &ref = _refs[i];
+        if (ref._pos > pos) {
+            iov[cnt].iov_base = src.GetData() + (pos - _consumed);
+            iov[cnt].iov_len = ref._pos - pos;
+            pos = ref._pos;
+            if (++cnt == maxcnt) {
+                return cnt;
+            }
+        }
+        uint32_t skip = (i == 0) ? _frontDone : 0;
+        iov[cnt].iov_base = const_cast<char *>(ref._data + skip);
+        iov[cnt].iov_len = ref._len - skip;
+        ++cnt;
+    }
+    if ((cnt < maxcnt) && (end > pos)) {
+        iov[cnt].iov_base = src.GetData() + (pos - _consumed);
+        iov[cnt].iov_len = end - pos;
+        ++cnt;
+    }
+    return cnt;
+}
+
+
+void
+FNET_OutputRefs::Consume(FNET_DataBuffer &src, uint64_t len)
+{
+    while (len > 0) {
+        if (!_refs.empty() && _refs.front()._pos == _consumed) {
+            Ref &ref = _refs.front();
+            uint32_t done = std::min(len, uint64_t(ref._len - _frontDone));
+            _frontDone += done;
+            _pendingRefs -= done;
+            len -= done;
+            if (_frontDone == ref._len) {
+                if (ref._owner != nullptr) {
+                    ref._owner->Free();
+                }
+                _refs.pop_front();
+                _frontDone = 0;
+            }
+        } else {
+            uint64_t avail = _refs.empty() ? src.GetDataLen() : (_refs.front()._pos - _consumed);
+            uint32_t done = std::min(len, avail);
+            assert(done > 0);
+            src.DataToDead(done);
+            _consumed += done;
+            len -= done;
+        }
+    }
+}
+
+
+void
+FNET_OutputRefs::Discard()
+{
+    for (const Ref &ref : _refs) {
+        if (ref._owner != nullptr) {
+            ref._owner->Free();
+        }
+    }
+    _refs.clear();
+    _frontDone = 0;
+    _pendingRefs = 0;
+}
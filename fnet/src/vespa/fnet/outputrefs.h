@@ -0,0 +1,113 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/size_literals.h>
+#include <cstdint>
+#include <deque>
+
+class FNET_DataBuffer;
+class FNET_Packet;
+struct iovec;
+
+/**
+ * Large blocks of memory owned by packets in the output stream of a
+ * connection. Instead of copying such a block into the output
+ * databuffer when the packet is encoded, a reference to it is placed
+ * here, positioned after the bytes already in the databuffer. The
+ * connection then writes the databuffer contents and the referenced
+ * memory in stream order using a single gather write. Packets owning
+ * referenced memory are freed when the last of their references has
+ * been written (or when the references are discarded).
+ *
+ * Stream positions count the bytes ever appended to the output
+ * databuffer, which is why the databuffer must be passed along when
+ * adding references and when consuming written bytes.
+ **/
+class FNET_OutputRefs
+{
+public:
+    enum {
+        MIN_REF_SIZE = 16_Ki, // smaller blocks are cheaper to copy
+        MAX_IOV      = 64     // max buffers presented to a single write
+    };
+
+private:
+    struct Ref {
+        uint64_t     _pos;   // position of the block in the copied stream
+        const char  *_data;
+        uint32_t     _len;
+        FNET_Packet *_owner; // freed when this block has been written
+    };
+
+    std::deque<Ref> _refs;
+    uint64_t        _consumed;    // bytes consumed from the databuffer
+    uint32_t        _frontDone;   // bytes written from the first block
+    uint64_t        _pendingRefs; // total bytes in blocks not yet written
+
+    FNET_OutputRefs(const FNET_OutputRefs &);
+    FNET_OutputRefs &operator=(const FNET_OutputRefs &);
+
+public:
+    FNET_OutputRefs();
+    ~FNET_OutputRefs();
+
+    /**
+     * @return true if no blocks are waiting to be written
+     **/
+    bool IsEmpty() const { return _refs.empty(); }
+
+    /**
+     * @return number of blocks waiting to be written
+     **/
+    size_t GetRefCnt() const { return _refs.size(); }
+
+    /**
+     * @return number of bytes in blocks waiting to be written
+     **/
+    uint64_t GetRefLen() const { return _pendingRefs; }
+
+    /**
+     * Add a reference to a block of memory to be written after the
+     * data currently in the given databuffer.
+     *
+     * @param dst the output databuffer
+     * @param data start of block
+     * @param len length of block
+     **/
+    void AddRef(FNET_DataBuffer &dst, const char *data, uint32_t len);
+
+    /**
+     * Make the given packet the owner of the last block added. The
+     * packet is freed when the block has been written.
+     *
+     * @param packet packet owning all blocks added since the last
+     *               call to this method
+     **/
+    void SetOwner(FNET_Packet *packet);
+
+    /**
+     * Describe the output stream, databuffer contents and blocks
+     * interleaved, as a list of buffers suitable for a gather write.
+     *
+     * @return number of buffers filled in
+     * @param src the output databuffer
+     * @param iov where to put the buffers
+     * @param maxcnt capacity of 'iov'
+     **/
+    int FillIOVec(FNET_DataBuffer &src, struct iovec *iov, int maxcnt) const;
+
+    /**
+     * Consume bytes that have been written from the front of the
+     * output stream, freeing packets whose blocks are done.
+     *
+     * @param src the output databuffer
+     * @param len number of bytes written
+     **/
+    void Consume(FNET_DataBuffer &src, uint64_t len);
+
+    /**
+     * Drop all blocks without writing them, freeing their owners.
+     **/
+    void Discard();
+};
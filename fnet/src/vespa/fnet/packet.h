@@ -6,6 +6,7 @@
 #include <memory>
 
 class FNET_DataBuffer;
+class FNET_OutputRefs;
 
 /**
  * This is a general superclass of all packets. Packets are used to
@@ -137,6 +138,26 @@ public:
     virtual void Encode(FNET_DataBuffer *dst) = 0;
 
 
+    /**
+     * @return number of encoded bytes that @ref EncodeWithRefs will
+     *         leave out of the databuffer (0)
+     **/
+    virtual uint32_t GetRefLength() { return 0; }
+
+
+    /**
+     * Encode this packet like @ref Encode, but leave large blocks of
+     * memory owned by this packet out of the databuffer, adding
+     * references to them instead. If any references are added, the
+     * packet is not freed until they have been written. The default
+     * implementation copies everything.
+     *
+     * @param dst the target databuffer
+     * @param refs where to add references to packet memory
+     **/
+    virtual void EncodeWithRefs(FNET_DataBuffer *dst, FNET_OutputRefs &) { Encode(dst); }
+
+
     /**
      * Decode data from the given DataBuffer and store that information
      * in this object. This method may only be called on regular
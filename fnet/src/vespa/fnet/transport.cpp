@@ -165,6 +165,18 @@ FNET_Transport::create_server_crypto_socket(vespalib::SocketHandle socket)
     return _crypto_engine->create_server_crypto_socket(std::move(socket));
 }
 
+void
+FNET_Transport::server_listening(int port)
+{
+    _crypto_engine->server_listening(port);
+}
+
+void
+FNET_Transport::server_closed(int port)
+{
+    _crypto_engine->server_closed(port);
+}
+
 FNET_TransportThread *
 FNET_Transport::select_thread(const void *key, size_t key_len) const
 {
@@ -87,6 +87,28 @@ public:
         _config._drop_empty_buffers = v;
         return *this;
     }
+    /**
+     * Wait for io events using io_uring rather than epoll. Changes to
+     * the set of events selected for are then batched with the wait
+     * itself, saving a system call each time a connection starts or
+     * stops waiting for its socket to become writable. Falls back to
+     * epoll if io_uring is not available.
+     **/
+    TransportConfig &use_io_uring(bool v) {
+        _config._use_io_uring = v;
+        return *this;
+    }
+    /**
+     * Measure the time connections spend in their crypto sockets
+     * (system calls plus TLS encryption and decryption). This costs
+     * two clock samples per socket operation, and is used to estimate
+     * the socket time of each request traced by FRT (see
+     * fnet::frt::MethodTracer).
+     **/
+    TransportConfig &measure_socket_time(bool v) {
+        _config._measure_socket_time = v;
+        return *this;
+    }
 
 private:
     FNET_Config                 _config;
@@ -181,6 +203,15 @@ public:
      **/
     vespalib::CryptoSocket::UP create_server_crypto_socket(vespalib::SocketHandle socket);
 
+    /**
+     * Tell the CryptoEngine used by this Transport that we started
+     * (or stopped) listening on the given port.
+     *
+     * @param port the port we are listening on
+     **/
+    void server_listening(int port);
+    void server_closed(int port);
+
     /**
      * Select one of the underlying transport threads. The selection
      * is based on hashing the given key as well as the current stack
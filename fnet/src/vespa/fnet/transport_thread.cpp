@@ -214,7 +214,7 @@ FNET_TransportThread::FNET_TransportThread(FNET_Transport &owner_in)
       _componentsTail(nullptr),
       _componentCnt(0),
       _deleteList(nullptr),
-      _selector(),
+      _selector(owner_in.getConfig()._use_io_uring),
       _queue(),
       _myQueue(),
       _lock(),
@@ -271,6 +271,7 @@ FNET_TransportThread::Listen(const char *spec, FNET_IPacketStreamer *streamer,
         FNET_Connector *connector = new FNET_Connector(this, streamer, serverAdapter, spec, std::move(server_socket));
         connector->EnableReadEvent(true);
         connector->AddRef_NoLock();
+        _owner.server_listening(connector->GetPortNumber());
         Add(connector, /* needRef = */ false);
         return connector;
     }
@@ -387,6 +388,13 @@ FNET_TransportThread::WaitFinished()
 }
 
 
+vespalib::steady_time
+FNET_TransportThread::current_time() const
+{
+    return time_tools().current_time();
+}
+
+
 bool
 FNET_TransportThread::InitEventLoop()
 {
@@ -378,6 +378,21 @@ public:
      **/
     FNET_Scheduler *GetScheduler() { return &_scheduler; }
 
+    /**
+     * Obtain the time sampled when the event loop last woke up to
+     * handle io events. Only meaningful within the transport thread.
+     *
+     * @return time of last event loop wakeup
+     **/
+    vespalib::steady_time event_loop_time() const { return _now; }
+
+    /**
+     * Sample the current time the same way as the event loop does.
+     *
+     * @return current time
+     **/
+    vespalib::steady_time current_time() const;
+
 
     /**
      * Calling this method will shut down the transport layer in a nice
@@ -0,0 +1,160 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/messagebus/network/compressiontuner.h>
+
+using namespace mbus;
+using vespalib::compression::CompressionConfig;
+
+namespace {
+
+const CompressionConfig base(CompressionConfig::LZ4, 6, 90, 1024);
+constexpr double wireCost = 2.0;
+constexpr size_t blobSize = 100000;
+
+/**
+ * Synthetic payload where each candidate achieves a fixed ratio at a fixed CPU cost per byte.
+ */
+struct Payload {
+    double ratio(const CompressionConfig &c) const {
+        switch (c.type) {
+        case CompressionConfig::LZ4: return 0.5;
+        case CompressionConfig::ZSTD: return (c.compressionLevel >= 9) ? 0.3 : (c.compressionLevel >= 3) ? 0.35 : 0.4;
+        default: return 1.0;
+        }
+    }
+    double nanosPerByte(const CompressionConfig &c) const {
+        switch (c.type) {
+        case CompressionConfig::LZ4: return 1.0;
+        case CompressionConfig::ZSTD: return (c.compressionLevel >= 9) ? 20.0 : (c.compressionLevel >= 3) ? 5.0 : 3.0;
+        default: return 0.0;
+        }
+    }
+};
+
+CompressionConfig
+sendOne(CompressionTuner &tuner, const Payload &payload)
+{
+    CompressionConfig c = tuner.select(base, wireCost);
+    tuner.report(c, blobSize, size_t(blobSize * payload.ratio(c)),
+                 std::chrono::nanoseconds(uint64_t(blobSize * payload.nanosPerByte(c))));
+    return c;
+}
+
+CompressionConfig
+sendMany(CompressionTuner &tuner, const Payload &payload, uint32_t count)
+{
+    CompressionConfig last;
+    for (uint32_t i = 0; i < count; ++i) {
+        last = sendOne(tuner, payload);
+    }
+    return last;
+}
+
+void
+setRtt(CompressionTuner &tuner, double ms)
+{
+    for (uint32_t i = 0; i < 2 * CompressionTuner::RTT_WINDOW; ++i) {
+        tuner.reportRoundTrip(std::chrono::duration_cast<duration>(std::chrono::duration<double, std::milli>(ms)));
+    }
+}
+
+}
+
+TEST("require that base config is used until round trip time is known") {
+    CompressionTuner tuner;
+    for (uint32_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(base == sendOne(tuner, Payload()));
+    }
+    auto stats = tuner.getStats(wireCost);
+    EXPECT_EQUAL(0.0, stats.minRttMs);
+    EXPECT_EQUAL(10u, stats.candidates[1].numBlobs);
+    EXPECT_EQUAL(10u * blobSize, stats.candidates[1].inputBytes);
+    EXPECT_EQUAL(10u * blobSize / 2, stats.candidates[1].outputBytes);
+}
+
+TEST("require that all candidates are probed before settling") {
+    CompressionTuner tuner;
+    setRtt(tuner, 10.0);
+    sendMany(tuner, Payload(), 10);
+    auto stats = tuner.getStats(wireCost);
+    for (size_t i = 1; i < CompressionTuner::NUM_CANDIDATES; ++i) {
+        EXPECT_LESS_EQUAL(1u, stats.candidates[i].numBlobs);
+    }
+}
+
+TEST("require that local links are not compressed") {
+    CompressionTuner tuner;
+    setRtt(tuner, 0.1);
+    CompressionConfig c = sendMany(tuner, Payload(), 10);
+    EXPECT_EQUAL(CompressionConfig::NONE, c.type);
+    auto stats = tuner.getStats(wireCost);
+    EXPECT_EQUAL(0u, stats.selected);
+    EXPECT_APPROX(0.2, stats.wireNanosPerByte, 1e-9);
+}
+
+TEST("require that distant links get stronger compression") {
+    CompressionTuner tuner;
+    setRtt(tuner, 2.0);
+    EXPECT_EQUAL(CompressionConfig::LZ4, sendMany(tuner, Payload(), 10).type);
+    setRtt(tuner, 50.0);
+    setRtt(tuner, 50.0);
+    CompressionConfig c = sendMany(tuner, Payload(), 10);
+    EXPECT_EQUAL(CompressionConfig::ZSTD, c.type);
+    EXPECT_EQUAL(3u, c.compressionLevel);
+    EXPECT_EQUAL(base.minSize, c.minSize);
+    setRtt(tuner, 1000.0);
+    setRtt(tuner, 1000.0);
+    c = sendMany(tuner, Payload(), 10);
+    EXPECT_EQUAL(CompressionConfig::ZSTD, c.type);
+    EXPECT_EQUAL(9u, c.compressionLevel);
+}
+
+TEST("require that threshold follows break even of selected candidate") {
+    CompressionTuner tuner;
+    setRtt(tuner, 2.0);
+    CompressionConfig c = sendMany(tuner, Payload(), 10);
+    EXPECT_EQUAL(CompressionConfig::LZ4, c.type);
+    EXPECT_EQUAL(75u, c.threshold); // 1 ns of CPU per byte against 4 ns on the wire
+    setRtt(tuner, 50.0);
+    setRtt(tuner, 50.0);
+    c = sendMany(tuner, Payload(), 10);
+    EXPECT_EQUAL(base.threshold, c.threshold); // capped by the configured threshold
+}
+
+TEST("require that other candidates are probed periodically") {
+    CompressionTuner tuner;
+    setRtt(tuner, 0.1);
+    sendMany(tuner, Payload(), 10);
+    auto before = tuner.getStats(wireCost);
+    sendMany(tuner, Payload(), 4 * CompressionTuner::PROBE_INTERVAL);
+    auto after = tuner.getStats(wireCost);
+    uint64_t probes = 0;
+    for (size_t i = 1; i < CompressionTuner::NUM_CANDIDATES; ++i) {
+        probes += after.candidates[i].numBlobs - before.candidates[i].numBlobs;
+    }
+    EXPECT_EQUAL(4u, probes);
+}
+
+TEST("require that round trip time follows the recent minimum") {
+    CompressionTuner tuner;
+    tuner.reportRoundTrip(std::chrono::milliseconds(5));
+    EXPECT_EQUAL(5.0, tuner.getStats(wireCost).minRttMs);
+    tuner.reportRoundTrip(std::chrono::milliseconds(3));
+    tuner.reportRoundTrip(std::chrono::milliseconds(7));
+    EXPECT_EQUAL(3.0, tuner.getStats(wireCost).minRttMs);
+    setRtt(tuner, 20.0);
+    EXPECT_EQUAL(20.0, tuner.getStats(wireCost).minRttMs);
+}
+
+TEST("require that small blobs and unknown settings are not counted") {
+    CompressionTuner tuner;
+    tuner.report(base, 100, 100, std::chrono::nanoseconds(100));
+    tuner.report(CompressionConfig(CompressionConfig::ZSTD, 22, 90, 0), blobSize, blobSize / 4, std::chrono::nanoseconds(1));
+    auto stats = tuner.getStats(wireCost);
+    for (const auto &c : stats.candidates) {
+        EXPECT_EQUAL(0u, c.numBlobs);
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -3,6 +3,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/messagebus/destinationsession.h>
 #include <vespa/messagebus/dynamicthrottlepolicy.h>
+#include <vespa/messagebus/errorcode.h>
+#include <vespa/messagebus/latencythrottlepolicy.h>
 #include <vespa/messagebus/routablequeue.h>
 #include <vespa/messagebus/routing/retrytransienterrorspolicy.h>
 #include <vespa/messagebus/routing/routingspec.h>
@@ -13,6 +15,7 @@
 #include <vespa/messagebus/testlib/simplemessage.h>
 #include <vespa/messagebus/testlib/simplereply.h>
 #include <vespa/messagebus/testlib/testserver.h>
+#include <functional>
 #include <thread>
 
 using namespace mbus;
@@ -44,6 +47,18 @@ RoutingSpec getRouting()
                   .addRoute(RouteSpec("dst").addHop("dst")));
 }
 
+/**
+ * Latency of a receiver that has the given base latency and handles the given number of messages per
+ * millisecond. Once more messages are pending than it can serve within its base latency, they queue up.
+ */
+std::function<uint64_t(uint32_t)> receiverLatency(uint64_t baseLatency, uint32_t messagesPerMilli)
+{
+    return [baseLatency, messagesPerMilli](uint32_t numPending) {
+        uint32_t capacity = baseLatency * messagesPerMilli;
+        return baseLatency + ((numPending > capacity) ? (numPending - capacity) / messagesPerMilli : 0);
+    };
+}
+
 bool waitQueueSize(RoutableQueue &queue, uint32_t size)
 {
     for (uint32_t i = 0; i < 10000; ++i) {
@@ -74,7 +89,10 @@ bool waitPending(SourceSession& session, uint32_t size)
 
 class Test : public vespalib::TestApp {
 private:
+    using LatencyCurve = std::function<uint64_t(uint32_t numPending)>;
     uint32_t getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending);
+    std::vector<uint32_t> simulateWindowSize(LatencyThrottlePolicy &policy, DynamicTimer &timer,
+                                             const LatencyCurve &latency, uint32_t numRounds);
 
 protected:
     void testMaxPendingCount();
@@ -84,6 +102,9 @@ protected:
     void testIdleTimePeriod();
     void testMinWindowSize();
     void testMaxWindowSize();
+    void testLatencyWindowSize();
+    void testLatencyWindowSizeFollowsBaseLatency();
+    void testLatencyWindowSizeBacksOffOnErrors();
 
 public:
     int Main() override;
@@ -101,6 +122,9 @@ Test::Main()
     testIdleTimePeriod();    TEST_FLUSH();
     testMinWindowSize();     TEST_FLUSH();
     testMaxWindowSize();     TEST_FLUSH();
+    testLatencyWindowSize(); TEST_FLUSH();
+    testLatencyWindowSizeFollowsBaseLatency(); TEST_FLUSH();
+    testLatencyWindowSizeBacksOffOnErrors();   TEST_FLUSH();
 
     TEST_DONE();
 }
@@ -357,3 +381,91 @@ Test::getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t
     printf("getWindowSize() = %d\n", ret);
     return ret;
 }
+
+void
+Test::testLatencyWindowSize()
+{
+    ITimer::UP ptr(new DynamicTimer());
+    DynamicTimer *timer = static_cast<DynamicTimer*>(ptr.get());
+    LatencyThrottlePolicy policy(std::move(ptr));
+    policy.setTargetQueueDelay(20);
+
+    // Receiver saturates at 200 pending messages; 20ms of queueing corresponds to 40 more.
+    auto windowSizes = simulateWindowSize(policy, *timer, receiverLatency(100, 2), 1000);
+    EXPECT_APPROX(100.0, policy.getBaseRtt(), 0.01);
+    for (uint32_t i = 500; i < windowSizes.size(); ++i) {
+        if (windowSizes[i] != policy.getMinWindowSize()) { // not probing base latency
+            ASSERT_TRUE(windowSizes[i] >= 220 && windowSizes[i] <= 260);
+        }
+    }
+
+    ptr.reset(new DynamicTimer());
+    timer = static_cast<DynamicTimer*>(ptr.get());
+    LatencyThrottlePolicy slowPolicy(std::move(ptr));
+    windowSizes = simulateWindowSize(slowPolicy, *timer, receiverLatency(50, 1), 1000);
+    for (uint32_t i = 500; i < windowSizes.size(); ++i) {
+        if (windowSizes[i] != slowPolicy.getMinWindowSize()) {
+            ASSERT_TRUE(windowSizes[i] >= 60 && windowSizes[i] <= 90);
+        }
+    }
+}
+
+void
+Test::testLatencyWindowSizeFollowsBaseLatency()
+{
+    ITimer::UP ptr(new DynamicTimer());
+    DynamicTimer *timer = static_cast<DynamicTimer*>(ptr.get());
+    LatencyThrottlePolicy policy(std::move(ptr));
+
+    simulateWindowSize(policy, *timer, receiverLatency(100, 2), 300);
+    uint32_t windowSize = policy.getMaxPendingCount();
+    ASSERT_TRUE(windowSize >= 220 && windowSize <= 260);
+
+    // Latency doubles without any loss of throughput, e.g. due to a longer network path. The window must grow
+    // to keep the receivers busy once the new base latency has been learned.
+    simulateWindowSize(policy, *timer, receiverLatency(200, 2), 300);
+    EXPECT_APPROX(200.0, policy.getBaseRtt(), 0.01);
+    windowSize = policy.getMaxPendingCount();
+    ASSERT_TRUE(windowSize >= 420 && windowSize <= 460);
+}
+
+void
+Test::testLatencyWindowSizeBacksOffOnErrors()
+{
+    ITimer::UP ptr(new DynamicTimer());
+    DynamicTimer *timer = static_cast<DynamicTimer*>(ptr.get());
+    LatencyThrottlePolicy policy(std::move(ptr));
+    policy.setWindowSizeBackOff(0.5);
+
+    simulateWindowSize(policy, *timer, receiverLatency(100, 2), 50);
+    uint32_t windowSize = policy.getMaxPendingCount();
+    ASSERT_TRUE(windowSize >= 200);
+
+    SimpleReply reply("bar");
+    reply.addError(Error(ErrorCode::SESSION_BUSY, "busy"));
+    policy.processReply(reply);
+    EXPECT_EQUAL(windowSize / 2, policy.getMaxPendingCount());
+}
+
+std::vector<uint32_t>
+Test::simulateWindowSize(LatencyThrottlePolicy &policy, DynamicTimer &timer,
+                         const LatencyCurve &latency, uint32_t numRounds)
+{
+    SimpleMessage msg("foo");
+    SimpleReply reply("bar");
+    std::vector<uint32_t> windowSizes;
+    for (uint32_t i = 0; i < numRounds; ++i) {
+        uint32_t numPending = 0;
+        while (policy.canSend(msg, numPending)) {
+            policy.processMessage(msg);
+            ++numPending;
+        }
+        timer._millis += latency(numPending);
+        for ( ; numPending > 0; --numPending) {
+            policy.processReply(reply);
+        }
+        windowSizes.push_back(policy.getMaxPendingCount());
+    }
+    printf("simulateWindowSize() = %d\n", windowSizes.back());
+    return windowSizes;
+}
@@ -0,0 +1,194 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "latencythrottlepolicy.h"
+#include "steadytimer.h"
+#include <algorithm>
+#include <climits>
+#include <limits>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".latencythrottlepolicy");
+
+namespace mbus {
+
+LatencyThrottlePolicy::LatencyThrottlePolicy()
+    : LatencyThrottlePolicy(std::make_unique<SteadyTimer>())
+{ }
+
+LatencyThrottlePolicy::LatencyThrottlePolicy(ITimer::UP timer) :
+    _timer(std::move(timer)),
+    _numPending(0),
+    _numReplies(0),
+    _sampleStart(_timer->getMilliTime()),
+    _lastEventTime(_sampleStart),
+    _pendingTime(0),
+    _numSamples(0),
+    _minRttWindow(100),
+    _minRtt(std::numeric_limits<double>::max()),
+    _prevMinRtt(std::numeric_limits<double>::max()),
+    _probingRtt(false),
+    _windowSizeBeforeProbe(0),
+    _rtt(0),
+    _throughput(0),
+    _targetQueueDelay(20),
+    _windowSizeIncrement(20),
+    _windowSize(_windowSizeIncrement),
+    _maxWindowSize(INT_MAX),
+    _minWindowSize(_windowSizeIncrement),
+    _windowSizeBackOff(0.7)
+{ }
+
+LatencyThrottlePolicy::~LatencyThrottlePolicy() = default;
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setTargetQueueDelay(double targetQueueDelay)
+{
+    _targetQueueDelay = targetQueueDelay;
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setWindowSizeIncrement(double windowSizeIncrement)
+{
+    _windowSizeIncrement = windowSizeIncrement;
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setWindowSizeBackOff(double windowSizeBackOff)
+{
+    _windowSizeBackOff = std::max(0.0, std::min(1.0, windowSizeBackOff));
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMinRttWindow(uint32_t samples)
+{
+    _minRttWindow = std::max(1u, samples);
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMaxWindowSize(double max)
+{
+    _maxWindowSize = max;
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMinWindowSize(double min)
+{
+    _minWindowSize = min;
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMaxPendingCount(uint32_t maxCount)
+{
+    StaticThrottlePolicy::setMaxPendingCount(maxCount);
+    _maxWindowSize = maxCount;
+    return *this;
+}
+
+double
+LatencyThrottlePolicy::getBaseRtt() const
+{
+    return std::min(_minRtt, _prevMinRtt);
+}
+
+bool
+LatencyThrottlePolicy::canSend(const Message &msg, uint32_t pendingCount)
+{
+    if (!StaticThrottlePolicy::canSend(msg, pendingCount)) {
+        return false;
+    }
+    return pendingCount < _windowSize;
+}
+
+void
+LatencyThrottlePolicy::processMessage(Message &msg)
+{
+    StaticThrottlePolicy::processMessage(msg);
+    updatePendingTime(_timer->getMilliTime());
+    ++_numPending;
+}
+
+void
+LatencyThrottlePolicy::processReply(Reply &reply)
+{
+    StaticThrottlePolicy::processReply(reply);
+    uint64_t time = _timer->getMilliTime();
+    updatePendingTime(time);
+    if (_numPending > 0) {
+        --_numPending;
+    }
+    if (reply.hasErrors()) {
+        _windowSize = std::max(_minWindowSize, _windowSize * _windowSizeBackOff);
+        return;
+    }
+    if (_probingRtt && (_numPending > _windowSize)) {
+        // Let messages sent with the larger window drain before measuring.
+        _sampleStart = time;
+        _pendingTime = 0;
+        _numReplies = 0;
+        return;
+    }
+    if (++_numReplies >= _windowSize) {
+        sample(time);
+    }
+}
+
+void
+LatencyThrottlePolicy::updatePendingTime(uint64_t time)
+{
+    if (time > _lastEventTime) {
+        _pendingTime += double(_numPending) * (time - _lastEventTime);
+        _lastEventTime = time;
+    }
+}
+
+void
+LatencyThrottlePolicy::sample(uint64_t time)
+{
+    if (time <= _sampleStart) {
+        return; // Need at least one tick of the timer to measure anything.
+    }
+    double elapsed = time - _sampleStart;
+    double avgPending = _pendingTime / elapsed;
+    _throughput = _numReplies / elapsed;
+    _rtt = avgPending / _throughput;
+    _sampleStart = time;
+    _pendingTime = 0;
+    _numReplies = 0;
+
+    _minRtt = std::min(_minRtt, _rtt);
+    if (_probingRtt) {
+        _probingRtt = false;
+        _windowSize = _windowSizeBeforeProbe;
+        return;
+    }
+    if (++_numSamples >= _minRttWindow) {
+        // A window that keeps the receivers saturated never observes their base latency. Like the
+        // ProbeRTT phase of BBR, shrink the window for one sample at the start of each period.
+        _prevMinRtt = _minRtt;
+        _minRtt = std::numeric_limits<double>::max();
+        _numSamples = 0;
+        _probingRtt = true;
+        _windowSizeBeforeProbe = _windowSize;
+        _windowSize = _minWindowSize;
+        return;
+    }
+    double baseRtt = getBaseRtt();
+    double queueDelay = _rtt - baseRtt;
+    if (queueDelay > _targetQueueDelay) {
+        double targetWindow = _throughput * (baseRtt + _targetQueueDelay);
+        _windowSize = std::max(_windowSize * _windowSizeBackOff, std::min(_windowSize, targetWindow));
+    } else if (avgPending + _windowSizeIncrement >= _windowSize) {
+        // Only grow when the window is what limits the number of pending messages.
+        _windowSize += _windowSizeIncrement;
+    }
+    _windowSize = std::max(_minWindowSize, _windowSize);
+    _windowSize = std::min(_maxWindowSize, _windowSize);
+    LOG(debug, "WindowSize = %.2f, Rtt = %.2f, BaseRtt = %.2f, Throughput = %f", _windowSize, _rtt, baseRtt, _throughput);
+}
+
+} // namespace mbus
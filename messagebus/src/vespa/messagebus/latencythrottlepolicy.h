@@ -0,0 +1,168 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "itimer.h"
+#include "staticthrottlepolicy.h"
+
+namespace mbus {
+
+/**
+ * This is an implementation of the {@link ThrottlePolicy} that sizes the window of pending messages from the
+ * observed round trip time, in the spirit of TCP Vegas. Round trip time is measured once per window of replies
+ * using Little's law (average number of pending messages divided by reply throughput). The lowest round trip
+ * time seen recently is taken as the base latency of the receivers, and anything above it as time spent queued.
+ *
+ * While the queueing delay is below the target, the window grows additively. When it exceeds the target, the
+ * window is shrunk towards the size that would hold exactly the target queueing delay at the measured
+ * throughput, but never by more than the back off factor at a time. Replies with errors back off the window
+ * immediately. Once per base latency period the window is dropped to its minimum for one sample, so that the
+ * base latency is measured without the policy's own queueing.
+ *
+ * Select this policy for a {@link SourceSession} through {@link SourceSessionParams#setThrottlePolicy}.
+ *
+ * <b>NOTE:</b> By context, "pending" is refering to the number of sent messages that have not been replied to
+ * yet.
+ */
+class LatencyThrottlePolicy : public StaticThrottlePolicy {
+private:
+    ITimer::UP _timer;
+    uint32_t   _numPending;
+    uint32_t   _numReplies;
+    uint64_t   _sampleStart;
+    uint64_t   _lastEventTime;
+    double     _pendingTime;
+    uint32_t   _numSamples;
+    uint32_t   _minRttWindow;
+    double     _minRtt;
+    double     _prevMinRtt;
+    bool       _probingRtt;
+    double     _windowSizeBeforeProbe;
+    double     _rtt;
+    double     _throughput;
+    double     _targetQueueDelay;
+    double     _windowSizeIncrement;
+    double     _windowSize;
+    double     _maxWindowSize;
+    double     _minWindowSize;
+    double     _windowSizeBackOff;
+
+    void updatePendingTime(uint64_t time);
+    void sample(uint64_t time);
+
+public:
+    /**
+     * Convenience typedefs.
+     */
+    typedef std::unique_ptr<LatencyThrottlePolicy> UP;
+    typedef std::shared_ptr<LatencyThrottlePolicy> SP;
+
+    /**
+     * Constructs a new instance of this policy and sets the appropriate default values of member data.
+     */
+    LatencyThrottlePolicy();
+
+    /**
+     * Constructs a new instance of this class using the given clock to measure round trip time.
+     *
+     * @param timer The timer to use.
+     */
+    LatencyThrottlePolicy(ITimer::UP timer);
+    ~LatencyThrottlePolicy() override;
+
+    /**
+     * Sets the queueing delay, in milliseconds, that the window is sized to hold. Lower values keep latency
+     * closer to the base latency of the receivers, at the risk of not keeping them fully busy.
+     *
+     * @param targetQueueDelay The target to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setTargetQueueDelay(double targetQueueDelay);
+
+    /**
+     * Sets the step size used when increasing window size.
+     *
+     * @param windowSizeIncrement The step size to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setWindowSizeIncrement(double windowSizeIncrement);
+
+    /**
+     * Sets the smallest factor of window size that the window may shrink to in one step. This value is
+     * capped to the [0, 1] range.
+     *
+     * @param windowSizeBackOff The back off to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setWindowSizeBackOff(double windowSizeBackOff);
+
+    /**
+     * Sets the number of round trip time samples that the base latency is tracked over. The base latency is
+     * the lowest round trip time seen within the last one to two such periods, which lets the policy adapt
+     * when the latency of the receivers changes permanently.
+     *
+     * @param samples The number of samples.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMinRttWindow(uint32_t samples);
+
+    /**
+     * Sets the maximium number of pending operations allowed at any time, in
+     * order to avoid using too much resources.
+     *
+     * @param max The max to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMaxWindowSize(double max);
+
+    /**
+     * Sets the minimium number of pending operations allowed at any time, in
+     * order to keep a level of performance.
+     *
+     * @param min The min to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMinWindowSize(double min);
+
+    /**
+     * Get the minimum number of pending operations allowed at any time.
+     *
+     * @return The minimum number of operations.
+     */
+    double getMinWindowSize() const { return _minWindowSize; }
+
+    /**
+     * Sets the maximum number of pending messages allowed.
+     *
+     * @param maxCount The max count.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMaxPendingCount(uint32_t maxCount);
+
+    /**
+     * Returns the maximum number of pending messages allowed.
+     *
+     * @return The max limit.
+     */
+    uint32_t getMaxPendingCount() const { return (uint32_t)_windowSize; }
+
+    /**
+     * Returns the round trip time, in milliseconds, of the last sample.
+     */
+    double getRtt() const { return _rtt; }
+
+    /**
+     * Returns the lowest recently seen round trip time, in milliseconds.
+     */
+    double getBaseRtt() const;
+
+    /**
+     * Returns the reply throughput, in replies per millisecond, of the last sample.
+     */
+    double getThroughput() const { return _throughput; }
+
+    bool canSend(const Message &msg, uint32_t pendingCount) override;
+    void processMessage(Message &msg) override;
+    void processReply(Reply &reply) override;
+};
+
+} // namespace mbus
@@ -0,0 +1,181 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compressiontuner.h"
+#include <algorithm>
+#include <limits>
+
+namespace mbus {
+
+namespace {
+
+constexpr double UNKNOWN_RTT = std::numeric_limits<double>::max();
+constexpr double AVERAGE_WEIGHT = 1.0 / 16;
+
+void
+updateAverage(double &avg, double value, bool first)
+{
+    avg = first ? value : avg + (value - avg) * AVERAGE_WEIGHT;
+}
+
+}
+
+CompressionTuner::CandidateStats::CandidateStats(CompressionConfig::Type type_, uint8_t level_) noexcept
+    : type(type_),
+      level(level_),
+      numBlobs(0),
+      inputBytes(0),
+      outputBytes(0),
+      cpuNanos(0),
+      ratio(1.0),
+      nanosPerByte(0.0)
+{ }
+
+CompressionTuner::CompressionTuner()
+    : _lock(),
+      _candidates{{CandidateStats(CompressionConfig::NONE, 0),
+                   CandidateStats(CompressionConfig::LZ4, 6),
+                   CandidateStats(CompressionConfig::ZSTD, 1),
+                   CandidateStats(CompressionConfig::ZSTD, 3),
+                   CandidateStats(CompressionConfig::ZSTD, 9)}},
+      _numSelected(0),
+      _nextProbe(0),
+      _numRtts(0),
+      _minRtt(UNKNOWN_RTT),
+      _prevMinRtt(UNKNOWN_RTT)
+{ }
+
+CompressionTuner::~CompressionTuner() = default;
+
+double
+CompressionTuner::getMinRtt() const
+{
+    return std::min(_minRtt, _prevMinRtt);
+}
+
+double
+CompressionTuner::wireNanosPerByte(double wireCost) const
+{
+    double minRtt = getMinRtt();
+    return (minRtt == UNKNOWN_RTT) ? 0.0 : wireCost * minRtt;
+}
+
+size_t
+CompressionTuner::findBest(double wireNanos) const
+{
+    size_t best = 0;
+    double bestCost = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < _candidates.size(); ++i) {
+        const CandidateStats &c = _candidates[i];
+        if ((c.numBlobs == 0) && (c.type != CompressionConfig::NONE)) {
+            continue;
+        }
+        double cost = c.nanosPerByte + c.ratio * wireNanos;
+        if (cost < bestCost) {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+uint8_t
+CompressionTuner::calcThreshold(const CandidateStats &candidate, double wireNanos, uint8_t maxThreshold) const
+{
+    if ((candidate.type == CompressionConfig::NONE) || (wireNanos <= 0.0)) {
+        return maxThreshold;
+    }
+    // A blob pays for its compression when it shrinks by more than the CPU time spent per byte is worth
+    // on the wire; blobs that do worse are sent raw, sparing the receiver from decompressing them.
+    double breakEven = 100.0 * (1.0 - candidate.nanosPerByte / wireNanos);
+    return uint8_t(std::clamp(breakEven, 1.0, double(maxThreshold)));
+}
+
+CompressionTuner::CandidateStats *
+CompressionTuner::findCandidate(const CompressionConfig &config)
+{
+    for (CandidateStats &c : _candidates) {
+        if ((c.type == config.type) && ((c.type == CompressionConfig::NONE) || (c.level == config.compressionLevel))) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+CompressionTuner::CompressionConfig
+CompressionTuner::select(const CompressionConfig &base, double wireCost)
+{
+    std::lock_guard guard(_lock);
+    double wireNanos = wireNanosPerByte(wireCost);
+    if (wireNanos <= 0.0) {
+        return base;
+    }
+    size_t best = findBest(wireNanos);
+    size_t selected = best;
+    bool probe = false;
+    for (size_t i = 0; i < _candidates.size(); ++i) {
+        if ((_candidates[i].numBlobs == 0) && (_candidates[i].type != CompressionConfig::NONE)) {
+            selected = i;
+            probe = true;
+            break;
+        }
+    }
+    if (!probe && ((++_numSelected % PROBE_INTERVAL) == 0)) {
+        _nextProbe = (_nextProbe + 1) % _candidates.size();
+        if (_nextProbe == best) {
+            _nextProbe = (_nextProbe + 1) % _candidates.size();
+        }
+        selected = _nextProbe;
+        probe = true;
+    }
+    const CandidateStats &c = _candidates[selected];
+    // Probes use the configured threshold, so that they measure what the candidate can achieve.
+    uint8_t threshold = probe ? base.threshold : calcThreshold(c, wireNanos, base.threshold);
+    return CompressionConfig(c.type, c.level, threshold, base.minSize);
+}
+
+void
+CompressionTuner::report(const CompressionConfig &config, size_t inputBytes, size_t outputBytes, duration cpuTime)
+{
+    if ((inputBytes == 0) || (inputBytes < config.minSize)) {
+        return; // not compressed at all, whatever the setting
+    }
+    std::lock_guard guard(_lock);
+    CandidateStats *c = findCandidate(config);
+    if (c == nullptr) {
+        return;
+    }
+    uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(cpuTime).count();
+    bool first = (c->numBlobs == 0);
+    ++c->numBlobs;
+    c->inputBytes += inputBytes;
+    c->outputBytes += outputBytes;
+    c->cpuNanos += nanos;
+    updateAverage(c->ratio, double(outputBytes) / inputBytes, first);
+    updateAverage(c->nanosPerByte, double(nanos) / inputBytes, first);
+}
+
+void
+CompressionTuner::reportRoundTrip(duration rtt)
+{
+    double ms = std::chrono::duration<double, std::milli>(rtt).count();
+    std::lock_guard guard(_lock);
+    _minRtt = std::min(_minRtt, ms);
+    if (++_numRtts >= RTT_WINDOW) {
+        _prevMinRtt = _minRtt;
+        _minRtt = UNKNOWN_RTT;
+        _numRtts = 0;
+    }
+}
+
+CompressionTuner::Stats
+CompressionTuner::getStats(double wireCost) const
+{
+    std::lock_guard guard(_lock);
+    double wireNanos = wireNanosPerByte(wireCost);
+    double minRtt = getMinRtt();
+    size_t best = findBest(wireNanos);
+    return Stats{_candidates, (minRtt == UNKNOWN_RTT) ? 0.0 : minRtt, wireNanos, best,
+                 calcThreshold(_candidates[best], wireNanos, 100)};
+}
+
+} // namespace mbus
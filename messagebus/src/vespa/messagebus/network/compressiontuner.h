@@ -0,0 +1,120 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/messagebus/common.h>
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <array>
+#include <mutex>
+
+namespace mbus {
+
+/**
+ * Chooses how to compress the blobs sent to a single {@link RPCTarget}, based on what compression has
+ * achieved for that target so far. Each candidate setting (no compression, LZ4, and zstd at a few levels)
+ * is scored by the CPU time it costs per input byte plus the wire time of the bytes it produces, and the
+ * cheapest one is used. The value of a byte on the wire is taken to be proportional to the lowest round
+ * trip time recently seen for the target, so that links to a distant datacenter favour strong
+ * compression while links within a rack end up not compressing at all.
+ *
+ * Compression ratio and CPU time are tracked as moving averages per candidate. Candidates that have not
+ * been tried are probed first, and after that a different candidate is probed every so often so that
+ * the averages follow changes in payload and load. Until a round trip time is known, the configured base
+ * setting is used as is.
+ *
+ * Since every blob carries its compression type, the receiving side needs no knowledge of the choice.
+ * This class is thread safe.
+ */
+class CompressionTuner {
+public:
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+
+    static constexpr size_t NUM_CANDIDATES = 5;
+    static constexpr uint32_t PROBE_INTERVAL = 64;
+    static constexpr uint32_t RTT_WINDOW = 64;
+
+    /**
+     * Accumulated numbers for one candidate setting.
+     */
+    struct CandidateStats {
+        CompressionConfig::Type type;
+        uint8_t                 level;
+        uint64_t                numBlobs;
+        uint64_t                inputBytes;
+        uint64_t                outputBytes;
+        uint64_t                cpuNanos;
+        double                  ratio;        // moving average of output size relative to input size
+        double                  nanosPerByte; // moving average of CPU time per input byte
+        CandidateStats(CompressionConfig::Type type_, uint8_t level_) noexcept;
+    };
+
+    /**
+     * A snapshot of the tuning state of a target.
+     */
+    struct Stats {
+        std::array<CandidateStats, NUM_CANDIDATES> candidates;
+        double                                      minRttMs;     // 0 until known
+        double                                      wireNanosPerByte;
+        size_t                                      selected;     // index of the preferred candidate
+        uint8_t                                     threshold;    // for the preferred candidate, before capping
+    };
+
+private:
+    mutable std::mutex                          _lock;
+    std::array<CandidateStats, NUM_CANDIDATES> _candidates;
+    uint32_t                                    _numSelected;
+    size_t                                      _nextProbe;
+    uint32_t                                    _numRtts;
+    double                                      _minRtt;
+    double                                      _prevMinRtt;
+
+    double getMinRtt() const;
+    double wireNanosPerByte(double wireCost) const;
+    size_t findBest(double wireNanosPerByte) const;
+    uint8_t calcThreshold(const CandidateStats &candidate, double wireNanosPerByte, uint8_t maxThreshold) const;
+    CandidateStats *findCandidate(const CompressionConfig &config);
+
+public:
+    CompressionTuner(const CompressionTuner &) = delete;
+    CompressionTuner & operator = (const CompressionTuner &) = delete;
+    CompressionTuner();
+    ~CompressionTuner();
+
+    /**
+     * Returns the setting to compress the next blob with.
+     *
+     * @param base     The configured setting; its threshold caps the adaptive one and its minimum size is
+     *                 kept. It is returned unchanged until a round trip time has been reported.
+     * @param wireCost Nanoseconds of CPU time worth spending to save one byte on the wire, per millisecond
+     *                 of round trip time.
+     * @return The setting to use.
+     */
+    CompressionConfig select(const CompressionConfig &base, double wireCost);
+
+    /**
+     * Reports the outcome of compressing a blob with a setting returned by {@link #select}. Settings
+     * that are not among the candidates are ignored.
+     *
+     * @param config      The setting that was used.
+     * @param inputBytes  The size of the blob before compression.
+     * @param outputBytes The size of the blob as sent.
+     * @param cpuTime     The time spent compressing.
+     */
+    void report(const CompressionConfig &config, size_t inputBytes, size_t outputBytes, duration cpuTime);
+
+    /**
+     * Reports the time from sending a request to the target until receiving its reply.
+     *
+     * @param rtt The round trip time.
+     */
+    void reportRoundTrip(duration rtt);
+
+    /**
+     * Returns a snapshot of the tuning state, valuing wire bytes by the given cost.
+     *
+     * @param wireCost As given to {@link #select}.
+     * @return The current state.
+     */
+    Stats getStats(double wireCost) const;
+};
+
+} // namespace mbus
@@ -141,6 +141,8 @@ RPCNetwork::RPCNetwork(const RPCNetworkParams &params) :
     _sendV2(std::make_unique<RPCSendV2>()),
     _sendAdapters(),
     _compressionConfig(params.getCompressionConfig()),
+    _adaptiveCompression(params.getAdaptiveCompression()),
+    _compressionWireCost(params.getCompressionWireCost()),
     _allowDispatchForEncode(params.getDispatchOnEncode()),
     _allowDispatchForDecode(params.getDispatchOnDecode())
 {
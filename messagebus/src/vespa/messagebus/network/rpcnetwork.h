@@ -71,6 +71,8 @@ private:
     std::unique_ptr<RPCSendAdapter>                    _sendV2;
     SendAdapterMap                                     _sendAdapters;
     CompressionConfig                                  _compressionConfig;
+    bool                                               _adaptiveCompression;
+    double                                             _compressionWireCost;
     bool                                               _allowDispatchForEncode;
     bool                                               _allowDispatchForDecode;
 
@@ -223,6 +225,8 @@ public:
     void postShutdownHook() override;
     const slobrok::api::IMirrorAPI &getMirror() const override;
     CompressionConfig getCompressionConfig() { return _compressionConfig; }
+    bool getAdaptiveCompression() const { return _adaptiveCompression; }
+    double getCompressionWireCost() const { return _compressionWireCost; }
     void invoke(FRT_RPCRequest *req);
     vespalib::Executor & getExecutor() const { return *_executor; }
     bool allowDispatchForEncode() const { return _allowDispatchForEncode; }
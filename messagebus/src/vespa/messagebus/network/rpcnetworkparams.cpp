@@ -24,7 +24,9 @@ RPCNetworkParams::RPCNetworkParams(config::ConfigUri configUri) :
     _skip_request_thread(false),
     _skip_reply_thread(false),
     _connectionExpireSecs(600),
-    _compressionConfig(CompressionConfig::LZ4, 6, 90, 1024)
+    _compressionConfig(CompressionConfig::LZ4, 6, 90, 1024),
+    _adaptiveCompression(false),
+    _compressionWireCost(2.0)
 { }
 
 RPCNetworkParams::~RPCNetworkParams() = default;
@@ -29,6 +29,8 @@ private:
     bool              _skip_reply_thread;
     double            _connectionExpireSecs;
     CompressionConfig _compressionConfig;
+    bool              _adaptiveCompression;
+    double            _compressionWireCost;
 
 public:
     RPCNetworkParams();
@@ -204,6 +206,35 @@ public:
     }
     CompressionConfig getCompressionConfig() const { return _compressionConfig; }
 
+    /**
+     * Sets whether compression of requests should be chosen per target from what compression achieves
+     * for it, instead of always using the compression config. The compression config is then used until
+     * the round trip time of a target is known, and its threshold and minimum size still apply.
+     *
+     * @param adaptiveCompression Whether to tune compression per target.
+     * @return This, to allow chaining.
+     */
+    RPCNetworkParams &setAdaptiveCompression(bool adaptiveCompression) {
+        _adaptiveCompression = adaptiveCompression;
+        return *this;
+    }
+
+    bool getAdaptiveCompression() const { return _adaptiveCompression; }
+
+    /**
+     * Sets how many nanoseconds of CPU time adaptive compression may spend to save one byte on the wire,
+     * per millisecond of round trip time to the target.
+     *
+     * @param wireCost The cost to set.
+     * @return This, to allow chaining.
+     */
+    RPCNetworkParams &setCompressionWireCost(double wireCost) {
+        _compressionWireCost = wireCost;
+        return *this;
+    }
+
+    double getCompressionWireCost() const { return _compressionWireCost; }
+
 
     RPCNetworkParams &setDispatchOnDecode(bool dispatchOnDecode) {
         _dispatchOnDecode = dispatchOnDecode;
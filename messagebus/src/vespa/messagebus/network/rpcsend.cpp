@@ -179,6 +179,10 @@ RPCSend::doRequestDone(FRT_RPCRequest *req) {
     } else {
         FRT_Values &ret = *req->GetReturn();
         reply = createReply(ret, serviceName, error, trace);
+        auto &address = static_cast<RPCServiceAddress&>(ctx->getRecipient().getServiceAddress());
+        if (_net->getAdaptiveCompression() && address.hasTarget()) {
+            address.getTarget().getCompressionTuner().reportRoundTrip(vespalib::steady_clock::now() - ctx->getSendTime());
+        }
     }
     if (trace.shouldTrace(TraceLevel::SEND_RECEIVE)) {
         trace.trace(TraceLevel::SEND_RECEIVE,
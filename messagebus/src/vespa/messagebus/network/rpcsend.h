@@ -58,7 +58,7 @@ protected:
     virtual std::unique_ptr<Reply> createReply(const FRT_Values & response, const string & serviceName,
                                                Error & error, vespalib::Trace & trace) const = 0;
     virtual void encodeRequest(FRT_RPCRequest &req, const vespalib::Version &version, const Route & route,
-                               const RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
+                               RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
                                const PayLoadFiller &filler, duration timeRemaining) const = 0;
     virtual const char * getReturnSpec() const = 0;
     virtual void createResponse(FRT_Values & ret, const string & version, Reply & reply, Blob payload) const = 0;
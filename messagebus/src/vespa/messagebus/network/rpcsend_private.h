@@ -17,15 +17,18 @@ public:
     SendContext(mbus::RoutingNode &recipient, duration timeRemaining)
         : _recipient(recipient),
           _trace(recipient.getTrace().getLevel()),
-          _timeout(timeRemaining)
+          _timeout(timeRemaining),
+          _sendTime(vespalib::steady_clock::now())
    { }
     mbus::RoutingNode &getRecipient() { return _recipient; }
     mbus::Trace &getTrace() { return _trace; }
     duration getTimeout() { return _timeout; }
+    time_point getSendTime() const { return _sendTime; }
 private:
-    mbus::RoutingNode &_recipient;
-    mbus::Trace        _trace;
-    duration           _timeout;
+    mbus::RoutingNode    &_recipient;
+    mbus::Trace           _trace;
+    duration              _timeout;
+    time_point            _sendTime;
 };
 
 /**
@@ -58,7 +58,7 @@ RPCSendV1::build(FRT_ReflectionBuilder & builder)
 
 void
 RPCSendV1::encodeRequest(FRT_RPCRequest &req, const vespalib::Version &version, const Route & route,
-                         const RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
+                         RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
                          const PayLoadFiller &filler, duration timeRemaining) const
 {
 
@@ -63,16 +63,16 @@ RPCSendV2::build(FRT_ReflectionBuilder & builder)
 {
     builder.DefineMethod(METHOD_NAME, METHOD_PARAMS, METHOD_RETURN, FRT_METHOD(RPCSendV2::invoke), this);
     builder.MethodDesc("Send a message bus slime request and get a reply back.");
-    builder.ParamDesc("header_encoding", "0=raw, 6=lz4");
+    builder.ParamDesc("header_encoding", "0=raw, 6=lz4, 7=zstd");
     builder.ParamDesc("header_decoded_size", "Uncompressed header blob size");
     builder.ParamDesc("header_payload", "The message header blob in slime");
-    builder.ParamDesc("body_encoding", "0=raw, 6=lz4");
+    builder.ParamDesc("body_encoding", "0=raw, 6=lz4, 7=zstd");
     builder.ParamDesc("body_decoded_size", "Uncompressed body blob size");
     builder.ParamDesc("body_payload", "The message body blob in slime");
-    builder.ReturnDesc("header_encoding",  "0=raw, 6=lz4");
+    builder.ReturnDesc("header_encoding",  "0=raw, 6=lz4, 7=zstd");
     builder.ReturnDesc("header_decoded_size", "Uncompressed header blob size");
     builder.ReturnDesc("header_payload", "The reply header blob in slime.");
-    builder.ReturnDesc("body_encoding",  "0=raw, 6=lz4");
+    builder.ReturnDesc("body_encoding",  "0=raw, 6=lz4, 7=zstd");
     builder.ReturnDesc("body_decoded_size", "Uncompressed body blob size");
     builder.ReturnDesc("body_payload", "The reply body blob in slime.");
 }
@@ -102,7 +102,7 @@ private:
 
 void
 RPCSendV2::encodeRequest(FRT_RPCRequest &req, const Version &version, const Route & route,
-                         const RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
+                         RPCServiceAddress & address, const Message & msg, uint32_t traceLevel,
                          const PayLoadFiller &filler, duration timeRemaining) const
 {
     FRT_Values &args = *req.GetParams();
@@ -129,7 +129,16 @@ RPCSendV2::encodeRequest(FRT_RPCRequest &req, const Version &version, const Rout
     BinaryFormat::encode(slime, rBuf);
     ConstBufferRef toCompress(rBuf.getBuf().getData(), rBuf.getBuf().getDataLen());
     DataBuffer buf(vespalib::roundUp2inN(rBuf.getBuf().getDataLen()));
-    CompressionConfig::Type type = compress(_net->getCompressionConfig(), toCompress, buf, false);
+    CompressionConfig::Type type;
+    if (_net->getAdaptiveCompression() && address.hasTarget()) {
+        CompressionTuner &tuner = address.getTarget().getCompressionTuner();
+        CompressionConfig config = tuner.select(_net->getCompressionConfig(), _net->getCompressionWireCost());
+        time_point start = vespalib::steady_clock::now();
+        type = compress(config, toCompress, buf, false);
+        tuner.report(config, toCompress.size(), buf.getDataLen(), vespalib::steady_clock::now() - start);
+    } else {
+        type = compress(_net->getCompressionConfig(), toCompress, buf, false);
+    }
 
     args.AddInt8(type);
     args.AddInt32(toCompress.size());
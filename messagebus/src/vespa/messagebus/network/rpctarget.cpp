@@ -12,7 +12,8 @@ RPCTarget::RPCTarget(const string &spec, FRT_Supervisor &orb) :
     _target(*_orb.GetTarget(spec.c_str())),
     _state(VERSION_NOT_RESOLVED),
     _version(),
-    _versionHandlers()
+    _versionHandlers(),
+    _compressionTuner()
 {
     // empty
 }
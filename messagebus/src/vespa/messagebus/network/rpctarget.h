@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include "compressiontuner.h"
 #include <vespa/messagebus/common.h>
 #include <vespa/fnet/frt/invoker.h>
 #include <vespa/fnet/frt/target.h>
@@ -57,6 +58,7 @@ private:
     std::atomic<ResolveState>  _state;
     Version_UP                 _version;
     HandlerList                _versionHandlers;
+    CompressionTuner           _compressionTuner;
 
 public:
     /**
@@ -112,6 +114,14 @@ public:
      */
     const vespalib::Version &getVersion() const { return *_version; }
 
+    /**
+     * Returns the object that chooses how to compress what is sent to this target, and that keeps the
+     * compression statistics of it.
+     *
+     * @return The compression tuner.
+     */
+    CompressionTuner &getCompressionTuner() { return _compressionTuner; }
+
     // Implements FRT_IRequestWait.
     void RequestDone(FRT_RPCRequest *req) override;
 };
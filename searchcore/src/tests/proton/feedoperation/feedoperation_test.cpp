@@ -282,6 +282,24 @@ TEST_F("require that we can serialize and deserialize put operations", Fixture)
     }
 }
 
+TEST_F("require that serialized put document is kept for reuse", Fixture)
+{
+    vespalib::nbostream stream;
+    BucketId bucket(toBucket(docId.getGlobalId()));
+    auto doc(f.makeDoc());
+    PutOperation op(bucket, Timestamp(10), doc);
+    EXPECT_TRUE(!op.getSerializedDocument());
+    op.serialize(stream);
+    auto serializedDoc = op.getSerializedDocument();
+    ASSERT_TRUE(serializedDoc);
+    EXPECT_EQUAL(op.getSerializedDocSize(), serializedDoc->size());
+    vespalib::nbostream copy(serializedDoc->peek(), serializedDoc->size());
+    Document copyDoc(*f._repo, copy);
+    EXPECT_EQUAL(*doc, copyDoc);
+    op.deserializeDocument(*f._repo);
+    EXPECT_TRUE(!op.getSerializedDocument());
+}
+
 TEST_F("require that we can serialize and deserialize move operations", Fixture)
 {
     vespalib::nbostream stream;
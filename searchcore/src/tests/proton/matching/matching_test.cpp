@@ -17,6 +17,7 @@
 #include <vespa/searchlib/aggregation/aggregation.h>
 #include <vespa/searchlib/aggregation/grouping.h>
 #include <vespa/searchlib/aggregation/perdocexpression.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
 #include <vespa/searchlib/attribute/extendableattributes.h>
 #include <vespa/searchlib/common/featureset.h>
 #include <vespa/searchlib/engine/docsumrequest.h>
@@ -889,6 +890,53 @@ TEST("require that match phase limiting works") {
     }
 }
 
+TEST("require that single attribute sort spec can be parsed") {
+    vespalib::string attribute;
+    bool descending = false;
+    EXPECT_TRUE(parse_single_attribute_sort("-a1", attribute, descending));
+    EXPECT_EQUAL("a1", attribute);
+    EXPECT_TRUE(descending);
+    EXPECT_TRUE(parse_single_attribute_sort(" +my.a1 ", attribute, descending));
+    EXPECT_EQUAL("my.a1", attribute);
+    EXPECT_FALSE(descending);
+    EXPECT_FALSE(parse_single_attribute_sort("", attribute, descending));
+    EXPECT_FALSE(parse_single_attribute_sort("-", attribute, descending));
+    EXPECT_FALSE(parse_single_attribute_sort("a1", attribute, descending));
+    EXPECT_FALSE(parse_single_attribute_sort("+a1 -a2", attribute, descending));
+    EXPECT_FALSE(parse_single_attribute_sort("-[rank]", attribute, descending));
+    EXPECT_FALSE(parse_single_attribute_sort("+uca(a1,en_US)", attribute, descending));
+}
+
+TEST("require that sort attribute is not used for match phase limiting unless fast-search") {
+    MyWorld world;
+    world.basicSetup();
+    SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+    request->propertiesMap.lookupCreate(search::MapNames::RANK).add(indexproperties::matchphase::SortAttributeLimit::NAME, "true");
+    Matcher::SP matcher = world.createMatcher();
+    search::fef::Properties overrides;
+    auto mtf = matcher->create_match_tools_factory(*request, world.searchContext, world.attributeContext, world.metaStore,
+                                                   overrides, true, "-a1", 10);
+    EXPECT_FALSE(mtf->match_limiter().is_enabled());
+}
+
+TEST("require that fast-search sort attribute is used for match phase limiting") {
+    MyWorld world;
+    world.basicSetup();
+    search::attribute::Config cfg(search::attribute::BasicType::INT32, search::attribute::CollectionType::SINGLE);
+    cfg.setFastSearch(true);
+    auto attr = search::AttributeFactory::createAttribute("fast_a1", cfg);
+    attr->addDocs(NUM_DOCS);
+    attr->commit();
+    world.attributeContext.add(attr);
+    SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+    request->propertiesMap.lookupCreate(search::MapNames::RANK).add(indexproperties::matchphase::SortAttributeLimit::NAME, "true");
+    Matcher::SP matcher = world.createMatcher();
+    search::fef::Properties overrides;
+    auto mtf = matcher->create_match_tools_factory(*request, world.searchContext, world.attributeContext, world.metaStore,
+                                                   overrides, true, "-fast_a1", 10);
+    EXPECT_TRUE(mtf->match_limiter().is_enabled());
+}
+
 TEST("require that arithmetic used for rank drop limit works") {
     double small = -HUGE_VAL;
     double limit = -std::numeric_limits<feature_t>::quiet_NaN();
@@ -180,6 +180,16 @@ struct MyDocumentStore : proton::test::DummyDocumentStore {
 
         return doc;
     }
+
+    void visit(const LidVector & lids, const DocumentTypeRepo &r, search::IDocumentVisitor & visitor) const override {
+        for (DocumentIdT lid : lids) {
+            Document::UP doc = read(lid, r);
+            if (doc && visitor.onlyDocumentId()) {
+                doc = std::make_unique<Document>(doc->getType(), doc->getId());
+            }
+            visitor.visit(lid, std::move(doc));
+        }
+    }
     
     uint64_t
     initFlush(uint64_t syncToken) override
@@ -475,6 +485,29 @@ TEST_F("require that we can look up NONE and DOCIDONLY field sets", Fixture) {
         EXPECT_TRUE(doc->getFields().empty());
 }
 
+struct CollectingVisitor : search::IDocumentVisitor {
+    std::vector<Document::UP> docs;
+    void visit(uint32_t, Document::UP doc) override { docs.push_back(std::move(doc)); }
+    bool allowVisitCaching() const override { return false; }
+};
+
+TEST_F("require that attribute only field sets are visited without stored fields", Fixture) {
+    DocumentMetaData meta_data = f._retriever->getDocumentMetaData(doc_id);
+    const DocumentType &type = *f.repo.getDocumentType(doc_type_name);
+    CollectingVisitor visitor;
+    f._retriever->visitPartialDocuments({meta_data.lid}, type.getField(dyn_field_i), visitor,
+                                        storage::spi::ReadConsistency::STRONG);
+    ASSERT_EQUAL(1u, visitor.docs.size());
+    EXPECT_EQUAL(doc_id, visitor.docs[0]->getId());
+    EXPECT_TRUE(checkFieldValue<IntFieldValue>(visitor.docs[0]->getValue(dyn_field_i), dyn_value_i));
+    EXPECT_FALSE(visitor.docs[0]->getValue(static_field));
+
+    f._retriever->visitPartialDocuments({meta_data.lid}, type.getField(static_field), visitor,
+                                        storage::spi::ReadConsistency::STRONG);
+    ASSERT_EQUAL(2u, visitor.docs.size());
+    EXPECT_TRUE(checkFieldValue<IntFieldValue>(visitor.docs[1]->getValue(static_field), static_value));
+}
+
 TEST_F("require that attributes are patched into stored document unless also index field", Fixture) {
     f.addIndexField(Schema::IndexField(dyn_field_s, DataType::STRING)).build();
     DocumentMetaData meta_data = f._retriever->getDocumentMetaData(doc_id);
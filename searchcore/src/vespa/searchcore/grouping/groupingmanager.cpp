@@ -5,6 +5,7 @@
 #include "groupingcontext.h"
 #include <vespa/searchlib/aggregation/fs4hit.h>
 #include <vespa/searchlib/expression/attributenode.h>
+#include <vespa/searchlib/grouping/flatgroupingengine.h>
 #include <vespa/vespalib/util/issue.h>
 #include <vespa/vespalib/util/stringfmt.h>
 
@@ -88,7 +89,13 @@ GroupingManager::groupUnordered(const RankedHit *searchResults, uint32_t binSize
     for (size_t i = 0; i < groupingList.size(); ++i) {
         Grouping & g = *groupingList[i];
         if ( g.needResort() ) {
-            g.aggregate(searchResults, binSize, overflow);
+            if (FlatGroupingEngine::supports(g)) {
+                FlatGroupingEngine engine(g);
+                engine.aggregate(searchResults, binSize, overflow);
+                engine.fill(g);
+            } else {
+                g.aggregate(searchResults, binSize, overflow);
+            }
             LOG(debug, "groupUnordered: %s", g.asString().c_str());
             g.cleanTemporary();
             g.cleanupAttributeReferences();
@@ -2,6 +2,7 @@
 
 #include "putoperation.h"
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/vespalib/objects/nbostream.h>
 
 using document::BucketId;
 using document::Document;
@@ -13,13 +14,15 @@ namespace proton {
 
 PutOperation::PutOperation()
     : DocumentOperation(FeedOperation::PUT),
-      _doc()
+      _doc(),
+      _serializedDoc()
 { }
 
 
 PutOperation::PutOperation(BucketId bucketId, Timestamp timestamp, Document::SP doc)
     : DocumentOperation(FeedOperation::PUT, bucketId, timestamp),
-      _doc(std::move(doc))
+      _doc(std::move(doc)),
+      _serializedDoc()
 { }
 
 PutOperation::~PutOperation() = default;
@@ -29,9 +32,11 @@ PutOperation::serialize(vespalib::nbostream &os) const
 {
     assertValidBucketId(_doc->getId());
     DocumentOperation::serialize(os);
-    size_t oldSize = os.size();
-    _doc->serialize(os);
-    _serializedDocSize = os.size() - oldSize;
+    auto serializedDoc = std::make_shared<vespalib::nbostream>();
+    _doc->serialize(*serializedDoc);
+    os.write(serializedDoc->peek(), serializedDoc->size());
+    _serializedDocSize = serializedDoc->size();
+    _serializedDoc = std::move(serializedDoc);
 }
 
 
@@ -51,6 +56,7 @@ PutOperation::deserializeDocument(const DocumentTypeRepo &repo)
     _doc->serialize(stream);
     auto fixedDoc = std::make_shared<Document>(repo, stream);
     _doc = std::move(fixedDoc);
+    _serializedDoc.reset();
 }
 
 vespalib::string
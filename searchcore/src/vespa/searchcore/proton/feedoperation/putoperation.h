@@ -8,7 +8,9 @@ namespace proton {
 class PutOperation : public DocumentOperation
 {
     using DocumentSP = std::shared_ptr<document::Document>;
+    using SerializedDocumentSP = std::shared_ptr<const vespalib::nbostream>;
     DocumentSP _doc;
+    mutable SerializedDocumentSP _serializedDoc;
 
 public:
     PutOperation();
@@ -17,6 +19,12 @@ public:
                  DocumentSP doc);
     ~PutOperation() override;
     const DocumentSP &getDocument() const { return _doc; }
+    /**
+     * The document as written to the transaction log, available after
+     * serialize(). Lets the document store reuse it instead of
+     * serializing the document again.
+     */
+    const SerializedDocumentSP &getSerializedDocument() const { return _serializedDoc; }
     void assertValid() const;
     void serialize(vespalib::nbostream &os) const override;
     void deserialize(vespalib::nbostream &is, const document::DocumentTypeRepo &repo) override;
@@ -68,6 +68,29 @@ LimitedSearch::visitMembers(vespalib::ObjectVisitor &visitor) const
     visit(visitor, "second", getSecond());
 }
 
+bool
+parse_single_attribute_sort(vespalib::stringref sort_spec, vespalib::string &attribute, bool &descending)
+{
+    while (!sort_spec.empty() && (sort_spec[0] == ' ')) {
+        sort_spec = sort_spec.substr(1);
+    }
+    while (!sort_spec.empty() && (sort_spec[sort_spec.size() - 1] == ' ')) {
+        sort_spec = sort_spec.substr(0, sort_spec.size() - 1);
+    }
+    if ((sort_spec.size() < 2) || ((sort_spec[0] != '+') && (sort_spec[0] != '-'))) {
+        return false;
+    }
+    vespalib::stringref name = sort_spec.substr(1);
+    for (char c : name) {
+        if (!isalnum(static_cast<unsigned char>(c)) && (c != '_') && (c != '.')) {
+            return false;
+        }
+    }
+    attribute = name;
+    descending = (sort_spec[0] == '-');
+    return true;
+}
+
 MatchPhaseLimiter::MatchPhaseLimiter(uint32_t docIdLimit, Searchable &searchable_attributes,
                                      IRequestContext & requestContext,
                                      DegradationParams degradation, DiversityParams diversity)
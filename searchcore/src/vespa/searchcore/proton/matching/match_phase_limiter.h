@@ -105,6 +105,14 @@ struct DegradationParams {
     double           post_filter_multiplier;
 };
 
+/**
+ * Extracts the attribute name and order from a sort spec consisting
+ * of a single plain ascending ('+') or descending ('-') attribute,
+ * like "-timestamp". Returns false for anything else (multiple sort
+ * levels, [rank], [docid] or converter functions like uca/lowercase).
+ **/
+bool parse_single_attribute_sort(vespalib::stringref sort_spec, vespalib::string &attribute, bool &descending);
+
 /**
  * This class is is used when rank phase limiting is configured.
  **/
@@ -3,6 +3,7 @@
 #include "match_tools.h"
 #include "querynodes.h"
 #include <vespa/searchcorespi/index/indexsearchable.h>
+#include <vespa/searchcommon/attribute/iattributevector.h>
 #include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/fef/ranksetup.h>
 #include <vespa/searchlib/engine/trace.h>
@@ -66,6 +67,28 @@ extractDiversityParams(const RankSetup &rankSetup, const Properties &rankPropert
                            AttributeLimiter::toDiversityCutoffStrategy(DiversityCutoffStrategy::lookup(rankProperties, rankSetup.getDiversityCutoffStrategy())));
 }
 
+DegradationParams
+extractSortAttributeDegradationParams(const RankSetup &rankSetup, const Properties &rankProperties,
+                                      const IRequestContext &requestContext,
+                                      vespalib::stringref sortSpec, uint32_t wantedHits)
+{
+    vespalib::string attribute;
+    bool descending = false;
+    if ((wantedHits == 0) || !parse_single_attribute_sort(sortSpec, attribute, descending)) {
+        return DegradationParams("", 0, false, 0.0, 0.0, 0.0);
+    }
+    const auto * attr = requestContext.getAttribute(attribute);
+    if ((attr == nullptr) || !attr->getIsFastSearch() || attr->hasMultiValue() ||
+        !(attr->isIntegerType() || attr->isFloatingPointType()))
+    {
+        return DegradationParams("", 0, false, 0.0, 0.0, 0.0);
+    }
+    return DegradationParams(attribute, wantedHits, descending,
+                             DegradationMaxFilterCoverage::lookup(rankProperties, rankSetup.getDegradationMaxFilterCoverage()),
+                             DegradationSamplePercentage::lookup(rankProperties, rankSetup.getDegradationSamplePercentage()),
+                             DegradationPostFilterMultiplier::lookup(rankProperties, rankSetup.getDegradationPostFilterMultiplier()));
+}
+
 AttributeBlueprintParams
 extractAttributeBlueprintParams(const RankSetup& rank_setup, const Properties &rankProperties)
 {
@@ -112,7 +135,8 @@ MatchTools::MatchTools(QueryLimiter & queryLimiter,
       _queryEnv(queryEnv),
       _rankSetup(rankSetup),
       _featureOverrides(featureOverrides),
-      _match_data(mdl.createMatchData()),
+      _match_data(mdl.createMatchData(CompactPositionsPerTermField::lookup(queryEnv.getProperties(),
+                                                                           rankSetup.get_compact_positions_per_term_field()))),
       _rank_program(),
       _search(),
       _used_handles(),
@@ -168,7 +192,9 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
                   const RankSetup            & rankSetup,
                   const Properties           & rankProperties,
                   const Properties           & featureOverrides,
-                  bool                         is_search)
+                  bool                         is_search,
+                  vespalib::stringref          sortSpec,
+                  uint32_t                     wantedHits)
     : _queryLimiter(queryLimiter),
       _requestContext(doom, attributeContext, rankProperties, extractAttributeBlueprintParams(rankSetup, rankProperties)),
       _query(),
@@ -205,6 +231,13 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
         _rankSetup.prepareSharedState(_queryEnv, _queryEnv.getObjectStore());
         _diversityParams = extractDiversityParams(_rankSetup, rankProperties);
         DegradationParams degradationParams = extractDegradationParams(_rankSetup, rankProperties);
+        if (!degradationParams.enabled() && is_search && SortAttributeLimit::lookup(rankProperties)) {
+            degradationParams = extractSortAttributeDegradationParams(_rankSetup, rankProperties, _requestContext,
+                                                                      sortSpec, wantedHits);
+            if (degradationParams.enabled()) {
+                trace.addEvent(5, "MTF: Use sort attribute for match phase limiting");
+            }
+        }
 
         if (degradationParams.enabled()) {
             trace.addEvent(5, "MTF: Build MatchPhaseLimiter");
@@ -120,7 +120,9 @@ public:
                       const search::fef::RankSetup &rankSetup,
                       const search::fef::Properties &rankProperties,
                       const search::fef::Properties &featureOverrides,
-                      bool is_search);
+                      bool is_search,
+                      vespalib::stringref sortSpec,
+                      uint32_t wantedHits);
     ~MatchToolsFactory();
     bool valid() const { return _valid; }
     const MaybeMatchPhaseLimiter &match_limiter() const { return *_match_limiter; }
@@ -138,6 +138,16 @@ std::unique_ptr<MatchToolsFactory>
 Matcher::create_match_tools_factory(const search::engine::Request &request, ISearchContext &searchContext,
                                     IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
                                     const Properties &feature_overrides, bool is_search) const
+{
+    return create_match_tools_factory(request, searchContext, attrContext, metaStore, feature_overrides,
+                                      is_search, vespalib::stringref(), 0);
+}
+
+std::unique_ptr<MatchToolsFactory>
+Matcher::create_match_tools_factory(const search::engine::Request &request, ISearchContext &searchContext,
+                                    IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
+                                    const Properties &feature_overrides, bool is_search,
+                                    vespalib::stringref sort_spec, uint32_t wanted_hits) const
 {
     const Properties & rankProperties = request.propertiesMap.rankProperties();
     bool softTimeoutEnabled = Enabled::lookup(rankProperties, _rankSetup->getSoftTimeoutEnabled());
@@ -157,7 +167,8 @@ Matcher::create_match_tools_factory(const search::engine::Request &request, ISea
     return std::make_unique<MatchToolsFactory>(_queryLimiter, doom, searchContext, attrContext,
                                                request.trace(), request.getStackRef(), request.location,
                                                _viewResolver, metaStore, _indexEnv, *_rankSetup,
-                                               rankProperties, feature_overrides, is_search);
+                                               rankProperties, feature_overrides, is_search,
+                                               sort_spec, wanted_hits);
 }
 
 size_t
@@ -217,7 +228,7 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
         }
 
         MatchToolsFactory::UP mtf = create_match_tools_factory(request, searchContext, attrContext,
-                metaStore, *feature_overrides, true);
+                metaStore, *feature_overrides, true, request.sortSpec, request.offset + request.maxhits);
         isDoomExplicit = mtf->getRequestContext().getDoom().isExplicitSoftDoom();
         traceQuery(6, request.trace(), mtf->query());
         if (!mtf->valid()) {
@@ -110,6 +110,18 @@ public:
                                IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
                                const Properties &feature_overrides, bool is_search) const;
 
+    /**
+     * Create the low-level tools needed to perform matching for a
+     * search request. The sort spec and the number of wanted hits
+     * (offset + hits) are used to enable match phase limiting on the
+     * sort attribute when requested by the rank properties.
+     **/
+    std::unique_ptr<MatchToolsFactory>
+    create_match_tools_factory(const search::engine::Request &request, ISearchContext &searchContext,
+                               IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
+                               const Properties &feature_overrides, bool is_search,
+                               vespalib::stringref sort_spec, uint32_t wanted_hits) const;
+
     /**
      * Perform a search against this matcher.
      *
@@ -51,6 +51,15 @@ CommitAndWaitDocumentRetriever::visitDocuments(const LidVector &lids, search::ID
     _retriever->visitDocuments(lids, visitor, readConsistency);
 }
 
+void
+CommitAndWaitDocumentRetriever::visitPartialDocuments(const LidVector &lids, const document::FieldSet & fieldSet,
+                                                      search::IDocumentVisitor &visitor,
+                                                      ReadConsistency readConsistency) const
+{
+    _uncommittedLidsTracker.waitComplete(lids);
+    _retriever->visitPartialDocuments(lids, fieldSet, visitor, readConsistency);
+}
+
 CachedSelect::SP
 CommitAndWaitDocumentRetriever::parseSelect(const vespalib::string &selection) const {
     return _retriever->parseSelect(selection);
@@ -155,6 +155,8 @@ public:
     }
 
     bool willAlwaysFail() const { return _willAlwaysFail; }
+    // Whether the selection must be evaluated against the full document.
+    bool needsDocument() const { return !(_dscTrue || _metaOnly); }
 
     bool match(const search::DocumentMetaData & meta) const {
         if (meta.lid >= _docidLimit) {
@@ -271,7 +273,11 @@ DocumentIterator::fetchCompleteSource(const IDocumentRetriever & source, Iterate
     } else {
         MatchVisitor visitor(matcher, metaData, lidIndexMap, _fields.get(), list, _defaultSerializedSize);
         visitor.allowVisitCaching(isWeakRead());
-        source.visitDocuments(lidsToFetch, visitor, _readConsistency);
+        if (matcher.needsDocument()) {
+            source.visitDocuments(lidsToFetch, visitor, _readConsistency);
+        } else {
+            source.visitPartialDocuments(lidsToFetch, *_fields, visitor, _readConsistency);
+        }
     }
 
 }
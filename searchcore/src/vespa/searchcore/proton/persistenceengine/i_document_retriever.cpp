@@ -21,6 +21,12 @@ IDocumentRetriever::getPartialDocument(search::DocumentIdT lid, const document::
     return doc;
 }
 
+void
+IDocumentRetriever::visitPartialDocuments(const LidVector &lids, const document::FieldSet &,
+                                          search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const {
+    visitDocuments(lids, visitor, readConsistency);
+}
+
 void
 DocumentRetrieverBaseForTest::visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const {
     (void) readConsistency;
@@ -52,6 +52,13 @@ public:
      * @param Visitor to receive callback for each document found.
      */
     virtual void visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const = 0;
+    /**
+     * As visitDocuments, but the visited documents only need to contain the fields in the given
+     * field set, allowing documents to be assembled from attributes when that covers the field set.
+     * Documents may contain more fields than requested.
+     */
+    virtual void visitPartialDocuments(const LidVector &lids, const document::FieldSet & fieldSet,
+                                       search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const;
 
     virtual CachedSelect::SP parseSelect(const vespalib::string &selection) const = 0;
 
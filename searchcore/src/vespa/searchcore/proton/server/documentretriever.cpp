@@ -220,8 +220,42 @@ private:
     search::IDocumentVisitor & _visitor;
 };
 
+/**
+ * Used when all requested fields are attributes. Only the document id is
+ * read from the document store, and the fields are filled in from attributes.
+ */
+class AttributePopulateVisitor : public search::IDocumentVisitor
+{
+public:
+    AttributePopulateVisitor(const DocumentRetriever & retriever, const FieldSet & fieldSet,
+                             search::IDocumentVisitor & visitor) :
+        _retriever(retriever),
+        _fieldSet(fieldSet),
+        _visitor(visitor)
+    { }
+    void visit(uint32_t lid, document::Document::UP doc) override;
+
+    bool allowVisitCaching() const override {
+        return _visitor.allowVisitCaching();
+    }
+    bool onlyDocumentId() const override { return true; }
+
+private:
+    const DocumentRetriever  & _retriever;
+    const FieldSet           & _fieldSet;
+    search::IDocumentVisitor & _visitor;
+};
+
 }  // namespace
 
+void
+AttributePopulateVisitor::visit(uint32_t lid, document::Document::UP doc) {
+    if (doc) {
+        _retriever.populateFromAttributes(lid, *doc, _fieldSet);
+        _visitor.visit(lid, std::move(doc));
+    }
+}
+
 Document::UP
 DocumentRetriever::getFullDocument(DocumentIdT lid) const
 {
@@ -243,29 +277,35 @@ DocumentRetriever::getPartialDocument(search::DocumentIdT lid, const document::D
         }
     } else {
         doc = std::make_unique<Document>(getDocumentType(), docId);
-        switch (fieldSet.getType()) {
-            case FieldSet::Type::ALL:
-                populate(lid, *doc);
-                break;
-            case FieldSet::Type::FIELD: {
-                const auto & field = static_cast<const Field&>(fieldSet);
-                populate(lid, *doc, Field::Set::Builder().add(&field).build());
-                break;
-            }
-            case FieldSet::Type::SET: {
-                const auto &set = static_cast<const document::FieldCollection &>(fieldSet);
-                populate(lid, *doc, set.getFields());
-                break;
-            }
-            case FieldSet::Type::NONE:
-            case FieldSet::Type::DOCID:
-                break;
-        }
-        doc->setRepo(getDocumentTypeRepo());
+        populateFromAttributes(lid, *doc, fieldSet);
     }
     return doc;
 }
 
+void
+DocumentRetriever::populateFromAttributes(DocumentIdT lid, Document & doc, const FieldSet & fieldSet) const
+{
+    switch (fieldSet.getType()) {
+        case FieldSet::Type::ALL:
+            populate(lid, doc);
+            break;
+        case FieldSet::Type::FIELD: {
+            const auto & field = static_cast<const Field&>(fieldSet);
+            populate(lid, doc, Field::Set::Builder().add(&field).build());
+            break;
+        }
+        case FieldSet::Type::SET: {
+            const auto &set = static_cast<const document::FieldCollection &>(fieldSet);
+            populate(lid, doc, set.getFields());
+            break;
+        }
+        case FieldSet::Type::NONE:
+        case FieldSet::Type::DOCID:
+            break;
+    }
+    doc.setRepo(getDocumentTypeRepo());
+}
+
 void
 DocumentRetriever::visitDocuments(const LidVector & lids, search::IDocumentVisitor & visitor, ReadConsistency) const
 {
@@ -273,6 +313,18 @@ DocumentRetriever::visitDocuments(const LidVector & lids, search::IDocumentVisit
     _doc_store.visit(lids, getDocumentTypeRepo(), populater);
 }
 
+void
+DocumentRetriever::visitPartialDocuments(const LidVector & lids, const FieldSet & fieldSet,
+                                         search::IDocumentVisitor & visitor, ReadConsistency readConsistency) const
+{
+    if (needFetchFromDocStore(fieldSet)) {
+        visitDocuments(lids, visitor, readConsistency);
+    } else {
+        AttributePopulateVisitor populater(*this, fieldSet, visitor);
+        _doc_store.visit(lids, getDocumentTypeRepo(), populater);
+    }
+}
+
 void
 DocumentRetriever::populate(DocumentIdT lid, Document & doc) const {
     populate(lid, doc, _attributeFields);
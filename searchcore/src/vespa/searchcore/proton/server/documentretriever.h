@@ -45,8 +45,11 @@ public:
 
     document::Document::UP getFullDocument(search::DocumentIdT lid) const override;
     void visitDocuments(const LidVector & lids, search::IDocumentVisitor & visitor, ReadConsistency) const override;
+    void visitPartialDocuments(const LidVector & lids, const document::FieldSet & fieldSet,
+                               search::IDocumentVisitor & visitor, ReadConsistency) const override;
     DocumentUP getPartialDocument(search::DocumentIdT lid, const document::DocumentId &, const document::FieldSet &) const override;
     void populate(search::DocumentIdT lid, document::Document & doc) const;
+    void populateFromAttributes(search::DocumentIdT lid, document::Document & doc, const document::FieldSet & fieldSet) const;
     bool needFetchFromDocStore(const document::FieldSet &) const;
 private:
     void populate(search::DocumentIdT lid, document::Document & doc, const document::Field::Set & attributeFields) const;
@@ -46,6 +46,7 @@
 #include <vespa/searchlib/aggregation/forcelink.hpp>
 #include <vespa/searchlib/expression/forcelink.hpp>
 #include <sstream>
+#include <algorithm>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.proton");
@@ -130,6 +131,12 @@ computeRpcTransportThreads(const ProtonConfig & cfg, const HwInfo::Cpu &cpuInfo)
                 : cpuInfo.cores();
 }
 
+uint32_t
+computeStateServerReactors(const HwInfo::Cpu &cpuInfo) {
+    // a reactor busy with a large metrics snapshot only delays the connections it owns
+    return std::clamp(cpuInfo.cores() / 8, 2u, 8u);
+}
+
 struct MetricsUpdateHook : metrics::UpdateHook
 {
     Proton &self;
@@ -356,8 +363,8 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     waitForInitDone();
 
     _metricsEngine->start(_configUri);
-    _stateServer = std::make_unique<vespalib::StateServer>(protonConfig.httpport, _healthAdapter,
-                                                           _metricsEngine->metrics_producer(), *this);
+    _stateServer = std::make_unique<vespalib::StateServer>(protonConfig.httpport, computeStateServerReactors(hwInfo.cpu()),
+                                                           _healthAdapter, _metricsEngine->metrics_producer(), *this);
     _customComponentBindToken = _stateServer->repo().bind(CUSTOM_COMPONENT_API_PATH, _genericStateHandler);
     _customComponentRootToken = _stateServer->repo().add_root_resource(CUSTOM_COMPONENT_API_PATH);
 
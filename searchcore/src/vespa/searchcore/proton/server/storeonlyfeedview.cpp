@@ -249,7 +249,12 @@ StoreOnlyFeedView::internalPut(FeedToken token, const PutOperation &putOp)
             _gidToLidChangeHandler.notifyPut(token, docId.getGlobalId(), putOp.getLid(), serialNum);
         }
         auto onWriteDone = createPutDoneContext(std::move(token), get_pending_lid_token(putOp), doc, putOp.getLid());
-        putSummary(serialNum, putOp.getLid(), doc, onWriteDone);
+        if (putOp.getSerializedDocument()) {
+            // Reuse the transaction log serialization instead of serializing the document again.
+            putSummary(serialNum, putOp.getLid(), putOp.getSerializedDocument(), onWriteDone);
+        } else {
+            putSummary(serialNum, putOp.getLid(), doc, onWriteDone);
+        }
         putAttributes(serialNum, putOp.getLid(), *doc, onWriteDone);
         putIndexedFields(serialNum, putOp.getLid(), doc, onWriteDone);
     }
@@ -339,6 +344,17 @@ StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, Document::SP doc, On
                 _summaryAdapter->put(serialNum, lid, *doc);
             }));
 }
+
+void
+StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, std::shared_ptr<const vespalib::nbostream> serializedDoc, OnOperationDoneType onDone)
+{
+    summaryExecutor().execute(
+            makeLambdaTask([serialNum, serializedDoc = std::move(serializedDoc), trackerToken = _pendingLidsForDocStore.produce(lid), onDone, lid, this] {
+                (void) onDone;
+                (void) trackerToken;
+                _summaryAdapter->put(serialNum, lid, *serializedDoc);
+            }));
+}
 void
 StoreOnlyFeedView::removeSummary(SerialNum serialNum, Lid lid, OnWriteDoneType onDone) {
     summaryExecutor().execute(
@@ -159,6 +159,7 @@ private:
     void putSummary(SerialNum serialNum, Lid lid, FutureStream doc, OnOperationDoneType onDone);
     void putSummaryNoop(FutureStream doc, OnOperationDoneType onDone);
     void putSummary(SerialNum serialNum, Lid lid, DocumentSP doc, OnOperationDoneType onDone);
+    void putSummary(SerialNum serialNum, Lid lid, std::shared_ptr<const vespalib::nbostream> serializedDoc, OnOperationDoneType onDone);
     void removeSummary(SerialNum serialNum, Lid lid, OnWriteDoneType onDone);
     void removeSummaries(SerialNum serialNum, const LidVector & lids, OnWriteDoneType onDone);
     void heartBeatSummary(SerialNum serialNum);
@@ -26,6 +26,7 @@ public class Group extends Identifiable {
     private List<Group> children = new ArrayList<>();
     private ResultNode id = null;
     private double rank;
+    private double approximationError = 0;
     private int tag = -1;
     private SortType sortType = SortType.UNSORTED;
 
@@ -51,6 +52,7 @@ public class Group extends Identifiable {
         if (rhs.rank > rank) {
             rank = rhs.rank; // keep highest rank
         }
+        approximationError += rhs.approximationError;
         if (currentLevel >= firstLevel) {
             for (int i = 0, len = aggregationResults.size(); i < len; ++i) {
                 aggregationResults.get(i).merge(rhs.aggregationResults.get(i));
@@ -190,6 +192,29 @@ public class Group extends Identifiable {
         return rank;
     }
 
+    /**
+     * Returns how much the values ordering the children of this group (such as count()) may differ from their
+     * exact values because the next level was grouped approximately, see
+     * {@link GroupingLevel#setApproximateGroups(int)}. Children that were dropped have no exact value above this.
+     * This is 0 when all groups were kept.
+     *
+     * @return The error bound.
+     */
+    public double getApproximationError() {
+        return approximationError;
+    }
+
+    /**
+     * Sets the error bound of the values ordering the children of this group.
+     *
+     * @param approximationError The error bound.
+     * @return This, to allow chaining.
+     */
+    public Group setApproximationError(double approximationError) {
+        this.approximationError = approximationError;
+        return this;
+    }
+
     /**
      * Adds a child group to this.
      *
@@ -312,6 +337,12 @@ public class Group extends Identifiable {
         super.onSerialize(buf);
         serializeOptional(buf, id);
         buf.putDouble(null, rank);
+        if (approximationError > 0) {
+            buf.putByte(null, (byte)1);
+            buf.putDouble(null, approximationError);
+        } else {
+            buf.putByte(null, (byte)0);
+        }
         int sz = orderByIdx.size();
         buf.putInt(null, sz);
         for (Integer index : orderByIdx) {
@@ -340,6 +371,7 @@ public class Group extends Identifiable {
         super.onDeserialize(buf);
         id = (ResultNode)deserializeOptional(buf);
         rank = buf.getDouble(null);
+        approximationError = (buf.getByte(null) != 0) ? buf.getDouble(null) : 0;
         orderByIdx.clear();
         int orderByCount = buf.getInt(null);
         for (int i = 0; i < orderByCount; i++) {
@@ -383,6 +415,9 @@ public class Group extends Identifiable {
         if (rank != rhs.rank) {
             return false;
         }
+        if (approximationError != rhs.approximationError) {
+            return false;
+        }
         if (!aggregationResults.equals(rhs.aggregationResults)) {
             return false;
         }
@@ -428,6 +463,7 @@ public class Group extends Identifiable {
         super.visitMembers(visitor);
         visitor.visit("id", id);
         visitor.visit("rank", rank);
+        visitor.visit("approximationError", approximationError);
         visitor.visit("aggregationresults", aggregationResults);
         visitor.visit("orderby-idx", orderByIdx);
         visitor.visit("orderby-exp", orderByExp);
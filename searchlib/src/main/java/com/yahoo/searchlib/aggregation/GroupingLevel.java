@@ -18,6 +18,9 @@ public class GroupingLevel extends Identifiable {
     // The precsicion used for estimation. This is number of groups returned up when using orderby that need more info to get it correct.
     private long precision = -1;
 
+    // The number of groups kept while aggregating when approximating the top groups, 0 to keep all.
+    private int approximateGroups = 0;
+
     // The classifier expression; the result of this is the group key.
     private ExpressionNode classify = null;
 
@@ -67,6 +70,29 @@ public class GroupingLevel extends Identifiable {
         return this;
     }
 
+    /**
+     * <p>Returns the number of groups kept per parent group while aggregating, 0 if all groups are kept.</p>
+     *
+     * @return The number of groups kept.
+     */
+    public int getApproximateGroups() {
+        return approximateGroups;
+    }
+
+    /**
+     * <p>Bounds the number of groups kept per parent group while aggregating to the given number. When more groups
+     * are found, the group with the lowest value of the first (descending) order-by expression is replaced, and the
+     * new group inherits its aggregates. The parent group reports how much this may have changed the results, see
+     * {@link Group#getApproximationError()}. 0 keeps all groups.</p>
+     *
+     * @param approximateGroups The number of groups to keep.
+     * @return This, to allow chaining.
+     */
+    public GroupingLevel setApproximateGroups(int approximateGroups) {
+        this.approximateGroups = approximateGroups;
+        return this;
+    }
+
     /**
      * <p>Returns the expression used to classify hits into groups.</p>
      *
@@ -125,6 +151,7 @@ public class GroupingLevel extends Identifiable {
     protected void onSerialize(Serializer buf) {
         buf.putLong(null, maxGroups);
         buf.putLong(null, precision);
+        buf.putInt(null, approximateGroups);
         serializeOptional(buf, classify);
         collect.serializeWithId(buf);
     }
@@ -133,6 +160,7 @@ public class GroupingLevel extends Identifiable {
     protected void onDeserialize(Deserializer buf) {
         maxGroups = buf.getLong(null);
         precision = buf.getLong(null);
+        approximateGroups = buf.getInt(null);
         classify = (ExpressionNode)deserializeOptional(buf);
         collect.deserializeWithId(buf);
     }
@@ -154,6 +182,9 @@ public class GroupingLevel extends Identifiable {
         if (precision != rhs.precision) {
             return false;
         }
+        if (approximateGroups != rhs.approximateGroups) {
+            return false;
+        }
         if (!equals(classify, rhs.classify)) {
             return false;
         }
@@ -178,6 +209,7 @@ public class GroupingLevel extends Identifiable {
         super.visitMembers(visitor);
         visitor.visit("maxGroups", maxGroups);
         visitor.visit("precision", precision);
+        visitor.visit("approximateGroups", approximateGroups);
         visitor.visit("classify", classify);
         visitor.visit("collect", collect);
     }
@@ -226,4 +226,20 @@ public class GroupTestCase {
         assertEquals(res, ref.getExpression());
         assertNotSame(res, ref.getExpression());
     }
+
+    @Test
+    public void requireThatApproximationErrorIsSerializedAndSummedOnMerge() {
+        Group group = new Group().setApproximationError(3);
+        BufferSerializer buf = new BufferSerializer();
+        group.serializeWithId(buf);
+        buf.flip();
+        Group copy = (Group)Identifiable.create(buf);
+        assertEquals(group, copy);
+        assertEquals(3, copy.getApproximationError(), 0);
+
+        copy.merge(0, 0, new Group().setApproximationError(2));
+        assertEquals(5, copy.getApproximationError(), 0);
+        copy.merge(0, 0, new Group());
+        assertEquals(5, copy.getApproximationError(), 0);
+    }
 }
@@ -441,7 +441,7 @@ makeDoc(const DocumentTypeRepo &repo, uint32_t i, bool extra_field, size_t numRe
 class VisitCacheStore {
 public:
     using UpdateStrategy=DocumentStore::Config::UpdateStrategy;
-    VisitCacheStore(UpdateStrategy strategy);
+    VisitCacheStore(UpdateStrategy strategy, uint32_t readAheadChunks = 4);
     ~VisitCacheStore();
     IDocumentStore & getStore() { return *_datastore; }
     void write(uint32_t id) {
@@ -520,12 +520,12 @@ VisitCacheStore::VerifyVisitor::~VerifyVisitor() {
 }
 
 
-VisitCacheStore::VisitCacheStore(UpdateStrategy strategy) :
+VisitCacheStore::VisitCacheStore(UpdateStrategy strategy, uint32_t readAheadChunks) :
     _myDir("visitcache"),
     _repo(makeDocTypeRepoConfig()),
     _config(DocumentStore::Config(CompressionConfig::LZ4, 1000000, 0)
                     .allowVisitCaching(true).updateStrategy(strategy),
-            LogDataStore::Config().setMaxFileSize(50000).setMaxBucketSpread(3.0)
+            LogDataStore::Config().setMaxFileSize(50000).setMaxBucketSpread(3.0).setReadAheadChunks(readAheadChunks)
                     .setFileConfig(WriteableFileChunk::Config(CompressionConfig(), 16_Ki))),
     _fileHeaderContext(),
     _executor(1, 128_Ki),
@@ -612,6 +612,25 @@ TEST("test the invalidate cache strategy") {
     TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 3, 1, 221));
 }
 
+void
+verifyVisitOfManyChunks(uint32_t readAheadChunks) {
+    VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE, readAheadChunks);
+    std::vector<uint32_t> lids;
+    for (uint32_t i(1); i <= 500; i++) {
+        vcs.write(i, 100);
+        lids.push_back(i);
+    }
+    vcs.recreate();
+    vcs.verifyVisit(lids, false);
+    vcs.verifyVisit({3, 250, 499}, false);
+}
+
+TEST("test that visiting documents spread across many chunks reads them all") {
+    TEST_DO(verifyVisitOfManyChunks(0));
+    TEST_DO(verifyVisitOfManyChunks(1));
+    TEST_DO(verifyVisitOfManyChunks(4));
+}
+
 TEST("test that the integrated visit cache works.") {
     VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE);
     IDocumentStore & ds = vcs.getStore();
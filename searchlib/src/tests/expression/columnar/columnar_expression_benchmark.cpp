@@ -0,0 +1,97 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/attribute/floatbase.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/expression/columnarexpression.h>
+#include <vespa/searchlib/expression/expressiontree.h>
+#include <vespa/searchlib/expression/attributenode.h>
+#include <vespa/searchlib/expression/constantnode.h>
+#include <vespa/searchlib/expression/addfunctionnode.h>
+#include <vespa/searchlib/expression/multiplyfunctionnode.h>
+#include <vespa/searchlib/expression/fixedwidthbucketfunctionnode.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <cstdio>
+
+using namespace search::expression;
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::IntegerAttribute;
+using search::FloatingPointAttribute;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using vespalib::BenchmarkTimer;
+
+namespace {
+
+constexpr uint32_t NUM_DOCS = 1000000;
+
+AttributeVector::SP
+makeAttribute(const vespalib::string & name, BasicType type)
+{
+    AttributeVector::SP attr = AttributeFactory::createAttribute(name, Config(type, CollectionType::SINGLE));
+    attr->addReservedDoc();
+    for (uint32_t i(1); i < NUM_DOCS; i++) {
+        uint32_t docId = 0;
+        attr->addDoc(docId);
+        int64_t v = (int64_t(i) * 7919) % 100003;
+        if (type == BasicType::DOUBLE) {
+            dynamic_cast<FloatingPointAttribute &>(*attr).update(docId, v * 0.25);
+        } else {
+            dynamic_cast<IntegerAttribute &>(*attr).update(docId, v);
+        }
+    }
+    attr->commit();
+    return attr;
+}
+
+// bucket(ints * 3 + floats, 100.0)
+ExpressionNode::UP
+makeExpression(const AttributeVector & ints, const AttributeVector & floats)
+{
+    auto mul = std::make_unique<MultiplyFunctionNode>();
+    mul->addArg(std::make_unique<AttributeNode>(ints)).addArg(std::make_unique<ConstantNode>(std::make_unique<Int64ResultNode>(3)));
+    auto add = std::make_unique<AddFunctionNode>();
+    add->addArg(std::move(mul)).addArg(std::make_unique<AttributeNode>(floats));
+    auto bucket = std::make_unique<FixedWidthBucketFunctionNode>(std::move(add));
+    bucket->setWidth(NumericResultNode::CP(new FloatResultNode(100.0)));
+    return bucket;
+}
+
+}
+
+int
+main(int, char **)
+{
+    AttributeVector::SP ints = makeAttribute("ints", BasicType::INT64);
+    AttributeVector::SP floats = makeAttribute("floats", BasicType::DOUBLE);
+    std::vector<uint32_t> docs;
+    for (uint32_t docId(1); docId < NUM_DOCS; docId++) {
+        docs.push_back(docId);
+    }
+    ExpressionTree tree(makeExpression(*ints, *floats));
+    tree.prepare(false);
+    ColumnarExpression::UP columnar = ColumnarExpression::compile(*tree.getRoot());
+    if (!columnar) {
+        fprintf(stderr, "expression could not be compiled\n");
+        return 1;
+    }
+    double sum = 0.0;
+    double interpreted = BenchmarkTimer::benchmark([&]() {
+            for (uint32_t docId : docs) {
+                tree.execute(docId, 0.0);
+                sum += tree.getResult().hash();
+            }
+        }, 5.0);
+    ColumnarExpression::Column column;
+    double vectorized = BenchmarkTimer::benchmark([&]() {
+            columnar->evaluate(docs.data(), docs.size(), column);
+            sum += column.floats[0];
+        }, 5.0);
+    fprintf(stderr, "interpreted: %10.3f ms (%5.1f ns/doc)\n", interpreted * 1000.0, interpreted * 1e9 / docs.size());
+    fprintf(stderr, "columnar:    %10.3f ms (%5.1f ns/doc)\n", vectorized * 1000.0, vectorized * 1e9 / docs.size());
+    fprintf(stderr, "speedup:     %10.2f x (checksum %g)\n", interpreted / vectorized, sum);
+    return 0;
+}
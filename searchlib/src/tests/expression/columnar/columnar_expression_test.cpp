@@ -0,0 +1,176 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/attribute/floatbase.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/expression/columnarexpression.h>
+#include <vespa/searchlib/expression/expressiontree.h>
+#include <vespa/searchlib/expression/attributenode.h>
+#include <vespa/searchlib/expression/constantnode.h>
+#include <vespa/searchlib/expression/addfunctionnode.h>
+#include <vespa/searchlib/expression/multiplyfunctionnode.h>
+#include <vespa/searchlib/expression/minfunctionnode.h>
+#include <vespa/searchlib/expression/maxfunctionnode.h>
+#include <vespa/searchlib/expression/negatefunctionnode.h>
+#include <vespa/searchlib/expression/fixedwidthbucketfunctionnode.h>
+#include <vespa/searchlib/expression/strlenfunctionnode.h>
+#include <vespa/vespalib/testkit/testapp.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("columnar_expression_test");
+
+using namespace search::expression;
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::IntegerAttribute;
+using search::FloatingPointAttribute;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+
+namespace {
+
+constexpr uint32_t NUM_DOCS = 1000;
+
+struct Fixture {
+    AttributeVector::SP ints;
+    AttributeVector::SP floats;
+    AttributeVector::SP array;
+    std::vector<uint32_t> docs;
+    Fixture();
+    ~Fixture();
+};
+
+Fixture::Fixture()
+    : ints(AttributeFactory::createAttribute("ints", Config(BasicType::INT64, CollectionType::SINGLE))),
+      floats(AttributeFactory::createAttribute("floats", Config(BasicType::DOUBLE, CollectionType::SINGLE))),
+      array(AttributeFactory::createAttribute("array", Config(BasicType::INT64, CollectionType::ARRAY))),
+      docs()
+{
+    auto & iattr = dynamic_cast<IntegerAttribute &>(*ints);
+    auto & fattr = dynamic_cast<FloatingPointAttribute &>(*floats);
+    auto & aattr = dynamic_cast<IntegerAttribute &>(*array);
+    for (AttributeVector * attr : { ints.get(), floats.get(), array.get() }) {
+        attr->addReservedDoc();
+    }
+    for (uint32_t i(1); i < NUM_DOCS; i++) {
+        uint32_t docId = 0;
+        ints->addDoc(docId);
+        floats->addDoc(docId);
+        array->addDoc(docId);
+        int64_t v = int64_t(i * 7919) % 2001 - 1000;
+        iattr.update(docId, v);
+        fattr.update(docId, v * 0.37);
+        aattr.append(docId, v, 1);
+        docs.push_back(docId);
+    }
+    iattr.update(NUM_DOCS / 2, std::numeric_limits<int64_t>::max());
+    iattr.update(NUM_DOCS / 3, std::numeric_limits<int64_t>::min() + 1);
+    for (AttributeVector * attr : { ints.get(), floats.get(), array.get() }) {
+        attr->commit();
+    }
+}
+
+Fixture::~Fixture() = default;
+
+ExpressionNode::UP attr(const AttributeVector & a) { return std::make_unique<AttributeNode>(a); }
+ExpressionNode::UP icons(int64_t v) { return std::make_unique<ConstantNode>(std::make_unique<Int64ResultNode>(v)); }
+ExpressionNode::UP fcons(double v) { return std::make_unique<ConstantNode>(std::make_unique<FloatResultNode>(v)); }
+
+template <typename T>
+ExpressionNode::UP op(ExpressionNode::UP a, ExpressionNode::UP b) {
+    auto node = std::make_unique<T>();
+    node->addArg(std::move(a)).addArg(std::move(b));
+    return node;
+}
+
+ExpressionNode::UP neg(ExpressionNode::UP a) { return std::make_unique<NegateFunctionNode>(std::move(a)); }
+
+ExpressionNode::UP bucket(ExpressionNode::UP a, NumericResultNode * width) {
+    auto node = std::make_unique<FixedWidthBucketFunctionNode>(std::move(a));
+    node->setWidth(NumericResultNode::CP(width));
+    return node;
+}
+
+void verify(const Fixture & f, ExpressionNode::UP root, ColumnarExpression::Type expectedType) {
+    ExpressionTree tree(std::move(root));
+    tree.prepare(false);
+    auto columnar = ColumnarExpression::compile(*tree.getRoot());
+    ASSERT_TRUE(columnar);
+    EXPECT_TRUE(columnar->type() == expectedType);
+    ColumnarExpression::Column column;
+    columnar->evaluate(f.docs.data(), f.docs.size(), column);
+    ResultNode::UP result(tree.getResult().clone());
+    for (size_t i(0); i < f.docs.size(); i++) {
+        tree.execute(f.docs[i], 0.0);
+        columnar->getResult(column, i, *result);
+        EXPECT_EQUAL(0, result->cmp(tree.getResult()));
+    }
+}
+
+void verifyNotSupported(ExpressionNode::UP root) {
+    ExpressionTree tree(std::move(root));
+    tree.prepare(false);
+    EXPECT_FALSE(ColumnarExpression::compile(*tree.getRoot()));
+}
+
+}
+
+using Type = ColumnarExpression::Type;
+
+TEST_F("require that integer expressions give same result as interpreted", Fixture) {
+    TEST_DO(verify(f, attr(*f.ints), Type::INTEGER));
+    TEST_DO(verify(f, op<AddFunctionNode>(attr(*f.ints), icons(17)), Type::INTEGER));
+    TEST_DO(verify(f, op<MultiplyFunctionNode>(attr(*f.ints), attr(*f.ints)), Type::INTEGER));
+    TEST_DO(verify(f, op<MinFunctionNode>(attr(*f.ints), icons(3)), Type::INTEGER));
+    TEST_DO(verify(f, op<MaxFunctionNode>(neg(attr(*f.ints)), icons(-3)), Type::INTEGER));
+}
+
+TEST_F("require that float and mixed expressions give same result as interpreted", Fixture) {
+    TEST_DO(verify(f, attr(*f.floats), Type::FLOAT));
+    TEST_DO(verify(f, op<AddFunctionNode>(attr(*f.ints), attr(*f.floats)), Type::FLOAT));
+    TEST_DO(verify(f, op<MultiplyFunctionNode>(attr(*f.floats), icons(3)), Type::FLOAT));
+    TEST_DO(verify(f, op<MinFunctionNode>(icons(1), fcons(0.5)), Type::FLOAT));
+    TEST_DO(verify(f, neg(op<MaxFunctionNode>(attr(*f.floats), fcons(-100.0))), Type::FLOAT));
+}
+
+TEST_F("require that bucket expressions give same result as interpreted", Fixture) {
+    TEST_DO(verify(f, bucket(attr(*f.ints), new Int64ResultNode(10)), Type::INTEGER_BUCKET));
+    TEST_DO(verify(f, bucket(op<AddFunctionNode>(attr(*f.ints), icons(5)), new Int64ResultNode(7)), Type::INTEGER_BUCKET));
+    TEST_DO(verify(f, bucket(attr(*f.ints), new Int64ResultNode(0)), Type::INTEGER_BUCKET));
+    TEST_DO(verify(f, bucket(attr(*f.floats), new FloatResultNode(2.5)), Type::FLOAT_BUCKET));
+    TEST_DO(verify(f, bucket(op<MultiplyFunctionNode>(attr(*f.ints), fcons(0.1)), new FloatResultNode(1.0)), Type::FLOAT_BUCKET));
+}
+
+TEST_F("require that unsupported expressions are not compiled", Fixture) {
+    TEST_DO(verifyNotSupported(attr(*f.array)));
+    TEST_DO(verifyNotSupported(op<AddFunctionNode>(attr(*f.ints), attr(*f.array))));
+    TEST_DO(verifyNotSupported(std::make_unique<StrLenFunctionNode>(attr(*f.ints))));
+}
+
+TEST_F("require that hit evaluator handles skipped and repeated hits", Fixture) {
+    ExpressionTree tree(op<AddFunctionNode>(attr(*f.ints), icons(1)));
+    tree.prepare(false);
+    auto columnar = ColumnarExpression::compile(*tree.getRoot());
+    ASSERT_TRUE(columnar);
+    ColumnarHitEvaluator hits(std::move(columnar), tree.getResult(), f.docs);
+    // Crosses several blocks, skipping every third hit and asking
+    // twice for every fifth.
+    for (size_t i(0); i < f.docs.size(); i++) {
+        if ((i % 3) == 1) {
+            continue;
+        }
+        size_t times = ((i % 5) == 0) ? 2 : 1;
+        for (size_t t(0); t < times; t++) {
+            const ResultNode * result = hits.getResult(f.docs[i]);
+            ASSERT_TRUE(result != nullptr);
+            tree.execute(f.docs[i], 0.0);
+            EXPECT_EQUAL(0, result->cmp(tree.getResult()));
+        }
+    }
+    EXPECT_TRUE(hits.getResult(f.docs[0]) == nullptr);
+    EXPECT_TRUE(hits.getResult(NUM_DOCS + 1) == nullptr);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -307,6 +307,63 @@ TEST("require that MatchData soft_reset retains appropriate state") {
     EXPECT_EQUAL(new_term->getDocId(), TermFieldMatchData::invalidId());
 }
 
+TEST("require that MatchData can keep positions for all term fields in one block") {
+    MatchData md(MatchData::params().numTermFields(3).positionsPerTermField(4));
+    TermFieldMatchData *t0 = md.resolveTermField(0);
+    TermFieldMatchData *t1 = md.resolveTermField(1);
+    TermFieldMatchData *t2 = md.resolveTermField(2);
+    EXPECT_EQUAL(4u, t0->capacity());
+    EXPECT_EQUAL(t0->begin() + 4, t1->begin());
+    EXPECT_EQUAL(t1->begin() + 4, t2->begin());
+    t1->reset(5);
+    for (uint32_t i = 0; i < 4; ++i) {
+        t1->appendPosition(TermFieldMatchDataPosition(0, i, 1, 10 + i));
+    }
+    EXPECT_EQUAL(4u, t1->size());
+    EXPECT_EQUAL(t0->begin() + 4, t1->begin());
+    EXPECT_EQUAL(13u, t1->getIterator().getFieldLength());
+    t1->appendPosition(TermFieldMatchDataPosition(0, 4, 1, 20));
+    EXPECT_EQUAL(5u, t1->size());
+    EXPECT_EQUAL(8u, t1->capacity());
+    EXPECT_NOT_EQUAL(t0->begin() + 4, t1->begin());
+    for (uint32_t i = 0; i < 5; ++i) {
+        EXPECT_EQUAL(i, t1->begin()[i].getPosition());
+    }
+    EXPECT_EQUAL(20u, t1->getIterator().getFieldLength());
+    TermFieldMatchData copy(*t1);
+    EXPECT_EQUAL(5u, copy.size());
+    t2->populate_fixed()->setElementWeight(21);
+    EXPECT_EQUAL(1u, t2->capacity());
+    EXPECT_EQUAL(21, t2->getWeight());
+}
+
+TEST("require that term fields give back block positions when used for other data") {
+    MatchData md(MatchData::params().numTermFields(4).positionsPerTermField(4));
+    TermFieldMatchData *raw = md.resolveTermField(0);
+    TermFieldMatchData *sub = md.resolveTermField(1);
+    TermFieldMatchData *unused = md.resolveTermField(2);
+    TermFieldMatchData *normal = md.resolveTermField(3);
+    EXPECT_EQUAL(0ULL, sub->getSubqueries());
+    raw->setRawScore(5, 42.0);
+    EXPECT_EQUAL(42.0, raw->getRawScore());
+    EXPECT_EQUAL(0ULL, raw->getSubqueries());
+    sub->setSubqueries(5, 0x1234);
+    EXPECT_EQUAL(0x1234ULL, sub->getSubqueries());
+    unused->tagAsNotNeeded();
+    EXPECT_EQUAL(1u, raw->capacity());
+    EXPECT_EQUAL(1u, sub->capacity());
+    EXPECT_EQUAL(1u, unused->capacity());
+    EXPECT_EQUAL(4u, normal->capacity());
+    normal->reset(5);
+    for (uint32_t i = 0; i < 4; ++i) {
+        normal->appendPosition(TermFieldMatchDataPosition(0, i, 1, 10));
+    }
+    EXPECT_EQUAL(42.0, raw->getRawScore());
+    EXPECT_EQUAL(0x1234ULL, sub->getSubqueries());
+    raw->setRawScore(6, 43.0);
+    EXPECT_EQUAL(43.0, raw->getRawScore());
+}
+
 TEST("require that compareWithExactness implements a strict weak ordering") {
    TermFieldMatchDataPosition a(0, 1, 100, 1);
    TermFieldMatchDataPosition b(0, 2, 100, 1);
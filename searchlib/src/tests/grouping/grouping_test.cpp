@@ -8,12 +8,16 @@
 #include <vespa/searchlib/aggregation/hitsaggregationresult.h>
 #include <vespa/searchlib/aggregation/fs4hit.h>
 #include <vespa/searchlib/aggregation/predicates.h>
+#include <vespa/searchlib/grouping/flatgroupingengine.h>
+#include <vespa/searchlib/expression/columnarexpression.h>
 #include <vespa/searchlib/expression/fixedwidthbucketfunctionnode.h>
 #include <vespa/searchlib/test/make_attribute_map_lookup_node.h>
+#include <vespa/vespalib/objects/nboserializer.h>
 #include <vespa/searchcommon/common/undefinedvalues.h>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <map>
 
 #include <vespa/log/log.h>
 LOG_SETUP("grouping_test");
@@ -169,6 +173,7 @@ public:
     void testAggregationGroupOrder();
     void testAggregationGroupRank();
     void testAggregationGroupCapping();
+    void testAggregationApproximateGroups();
     void testMergeSimpleSum();
     void testMergeLevels();
     void testMergeGroups();
@@ -185,6 +190,8 @@ public:
     void testThatNanIsConverted();
     void testNanSorting();
     void testAttributeMapLookup();
+    void testFlatGroupingEngine();
+    void testColumnarClassification();
     int Main() override;
 private:
     void testAggregationSimple(AggregationContext & ctx, const AggregationResult & aggr, const ResultNode & ir, const vespalib::string &name);
@@ -749,6 +756,102 @@ Test::testAggregationGroupCapping()
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+std::map<int64_t, uint64_t>
+countPerGroup(const Group &root)
+{
+    std::map<int64_t, uint64_t> result;
+    for (size_t i = 0; i < root.getChildrenSize(); ++i) {
+        const Group &child = root.getChild(i);
+        result[child.getId().getInteger()] = static_cast<const CountAggregationResult &>(child.getAggregationResult(0)).getCount();
+    }
+    return result;
+}
+
+}
+
+/**
+ * Verify that approximate grouping keeps at most the given number of
+ * groups per parent, that a group replacing another inherits its
+ * count, and that the parent reports how much the counts may be
+ * overestimated.
+ **/
+void
+Test::testAggregationApproximateGroups()
+{
+    AggregationContext ctx;
+    IntAttrBuilder attr("attr");
+    auto addHits = [&ctx, &attr](const std::vector<int64_t> & values) {
+        for (int64_t value : values) {
+            attr.add(value);
+            ctx.result().add(ctx.result().size(), 1);
+        }
+    };
+    // 5 and 6 dominate, 1 to 4 are seen once each
+    addHits({5, 6, 5, 6, 1, 5, 6, 2, 5, 6, 3, 5, 6, 4, 5});
+    // 8 is seen most, but 9 is seen last
+    addHits({7, 7, 8, 8, 8, 9, 9});
+    ctx.add(attr.sp());
+
+    auto makeRequest = [](int64_t maxGroups, uint32_t approximateGroups) {
+        Grouping request;
+        request.setFirstLevel(0)
+               .setLastLevel(1)
+               .addLevel(std::move(GroupingLevel().setMaxGroups(maxGroups).setApproximateGroups(approximateGroups)
+                                   .setExpression(MU<AttributeNode>("attr"))
+                                   .addAggregationResult(MU<CountAggregationResult>())
+                                   .addOrderBy(MU<AggregationRefNode>(0), false)));
+        return request;
+    };
+    double error = 0;
+    auto aggregate = [&ctx, &error](Grouping request, size_t firstHit, size_t numHits) {
+        ctx.setup(request);
+        request.aggregate(ctx.result().hits() + firstHit, numHits);
+        request.cleanupAttributeReferences();
+        error = request.getRoot().getApproximationError();
+        return countPerGroup(request.getRoot());
+    };
+
+    std::map<int64_t, uint64_t> exact = {{1, 1}, {2, 1}, {3, 1}, {4, 1}, {5, 6}, {6, 5}};
+    EXPECT_TRUE(exact == aggregate(makeRequest(-1, 0), 0, 15));
+    EXPECT_EQUAL(0.0, error);
+    // Each of the ids seen once replaces the previous one and inherits
+    // its count, so 4 is counted as 4 while only seen once.
+    std::map<int64_t, uint64_t> bounded = {{4, 4}, {5, 6}, {6, 5}};
+    EXPECT_TRUE(bounded == aggregate(makeRequest(-1, 3), 0, 15));
+    EXPECT_EQUAL(3.0, error);
+    std::map<int64_t, uint64_t> top = {{5, 6}, {6, 5}};
+    EXPECT_TRUE(top == aggregate(makeRequest(2, 0), 0, 15));
+    EXPECT_TRUE(top == aggregate(makeRequest(2, 3), 0, 15));
+    // All groups are kept when there is room for them.
+    EXPECT_TRUE(exact == aggregate(makeRequest(-1, 6), 0, 15));
+    EXPECT_EQUAL(0.0, error);
+
+    // 9 replaces 7 and is ranked by its overestimated count, within
+    // the error bound of its exact count.
+    std::map<int64_t, uint64_t> exactTop = {{8, 3}};
+    EXPECT_TRUE(exactTop == aggregate(makeRequest(1, 0), 15, 7));
+    std::map<int64_t, uint64_t> approximateTop = {{9, 4}};
+    EXPECT_TRUE(approximateTop == aggregate(makeRequest(1, 2), 15, 7));
+    EXPECT_EQUAL(2.0, error);
+
+    // The option and the error bound survive serialization.
+    Grouping request = makeRequest(-1, 2);
+    ctx.setup(request);
+    request.aggregate(ctx.result().hits() + 15, 7);
+    request.cleanupAttributeReferences();
+    nbostream stream;
+    NBOSerializer serializer(stream);
+    serializer << request;
+    Grouping copy;
+    NBOSerializer deserializer(stream);
+    deserializer >> copy;
+    EXPECT_EQUAL(2u, copy.getLevels()[0].getApproximateGroups());
+    EXPECT_EQUAL(2.0, copy.getRoot().getApproximationError());
+    EXPECT_TRUE(countPerGroup(request.getRoot()) == countPerGroup(copy.getRoot()));
+}
+
 /**
  * Test merging the sum of the values from a single attribute vector
  * that was collected directly into the root node. Consider this a
@@ -1948,6 +2051,110 @@ Test::testAttributeMapLookup()
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Verify that the flat grouping engine produces the same group tree
+ * as regular aggregation, also when partial results are merged.
+ **/
+void
+Test::testFlatGroupingEngine()
+{
+    AggregationContext ctx;
+    ctx.add(IntAttrBuilder("key").add(3).add(1).add(3).add(2).add(1).add(3).sp());
+    ctx.add(IntAttrBuilder("ival").add(10).add(20).add(30).add(40).add(50).add(60).sp());
+    ctx.add(FloatAttrBuilder("fval").add(0.5).add(1.5).add(2.5).add(3.5).add(4.5).add(5.5).sp());
+    ctx.add(IntArrayAttrBuilder("multi").add({1, 2}).add({3}).add({4}).add({5}).add({6}).add({7}).sp());
+    ctx.result().add(0, 5).add(1, 10).add(2, 15).add(3, 20).add(4, 25).add(5, 30);
+
+    GroupingLevel level;
+    level.setExpression(MU<AttributeNode>("key"));
+    level.addResult(CountAggregationResult());
+    level.addResult(SumAggregationResult().setExpression(MU<AttributeNode>("ival")));
+    level.addResult(SumAggregationResult().setExpression(MU<AttributeNode>("fval")));
+    Grouping request = Grouping().setFirstLevel(0).setLastLevel(1).addLevel(std::move(level));
+
+    Grouping expect = request;
+    ctx.setup(expect);
+    expect.aggregate(ctx.result().hits(), ctx.result().size());
+
+    Grouping flat = request;
+    ctx.setup(flat);
+    ASSERT_TRUE(grouping::FlatGroupingEngine::supports(flat));
+    {
+        grouping::FlatGroupingEngine engine(flat);
+        engine.aggregate(ctx.result().hits(), 2);
+        grouping::FlatGroupingEngine other(flat);
+        other.aggregate(ctx.result().hits() + 2, ctx.result().size() - 2);
+        engine.merge(other);
+        EXPECT_EQUAL(3u, engine.numGroups());
+        engine.fill(flat);
+    }
+    flat.cleanupAttributeReferences();
+    expect.cleanupAttributeReferences();
+    EXPECT_EQUAL(expect.getRoot().asString(), flat.getRoot().asString());
+
+    Grouping multi = Grouping().setFirstLevel(0).setLastLevel(1).addLevel(createGL(MU<AttributeNode>("multi")));
+    ctx.setup(multi);
+    EXPECT_FALSE(grouping::FlatGroupingEngine::supports(multi));
+    Grouping minAggr = Grouping().setFirstLevel(0).setLastLevel(1)
+                       .addLevel(std::move(GroupingLevel().setExpression(MU<AttributeNode>("key"))
+                                           .addResult(MinAggregationResult().setExpression(MU<AttributeNode>("ival")))));
+    ctx.setup(minAggr);
+    EXPECT_FALSE(grouping::FlatGroupingEngine::supports(minAggr));
+}
+
+/**
+ * Verify that aggregating hits with classifiers that compile to
+ * columnar expressions gives the same group tree as executing each
+ * classifier per document, also when mixed with levels that do not
+ * compile.
+ **/
+void
+Test::testColumnarClassification()
+{
+    const uint32_t numDocs = 600;
+    AggregationContext ctx;
+    IntAttrBuilder ikey("ikey");
+    FloatAttrBuilder fkey("fkey");
+    StringAttrBuilder skey("skey");
+    const char * strings[] = { "a", "b", "c" };
+    for (uint32_t i = 0; i < numDocs; ++i) {
+        int64_t v = int64_t(i * 7919) % 101 - 50;
+        ikey.add(v);
+        fkey.add(v * 0.25);
+        skey.add(strings[i % 3]);
+        ctx.result().add(i);
+    }
+    ctx.add(ikey.sp());
+    ctx.add(fkey.sp());
+    ctx.add(skey.sp());
+
+    auto add = MU<AddFunctionNode>();
+    add->addArg(MU<AttributeNode>("ikey")).addArg(MU<ConstantNode>(MU<Int64ResultNode>(3)));
+    auto ibucket = MU<FixedWidthBucketFunctionNode>(std::move(add));
+    ibucket->setWidth(Int64ResultNode(10));
+    auto fbucket = MU<FixedWidthBucketFunctionNode>(MU<AttributeNode>("fkey"));
+    fbucket->setWidth(FloatResultNode(2.5));
+    Grouping request = Grouping().setFirstLevel(0).setLastLevel(3)
+                       .addLevel(createGL(std::move(ibucket), MU<AttributeNode>("fkey")))
+                       .addLevel(createGL(MU<AttributeNode>("skey"), MU<AttributeNode>("ikey")))
+                       .addLevel(createGL(std::move(fbucket), MU<AttributeNode>("ikey")));
+
+    Grouping columnar = request;
+    ctx.setup(columnar);
+    EXPECT_TRUE(ColumnarExpression::compile(*columnar.levels()[0].getExpression().getRoot()));
+    EXPECT_FALSE(ColumnarExpression::compile(*columnar.levels()[1].getExpression().getRoot()));
+    EXPECT_TRUE(ColumnarExpression::compile(*columnar.levels()[2].getExpression().getRoot()));
+    columnar.aggregate(ctx.result().hits(), ctx.result().size());
+    columnar.cleanupAttributeReferences();
+
+    Grouping interpreted = request;
+    ctx.setup(interpreted);
+    interpreted.aggregate(DocId(0), DocId(numDocs));
+    interpreted.cleanupAttributeReferences();
+
+    EXPECT_EQUAL(interpreted.getRoot().asString(), columnar.getRoot().asString());
+}
+
 struct RunDiff { ~RunDiff() { system("diff -u lhs.out rhs.out > diff.txt"); }};
 
 //-----------------------------------------------------------------------------
@@ -1965,6 +2172,7 @@ Test::Main()
     testAggregationGroupOrder();
     testAggregationGroupRank();
     testAggregationGroupCapping();
+    TEST_DO(testAggregationApproximateGroups());
     testMergeSimpleSum();
     testMergeLevels();
     testMergeGroups();
@@ -1979,6 +2187,8 @@ Test::Main()
     testThatNanIsConverted();
     testNanSorting();
     testAttributeMapLookup();
+    TEST_DO(testFlatGroupingEngine());
+    TEST_DO(testColumnarClassification());
     TEST_DONE();
 }
 
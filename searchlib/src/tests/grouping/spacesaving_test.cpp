@@ -0,0 +1,148 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+// Unit tests for spacesaving.
+
+#include <vespa/log/log.h>
+LOG_SETUP("spacesaving_test");
+
+#include <vespa/searchlib/grouping/spacesaving.h>
+#include <vespa/vespalib/objects/nboserializer.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <map>
+
+using vespalib::NBOSerializer;
+using vespalib::nbostream;
+using namespace search;
+
+namespace {
+
+using Summary = SpaceSaving<uint64_t, uint64_t>;
+using Exact = std::map<uint64_t, uint64_t>;
+
+// Skewed stream: key k (1-based) occurs about n/k times.
+void fill(Summary &summary, Exact &exact, size_t n, uint64_t keyOffset) {
+    for (uint64_t k = 1; k <= n; ++k) {
+        for (uint64_t i = 0; i < n / k; ++i) {
+            uint64_t key = (k == 1 || (i % 3) != 0) ? k : k + n;
+            summary.aggregate(key + keyOffset);
+            exact[key + keyOffset]++;
+        }
+    }
+}
+
+void checkBounds(const Summary &summary, const Exact &exact) {
+    uint64_t total = 0;
+    for (const auto &entry : exact) {
+        total += entry.second;
+    }
+    EXPECT_EQUAL(total, summary.getTotal());
+    EXPECT_LESS_EQUAL(summary.getMaxError(), total / summary.getCapacity());
+    auto top = summary.getTop(summary.getCapacity());
+    for (const auto &counter : top) {
+        uint64_t actual = exact.count(counter.key) ? exact.find(counter.key)->second : 0;
+        EXPECT_GREATER_EQUAL(counter.count, actual);
+        EXPECT_LESS_EQUAL(counter.lowerBound(), actual);
+        EXPECT_LESS_EQUAL(counter.error, summary.getMaxError());
+    }
+    for (const auto &entry : exact) {
+        if (entry.second > summary.getMaxError()) {
+            bool found = false;
+            for (const auto &counter : top) {
+                found = found || (counter.key == entry.first);
+            }
+            EXPECT_TRUE(found);
+        }
+    }
+}
+
+TEST("require that counts are exact below capacity") {
+    Summary summary(11);
+    for (uint64_t i = 0; i < 10; ++i) {
+        for (uint64_t j = 0; j <= i; ++j) {
+            summary.aggregate(i);
+        }
+    }
+    EXPECT_EQUAL(10u, summary.getSize());
+    EXPECT_EQUAL(0u, summary.getMaxError());
+    auto top = summary.getTop(3);
+    ASSERT_EQUAL(3u, top.size());
+    EXPECT_EQUAL(9u, top[0].key);
+    EXPECT_EQUAL(10u, top[0].count);
+    EXPECT_EQUAL(0u, top[0].error);
+    EXPECT_EQUAL(8u, top[1].key);
+    EXPECT_EQUAL(7u, top[2].key);
+}
+
+TEST("require that weighted aggregation tracks top sums") {
+    Summary summary(2);
+    summary.aggregate(1, 100);
+    summary.aggregate(2, 5);
+    summary.aggregate(3, 7);
+    summary.aggregate(1, 50);
+    auto top = summary.getTop(1);
+    ASSERT_EQUAL(1u, top.size());
+    EXPECT_EQUAL(1u, top[0].key);
+    EXPECT_EQUAL(150u, top[0].count);
+    EXPECT_EQUAL(162u, summary.getTotal());
+}
+
+TEST("require that error bounds hold with bounded memory") {
+    Summary summary(50);
+    Exact exact;
+    fill(summary, exact, 1000, 0);
+    EXPECT_EQUAL(50u, summary.getSize());
+    EXPECT_GREATER(exact.size(), 1000u);
+    TEST_DO(checkBounds(summary, exact));
+    EXPECT_EQUAL(1u, summary.getTop(1)[0].key);
+}
+
+TEST("require that merged summaries keep error bounds") {
+    Summary a(50);
+    Summary b(50);
+    Exact exact;
+    fill(a, exact, 800, 0);
+    fill(b, exact, 600, 3);
+    a.merge(b);
+    EXPECT_EQUAL(50u, a.getSize());
+    TEST_DO(checkBounds(a, exact));
+}
+
+TEST("require that summaries can be (de)serialized") {
+    Summary summary(20);
+    Exact exact;
+    fill(summary, exact, 200, 0);
+    nbostream stream;
+    NBOSerializer serializer(stream);
+    summary.serialize(serializer);
+    Summary copy(1);
+    copy.deserialize(serializer);
+    EXPECT_EQUAL(summary.getCapacity(), copy.getCapacity());
+    EXPECT_EQUAL(summary.getTotal(), copy.getTotal());
+    EXPECT_EQUAL(summary.getMaxError(), copy.getMaxError());
+    auto expect = summary.getTop(20);
+    auto actual = copy.getTop(20);
+    ASSERT_EQUAL(expect.size(), actual.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+        EXPECT_EQUAL(expect[i].key, actual[i].key);
+        EXPECT_EQUAL(expect[i].count, actual[i].count);
+        EXPECT_EQUAL(expect[i].error, actual[i].error);
+    }
+}
+
+}  // namespace
+
+TEST("require that malformed summaries are rejected before allocating") {
+    nbostream stream;
+    NBOSerializer serializer(stream);
+    serializer << uint32_t(Summary::MAX_CAPACITY + 1) << uint64_t(0) << uint32_t(0xffffffff);
+    Summary copy(1);
+    EXPECT_EXCEPTION(copy.deserialize(serializer), std::runtime_error, "Invalid space-saving summary");
+
+    nbostream small;
+    NBOSerializer smallSerializer(small);
+    smallSerializer << uint32_t(10) << uint64_t(0) << uint32_t(11);
+    EXPECT_EXCEPTION(copy.deserialize(smallSerializer), std::runtime_error, "Invalid space-saving summary");
+    EXPECT_EQUAL(1u, copy.getCapacity());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
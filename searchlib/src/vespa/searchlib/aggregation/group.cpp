@@ -7,10 +7,12 @@
 
 #include <vespa/vespalib/objects/objectdumper.h>
 #include <vespa/vespalib/objects/visit.hpp>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/stllike/hash_set.hpp>
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <functional>
 
 namespace search::aggregation {
 
@@ -50,6 +52,16 @@ destruct(Group::GroupList & l, size_t m)
 
 IMPLEMENT_IDENTIFIABLE_NS2(search, aggregation, Group, vespalib::Identifiable);
 
+struct Group::Value::ChildMap {
+    using Counter = std::pair<double, uint32_t>; // value last seen, index of the child
+    ChildMap(size_t size, const GroupList * children)
+        : groups(size, GroupHasher(children), GroupEqual(children)),
+          counters()
+    { }
+    GroupHash            groups;
+    std::vector<Counter> counters; // min-heap of the kept children when approximating
+};
+
 int
 Group::cmpRank(const Group &rhs) const
 {
@@ -85,6 +97,11 @@ template <typename Doc>
 void
 Group::groupNext(const GroupingLevel & level, const Doc & doc, HitRank rank)
 {
+    const ResultNode * columnarResult = level.getColumnarResult(doc);
+    if (columnarResult != nullptr) {
+        level.group(*this, *columnarResult, doc, rank);
+        return;
+    }
     const ExpressionTree &selector = level.getExpression();
     if (!selector.execute(doc, rank)) {
         throw std::runtime_error("Does not know how to handle failed select statements");
@@ -98,9 +115,12 @@ Group::Value::groupSingle(const ResultNode & selectResult, HitRank rank, const G
 {
     if (_childInfo._childMap == nullptr) {
         assert(getChildrenSize() == 0);
-        _childInfo._childMap = new GroupHash(1, GroupHasher(&_children), GroupEqual(&_children));
+        _childInfo._childMap = new ChildMap(1, &_children);
+    }
+    if (level.approximates() && ((getChildrenSize() == 0) || !_childInfo._childMap->counters.empty())) {
+        return groupApproximate(selectResult, rank, level);
     }
-    GroupHash & childMap = *_childInfo._childMap;
+    GroupHash & childMap = _childInfo._childMap->groups;
     Group * group(nullptr);
     GroupHash::iterator found = childMap.find(selectResult);
     if (found == childMap.end()) { // group not present in child map
@@ -120,6 +140,58 @@ Group::Value::groupSingle(const ResultNode & selectResult, HitRank rank, const G
     return group;
 }
 
+Group *
+Group::Value::groupApproximate(const ResultNode & selectResult, HitRank rank, const GroupingLevel & level)
+{
+    ChildMap & childMap = *_childInfo._childMap;
+    GroupHash::iterator found = childMap.groups.find(selectResult);
+    if (found != childMap.groups.end()) {
+        Group * group = _children[(*found)];
+        group->updateRank(rank);
+        return group;
+    }
+    std::vector<ChildMap::Counter> & counters = childMap.counters;
+    std::greater<ChildMap::Counter> lowest;
+    Group * group = new Group(level.getGroupPrototype());
+    group->setId(selectResult);
+    group->setRank(rank);
+    uint32_t slot;
+    if (getChildrenSize() < level.getApproximateGroups()) {
+        addChild(group);
+        slot = getChildrenSize() - 1;
+        counters.emplace_back(0.0, slot);
+    } else {
+        // Space-Saving: the new group replaces the kept group with the
+        // lowest value. Counters hold the values last seen, which the
+        // current values never go below, so refresh until the lowest
+        // counter is current.
+        std::pop_heap(counters.begin(), counters.end(), lowest);
+        for (;;) {
+            ChildMap::Counter & counter = counters.back();
+            double value = _children[counter.second]->_aggr.getFirstOrderByValue();
+            if ( ! (value > counter.first)) {
+                break;
+            }
+            counter.first = value;
+            std::push_heap(counters.begin(), counters.end(), lowest);
+            std::pop_heap(counters.begin(), counters.end(), lowest);
+        }
+        slot = counters.back().second;
+        Group * replaced = _children[slot];
+        // The hits of the new group may have been counted in the
+        // replaced group, so it takes over its aggregates.
+        group->_aggr.mergeCollectors(replaced->_aggr);
+        _approxError = std::max(_approxError, float(counters.back().first));
+        childMap.groups.erase(slot);
+        replaced->postAggregate();
+        destruct(replaced);
+        _children[slot] = group;
+    }
+    std::push_heap(counters.begin(), counters.end(), lowest);
+    childMap.groups.insert(slot);
+    return group;
+}
+
 void
 Group::merge(const GroupingLevelList &levels, uint32_t firstLevel, uint32_t currentLevel, Group &b) {
     bool frozen = (currentLevel < firstLevel);    // is this level frozen ?
@@ -215,6 +287,15 @@ Group::partialCopy(const Group & rhs) {
 template void Group::aggregate(const Grouping & grouping, uint32_t currentLevel, const DocId & doc, HitRank rank);
 template void Group::aggregate(const Grouping & grouping, uint32_t currentLevel, const document::Document & doc, HitRank rank);
 
+double
+Group::Value::getFirstOrderByValue()
+{
+    ExpressionNode & e(expr(std::abs(getOrderBy(0)) - 1));
+    e.prepare(false);
+    e.execute();
+    return e.getResult().getFloat();
+}
+
 int
 Group::Value::cmp(const Value & rhs) const {
     int diff(0);
@@ -316,8 +397,8 @@ void
 Group::Value::preAggregate()
 {
     assert(_childInfo._childMap == nullptr);
-    _childInfo._childMap = new GroupHash(getChildrenSize()*2, GroupHasher(&_children), GroupEqual(&_children));
-    GroupHash & childMap = *_childInfo._childMap;
+    _childInfo._childMap = new ChildMap(getChildrenSize()*2, &_children);
+    GroupHash & childMap = _childInfo._childMap->groups;
     for (ChildP *it(_children), *mt(_children + getChildrenSize()); it != mt; ++it) {
         (*it)->preAggregate();
         childMap.insert(it - _children);
@@ -369,6 +450,7 @@ Group::Value::execute() {
 
 void
 Group::Value::mergeLevel(const Group & protoType, const Value & b) {
+    _approxError = b._approxError;
     for (ChildP *it(b._children), *mt(b._children + b.getChildrenSize()); it != mt; ++it) {
         auto g(new Group(protoType));
         g->partialCopy(**it);
@@ -380,6 +462,8 @@ void
 Group::Value::merge(const std::vector<GroupingLevel> &levels,
                     uint32_t firstLevel, uint32_t currentLevel, const Value &b)
 {
+    // groups kept on only one side may lack up to the other side's error
+    _approxError += b._approxError;
     auto z = new ChildP[getChildrenSize() + b.getChildrenSize()];
     size_t kept(0);
     ChildP * px = _children;
@@ -450,6 +534,8 @@ void
 Group::Value::mergePartial(const GroupingLevelList &levels, uint32_t firstLevel, uint32_t lastLevel,
                            uint32_t currentLevel, const Value & b)
 {
+    // b is the result of a single node, this may already hold the bound of the merged results
+    _approxError = std::max(_approxError, b._approxError);
     ChildP * px = _children;
     ChildP * ex = _children + getChildrenSize();
     const ChildP * py = b._children;
@@ -521,7 +607,11 @@ Group::Value::assertIdOrder() const {
 
 Serializer &
 Group::Value::serialize(Serializer & os) const {
-
+    if (_approxError > 0) {
+        os << uint8_t(1) << double(_approxError);
+    } else {
+        os << uint8_t(0);
+    }
     os << uint32_t(getOrderBySize());
     for (size_t i(0), m(getOrderBySize()); i < m; i++) {
         os << int32_t(getOrderBy(i));
@@ -543,6 +633,13 @@ Group::Value::serialize(Serializer & os) const {
 
 Deserializer &
 Group::Value::deserialize(Deserializer & is) {
+    uint8_t approximated(0);
+    is >> approximated;
+    double approxError(0);
+    if (approximated != 0) {
+        is >> approxError;
+    }
+    _approxError = approxError;
     uint32_t count(0);
     is >> count;
     assert(count < sizeof(_orderBy)*2);
@@ -626,6 +723,7 @@ Group::Value::visitMembers(vespalib::ObjectVisitor &visitor) const {
     }
     visitor.closeStruct();
     visit(visitor, "tag",                   _tag);
+    visit(visitor, "approximationError",    _approxError);
 }
 
 Group::Value::Value() :
@@ -635,7 +733,8 @@ Group::Value::Value() :
     _childrenLength(0),
     _tag(-1),
     _packedLength(0),
-    _orderBy()
+    _orderBy(),
+    _approxError(0)
 {
     memset(_orderBy, 0, sizeof(_orderBy));
     _childInfo._childMap = nullptr;
@@ -648,7 +747,8 @@ Group::Value::Value(const Value & rhs) :
     _childrenLength(rhs._childrenLength),
     _tag(rhs._tag),
     _packedLength(rhs._packedLength),
-    _orderBy()
+    _orderBy(),
+    _approxError(rhs._approxError)
 {
     _childInfo._childMap = nullptr;
     memcpy(_orderBy, rhs._orderBy, sizeof(_orderBy));
@@ -677,7 +777,8 @@ Group::Value::Value(Value && rhs) noexcept :
     _childrenLength(rhs._childrenLength),
     _tag(rhs._tag),
     _packedLength(rhs._packedLength),
-    _orderBy()
+    _orderBy(),
+    _approxError(rhs._approxError)
 {
     memcpy(_orderBy, rhs._orderBy, sizeof(_orderBy));
 
@@ -692,6 +793,7 @@ Group::Value::operator =(Value && rhs) noexcept {
     _childrenLength = rhs._childrenLength;
     _tag = rhs._tag;
     _packedLength = rhs._packedLength;
+    _approxError = rhs._approxError;
     _aggregationResults = rhs._aggregationResults;
     _children = rhs._children;
     _childInfo = rhs._childInfo;
@@ -734,6 +836,7 @@ Group::Value::swap(Value & rhs)
     std::swap(_childrenLength, rhs._childrenLength);
     std::swap(_tag, rhs._tag);
     std::swap(_packedLength, rhs._packedLength);
+    std::swap(_approxError, rhs._approxError);
 }
 
 
@@ -27,9 +27,10 @@ class Grouping;
  * | orderby vector                      | 2               |
  * | sub group vector                    | 8               |
  * | sub group vector size/temp hash map | 8               |
+ * | approximation error bound           | 4               |
  * +-------------------------------------+-----------------+
  *
- * Total: 50 bytes
+ * Total: 54 bytes
  */
 class Group : public vespalib::Identifiable
 {
@@ -95,7 +96,10 @@ private:
         void prune(const Value & b, uint32_t lastLevel, uint32_t currentLevel);
         void postMerge(const std::vector<GroupingLevel> &levels, uint32_t firstLevel, uint32_t currentLevel);
         void partialCopy(const Value & rhs);
+        double getApproximationError() const { return _approxError; }
         VESPA_DLL_LOCAL Group * groupSingle(const ResultNode & selectResult, HitRank rank, const GroupingLevel & level);
+        VESPA_DLL_LOCAL Group * groupApproximate(const ResultNode & selectResult, HitRank rank, const GroupingLevel & level);
+        VESPA_DLL_LOCAL double getFirstOrderByValue();
 
         GroupList groups() const { return _children; }
         void addChild(Group * child);
@@ -119,6 +123,7 @@ private:
 
         using  ExpressionVector = ExpressionNode::CP *;
         using GroupHash = vespalib::hash_set<uint32_t, GroupHasher, GroupEqual >;
+        struct ChildMap;
         void setAggrSize(uint32_t v)    { _packedLength = (_packedLength & ~0x0f) | v; }
         void setExprSize(uint32_t v)    { _packedLength = (_packedLength & ~0x30) | (v << 4); }
         void setOrderBySize(uint32_t v) { _packedLength = (_packedLength & ~0xc0) | (v << 6); }
@@ -146,13 +151,14 @@ private:
 
         ChildP          *_children;             // the sub-groups of this group. Great care must be taken to ensure proper destruct.
         union ChildInfo {
-            GroupHash *_childMap;               // child map used during aggregation
+            ChildMap  *_childMap;               // child map used during aggregation
             size_t     _allChildren;            // Keep real number of children.
         }                _childInfo;
         uint32_t         _childrenLength;
         uint32_t         _tag;             // Opaque tag used to identify the group by the client.
         uint8_t          _packedLength;    // Length of aggr and expr vectors.
         uint8_t          _orderBy[2];           // How this group is ranked, negative means reverse rank.
+        float            _approxError;          // Error bound of the children when approximating, see Group.
     };
 
     ResultNode::CP   _id;                   // the label of this group, separating it from other groups
@@ -184,6 +190,15 @@ public:
         return _aggr.groupSingle(result, rank, level);
     }
 
+    /**
+     * How much the values ordering the children (such as count()) may
+     * differ from their exact values because the next level was
+     * grouped approximately (see GroupingLevel::setApproximateGroups).
+     * Children that were dropped have no exact value above this. 0
+     * when all groups were kept.
+     **/
+    double getApproximationError() const { return _aggr.getApproximationError(); }
+
     bool hasId() const { return static_cast<bool>(_id); }
     const ResultNode &getId() const { return *_id; }
 
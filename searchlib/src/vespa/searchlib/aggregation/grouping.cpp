@@ -221,14 +221,30 @@ void Grouping::aggregate(const RankedHit * rankedHit, unsigned int len)
     preAggregate(isOrdered);
     HitsAggregationResult::SetOrdered pred;
     select(pred, pred);
+    prepareColumnar(rankedHit, getMaxN(len));
     if (_clock == NULL) {
         aggregateWithoutClock(rankedHit, getMaxN(len));
     } else {
         aggregateWithClock(rankedHit, getMaxN(len));
     }
+    for (GroupingLevel & level : _levels) {
+        level.clearColumnar();
+    }
     postProcess();
 }
 
+void Grouping::prepareColumnar(const RankedHit * rankedHit, unsigned int len)
+{
+    std::vector<DocId> docs;
+    docs.reserve(len);
+    for (unsigned int i(0); i < len; i++) {
+        docs.push_back(rankedHit[i]._docId);
+    }
+    for (GroupingLevel & level : _levels) {
+        level.prepareColumnar(docs);
+    }
+}
+
 void Grouping::aggregate(const RankedHit * rankedHit, unsigned int len, const BitVector * bVec)
 {
     preAggregate(false);
@@ -36,6 +36,7 @@ private:
     bool hasExpired() const { return _clock->getTimeNS() > _timeOfDoom; }
     void aggregateWithoutClock(const RankedHit * rankedHit, unsigned int len);
     void aggregateWithClock(const RankedHit * rankedHit, unsigned int len);
+    void prepareColumnar(const RankedHit * rankedHit, unsigned int len);
     void postProcess();
 public:
     DECLARE_IDENTIFIABLE_NS2(search, aggregation, Grouping);
@@ -71,6 +72,7 @@ public:
     const GroupingLevelList &getLevels() const { return _levels; }
     const Group &getRoot()   const { return _root; }
     bool needResort() const;
+    bool expired() const { return (_clock != nullptr) && hasExpired(); }
 
     GroupingLevelList &levels() { return _levels; }
     Group &root() { return _root; }
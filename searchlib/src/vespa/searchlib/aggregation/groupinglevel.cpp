@@ -2,10 +2,13 @@
 
 #include "groupinglevel.h"
 #include "grouping.h"
+#include <vespa/searchlib/expression/columnarexpression.h>
 #include <vespa/searchlib/expression/resultvector.h>
 
 namespace search::aggregation {
 
+using expression::ColumnarExpression;
+using expression::ColumnarHitEvaluator;
 using expression::ResultNodeVector;
 using vespalib::Serializer;
 using vespalib::Deserializer;
@@ -17,9 +20,12 @@ GroupingLevel::GroupingLevel() :
     _precision(-1),
     _isOrdered(false),
     _frozen(false),
+    _approximateGroups(0),
+    _approximate(false),
     _classify(),
     _collect(),
-    _grouper(NULL)
+    _grouper(NULL),
+    _columnar()
 { }
 
 GroupingLevel::~GroupingLevel() = default;
@@ -30,13 +36,13 @@ GroupingLevel & GroupingLevel::operator =(const GroupingLevel &) = default;
 Serializer &
 GroupingLevel::onSerialize(Serializer & os) const
 {
-    return os << _maxGroups << _precision << _classify << _collect;
+    return os << _maxGroups << _precision << _approximateGroups << _classify << _collect;
 }
 
 Deserializer &
 GroupingLevel::onDeserialize(Deserializer & is)
 {
-    return is >> _maxGroups >> _precision >> _classify >> _collect;
+    return is >> _maxGroups >> _precision >> _approximateGroups >> _classify >> _collect;
 }
 
 void
@@ -44,6 +50,7 @@ GroupingLevel::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
     visit(visitor, "maxGroups", _maxGroups);
     visit(visitor, "precision", _precision);
+    visit(visitor, "approximateGroups", _approximateGroups);
     visit(visitor, "classify",  _classify);
     visit(visitor, "collect",   _collect);
 }
@@ -96,6 +103,10 @@ void GroupingLevel::prepare(const Grouping * grouping, uint32_t level, bool isOr
 {
     _isOrdered = isOrdered_;
     _frozen = level < grouping->getFirstLevel();
+    // values are only known when collecting into the groups, and only descending orders keep the largest
+    _approximate = (_approximateGroups > 0) && !_isOrdered && !_frozen && (level < grouping->getLastLevel()) &&
+                   (_collect.getOrderBySize() > 0) && (_collect.getOrderBy(0) < 0);
+    _columnar.reset();
     if (_classify.getResult().inherits(ResultNodeVector::classId)) {
        _grouper.reset(new MultiValueGrouper(grouping, level));
     } else {
@@ -103,6 +114,24 @@ void GroupingLevel::prepare(const Grouping * grouping, uint32_t level, bool isOr
     }
 }
 
+void GroupingLevel::prepareColumnar(const std::vector<DocId> & docs)
+{
+    _columnar.reset();
+    ExpressionNode * root = _classify.getRoot();
+    if (root == nullptr) {
+        return;
+    }
+    ColumnarExpression::UP expr = ColumnarExpression::compile(*root);
+    if (expr) {
+        _columnar = std::make_shared<ColumnarHitEvaluator>(std::move(expr), _classify.getResult(), docs);
+    }
+}
+
+const expression::ResultNode * GroupingLevel::getColumnarResult(DocId docId) const
+{
+    return _columnar ? _columnar->getResult(docId) : nullptr;
+}
+
 // template<> void GroupingLevel::MultiValueGrouper::groupDoc(Group & g, const ResultNode::CP & result, const document::Document & doc, HitRank rank, bool isOrdered) const;
 // template<> void GroupingLevel::MultiValueGrouper::groupDoc(Group & g, const ResultNode::CP & result, DocId doc, HitRank rank, bool isOrdered) const;
 
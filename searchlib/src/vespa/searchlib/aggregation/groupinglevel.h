@@ -4,6 +4,8 @@
 #include "group.h"
 #include <vespa/searchlib/expression/aggregationrefnode.h>
 
+namespace search::expression { class ColumnarHitEvaluator; }
+
 namespace search::aggregation {
 
 class Grouping;
@@ -71,10 +73,13 @@ private:
     int64_t        _precision;
     bool           _isOrdered;
     bool           _frozen;
+    uint32_t       _approximateGroups;
+    bool           _approximate;       // whether groups are approximated in the current aggregation
     ExpressionTree _classify;
     Group          _collect;
 
     vespalib::CloneablePtr<Grouper>    _grouper;
+    std::shared_ptr<expression::ColumnarHitEvaluator> _columnar; // classifier values for the current hits, if compiled
 public:
     GroupingLevel();
     GroupingLevel(GroupingLevel &&) noexcept = default;
@@ -96,6 +101,16 @@ public:
     }
     GroupingLevel & freeze() { _frozen = true; return *this; }
     GroupingLevel &setPresicion(int64_t precision) { _precision = precision; return *this; }
+    /**
+     * Bound the number of groups kept per parent to the given number
+     * when the groups are ordered by a descending expression, such as
+     * -count() or -sum(), that does not decrease as hits are added (0
+     * keeps all groups). Following Space-Saving, a new group replaces
+     * the kept group with the lowest value and inherits its
+     * aggregates, so values are overestimated by at most the error
+     * bound reported by the parent (Group::getApproximationError).
+     **/
+    GroupingLevel &setApproximateGroups(uint32_t maxGroups) { _approximateGroups = maxGroups; return *this; }
     GroupingLevel &setExpression(ExpressionNode::UP root) { _classify = std::move(root); return *this; }
     GroupingLevel &addResult(ExpressionNode::UP result) { _collect.addResult(std::move(result)); return *this; }
     GroupingLevel &addResult(const ExpressionNode & result) { return addResult(ExpressionNode::UP(result.clone())); }
@@ -106,11 +121,23 @@ public:
     int64_t getMaxGroups() const { return _maxGroups; }
     int64_t getPrecision() const { return _precision; }
     bool        isFrozen() const { return _frozen; }
+    bool       isOrdered() const { return _isOrdered; }
+    uint32_t getApproximateGroups() const { return _approximateGroups; }
+    bool approximates() const { return _approximate; }
     bool    allowMoreGroups(size_t sz) const { return (!_frozen && (!_isOrdered || (sz < (uint64_t)_precision))); }
     const ExpressionTree & getExpression() const { return _classify; }
     ExpressionTree & getExpression() { return _classify; }
     const       Group &getGroupPrototype() const { return _collect; }
     void prepare(const Grouping * grouping, uint32_t level, bool isOrdered_);
+    /**
+     * Set up block evaluation of the classifier for the given hits, if
+     * it can be compiled to a columnar expression. Cleared by prepare()
+     * and clearColumnar().
+     **/
+    void prepareColumnar(const std::vector<DocId> & docs);
+    void clearColumnar() { _columnar.reset(); }
+    const ResultNode * getColumnarResult(DocId docId) const;
+    const ResultNode * getColumnarResult(const document::Document &) const { return nullptr; }
 
     Group &groupPrototype() { return _collect; }
     const Group & groupPrototype() const { return _collect; }
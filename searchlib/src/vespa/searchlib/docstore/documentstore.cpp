@@ -5,7 +5,9 @@
 #include "visitcache.h"
 #include "ibucketizer.h"
 #include "value.h"
+#include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/vespalib/stllike/cache.hpp>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/compressor.h>
@@ -39,6 +41,15 @@ void
 DocumentVisitorAdapter::visit(uint32_t lid, vespalib::ConstBufferRef buf) {
     if (buf.size() > 0) {
         vespalib::nbostream is(buf.c_str(), buf.size());
+        if (_visitor.onlyDocumentId()) {
+            document::DocumentId id = document::Document::getIdFromSerialized(is);
+            const document::DocumentType * type = _repo.getDocumentType(id.getDocType());
+            if (type != nullptr) {
+                _visitor.visit(lid, std::make_unique<document::Document>(*type, std::move(id)));
+                return;
+            }
+            is.rp(0);
+        }
         _visitor.visit(lid, std::make_unique<document::Document>(_repo, is));
     }
 }
@@ -15,6 +15,8 @@
 #include <vespa/vespalib/util/array.hpp>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/fastos/file.h>
+#include <deque>
+#include <functional>
 #include <future>
 
 #include <vespa/log/log.h>
@@ -363,31 +365,112 @@ FileChunk::appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWr
     dest.close();
 }
 
+namespace {
+
+/**
+ * Reads and decompresses chunks on an executor ahead of the thread visiting
+ * them, so that disk reads and decompression of the next chunks overlap with
+ * deserialization of the current one. At most depth chunks are in flight or
+ * waiting to be visited.
+ */
+class ChunkReadAhead {
+public:
+    using ReadChunk = std::function<std::unique_ptr<Chunk>(size_t)>;
+    ChunkReadAhead(vespalib::Executor & executor, size_t numChunks, size_t depth, ReadChunk readChunk)
+        : _executor(executor),
+          _readChunk(std::move(readChunk)),
+          _numChunks(numChunks),
+          _nextToRead(0),
+          _pending()
+    {
+        while ((_nextToRead < _numChunks) && (_pending.size() < depth)) {
+            readAhead();
+        }
+    }
+    ~ChunkReadAhead() {
+        // Outstanding tasks refer to us.
+        for (const auto & chunk : _pending) {
+            chunk.wait();
+        }
+    }
+    std::unique_ptr<Chunk> next() {
+        std::future<std::unique_ptr<Chunk>> chunk = std::move(_pending.front());
+        _pending.pop_front();
+        if (_nextToRead < _numChunks) {
+            readAhead();
+        }
+        return chunk.get();
+    }
+private:
+    void readAhead() {
+        std::promise<std::unique_ptr<Chunk>> promise;
+        _pending.push_back(promise.get_future());
+        auto task = vespalib::makeLambdaTask([this, id = _nextToRead++, promise = std::move(promise)]() mutable {
+            try {
+                promise.set_value(_readChunk(id));
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+        task = _executor.execute(std::move(task));
+        if (task) {
+            task->run();
+        }
+    }
+
+    vespalib::Executor                               & _executor;
+    ReadChunk                                          _readChunk;
+    size_t                                             _numChunks;
+    size_t                                             _nextToRead;
+    std::deque<std::future<std::unique_ptr<Chunk>>>    _pending;
+};
+
+}
+
 void
-FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const
+FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+                vespalib::Executor & executor, uint32_t readAheadChunks) const
 {
     if (count == 0) { return; }
+    // Split into runs of lids residing in the same chunk.
+    std::vector<std::pair<size_t, ChunkInfo>> runs;
     uint32_t prevChunk = begin->getChunkId();
-    uint32_t start(0);
+    runs.emplace_back(0, _chunkInfo[prevChunk]);
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         if (li.getChunkId() != prevChunk) {
-            ChunkInfo ci = _chunkInfo[prevChunk];
-            read(begin + start, i - start, ci, visitor);
             prevChunk = li.getChunkId();
-            start = i;
+            runs.emplace_back(i, _chunkInfo[prevChunk]);
+        }
+    }
+    runs.emplace_back(count, ChunkInfo());
+    size_t numChunks = runs.size() - 1;
+    auto readRun = [this, begin, &runs](size_t i) {
+        return readChunk((begin + runs[i].first)->getChunkId(), runs[i].second);
+    };
+    if ((numChunks == 1) || (readAheadChunks == 0)) {
+        for (size_t i(0); i < numChunks; i++) {
+            visit(begin + runs[i].first, runs[i + 1].first - runs[i].first, *readRun(i), visitor);
         }
+        return;
+    }
+    ChunkReadAhead readAhead(executor, numChunks, readAheadChunks, readRun);
+    for (size_t i(0); i < numChunks; i++) {
+        visit(begin + runs[i].first, runs[i + 1].first - runs[i].first, *readAhead.next(), visitor);
     }
-    ChunkInfo ci = _chunkInfo[prevChunk];
-    read(begin + start, count - start, ci, visitor);
 }
 
-void
-FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const
+std::unique_ptr<Chunk>
+FileChunk::readChunk(SubChunkId chunkId, ChunkInfo ci) const
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
-    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+    return std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+}
+
+void
+FileChunk::visit(LidInfoWithLidV::const_iterator begin, size_t count, const Chunk & chunk, IBufferVisitor & visitor)
+{
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
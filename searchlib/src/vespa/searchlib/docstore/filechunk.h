@@ -17,6 +17,7 @@ class FastOS_FileInterface;
 
 namespace vespalib {
     class DataBuffer;
+    class Executor;
     class GenericHeader;
     class ThreadExecutor;
 }
@@ -111,7 +112,13 @@ public:
 
     virtual size_t updateLidMap(const unique_lock &guard, ISetLid &lidMap, uint64_t serialNum, uint32_t docIdLimit);
     virtual ssize_t read(uint32_t lid, SubChunkId chunk, vespalib::DataBuffer & buffer) const;
-    virtual void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const;
+    /**
+     * Visit the given lids, which must be sorted by chunk. When they span several chunks,
+     * up to readAheadChunks chunks are read and decompressed on the executor ahead of the
+     * one being visited. The caller must not be running in the executor.
+     */
+    virtual void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+                      vespalib::Executor & executor, uint32_t readAheadChunks) const;
     void remove(uint32_t lid, uint32_t size);
     virtual size_t getDiskFootprint() const { return _diskFootprint; }
     virtual size_t getMemoryFootprint() const;
@@ -234,7 +241,8 @@ protected:
 
     void setNumUniqueBuckets(size_t numUniqueBuckets) { _numUniqueBuckets = numUniqueBuckets; }
     ssize_t read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo, vespalib::DataBuffer & buffer) const;
-    void read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const;
+    std::unique_ptr<Chunk> readChunk(SubChunkId chunkId, ChunkInfo ci) const;
+    static void visit(LidInfoWithLidV::const_iterator begin, size_t count, const Chunk & chunk, IBufferVisitor & visitor);
     static uint32_t readDocIdLimit(vespalib::GenericHeader &header);
     static void writeDocIdLimit(vespalib::GenericHeader &header, uint32_t docIdLimit);
 
@@ -50,6 +50,11 @@ public:
     virtual ~IDocumentVisitor() { }
     virtual void visit(uint32_t lid, DocumentUP doc) = 0;
     virtual bool allowVisitCaching() const = 0;
+    /**
+     * If true, the visited documents only carry their document id, and
+     * deserialization of the stored fields is skipped.
+     */
+    virtual bool onlyDocumentId() const { return false; }
 private:
 };
 
@@ -40,6 +40,7 @@ LogDataStore::Config::Config()
       _maxBucketSpread(2.5),
       _minFileSizeFactor(0.2),
       _maxNumLids(DEFAULT_MAX_LIDS_PER_FILE),
+      _readAheadChunks(4),
       _skipCrcOnRead(false),
       _compactCompression(CompressionConfig::LZ4),
       _fileConfig()
@@ -51,6 +52,7 @@ LogDataStore::Config::operator == (const Config & rhs) const {
             (_maxDiskBloatFactor == rhs._maxDiskBloatFactor) &&
             (_maxFileSize == rhs._maxFileSize) &&
             (_minFileSizeFactor == rhs._minFileSizeFactor) &&
+            (_readAheadChunks == rhs._readAheadChunks) &&
             (_skipCrcOnRead == rhs._skipCrcOnRead) &&
             (_compactCompression == rhs._compactCompression) &&
             (_fileConfig == rhs._fileConfig);
@@ -149,13 +151,13 @@ LogDataStore::read(const LidVector & lids, IBufferVisitor & visitor) const
         const LidInfoWithLid & li = orderedLids[curr];
         if (prevFile != li.getFileId()) {
             const FileChunk & fc(*_fileChunks[prevFile]);
-            fc.read(orderedLids.begin() + start, curr - start, visitor);
+            fc.read(orderedLids.begin() + start, curr - start, visitor, _executor, _config.getReadAheadChunks());
             start = curr;
             prevFile = li.getFileId();
         }
     }
     const FileChunk & fc(*_fileChunks[prevFile]);
-    fc.read(orderedLids.begin() + start, orderedLids.size() - start, visitor);
+    fc.read(orderedLids.begin() + start, orderedLids.size() - start, visitor, _executor, _config.getReadAheadChunks());
 }
 
 ssize_t
@@ -215,7 +215,8 @@ struct LidAndBuffer {
 }
 
 void
-WriteableFileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const
+WriteableFileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+                         vespalib::Executor & executor, uint32_t readAheadChunks) const
 {
     if (count == 0) { return; }
     if (!frozen()) {
@@ -250,10 +251,10 @@ WriteableFileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IB
         for (auto & it : chunksOnFile) {
             auto first = find_first(begin, it.first);
             auto last = seek_past(first, begin + count, it.first);
-            FileChunk::read(first, last - first, it.second, visitor);
+            visit(first, last - first, *readChunk(it.first, it.second), visitor);
         }
     } else {
-        FileChunk::read(begin, count, visitor);
+        FileChunk::read(begin, count, visitor, executor, readAheadChunks);
     }
 }
 
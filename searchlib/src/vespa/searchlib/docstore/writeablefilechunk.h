@@ -51,7 +51,8 @@ public:
     ~WriteableFileChunk() override;
 
     ssize_t read(uint32_t lid, SubChunkId chunk, vespalib::DataBuffer & buffer) const override;
-    void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const override;
+    void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor,
+              vespalib::Executor & executor, uint32_t readAheadChunks) const override;
 
     LidInfo append(uint64_t serialNum, uint32_t lid, const void * buffer, size_t len);
     void flush(bool block, uint64_t syncToken);
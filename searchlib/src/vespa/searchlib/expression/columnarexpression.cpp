@@ -0,0 +1,454 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "columnarexpression.h"
+#include "attributenode.h"
+#include "constantnode.h"
+#include "addfunctionnode.h"
+#include "multiplyfunctionnode.h"
+#include "minfunctionnode.h"
+#include "maxfunctionnode.h"
+#include "negatefunctionnode.h"
+#include "fixedwidthbucketfunctionnode.h"
+#include "integerresultnode.h"
+#include "enumresultnode.h"
+#include "floatresultnode.h"
+#include "integerbucketresultnode.h"
+#include "floatbucketresultnode.h"
+#include <vespa/searchcommon/attribute/iattributevector.h>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace search::expression {
+
+using search::attribute::IAttributeVector;
+
+namespace {
+
+bool
+isInteger(const ResultNode & r)
+{
+    return r.inherits(IntegerResultNode::classId) && !r.inherits(BoolResultNode::classId);
+}
+
+bool
+isFloat(const ResultNode & r)
+{
+    return r.getClass().id() == FloatResultNode::classId;
+}
+
+// Integer arithmetic is done unsigned to get the same wrap around as
+// the interpreted path without relying on signed overflow.
+struct IntAdd { static int64_t apply(int64_t a, int64_t b) { return int64_t(uint64_t(a) + uint64_t(b)); } };
+struct IntMul { static int64_t apply(int64_t a, int64_t b) { return int64_t(uint64_t(a) * uint64_t(b)); } };
+struct IntMin { static int64_t apply(int64_t a, int64_t b) { return (b < a) ? b : a; } };
+struct IntMax { static int64_t apply(int64_t a, int64_t b) { return (b > a) ? b : a; } };
+struct FloatAdd { static double apply(double a, double b) { return a + b; } };
+struct FloatMul { static double apply(double a, double b) { return a * b; } };
+struct FloatMin { static double apply(double a, double b) { return (b < a) ? b : a; } };
+struct FloatMax { static double apply(double a, double b) { return (b > a) ? b : a; } };
+
+template <typename F, typename D, typename S>
+void
+combine(D * __restrict__ dst, const S * __restrict__ src, size_t n)
+{
+    for (size_t i(0); i < n; i++) {
+        dst[i] = F::apply(dst[i], D(src[i]));
+    }
+}
+
+template <typename D, typename S>
+void
+convert(D * __restrict__ dst, const S * __restrict__ src, size_t n)
+{
+    for (size_t i(0); i < n; i++) {
+        dst[i] = D(src[i]);
+    }
+}
+
+void
+integerBucket(const int64_t * __restrict__ v, int64_t * __restrict__ from, int64_t * __restrict__ to, size_t n, int64_t width)
+{
+    if (width <= 0) {
+        convert(from, v, n);
+        convert(to, v, n);
+        return;
+    }
+    for (size_t i(0); i < n; i++) {
+        int64_t x = v[i];
+        if (x >= 0) {
+            int64_t f = (x/width) * width;
+            from[i] = f;
+            to[i] = (f >= (std::numeric_limits<int64_t>::max() - width)) ? std::numeric_limits<int64_t>::max() : f + width;
+        } else {
+            int64_t t = ((x+1)/width) * width;
+            to[i] = t;
+            from[i] = (t <= (std::numeric_limits<int64_t>::min() + width)) ? std::numeric_limits<int64_t>::min() : t - width;
+        }
+    }
+}
+
+void
+floatBucket(const double * __restrict__ v, double * __restrict__ from, double * __restrict__ to, size_t n, double width)
+{
+    if (!(width > 0.0)) {
+        convert(from, v, n);
+        convert(to, v, n);
+        return;
+    }
+    for (size_t i(0); i < n; i++) {
+        double tmp = std::floor(v[i]/width);
+        from[i] = tmp * width;
+        to[i] = (tmp + 1) * width;
+    }
+}
+
+}
+
+ColumnarExpression::Column::Column() = default;
+ColumnarExpression::Column::~Column() = default;
+
+ColumnarExpression::Node::Node(Op op_, Type type_)
+    : op(op_),
+      type(type_),
+      args(),
+      attr(nullptr),
+      intValue(0),
+      floatValue(0.0)
+{ }
+
+ColumnarExpression::Node::Node(Node &&) noexcept = default;
+ColumnarExpression::Node::~Node() = default;
+
+ColumnarExpression::ColumnarExpression()
+    : _nodes(),
+      _scratch()
+{ }
+
+ColumnarExpression::~ColumnarExpression() = default;
+
+int
+ColumnarExpression::compileNode(ExpressionNode & node, std::vector<Node> & nodes)
+{
+    const vespalib::Identifiable::RuntimeClass & cls = node.getClass();
+    if (cls.id() == AttributeNode::classId) {
+        const auto & attrNode = static_cast<const AttributeNode &>(node);
+        const IAttributeVector * attr = attrNode.getAttribute();
+        if ((attr == nullptr) || attrNode.hasMultiValue() || attr->hasMultiValue() ||
+            node.getResult().inherits(EnumResultNode::classId))
+        {
+            return -1;
+        }
+        Node n(Op::ATTRIBUTE, Type::INTEGER);
+        if (attr->isIntegerType() && (attr->getBasicType() != search::attribute::BasicType::BOOL) && isInteger(node.getResult())) {
+            n.type = Type::INTEGER;
+        } else if (attr->isFloatingPointType() && isFloat(node.getResult())) {
+            n.type = Type::FLOAT;
+        } else {
+            return -1;
+        }
+        n.attr = attr;
+        nodes.push_back(std::move(n));
+        return nodes.size() - 1;
+    }
+    if (cls.id() == ConstantNode::classId) {
+        const ResultNode & value = node.getResult();
+        if (isInteger(value)) {
+            Node n(Op::CONSTANT, Type::INTEGER);
+            n.intValue = value.getInteger();
+            nodes.push_back(std::move(n));
+        } else if (isFloat(value)) {
+            Node n(Op::CONSTANT, Type::FLOAT);
+            n.floatValue = value.getFloat();
+            nodes.push_back(std::move(n));
+        } else {
+            return -1;
+        }
+        return nodes.size() - 1;
+    }
+    Op op;
+    if (cls.id() == AddFunctionNode::classId) {
+        op = Op::ADD;
+    } else if (cls.id() == MultiplyFunctionNode::classId) {
+        op = Op::MULTIPLY;
+    } else if (cls.id() == MinFunctionNode::classId) {
+        op = Op::MIN;
+    } else if (cls.id() == MaxFunctionNode::classId) {
+        op = Op::MAX;
+    } else if (cls.id() == NegateFunctionNode::classId) {
+        op = Op::NEGATE;
+    } else if (cls.id() == FixedWidthBucketFunctionNode::classId) {
+        op = Op::BUCKET;
+    } else {
+        return -1;
+    }
+    auto & args = static_cast<MultiArgFunctionNode &>(node).expressionNodeVector();
+    if (args.empty() || (((op == Op::NEGATE) || (op == Op::BUCKET)) && (args.size() != 1))) {
+        return -1;
+    }
+    std::vector<uint32_t> argIds;
+    for (auto & arg : args) {
+        int id = compileNode(*arg, nodes);
+        if (id < 0) {
+            return -1;
+        }
+        argIds.push_back(id);
+    }
+    const ResultNode & result = node.getResult();
+    Node n(op, Type::INTEGER);
+    if (op == Op::BUCKET) {
+        const auto & bucket = static_cast<const FixedWidthBucketFunctionNode &>(node);
+        if (!bucket.getWidth()) {
+            return -1;
+        }
+        Type argType = nodes[argIds[0]].type;
+        if ((argType == Type::INTEGER) && (result.getClass().id() == IntegerBucketResultNode::classId)) {
+            n.type = Type::INTEGER_BUCKET;
+            n.intValue = bucket.getWidth()->getInteger();
+        } else if ((argType == Type::FLOAT) && (result.getClass().id() == FloatBucketResultNode::classId)) {
+            n.type = Type::FLOAT_BUCKET;
+            n.floatValue = bucket.getWidth()->getFloat();
+        } else {
+            return -1;
+        }
+    } else {
+        if (isInteger(result)) {
+            n.type = Type::INTEGER;
+        } else if (isFloat(result)) {
+            n.type = Type::FLOAT;
+        } else {
+            return -1;
+        }
+        for (uint32_t id : argIds) {
+            Type argType = nodes[id].type;
+            if ((argType != Type::INTEGER) && ((argType != Type::FLOAT) || (n.type != Type::FLOAT))) {
+                return -1;
+            }
+        }
+    }
+    n.args = std::move(argIds);
+    nodes.push_back(std::move(n));
+    return nodes.size() - 1;
+}
+
+ColumnarExpression::UP
+ColumnarExpression::compile(ExpressionNode & root)
+{
+    UP expr(new ColumnarExpression());
+    if (compileNode(root, expr->_nodes) < 0) {
+        return UP();
+    }
+    expr->_scratch.resize(expr->_nodes.size());
+    for (size_t i(0); i < expr->_nodes.size(); i++) {
+        const Node & node = expr->_nodes[i];
+        Column & col = expr->_scratch[i];
+        switch (node.type) {
+        case Type::INTEGER_BUCKET:
+            col.intsTo.resize(BLOCK_SIZE);
+            [[fallthrough]];
+        case Type::INTEGER:
+            col.ints.resize(BLOCK_SIZE);
+            if (node.op == Op::CONSTANT) {
+                std::fill(col.ints.begin(), col.ints.end(), node.intValue);
+            }
+            break;
+        case Type::FLOAT_BUCKET:
+            col.floatsTo.resize(BLOCK_SIZE);
+            [[fallthrough]];
+        case Type::FLOAT:
+            col.floats.resize(BLOCK_SIZE);
+            if (node.op == Op::CONSTANT) {
+                std::fill(col.floats.begin(), col.floats.end(), node.floatValue);
+            }
+            break;
+        }
+    }
+    return expr;
+}
+
+void
+ColumnarExpression::evaluateBlock(const DocId * docs, size_t n)
+{
+    for (size_t i(0); i < _nodes.size(); i++) {
+        const Node & node = _nodes[i];
+        Column & col = _scratch[i];
+        switch (node.op) {
+        case Op::CONSTANT:
+            break;
+        case Op::ATTRIBUTE:
+            if (node.type == Type::INTEGER) {
+                int64_t * dst = col.ints.data();
+                for (size_t j(0); j < n; j++) {
+                    dst[j] = node.attr->getInt(docs[j]);
+                }
+            } else {
+                double * dst = col.floats.data();
+                for (size_t j(0); j < n; j++) {
+                    dst[j] = node.attr->getFloat(docs[j]);
+                }
+            }
+            break;
+        case Op::NEGATE: {
+            const Column & arg = _scratch[node.args[0]];
+            if (node.type == Type::INTEGER) {
+                for (size_t j(0); j < n; j++) {
+                    col.ints[j] = int64_t(uint64_t(0) - uint64_t(arg.ints[j]));
+                }
+            } else if (_nodes[node.args[0]].type == Type::FLOAT) {
+                for (size_t j(0); j < n; j++) {
+                    col.floats[j] = -arg.floats[j];
+                }
+            } else {
+                for (size_t j(0); j < n; j++) {
+                    col.floats[j] = -double(arg.ints[j]);
+                }
+            }
+            break;
+        }
+        case Op::BUCKET: {
+            const Column & arg = _scratch[node.args[0]];
+            if (node.type == Type::INTEGER_BUCKET) {
+                integerBucket(arg.ints.data(), col.ints.data(), col.intsTo.data(), n, node.intValue);
+            } else {
+                floatBucket(arg.floats.data(), col.floats.data(), col.floatsTo.data(), n, node.floatValue);
+            }
+            break;
+        }
+        case Op::ADD:
+        case Op::MULTIPLY:
+        case Op::MIN:
+        case Op::MAX: {
+            const Node & first = _nodes[node.args[0]];
+            const Column & firstCol = _scratch[node.args[0]];
+            if (node.type == Type::INTEGER) {
+                convert(col.ints.data(), firstCol.ints.data(), n);
+            } else if (first.type == Type::FLOAT) {
+                convert(col.floats.data(), firstCol.floats.data(), n);
+            } else {
+                convert(col.floats.data(), firstCol.ints.data(), n);
+            }
+            for (size_t a(1); a < node.args.size(); a++) {
+                const Column & argCol = _scratch[node.args[a]];
+                bool argIsFloat = (_nodes[node.args[a]].type == Type::FLOAT);
+                if (node.type == Type::INTEGER) {
+                    int64_t * dst = col.ints.data();
+                    const int64_t * src = argCol.ints.data();
+                    switch (node.op) {
+                    case Op::ADD:      combine<IntAdd>(dst, src, n); break;
+                    case Op::MULTIPLY: combine<IntMul>(dst, src, n); break;
+                    case Op::MIN:      combine<IntMin>(dst, src, n); break;
+                    default:           combine<IntMax>(dst, src, n); break;
+                    }
+                } else if (argIsFloat) {
+                    double * dst = col.floats.data();
+                    const double * src = argCol.floats.data();
+                    switch (node.op) {
+                    case Op::ADD:      combine<FloatAdd>(dst, src, n); break;
+                    case Op::MULTIPLY: combine<FloatMul>(dst, src, n); break;
+                    case Op::MIN:      combine<FloatMin>(dst, src, n); break;
+                    default:           combine<FloatMax>(dst, src, n); break;
+                    }
+                } else {
+                    double * dst = col.floats.data();
+                    const int64_t * src = argCol.ints.data();
+                    switch (node.op) {
+                    case Op::ADD:      combine<FloatAdd>(dst, src, n); break;
+                    case Op::MULTIPLY: combine<FloatMul>(dst, src, n); break;
+                    case Op::MIN:      combine<FloatMin>(dst, src, n); break;
+                    default:           combine<FloatMax>(dst, src, n); break;
+                    }
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+void
+ColumnarExpression::evaluate(const DocId * docs, size_t numDocs, Column & out)
+{
+    Type t = type();
+    bool isInt = (t == Type::INTEGER) || (t == Type::INTEGER_BUCKET);
+    bool isBucket = (t == Type::INTEGER_BUCKET) || (t == Type::FLOAT_BUCKET);
+    if (isInt) {
+        out.ints.resize(numDocs);
+        if (isBucket) {
+            out.intsTo.resize(numDocs);
+        }
+    } else {
+        out.floats.resize(numDocs);
+        if (isBucket) {
+            out.floatsTo.resize(numDocs);
+        }
+    }
+    const Column & root = _scratch.back();
+    for (size_t offset(0); offset < numDocs; offset += BLOCK_SIZE) {
+        size_t n = std::min(BLOCK_SIZE, numDocs - offset);
+        evaluateBlock(docs + offset, n);
+        if (isInt) {
+            std::copy(root.ints.begin(), root.ints.begin() + n, out.ints.begin() + offset);
+            if (isBucket) {
+                std::copy(root.intsTo.begin(), root.intsTo.begin() + n, out.intsTo.begin() + offset);
+            }
+        } else {
+            std::copy(root.floats.begin(), root.floats.begin() + n, out.floats.begin() + offset);
+            if (isBucket) {
+                std::copy(root.floatsTo.begin(), root.floatsTo.begin() + n, out.floatsTo.begin() + offset);
+            }
+        }
+    }
+}
+
+void
+ColumnarExpression::getResult(const Column & column, size_t idx, ResultNode & result) const
+{
+    switch (type()) {
+    case Type::INTEGER:
+        result.set(Int64ResultNode(column.ints[idx]));
+        break;
+    case Type::FLOAT:
+        result.set(FloatResultNode(column.floats[idx]));
+        break;
+    case Type::INTEGER_BUCKET:
+        static_cast<IntegerBucketResultNode &>(result).setRange(column.ints[idx], column.intsTo[idx]);
+        break;
+    case Type::FLOAT_BUCKET:
+        static_cast<FloatBucketResultNode &>(result).setRange(column.floats[idx], column.floatsTo[idx]);
+        break;
+    }
+}
+
+ColumnarHitEvaluator::ColumnarHitEvaluator(ColumnarExpression::UP expr, const ResultNode & prototype, std::vector<DocId> docs)
+    : _expr(std::move(expr)),
+      _result(prototype.clone()),
+      _docs(std::move(docs)),
+      _column(),
+      _blockStart(0),
+      _blockEnd(0),
+      _pos(0)
+{ }
+
+ColumnarHitEvaluator::~ColumnarHitEvaluator() = default;
+
+const ResultNode *
+ColumnarHitEvaluator::getResult(DocId docId)
+{
+    size_t pos = _pos;
+    while ((pos < _docs.size()) && (_docs[pos] != docId)) {
+        pos++;
+    }
+    if (pos == _docs.size()) {
+        return nullptr;
+    }
+    _pos = pos;
+    if (pos >= _blockEnd) {
+        _blockStart = pos;
+        _blockEnd = std::min(pos + ColumnarExpression::BLOCK_SIZE, _docs.size());
+        _expr->evaluate(_docs.data() + _blockStart, _blockEnd - _blockStart, _column);
+    }
+    _expr->getResult(_column, pos - _blockStart, *_result);
+    return _result.get();
+}
+
+}
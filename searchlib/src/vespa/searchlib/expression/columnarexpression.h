@@ -0,0 +1,121 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "expressionnode.h"
+#include "resultnode.h"
+#include <vector>
+#include <memory>
+
+namespace search::attribute { class IAttributeVector; }
+
+namespace search::expression {
+
+/**
+ * A columnar compilation of a prepared, numeric expression tree.
+ *
+ * The interpreted path executes each ExpressionNode per document,
+ * producing ResultNode objects on every step. For trees built from
+ * single value numeric attributes, numeric constants, add, multiply,
+ * min, max, negate and fixed width buckets, this class instead
+ * evaluates the tree for a block of documents at a time: attribute
+ * values are gathered into flat arrays and each operation is applied
+ * as a tight loop over the block. The results are identical to the
+ * interpreted path, including integer vs float typing of each node.
+ **/
+class ColumnarExpression
+{
+public:
+    using DocId = uint32_t;
+    using UP = std::unique_ptr<ColumnarExpression>;
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    enum class Type { INTEGER, FLOAT, INTEGER_BUCKET, FLOAT_BUCKET };
+
+    /**
+     * Values for a set of documents. For bucket types 'ints'/'floats'
+     * hold the bucket start and 'intsTo'/'floatsTo' the bucket end.
+     **/
+    struct Column {
+        std::vector<int64_t> ints;
+        std::vector<double>  floats;
+        std::vector<int64_t> intsTo;
+        std::vector<double>  floatsTo;
+        Column();
+        ~Column();
+    };
+
+    /**
+     * Compile the given prepared expression tree. Returns an empty
+     * pointer if the tree contains anything not supported.
+     **/
+    static UP compile(ExpressionNode & root);
+
+    ~ColumnarExpression();
+    Type type() const { return _nodes.back().type; }
+    size_t numNodes() const { return _nodes.size(); }
+
+    /**
+     * Evaluate the expression for the given documents, storing one
+     * value per document in the given column.
+     **/
+    void evaluate(const DocId * docs, size_t numDocs, Column & out);
+
+    /**
+     * Store the value for a single document of an evaluated column in a
+     * result node of the same type as produced by the interpreted path.
+     **/
+    void getResult(const Column & column, size_t idx, ResultNode & result) const;
+
+private:
+    enum class Op { ATTRIBUTE, CONSTANT, ADD, MULTIPLY, MIN, MAX, NEGATE, BUCKET };
+    struct Node {
+        Op                                     op;
+        Type                                   type;
+        std::vector<uint32_t>                  args;
+        const search::attribute::IAttributeVector * attr;
+        int64_t                                intValue;   // constant or bucket width
+        double                                 floatValue; // constant or bucket width
+        Node(Op op_, Type type_);
+        Node(Node &&) noexcept;
+        ~Node();
+    };
+
+    ColumnarExpression();
+    static int compileNode(ExpressionNode & node, std::vector<Node> & nodes);
+    void evaluateBlock(const DocId * docs, size_t n);
+
+    std::vector<Node>   _nodes;   // post order, root last
+    std::vector<Column> _scratch; // one per node, BLOCK_SIZE values
+};
+
+/**
+ * Hands out the value of a compiled expression for the hits of a
+ * grouping pass, evaluating it one block of hits at a time. Documents
+ * must be asked for in hit order, but hits may be skipped (their
+ * group was not kept) or asked for repeatedly (multi value levels
+ * above).
+ **/
+class ColumnarHitEvaluator
+{
+public:
+    using DocId = ColumnarExpression::DocId;
+    ColumnarHitEvaluator(ColumnarExpression::UP expr, const ResultNode & prototype, std::vector<DocId> docs);
+    ~ColumnarHitEvaluator();
+
+    /**
+     * The value for the given document, or nullptr if it is not among
+     * the remaining hits, in which case the caller must fall back to
+     * the interpreted path.
+     **/
+    const ResultNode * getResult(DocId docId);
+private:
+    ColumnarExpression::UP     _expr;
+    ResultNode::UP             _result;
+    std::vector<DocId>         _docs;
+    ColumnarExpression::Column _column;
+    size_t                     _blockStart;
+    size_t                     _blockEnd;
+    size_t                     _pos;
+};
+
+}
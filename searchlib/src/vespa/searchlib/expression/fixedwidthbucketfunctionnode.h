@@ -65,6 +65,7 @@ public:
         _width = width;
         return *this;
     }
+    const NumericResultNode::CP & getWidth() const { return _width; }
 };
 
 }
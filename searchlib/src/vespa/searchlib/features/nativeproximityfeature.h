@@ -82,9 +82,11 @@ private:
     vespalib::ConstArrayRef<FieldSetup> _setups;
     uint32_t                      _totalFieldWeight;
     const fef::MatchData         *_md;
+    std::vector<const fef::TermFieldMatchData *> _termFields; // all term fields used by _setups
 
     feature_t calculateScoreForField(const FieldSetup & fs, uint32_t docId);
     feature_t calculateScoreForPair(const TermPair & pair, uint32_t fieldId, uint32_t docId);
+    void prefetchPositions(uint32_t docId) const;
 
     virtual void handle_bind_match_data(const fef::MatchData &md) override;
 
@@ -366,6 +366,21 @@ MinHitsPerThread::lookup(const Properties &props, uint32_t defaultValue)
     return lookupUint32(props, NAME, defaultValue);
 }
 
+const vespalib::string CompactPositionsPerTermField::NAME("vespa.matching.compact_positions_per_term_field");
+const uint32_t CompactPositionsPerTermField::DEFAULT_VALUE(0);
+
+uint32_t
+CompactPositionsPerTermField::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+CompactPositionsPerTermField::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
 const vespalib::string NearestNeighborBruteForceLimit::NAME("vespa.matching.nearest_neighbor.brute_force_limit");
 
 const double NearestNeighborBruteForceLimit::DEFAULT_VALUE(0.05);
@@ -484,6 +499,9 @@ const double DiversityCutoffFactor::DEFAULT_VALUE(10.0);
 const vespalib::string DiversityCutoffStrategy::NAME("vespa.matchphase.diversity.cutoff.strategy");
 const vespalib::string DiversityCutoffStrategy::DEFAULT_VALUE("loose");
 
+const vespalib::string SortAttributeLimit::NAME("vespa.matchphase.sortattribute.limit");
+const bool SortAttributeLimit::DEFAULT_VALUE(false);
+
 vespalib::string
 DegradationAttribute::lookup(const Properties &props, const vespalib::string & defaultValue)
 {
@@ -544,6 +562,12 @@ DiversityCutoffStrategy::lookup(const Properties &props, const vespalib::string
     return lookupString(props, NAME, defaultValue);
 }
 
+bool
+SortAttributeLimit::lookup(const Properties &props, bool defaultValue)
+{
+    return lookupBool(props, NAME, defaultValue);
+}
+
 }
 
 namespace trace {
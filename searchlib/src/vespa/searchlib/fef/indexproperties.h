@@ -259,6 +259,20 @@ namespace matching {
         static uint32_t lookup(const Properties &props);
         static uint32_t lookup(const Properties &props, uint32_t defaultValue);
     };
+    /**
+     * Property for the number of positions per term field kept in a
+     * single contiguous block in the match data of each search
+     * thread. This reduces scattered memory accesses when unpacking
+     * and calculating proximity for queries with many terms. 0 (the
+     * default) means that positions are allocated per term field.
+     **/
+    struct CompactPositionsPerTermField {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
     /**
      * Property for the minimum number of hits per thread.
      **/
@@ -454,6 +468,21 @@ namespace matchphase {
         static vespalib::string lookup(const Properties &props, const vespalib::string & defaultValue);
     };
 
+    /**
+     * Property enabling match phase limiting driven by the sort spec
+     * when no degradation attribute is configured. If the query is
+     * sorted on a single fast-search numeric attribute, the
+     * dictionary of that attribute is traversed in sort order and
+     * used as a filter, so that only roughly offset+hits matches are
+     * produced instead of matching the whole corpus.
+     **/
+    struct SortAttributeLimit {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool lookup(const Properties &props) { return lookup(props, DEFAULT_VALUE); }
+        static bool lookup(const Properties &props, bool defaultValue);
+    };
+
 } // namespace matchphase
 
 namespace trace {
@@ -1,16 +1,34 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "matchdata.h"
+#include <vespa/vespalib/util/stash.h>
+#include <algorithm>
+#include <limits>
 
 namespace search {
 namespace fef {
 
 MatchData::MatchData(const Params &cparams)
-    : _termFields(cparams.numTermFields()),
+    : _positionArena(),
+      _termFields(cparams.numTermFields()),
       _termwise_limit(1.0)
 {
+    uint32_t perTermField = std::min(cparams.positionsPerTermField(),
+                                     uint32_t(std::numeric_limits<uint16_t>::max()));
+    if ((perTermField > 1) && !_termFields.empty()) {
+        // Keep positions for all term fields in one contiguous block,
+        // so that unpack and proximity features touch fewer cache lines
+        // and no allocations happen per term field.
+        _positionArena = std::make_unique<vespalib::Stash>();
+        auto positions = _positionArena->create_array<TermFieldMatchDataPosition>(perTermField * _termFields.size());
+        for (size_t i = 0; i < _termFields.size(); ++i) {
+            _termFields[i].usePositionStorage(&positions[i * perTermField], perTermField);
+        }
+    }
 }
 
+MatchData::~MatchData() = default;
+
 void
 MatchData::soft_reset()
 {
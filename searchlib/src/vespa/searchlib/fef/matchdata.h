@@ -7,6 +7,8 @@
 #include <memory>
 #include <vector>
 
+namespace vespalib { class Stash; }
+
 namespace search::fef {
 
 /**
@@ -16,8 +18,9 @@ namespace search::fef {
 class MatchData
 {
 private:
-    std::vector<TermFieldMatchData> _termFields;
-    double                          _termwise_limit;
+    std::unique_ptr<vespalib::Stash> _positionArena;
+    std::vector<TermFieldMatchData>  _termFields;
+    double                           _termwise_limit;
 
 public:
     /**
@@ -27,15 +30,26 @@ public:
     {
     private:
         uint32_t _numTermFields;
+        uint32_t _positionsPerTermField;
 
         friend class ::search::fef::MatchData;
-        Params() : _numTermFields(0) {}
+        Params() : _numTermFields(0), _positionsPerTermField(0) {}
     public:
         uint32_t numTermFields() const { return _numTermFields; }
         Params & numTermFields(uint32_t value) {
             _numTermFields = value;
             return *this;
         }
+        /**
+         * Number of positions per term field to keep in a single
+         * arena shared by all term fields. 0 means that each term
+         * field allocates its own position vector when needed.
+         **/
+        uint32_t positionsPerTermField() const { return _positionsPerTermField; }
+        Params & positionsPerTermField(uint32_t value) {
+            _positionsPerTermField = value;
+            return *this;
+        }
     };
     /**
      * Avoid C++'s most vexing parse problem.
@@ -57,6 +71,7 @@ public:
      * @param numFeatures number of feature slots
      **/
     explicit MatchData(const Params &cparams);
+    ~MatchData();
 
     /**
      * Reset this match data in such a way that it can be re-used with
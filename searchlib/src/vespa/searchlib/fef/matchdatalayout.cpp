@@ -15,10 +15,12 @@ MatchDataLayout::~MatchDataLayout() = default;
 
 
 MatchData::UP
-MatchDataLayout::createMatchData() const
+MatchDataLayout::createMatchData(uint32_t positionsPerTermField) const
 {
     assert(_numTermFields == _fieldIds.size());
-    auto md = std::make_unique<MatchData>(MatchData::params().numTermFields(_numTermFields));
+    auto md = std::make_unique<MatchData>(MatchData::params()
+                                          .numTermFields(_numTermFields)
+                                          .positionsPerTermField(positionsPerTermField));
     for (size_t i = 0; i < _numTermFields; ++i) {
         md->resolveTermField(i)->setFieldId(_fieldIds[i]);
     }
@@ -42,7 +42,17 @@ public:
      *
      * @return auto-pointer to a match data object
      **/
-    MatchData::UP createMatchData() const;
+    MatchData::UP createMatchData() const { return createMatchData(0); }
+
+    /**
+     * Create a match data object where positions for all term fields
+     * are kept in a single contiguous block, with room for the given
+     * number of positions per term field.
+     *
+     * @return auto-pointer to a match data object
+     * @param positionsPerTermField positions reserved per term field
+     **/
+    MatchData::UP createMatchData(uint32_t positionsPerTermField) const;
 };
 
 }
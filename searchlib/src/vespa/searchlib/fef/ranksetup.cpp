@@ -38,6 +38,7 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _split_unpacking_iterators(false),
       _delay_unpacking_iterators(false),
       _termwise_limit(1.0),
+      _compact_positions_per_term_field(0),
       _numThreads(0),
       _minHitsPerThread(0),
       _numSearchPartitions(0),
@@ -95,6 +96,7 @@ RankSetup::configure()
     split_unpacking_iterators(matching::SplitUnpackingIterators::check(_indexEnv.getProperties()));
     delay_unpacking_iterators(matching::DelayUnpackingIterators::check(_indexEnv.getProperties()));
     set_termwise_limit(matching::TermwiseLimit::lookup(_indexEnv.getProperties()));
+    set_compact_positions_per_term_field(matching::CompactPositionsPerTermField::lookup(_indexEnv.getProperties()));
     setNumThreadsPerSearch(matching::NumThreadsPerSearch::lookup(_indexEnv.getProperties()));
     setMinHitsPerThread(matching::MinHitsPerThread::lookup(_indexEnv.getProperties()));
     setNumSearchPartitions(matching::NumSearchPartitions::lookup(_indexEnv.getProperties()));
@@ -46,6 +46,7 @@ private:
     bool                     _split_unpacking_iterators;
     bool                     _delay_unpacking_iterators;
     double                   _termwise_limit;
+    uint32_t                 _compact_positions_per_term_field;
     uint32_t                 _numThreads;
     uint32_t                 _minHitsPerThread;
     uint32_t                 _numSearchPartitions;
@@ -163,6 +164,13 @@ public:
      **/
     double get_termwise_limit() const { return _termwise_limit; }
 
+    /**
+     * Set/get the number of positions per term field kept in a single
+     * contiguous block in match data. 0 means disabled.
+     **/
+    void set_compact_positions_per_term_field(uint32_t value) { _compact_positions_per_term_field = value; }
+    uint32_t get_compact_positions_per_term_field() const { return _compact_positions_per_term_field; }
+
     /**
      * Sets the number of threads per search.
      *
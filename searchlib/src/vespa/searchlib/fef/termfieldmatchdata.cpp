@@ -20,7 +20,7 @@ TermFieldMatchData::TermFieldMatchData() :
 TermFieldMatchData::TermFieldMatchData(const TermFieldMatchData & rhs) :
     _docId(rhs._docId),
     _fieldId(rhs._fieldId),
-    _flags(rhs._flags),
+    _flags(rhs._flags & ~EXTERNAL_POSITIONS_FLAG),
     _sz(0),
     _numOccs(0),
     _fieldLength(0)
@@ -49,7 +49,9 @@ TermFieldMatchData::~TermFieldMatchData()
 {
     if (isRawScore()) {
     } else if (allocated()) {
-        delete [] _data._positions._positions;
+        if (ownsPositions()) {
+            delete [] _data._positions._positions;
+        }
     } else {
         getFixed()->~TermFieldMatchDataPosition();
     }
@@ -57,6 +59,10 @@ TermFieldMatchData::~TermFieldMatchData()
 
 TermFieldMatchData::MutablePositionsIterator
 TermFieldMatchData::populate_fixed() {
+    if (!ownsPositions()) {
+        // Single position updated in place; give back borrowed storage.
+        releasePositionStorage();
+    }
     assert(!allocated());
     if (_sz == 0) {
         new (_data._position) TermFieldMatchDataPosition();
@@ -65,6 +71,31 @@ TermFieldMatchData::populate_fixed() {
     return getFixed();
 }
 
+void
+TermFieldMatchData::releasePositionStorage()
+{
+    // raw scores and subqueries share memory with the positions
+    _flags &= ~(MULTIPOS_FLAG | EXTERNAL_POSITIONS_FLAG);
+    _sz = 0;
+    memset(&_data, 0, sizeof(_data));
+}
+
+void
+TermFieldMatchData::usePositionStorage(TermFieldMatchDataPosition *positions, uint16_t capacity)
+{
+    assert(!allocated() && !isRawScore());
+    assert(capacity > 0);
+    if (_sz > 0) {
+        positions[0] = *getFixed();
+        _data._positions._maxElementLength = getFixed()->getElementLen();
+    } else {
+        _data._positions._maxElementLength = 0;
+    }
+    _flags |= (MULTIPOS_FLAG | EXTERNAL_POSITIONS_FLAG);
+    _data._positions._allocated = capacity;
+    _data._positions._positions = positions;
+}
+
 TermFieldMatchData &
 TermFieldMatchData::setFieldId(uint32_t fieldId) {
     if (fieldId == IllegalFieldId) {
@@ -119,7 +150,10 @@ TermFieldMatchData::resizePositionVector(size_t sz)
     for (size_t i(0); i < _data._positions._allocated; i++) {
         n[i] = _data._positions._positions[i];
     }
-    delete [] _data._positions._positions;
+    if (ownsPositions()) {
+        delete [] _data._positions._positions;
+    }
+    _flags &= ~EXTERNAL_POSITIONS_FLAG;
     _data._positions._allocated = newSize;
     _data._positions._positions = n;
 }
@@ -40,6 +40,8 @@ private:
     bool  empty() const { return _sz == 0; }
     void  clear() { _sz = 0; }
     bool  allocated() const { return isMultiPos(); }
+    bool  ownsPositions() const { return (_flags & EXTERNAL_POSITIONS_FLAG) == 0; }
+    void  releasePositionStorage();
     const TermFieldMatchDataPosition * getFixed() const { return reinterpret_cast<const TermFieldMatchDataPosition *>(_data._position); }
     TermFieldMatchDataPosition * getFixed() { return reinterpret_cast<TermFieldMatchDataPosition *>(_data._position); }
     const TermFieldMatchDataPosition * getMultiple() const { return _data._positions._positions; }
@@ -56,6 +58,7 @@ private:
     static constexpr uint16_t UNPACK_NORMAL_FEATURES_FLAG = 4;
     static constexpr uint16_t UNPACK_INTERLEAVED_FEATURES_FLAG = 8;
     static constexpr uint16_t UNPACK_ALL_FEATURES_MASK = UNPACK_NORMAL_FEATURES_FLAG | UNPACK_INTERLEAVED_FEATURES_FLAG;
+    static constexpr uint16_t EXTERNAL_POSITIONS_FLAG = 16;
 
     uint32_t  _docId;
     uint16_t  _fieldId;
@@ -105,6 +108,20 @@ public:
 
     MutablePositionsIterator populate_fixed();
 
+    /**
+     * Use the given memory for storing positions instead of allocating
+     * a separate vector when more than one position is appended. The
+     * memory is owned by the caller (typically MatchData) and must
+     * outlive this object. If more than 'capacity' positions are
+     * appended, a private vector is allocated as usual. The storage
+     * is given back when this object is used for a raw score or
+     * subqueries, or tagged as not needing normal features.
+     *
+     * @param positions storage for positions
+     * @param capacity number of positions that fit in the storage
+     **/
+    void usePositionStorage(TermFieldMatchDataPosition *positions, uint16_t capacity);
+
     /**
      * Set which field this object has match information for.
      *
@@ -166,6 +183,9 @@ public:
      **/
     TermFieldMatchData &setRawScore(uint32_t docId, feature_t score) {
         resetOnlyDocId(docId);
+        if (__builtin_expect(!ownsPositions(), false)) {
+            releasePositionStorage();
+        }
         enableRawScore();
         _data._rawScore = score;
         return *this;
@@ -186,11 +206,14 @@ public:
 
     void setSubqueries(uint32_t docId, uint64_t subqueries) {
         resetOnlyDocId(docId);
+        if (__builtin_expect(!ownsPositions(), false)) {
+            releasePositionStorage();
+        }
         _data._subqueries = subqueries;
     }
 
     uint64_t getSubqueries() const {
-        if (!empty() || isRawScore()) {
+        if (!empty() || isRawScore() || isMultiPos()) {
             return 0;
         }
         return _data._subqueries;
@@ -271,6 +294,9 @@ public:
      */
     void tagAsNotNeeded() {
         _flags &=  ~(UNPACK_NORMAL_FEATURES_FLAG | UNPACK_INTERLEAVED_FEATURES_FLAG);
+        if (!ownsPositions()) {
+            releasePositionStorage();
+        }
     }
 
     /**
@@ -281,6 +307,9 @@ public:
             _flags |= UNPACK_NORMAL_FEATURES_FLAG;
         } else {
             _flags &= ~UNPACK_NORMAL_FEATURES_FLAG;
+            if (!ownsPositions()) {
+                releasePositionStorage();
+            }
         }
     }
 
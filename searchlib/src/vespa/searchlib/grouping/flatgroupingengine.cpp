@@ -0,0 +1,270 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "flatgroupingengine.h"
+#include <vespa/searchlib/aggregation/countaggregationresult.h>
+#include <vespa/searchlib/aggregation/sumaggregationresult.h>
+#include <vespa/searchlib/expression/attributenode.h>
+#include <vespa/searchlib/expression/enumresultnode.h>
+#include <vespa/searchlib/expression/floatresultnode.h>
+#include <vespa/searchlib/expression/integerresultnode.h>
+#include <vespa/searchlib/expression/stringresultnode.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchcommon/attribute/iattributevector.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <cassert>
+#include <cstring>
+
+namespace search::grouping {
+
+using namespace aggregation;
+using namespace expression;
+using search::attribute::IAttributeVector;
+
+namespace {
+
+const IAttributeVector *
+singleValueAttribute(const ExpressionNode * node)
+{
+    if ((node == nullptr) || !node->inherits(AttributeNode::classId)) {
+        return nullptr;
+    }
+    const auto & attrNode = static_cast<const AttributeNode &>(*node);
+    const IAttributeVector * attr = attrNode.getAttribute();
+    if ((attr == nullptr) || attrNode.hasMultiValue() || attr->hasMultiValue()) {
+        return nullptr;
+    }
+    return attr;
+}
+
+bool
+isNumeric(const IAttributeVector & attr)
+{
+    return (attr.isIntegerType() && (attr.getBasicType() != search::attribute::BasicType::BOOL)) ||
+           attr.isFloatingPointType();
+}
+
+int64_t
+floatToKey(double v)
+{
+    if (v == 0.0) {
+        v = 0.0; // -0.0 and 0.0 are the same group
+    }
+    int64_t key;
+    memcpy(&key, &v, sizeof(key));
+    return key;
+}
+
+double
+keyToFloat(int64_t key)
+{
+    double v;
+    memcpy(&v, &key, sizeof(v));
+    return v;
+}
+
+}
+
+bool
+FlatGroupingEngine::supports(const Grouping & request)
+{
+    const Grouping::GroupingLevelList & levels = request.getLevels();
+    if ((levels.size() != 1) || (request.getFirstLevel() != 0) || (request.getLastLevel() != 1)) {
+        return false;
+    }
+    const Group & root = request.getRoot();
+    if ((root.getAggrSize() != 0) || (root.getChildrenSize() != 0)) {
+        return false;
+    }
+    const GroupingLevel & level = levels[0];
+    const IAttributeVector * keyAttr = singleValueAttribute(level.getExpression().getRoot());
+    if (keyAttr == nullptr) {
+        return false;
+    }
+    if (keyAttr->isStringType()) {
+        if (!level.getExpression().getResult().inherits(EnumResultNode::classId)) {
+            return false;
+        }
+    } else if (!isNumeric(*keyAttr)) {
+        return false;
+    }
+    const Group & proto = level.getGroupPrototype();
+    if (proto.getChildrenSize() != 0) {
+        return false;
+    }
+    for (size_t i(0), m(proto.getAggrSize()); i < m; i++) {
+        const AggregationResult & aggr = proto.getAggregationResult(i);
+        if (aggr.getClass().id() == CountAggregationResult::classId) {
+            continue;
+        }
+        if (aggr.getClass().id() != SumAggregationResult::classId) {
+            return false;
+        }
+        const IAttributeVector * sumAttr = singleValueAttribute(aggr.getExpression());
+        if ((sumAttr == nullptr) || !isNumeric(*sumAttr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FlatGroupingEngine::FlatGroupingEngine(const Grouping & request)
+    : _request(request),
+      _keyAttr(nullptr),
+      _keyType(KeyType::INTEGER),
+      _accumulators(),
+      _slots(),
+      _keys(),
+      _ranks(),
+      _values()
+{
+    assert(supports(request));
+    const GroupingLevel & level = request.getLevels()[0];
+    _keyAttr = singleValueAttribute(level.getExpression().getRoot());
+    _keyType = _keyAttr->isStringType()
+               ? KeyType::ENUM
+               : (_keyAttr->isFloatingPointType() ? KeyType::FLOAT : KeyType::INTEGER);
+    const Group & proto = level.getGroupPrototype();
+    for (size_t i(0), m(proto.getAggrSize()); i < m; i++) {
+        const AggregationResult & aggr = proto.getAggregationResult(i);
+        if (aggr.getClass().id() == CountAggregationResult::classId) {
+            _accumulators.push_back({AccType::COUNT, nullptr});
+        } else {
+            const IAttributeVector * attr = singleValueAttribute(aggr.getExpression());
+            _accumulators.push_back({attr->isFloatingPointType() ? AccType::FLOAT_SUM : AccType::INT_SUM, attr});
+        }
+    }
+}
+
+FlatGroupingEngine::~FlatGroupingEngine() = default;
+
+int64_t
+FlatGroupingEngine::readKey(DocId docId) const
+{
+    switch (_keyType) {
+    case KeyType::INTEGER: return _keyAttr->getInt(docId);
+    case KeyType::FLOAT:   return floatToKey(_keyAttr->getFloat(docId));
+    case KeyType::ENUM:    return _keyAttr->getEnum(docId);
+    }
+    abort();
+}
+
+uint32_t
+FlatGroupingEngine::lookup(int64_t key, HitRank rank)
+{
+    auto found = _slots.find(key);
+    if (found != _slots.end()) {
+        uint32_t slot = found->second;
+        _ranks[slot] = std::max(_ranks[slot], rank);
+        return slot;
+    }
+    uint32_t slot = _keys.size();
+    _slots[key] = slot;
+    _keys.push_back(key);
+    _ranks.push_back(rank);
+    _values.resize(_values.size() + _accumulators.size(), Acc{0});
+    for (size_t i(0), m(_accumulators.size()); i < m; i++) {
+        if (_accumulators[i].type == AccType::FLOAT_SUM) {
+            _values[slot * m + i].f = 0.0;
+        }
+    }
+    return slot;
+}
+
+void
+FlatGroupingEngine::aggregate(DocId docId, HitRank rank)
+{
+    uint32_t slot = lookup(readKey(docId), rank);
+    Acc * acc = &_values[slot * _accumulators.size()];
+    for (size_t i(0), m(_accumulators.size()); i < m; i++) {
+        const Accumulator & a = _accumulators[i];
+        switch (a.type) {
+        case AccType::COUNT:     acc[i].i++; break;
+        case AccType::INT_SUM:   acc[i].i += a.attr->getInt(docId); break;
+        case AccType::FLOAT_SUM: acc[i].f += a.attr->getFloat(docId); break;
+        }
+    }
+}
+
+void
+FlatGroupingEngine::aggregate(const RankedHit * rankedHit, unsigned int len)
+{
+    for (unsigned int i(0); (i < len) && !_request.expired(); i++) {
+        aggregate(rankedHit[i]._docId, rankedHit[i]._rankValue);
+    }
+}
+
+void
+FlatGroupingEngine::aggregate(const RankedHit * rankedHit, unsigned int len, const BitVector * bVec)
+{
+    aggregate(rankedHit, len);
+    if (bVec != nullptr) {
+        unsigned int sz(bVec->size());
+        for (DocId d(bVec->getFirstTrueBit()); (d < sz) && !_request.expired(); d = bVec->getNextTrueBit(d+1)) {
+            aggregate(d, 0.0);
+        }
+    }
+}
+
+void
+FlatGroupingEngine::merge(const FlatGroupingEngine & b)
+{
+    assert(_accumulators.size() == b._accumulators.size());
+    size_t m = _accumulators.size();
+    for (size_t bSlot(0); bSlot < b._keys.size(); bSlot++) {
+        uint32_t slot = lookup(b._keys[bSlot], b._ranks[bSlot]);
+        Acc * acc = &_values[slot * m];
+        const Acc * bAcc = &b._values[bSlot * m];
+        for (size_t i(0); i < m; i++) {
+            if (_accumulators[i].type == AccType::FLOAT_SUM) {
+                acc[i].f += bAcc[i].f;
+            } else {
+                acc[i].i += bAcc[i].i;
+            }
+        }
+    }
+}
+
+ResultNode::UP
+FlatGroupingEngine::createId(int64_t key) const
+{
+    switch (_keyType) {
+    case KeyType::INTEGER: return std::make_unique<Int64ResultNode>(key);
+    case KeyType::FLOAT:   return std::make_unique<FloatResultNode>(keyToFloat(key));
+    case KeyType::ENUM:    return std::make_unique<StringResultNode>(_keyAttr->getStringFromEnum(key));
+    }
+    abort();
+}
+
+void
+FlatGroupingEngine::fill(Grouping & request) const
+{
+    request.preAggregate(false);
+    const GroupingLevel & level = request.getLevels()[0];
+    size_t m = _accumulators.size();
+    for (size_t slot(0); slot < _keys.size(); slot++) {
+        auto group = std::make_unique<Group>(level.getGroupPrototype());
+        group->setId(*createId(_keys[slot]));
+        group->setRank(_ranks[slot]);
+        const Acc * acc = &_values[slot * m];
+        for (size_t i(0); i < m; i++) {
+            AggregationResult & aggr = group->getAggregationResult(i);
+            switch (_accumulators[i].type) {
+            case AccType::COUNT:
+                static_cast<CountAggregationResult &>(aggr).setCount(acc[i].i);
+                break;
+            case AccType::INT_SUM:
+                aggr.getResult().set(Int64ResultNode(acc[i].i));
+                break;
+            case AccType::FLOAT_SUM:
+                aggr.getResult().set(FloatResultNode(acc[i].f));
+                break;
+            }
+        }
+        request.root().addChild(std::move(group));
+    }
+    request.postAggregate();
+    request.postMerge();
+    request.sortById();
+}
+
+}
@@ -0,0 +1,83 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchlib/aggregation/grouping.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vector>
+
+namespace search::attribute { class IAttributeVector; }
+namespace search { class BitVector; }
+
+namespace search::grouping {
+
+/**
+ * Grouping engine for the common case of a single level grouping on a
+ * single value attribute where each group only collects count() and
+ * sum() of single value numeric attributes. Instead of building Group
+ * objects with polymorphic ResultNode values per document, hits are
+ * aggregated into a flat hash table keyed on the raw attribute value
+ * (or the enum handle for string attributes) with typed accumulators.
+ * Group objects are only created when the result is stored back into
+ * the Grouping request.
+ *
+ * The engine is intended to be used per match thread. Partial results
+ * from several engines for the same request can be merged before
+ * being converted.
+ **/
+class FlatGroupingEngine
+{
+public:
+    using IAttributeVector = search::attribute::IAttributeVector;
+    using DocId = uint32_t;
+
+    /**
+     * Returns true if the given (configured) grouping request can be
+     * handled by this engine with the same result as Grouping::aggregate.
+     **/
+    static bool supports(const aggregation::Grouping & request);
+
+    FlatGroupingEngine(const FlatGroupingEngine &) = delete;
+    FlatGroupingEngine & operator = (const FlatGroupingEngine &) = delete;
+    explicit FlatGroupingEngine(const aggregation::Grouping & request);
+    ~FlatGroupingEngine();
+
+    void aggregate(DocId docId, HitRank rank);
+    void aggregate(const RankedHit * rankedHit, unsigned int len);
+    void aggregate(const RankedHit * rankedHit, unsigned int len, const BitVector * bVec);
+    void merge(const FlatGroupingEngine & b);
+    size_t numGroups() const { return _keys.size(); }
+
+    /**
+     * Replace the groups below the root of the request with the
+     * groups aggregated by this engine, and run the same post
+     * processing as Grouping::aggregate does.
+     **/
+    void fill(aggregation::Grouping & request) const;
+
+private:
+    enum class KeyType { INTEGER, FLOAT, ENUM };
+    enum class AccType { COUNT, INT_SUM, FLOAT_SUM };
+    union Acc {
+        int64_t i;
+        double  f;
+    };
+    struct Accumulator {
+        AccType                  type;
+        const IAttributeVector * attr;
+    };
+
+    int64_t readKey(DocId docId) const;
+    uint32_t lookup(int64_t key, HitRank rank);
+    expression::ResultNode::UP createId(int64_t key) const;
+
+    const aggregation::Grouping   & _request;
+    const IAttributeVector        * _keyAttr;
+    KeyType                         _keyType;
+    std::vector<Accumulator>        _accumulators;
+    vespalib::hash_map<int64_t, uint32_t> _slots;
+    std::vector<int64_t>            _keys;
+    std::vector<HitRank>            _ranks;
+    std::vector<Acc>                _values; // _accumulators.size() values per slot
+};
+
+}
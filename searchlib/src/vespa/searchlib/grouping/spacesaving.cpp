@@ -0,0 +1,156 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "spacesaving.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace search {
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::siftDown(size_t pos) {
+    Counter counter = _heap[pos];
+    size_t size = _heap.size();
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= size) {
+            break;
+        }
+        if ((child + 1 < size) && (_heap[child + 1].count < _heap[child].count)) {
+            ++child;
+        }
+        if (!(_heap[child].count < counter.count)) {
+            break;
+        }
+        place(pos, _heap[child]);
+        pos = child;
+    }
+    place(pos, counter);
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::siftUp(size_t pos) {
+    Counter counter = _heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!(counter.count < _heap[parent].count)) {
+            break;
+        }
+        place(pos, _heap[parent]);
+        pos = parent;
+    }
+    place(pos, counter);
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::insert(const Counter &counter) {
+    _heap.push_back(counter);
+    siftUp(_heap.size() - 1);
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::aggregate(KeyT key, CountT weight) {
+    _total += weight;
+    auto found = _index.find(key);
+    if (found != _index.end()) {
+        _heap[found->second].count += weight;
+        siftDown(found->second);
+    } else if (!isFull()) {
+        insert(Counter{key, weight, CountT(0)});
+    } else {
+        // Replace the counter with the lowest count; the new key may
+        // have been seen up to that many times before.
+        Counter &victim = _heap[0];
+        _index.erase(victim.key);
+        CountT min = victim.count;
+        victim = Counter{key, min + weight, min};
+        _index[key] = 0;
+        siftDown(0);
+    }
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::rebuild(std::vector<Counter> counters) {
+    if (counters.size() > _capacity) {
+        std::nth_element(counters.begin(), counters.begin() + _capacity, counters.end(),
+                         [](const Counter &a, const Counter &b) { return b.count < a.count; });
+        counters.resize(_capacity);
+    }
+    _heap.clear();
+    _index.clear();
+    for (const Counter &counter : counters) {
+        insert(counter);
+    }
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::merge(const SpaceSaving &other) {
+    CountT myMin = getMaxError();
+    CountT otherMin = other.getMaxError();
+    std::vector<Counter> merged;
+    merged.reserve(_heap.size() + other._heap.size());
+    for (const Counter &counter : _heap) {
+        auto found = other._index.find(counter.key);
+        if (found != other._index.end()) {
+            const Counter &o = other._heap[found->second];
+            merged.push_back(Counter{counter.key, counter.count + o.count, counter.error + o.error});
+        } else {
+            merged.push_back(Counter{counter.key, counter.count + otherMin, counter.error + otherMin});
+        }
+    }
+    for (const Counter &o : other._heap) {
+        if (_index.find(o.key) == _index.end()) {
+            merged.push_back(Counter{o.key, o.count + myMin, o.error + myMin});
+        }
+    }
+    _total += other._total;
+    rebuild(std::move(merged));
+}
+
+template <typename KeyT, typename CountT>
+std::vector<typename SpaceSaving<KeyT, CountT>::Counter>
+SpaceSaving<KeyT, CountT>::getTop(size_t n) const {
+    std::vector<Counter> result(_heap);
+    auto order = [](const Counter &a, const Counter &b) {
+        return (b.count < a.count) || (!(a.count < b.count) && (a.key < b.key));
+    };
+    n = std::min(n, result.size());
+    std::partial_sort(result.begin(), result.begin() + n, result.end(), order);
+    result.resize(n);
+    return result;
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::serialize(vespalib::Serializer &os) const {
+    os << _capacity << _total << uint32_t(_heap.size());
+    for (const Counter &counter : _heap) {
+        os << counter.key << counter.count << counter.error;
+    }
+}
+
+template <typename KeyT, typename CountT>
+void SpaceSaving<KeyT, CountT>::deserialize(vespalib::Deserializer &is) {
+    uint32_t capacity;
+    CountT total;
+    uint32_t size;
+    is >> capacity >> total >> size;
+    if ((capacity == 0) || (capacity > MAX_CAPACITY) || (size > capacity)) {
+        throw std::runtime_error(vespalib::make_string("Invalid space-saving summary: capacity %u, size %u",
+                                                       capacity, size));
+    }
+    std::vector<Counter> counters;
+    counters.reserve(size);
+    for (uint32_t i = 0; i < size; ++i) {
+        Counter counter;
+        is >> counter.key >> counter.count >> counter.error;
+        counters.push_back(counter);
+    }
+    _capacity = capacity;
+    _total = total;
+    rebuild(std::move(counters));
+}
+
+template class SpaceSaving<uint64_t, uint64_t>;
+
+}  // namespace search
@@ -0,0 +1,87 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/objects/deserializer.h>
+#include <vespa/vespalib/objects/serializer.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <cassert>
+#include <vector>
+
+namespace search {
+
+/**
+ * Space-Saving summary used to find the top groups by count or sum
+ * with memory bounded by the given capacity, independent of the
+ * number of distinct keys seen.
+ *
+ * Each tracked key has an estimated count that never underestimates
+ * the true count, and an error such that (count - error) never
+ * overestimates it. The error of any key is at most
+ * getTotal() / getCapacity(). Keys with a true count above that bound
+ * are always tracked. Weights must be non-negative.
+ *
+ * Summaries can be merged (across match threads and content nodes)
+ * with the same guarantees, using the mergeable Space-Saving scheme
+ * where keys missing from one side are assumed to have that side's
+ * minimum count.
+ */
+template <typename KeyT = uint64_t, typename CountT = uint64_t>
+class SpaceSaving {
+public:
+    struct Counter {
+        KeyT   key;
+        CountT count;
+        CountT error;
+        CountT lowerBound() const { return count - error; }
+    };
+
+    // Upper limit on the capacity accepted when deserializing.
+    static constexpr uint32_t MAX_CAPACITY = 1u << 20;
+
+    explicit SpaceSaving(uint32_t capacity)
+        : _capacity(capacity), _total(0), _heap(), _index()
+    {
+        assert(capacity > 0);
+    }
+
+    void aggregate(KeyT key, CountT weight = 1);
+    void merge(const SpaceSaving &other);
+
+    uint32_t getCapacity() const { return _capacity; }
+    size_t getSize() const { return _heap.size(); }
+    CountT getTotal() const { return _total; }
+    bool isFull() const { return _heap.size() >= _capacity; }
+    bool isTracked(KeyT key) const { return _index.find(key) != _index.end(); }
+
+    // The key that the next untracked key will replace when full.
+    KeyT getMinKey() const { return _heap[0].key; }
+
+    // Upper bound on the error of any estimate, and on the true count
+    // of any key that is not tracked.
+    CountT getMaxError() const { return isFull() ? _heap[0].count : CountT(0); }
+
+    // The n counters with highest estimated count, highest first.
+    std::vector<Counter> getTop(size_t n) const;
+
+    void serialize(vespalib::Serializer &os) const;
+    // Throws std::runtime_error if the serialized summary is malformed.
+    void deserialize(vespalib::Deserializer &is);
+
+private:
+    void place(size_t pos, const Counter &counter) {
+        _heap[pos] = counter;
+        _index[counter.key] = pos;
+    }
+    void siftDown(size_t pos);
+    void siftUp(size_t pos);
+    void insert(const Counter &counter);
+    void rebuild(std::vector<Counter> counters);
+
+    uint32_t                       _capacity;
+    CountT                         _total;
+    std::vector<Counter>           _heap;  // min-heap on count
+    vespalib::hash_map<KeyT, uint32_t> _index; // key -> position in _heap
+};
+
+}  // namespace search
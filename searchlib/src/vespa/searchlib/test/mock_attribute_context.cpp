@@ -9,7 +9,7 @@ MockAttributeContext::get(const string &name) const {
     if (_vectors.find(name) == _vectors.end()) {
         return 0;
     }
-    return _vectors.find(name)->second;
+    return _vectors.find(name)->second.get();
 }
 const IAttributeVector *
 MockAttributeContext::getAttribute(const string &name) const {
@@ -24,20 +24,19 @@ MockAttributeContext::getAttributeList(std::vector<const IAttributeVector *> & l
     Map::const_iterator pos = _vectors.begin();
     Map::const_iterator end = _vectors.end();
     for (; pos != end; ++pos) {
-        list.push_back(pos->second);
-    }
-}
-MockAttributeContext::~MockAttributeContext() {
-    Map::iterator pos = _vectors.begin();
-    Map::iterator end = _vectors.end();
-    for (; pos != end; ++pos) {
-        delete pos->second;
+        list.push_back(pos->second.get());
     }
 }
+MockAttributeContext::~MockAttributeContext() = default;
 
 void
 MockAttributeContext::add(IAttributeVector *attr) {
-    _vectors[attr->getName()] = attr;
+    add(std::shared_ptr<IAttributeVector>(attr));
+}
+
+void
+MockAttributeContext::add(std::shared_ptr<IAttributeVector> attr) {
+    _vectors[attr->getName()] = std::move(attr);
 }
 
 void
@@ -4,18 +4,20 @@
 
 #include <vespa/searchcommon/attribute/iattributecontext.h>
 #include <map>
+#include <memory>
 
 namespace search::attribute::test {
 
 class MockAttributeContext : public IAttributeContext
 {
 private:
-    typedef std::map<string, IAttributeVector *> Map;
+    typedef std::map<string, std::shared_ptr<IAttributeVector>> Map;
     Map _vectors;
 
 public:
     ~MockAttributeContext() override;
     void add(IAttributeVector *attr);
+    void add(std::shared_ptr<IAttributeVector> attr);
 
     const IAttributeVector *get(const string &name) const;
     const IAttributeVector * getAttribute(const string &name) const override;
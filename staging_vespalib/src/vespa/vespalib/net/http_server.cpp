@@ -18,9 +18,9 @@ HttpServer::get(Portal::GetRequest req)
 
 //-----------------------------------------------------------------------------
 
-HttpServer::HttpServer(int port_in)
+HttpServer::HttpServer(int port_in, size_t num_reactors)
     : _handler_repo(),
-      _server(Portal::create(CryptoEngine::get_default(), port_in)),
+      _server(Portal::create(CryptoEngine::get_default(), port_in, num_reactors)),
       _root(_server->bind("/", *this))
 {
 }
@@ -13,7 +13,8 @@ namespace vespalib {
  * a specific port to the constructor or use 0 to bind to a random
  * port. Note that you may not ask about the actual port until after
  * the server has been started. Request dispatching is done using a
- * JsonHandlerRepo.
+ * JsonHandlerRepo. Requests are served by num_reactors event loop
+ * threads, each accepting its share of the connections.
  **/
 class HttpServer : public Portal::GetHandler
 {
@@ -25,7 +26,8 @@ private:
     void get(Portal::GetRequest req) override;
 public:
     typedef std::unique_ptr<HttpServer> UP;
-    HttpServer(int port_in);
+    HttpServer(int port_in, size_t num_reactors);
+    HttpServer(int port_in) : HttpServer(port_in, 1) {}
     ~HttpServer();
     const vespalib::string &host() const { return _server->my_host(); }
     JsonHandlerRepo &repo() { return _handler_repo; }
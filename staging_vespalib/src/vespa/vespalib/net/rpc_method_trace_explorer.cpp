@@ -0,0 +1,14 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "rpc_method_trace_explorer.h"
+#include <vespa/fnet/frt/method_tracer.h>
+
+namespace vespalib {
+
+void
+RpcMethodTraceExplorer::get_state(const slime::Inserter &inserter, bool full) const
+{
+    _tracer.to_slime(inserter.insertObject(), full);
+}
+
+} // namespace vespalib
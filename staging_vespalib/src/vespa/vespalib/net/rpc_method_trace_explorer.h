@@ -0,0 +1,26 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "state_explorer.h"
+
+namespace fnet::frt { class MethodTracer; }
+
+namespace vespalib {
+
+/**
+ * Exposes the per method statistics collected by an RPC method
+ * tracer through the StateExplorer interface. Histogram buckets are
+ * only included in the full state.
+ **/
+class RpcMethodTraceExplorer : public StateExplorer
+{
+private:
+    const fnet::frt::MethodTracer &_tracer;
+
+public:
+    RpcMethodTraceExplorer(const fnet::frt::MethodTracer &tracer) : _tracer(tracer) {}
+    void get_state(const slime::Inserter &inserter, bool full) const override;
+};
+
+} // namespace vespalib
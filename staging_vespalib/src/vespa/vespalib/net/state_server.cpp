@@ -5,11 +5,12 @@
 namespace vespalib {
 
 StateServer::StateServer(int port,
+                         size_t num_reactors,
                          const HealthProducer &hp,
                          MetricsProducer &mp,
                          ComponentConfigProducer &ccp)
     : _api(hp, mp, ccp),
-      _server(port),
+      _server(port, num_reactors),
       _tokens()
 {
     _tokens.push_back(_server.repo().bind("/state/v1", _api));
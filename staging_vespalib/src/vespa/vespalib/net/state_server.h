@@ -25,7 +25,10 @@ private:
 
 public:
     typedef std::unique_ptr<StateServer> UP;
-    StateServer(int port, const HealthProducer &hp, MetricsProducer &mp, ComponentConfigProducer &ccp);
+    StateServer(int port, const HealthProducer &hp, MetricsProducer &mp, ComponentConfigProducer &ccp)
+        : StateServer(port, 1, hp, mp, ccp) {}
+    // num_reactors > 1 keeps slow requests (like huge metric snapshots) from delaying the rest
+    StateServer(int port, size_t num_reactors, const HealthProducer &hp, MetricsProducer &mp, ComponentConfigProducer &ccp);
     ~StateServer();
     int getListenPort() { return _server.port(); }
     JsonHandlerRepo &repo() { return _api.repo(); }
@@ -0,0 +1,109 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/storage/persistence/bucket_range_summary.h>
+#include <vespa/storage/persistence/mergehandler.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+
+namespace storage {
+
+using Entry = api::GetBucketDiffCommand::Entry;
+
+namespace {
+
+std::vector<Entry> make_entries(uint64_t first, uint64_t count) {
+    std::vector<Entry> entries(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        entries[i]._timestamp = first + i;
+        entries[i]._flags = MergeHandler::IN_USE;
+    }
+    return entries;
+}
+
+std::vector<uint32_t> differing(const std::vector<Entry>& a, const std::vector<Entry>& b) {
+    std::vector<uint32_t> ranges;
+    BucketRangeSummary(a).add_differing_ranges(BucketRangeSummary(b).hashes(), ranges);
+    return ranges;
+}
+
+}
+
+TEST(BucketRangeSummaryTest, equal_content_gives_equal_summary_independent_of_order)
+{
+    auto entries = make_entries(1000, 500);
+    auto reversed = entries;
+    std::reverse(reversed.begin(), reversed.end());
+    EXPECT_EQ(BucketRangeSummary(entries).hashes(), BucketRangeSummary(reversed).hashes());
+    EXPECT_TRUE(differing(entries, reversed).empty());
+}
+
+TEST(BucketRangeSummaryTest, missing_entry_differs_in_its_range_only)
+{
+    auto entries = make_entries(1000, 500);
+    auto missing = entries;
+    missing.erase(missing.begin() + 17);
+    EXPECT_EQ((std::vector<uint32_t>{BucketRangeSummary::range_of(entries[17])}), differing(entries, missing));
+}
+
+TEST(BucketRangeSummaryTest, remove_differs_from_put_with_same_timestamp)
+{
+    auto entries = make_entries(1000, 500);
+    auto removed = entries;
+    removed[3]._flags |= MergeHandler::DELETED;
+    EXPECT_EQ((std::vector<uint32_t>{BucketRangeSummary::range_of(entries[3])}), differing(entries, removed));
+}
+
+TEST(BucketRangeSummaryTest, entries_differing_only_in_gid_differ_in_their_range)
+{
+    auto entries = make_entries(1000, 500);
+    auto other_gid = entries;
+    other_gid[42]._gid = document::GlobalId("aaaaaaaaaaaa");
+    EXPECT_EQ((std::vector<uint32_t>{BucketRangeSummary::range_of(entries[42])}), differing(entries, other_gid));
+}
+
+TEST(BucketRangeSummaryTest, differing_ranges_are_merged_into_sorted_list)
+{
+    auto entries = make_entries(1000, 500);
+    auto missing = entries;
+    missing.erase(missing.begin() + 5);
+    uint32_t range = BucketRangeSummary::range_of(entries[5]);
+    uint32_t other = (range + 7) % BucketRangeSummary::NUM_RANGES;
+    std::vector<uint32_t> ranges{std::min(range, other), std::max(range, other)};
+    BucketRangeSummary(entries).add_differing_ranges(BucketRangeSummary(missing).hashes(), ranges);
+    EXPECT_EQ((std::vector<uint32_t>{std::min(range, other), std::max(range, other)}), ranges);
+}
+
+TEST(BucketRangeSummaryTest, summary_of_unexpected_size_differs_in_all_ranges)
+{
+    std::vector<uint32_t> ranges;
+    BucketRangeSummary(make_entries(1000, 10)).add_differing_ranges({1, 2, 3}, ranges);
+    EXPECT_EQ(BucketRangeSummary::NUM_RANGES, ranges.size());
+}
+
+TEST(BucketRangeSummaryTest, entries_are_spread_over_ranges)
+{
+    std::vector<uint32_t> counts(BucketRangeSummary::NUM_RANGES, 0);
+    for (const auto& entry : make_entries(1600000000000000ul, 25600)) {
+        ++counts[BucketRangeSummary::range_of(entry)];
+    }
+    EXPECT_GT(*std::min_element(counts.begin(), counts.end()), 50u);
+    EXPECT_LT(*std::max_element(counts.begin(), counts.end()), 150u);
+}
+
+TEST(BucketRangeSummaryTest, filter_keeps_entries_in_given_ranges)
+{
+    auto entries = make_entries(1000, 500);
+    std::vector<uint32_t> ranges{BucketRangeSummary::range_of(entries[0]), BucketRangeSummary::range_of(entries[1])};
+    std::sort(ranges.begin(), ranges.end());
+    auto filtered = entries;
+    BucketRangeSummary::filter(filtered, ranges);
+    EXPECT_FALSE(filtered.empty());
+    EXPECT_LT(filtered.size(), entries.size());
+    EXPECT_TRUE(std::is_sorted(filtered.begin(), filtered.end()));
+    size_t expected = std::count_if(entries.begin(), entries.end(), [&](const Entry& e) {
+        return std::binary_search(ranges.begin(), ranges.end(), BucketRangeSummary::range_of(e));
+    });
+    EXPECT_EQ(expected, filtered.size());
+}
+
+}
@@ -0,0 +1,105 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <tests/persistence/common/filestortestfixture.h>
+#include <vespa/storage/persistence/filestorage/filestormetrics.h>
+#include <vespa/document/test/make_document_bucket.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <atomic>
+#include <cinttypes>
+#include <chrono>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP("filestorhandler_benchmark");
+
+using document::test::makeDocumentBucket;
+
+namespace storage {
+
+namespace {
+
+constexpr uint32_t num_buckets = 1024;
+constexpr uint32_t num_ops = 400000;
+constexpr uint32_t num_schedulers = 4;
+
+struct DiscardingMessageSender : MessageSender {
+    void sendCommand(const std::shared_ptr<api::StorageCommand>&) override {}
+    void sendReply(const std::shared_ptr<api::StorageReply>&) override {}
+};
+
+}
+
+/*
+ * Measures throughput of the persistence queue itself: scheduler threads
+ * (standing in for the communication layer) feed removes for random buckets
+ * while persistence threads take and release bucket locks without doing
+ * any work, which is where queue lock contention shows up under feed.
+ */
+struct FileStorHandlerBenchmark : FileStorTestFixture {
+    std::vector<std::shared_ptr<api::StorageMessage>> _ops;
+
+    void SetUp() override {
+        FileStorTestFixture::SetUp();
+        _ops.reserve(num_ops);
+        for (uint32_t i = 0; i < num_ops; ++i) {
+            uint64_t location = (i * 7919u) % num_buckets;
+            document::DocumentId id(vespalib::make_string("id:foo:testdoctype1:n=%" PRIu64 ":%u", location, i));
+            auto cmd = std::make_shared<api::RemoveCommand>(makeDocumentBucket(document::BucketId(16, location)), id, 1000 + i);
+            cmd->setAddress(makeSelfAddress());
+            _ops.push_back(std::move(cmd));
+        }
+    }
+
+    double ops_per_second(uint32_t num_threads, uint32_t threads_per_stripe);
+};
+
+double
+FileStorHandlerBenchmark::ops_per_second(uint32_t num_threads, uint32_t threads_per_stripe)
+{
+    uint32_t num_stripes = std::max(1u, num_threads / threads_per_stripe);
+    DiscardingMessageSender sender;
+    FileStorMetrics metrics;
+    metrics.initDiskMetrics(num_stripes, num_threads);
+    FileStorHandlerImpl handler(num_threads, num_stripes, sender, metrics, _node->getComponentRegister());
+    handler.setGetNextMessageTimeout(1ms);
+
+    std::atomic<uint32_t> processed(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&handler, &processed, t, num_stripes]() {
+            while (processed.load(std::memory_order_relaxed) < num_ops) {
+                auto locked = handler.getNextMessage(t % num_stripes);
+                if (locked.second) {
+                    processed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (uint32_t t = 0; t < num_schedulers; ++t) {
+        threads.emplace_back([this, &handler, t]() {
+            for (uint32_t i = t; i < num_ops; i += num_schedulers) {
+                handler.schedule(_ops[i]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return num_ops / elapsed.count();
+}
+
+TEST_F(FileStorHandlerBenchmark, ops_per_second_by_persistence_threads) {
+    for (uint32_t threads_per_stripe : {2u, 1u}) {
+        for (uint32_t num_threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+            double ops = ops_per_second(num_threads, threads_per_stripe);
+            fprintf(stderr, "threads: %2u, threads per stripe: %u, ops/s: %10.0f\n",
+                    num_threads, threads_per_stripe, ops);
+        }
+    }
+}
+
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/document/base/testdocman.h>
+#include <vespa/storage/persistence/bucket_range_summary.h>
 #include <vespa/storage/persistence/mergehandler.h>
 #include <vespa/storage/persistence/filestorage/mergestatus.h>
 #include <tests/persistence/persistencetestutils.h>
@@ -1454,6 +1455,90 @@ TEST_P(MergeHandlerTest, partially_filled_apply_bucket_diff_reply)
     LOG(debug, "got mergebucket reply");
 }
 
+TEST_P(MergeHandlerTest, range_summary_merge_of_equal_copies_completes_without_diff) {
+    MergeHandler handler = createHandler();
+    handler.configure(GetParam(), true);
+    auto cmd = std::make_shared<api::MergeBucketCommand>(_bucket, _nodes, _maxTimestamp);
+    handler.handleMergeBucket(*cmd, createTracker(cmd, _bucket));
+
+    auto getBucketDiffCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    EXPECT_TRUE(getBucketDiffCmd->isRangeSummaryOnly());
+    EXPECT_EQ(BucketRangeSummary::NUM_RANGES, getBucketDiffCmd->getRangeSummary().size());
+    EXPECT_TRUE(getBucketDiffCmd->getDiff().empty());
+    EXPECT_TRUE(getBucketDiffCmd->getRanges().empty());
+
+    auto getBucketDiffReply = std::make_unique<api::GetBucketDiffReply>(*getBucketDiffCmd);
+    getBucketDiffReply->setRangeSummaryCompared(true);
+    handler.handleGetBucketDiffReply(*getBucketDiffReply, messageKeeper());
+
+    ASSERT_EQ(2u, messageKeeper()._msgs.size());
+    auto mergeReply = std::dynamic_pointer_cast<api::MergeBucketReply>(messageKeeper()._msgs[1]);
+    ASSERT_TRUE(mergeReply);
+    EXPECT_TRUE(mergeReply->getResult().success());
+}
+
+TEST_P(MergeHandlerTest, range_summary_merge_only_diffs_entries_in_differing_ranges) {
+    MergeHandler handler = createHandler();
+    handler.configure(GetParam(), true);
+    auto cmd = std::make_shared<api::MergeBucketCommand>(_bucket, _nodes, _maxTimestamp);
+    handler.handleMergeBucket(*cmd, createTracker(cmd, _bucket));
+
+    auto summaryCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    std::vector<api::GetBucketDiffCommand::Entry> all;
+    ASSERT_TRUE(handler.buildBucketInfoList(spi::Bucket(_bucket), Timestamp(_maxTimestamp), 0, all, *_context));
+    ASSERT_EQ(17u, all.size());
+    std::vector<uint32_t> ranges{BucketRangeSummary::range_of(all[0])};
+
+    auto summaryReply = std::make_unique<api::GetBucketDiffReply>(*summaryCmd);
+    summaryReply->getRanges() = ranges;
+    summaryReply->setRangeSummaryCompared(true);
+    handler.handleGetBucketDiffReply(*summaryReply, messageKeeper());
+
+    auto diffCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    EXPECT_FALSE(diffCmd->isRangeSummaryOnly());
+    EXPECT_EQ(ranges, diffCmd->getRanges());
+    ASSERT_FALSE(diffCmd->getDiff().empty());
+    EXPECT_LT(diffCmd->getDiff().size(), all.size());
+    for (const auto& entry : diffCmd->getDiff()) {
+        EXPECT_EQ(ranges[0], BucketRangeSummary::range_of(entry));
+    }
+}
+
+TEST_P(MergeHandlerTest, range_summary_merge_falls_back_to_full_diff_if_summary_not_compared) {
+    MergeHandler handler = createHandler();
+    handler.configure(GetParam(), true);
+    auto cmd = std::make_shared<api::MergeBucketCommand>(_bucket, _nodes, _maxTimestamp);
+    handler.handleMergeBucket(*cmd, createTracker(cmd, _bucket));
+
+    auto summaryCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    auto summaryReply = std::make_unique<api::GetBucketDiffReply>(*summaryCmd);
+    handler.handleGetBucketDiffReply(*summaryReply, messageKeeper());
+
+    auto diffCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    EXPECT_FALSE(diffCmd->isRangeSummaryOnly());
+    EXPECT_TRUE(diffCmd->getRanges().empty());
+    EXPECT_EQ(17u, diffCmd->getDiff().size());
+}
+
+TEST_P(MergeHandlerTest, range_summary_is_compared_at_end_of_chain) {
+    setUpChain(BACK);
+    MergeHandler handler = createHandler();
+    std::vector<api::GetBucketDiffCommand::Entry> entries;
+    ASSERT_TRUE(handler.buildBucketInfoList(spi::Bucket(_bucket), Timestamp(_maxTimestamp), 1, entries, *_context));
+    std::vector<uint32_t> ranges{BucketRangeSummary::range_of(entries[0])};
+    // Pretend the other copy is missing the first entry.
+    entries.erase(entries.begin());
+
+    auto cmd = std::make_shared<api::GetBucketDiffCommand>(_bucket, _nodes, _maxTimestamp);
+    cmd->getRangeSummary() = BucketRangeSummary(entries).hashes();
+    MessageTracker::UP tracker = handler.handleGetBucketDiff(*cmd, createTracker(cmd, _bucket));
+    auto reply = std::dynamic_pointer_cast<api::GetBucketDiffReply>(std::move(*tracker).stealReplySP());
+    ASSERT_TRUE(reply);
+    EXPECT_TRUE(reply->isRangeSummaryCompared());
+    EXPECT_TRUE(reply->getDiff().empty());
+    EXPECT_EQ(ranges, reply->getRanges());
+}
+
 VESPA_GTEST_INSTANTIATE_TEST_SUITE_P(AsyncApplyBucketDiffParams, MergeHandlerTest, testing::Values(false, true));
 
 } // storage
@@ -163,4 +163,68 @@ TEST_F(PersistenceQueueTest, exclusive_locked_operation_not_started_if_exclusive
     ASSERT_FALSE(lock1.first.get());
 }
 
+
+TEST_F(PersistenceQueueTest, batchable_operations_for_locked_bucket_are_fetched_in_scheduling_order) {
+    Fixture f(*this);
+
+    f.filestorHandler->schedule(createPut(1234, 0));
+    f.filestorHandler->schedule(createPut(1234, 1));
+    f.filestorHandler->schedule(createPut(5432, 0));
+    f.filestorHandler->schedule(createPut(1234, 2));
+    f.filestorHandler->schedule(createGet(1234));
+    f.filestorHandler->schedule(createPut(1234, 3));
+
+    auto lock0 = f.filestorHandler->getNextMessage(f.stripeId);
+    ASSERT_TRUE(lock0.first.get());
+    auto batch = f.filestorHandler->fetch_batchable_operations(*lock0.first, 10);
+    // Stops at the get, which cannot be batched.
+    ASSERT_EQ(2u, batch.size());
+    EXPECT_EQ("id:foo:testdoctype1:n=1234:1", dynamic_cast<api::PutCommand&>(*batch[0]).getDocumentId().toString());
+    EXPECT_EQ("id:foo:testdoctype1:n=1234:2", dynamic_cast<api::PutCommand&>(*batch[1]).getDocumentId().toString());
+    EXPECT_EQ(3u, f.filestorHandler->getQueueSize());
+
+    // Bucket is still locked, so the other bucket is next.
+    auto lock1 = f.filestorHandler->getNextMessage(f.stripeId);
+    ASSERT_TRUE(lock1.first.get());
+    EXPECT_EQ(document::BucketId(16, 5432), dynamic_cast<api::PutCommand&>(*lock1.second).getBucketId());
+}
+
+TEST_F(PersistenceQueueTest, batchable_operations_are_limited_by_max_ops) {
+    Fixture f(*this);
+
+    for (uint64_t i = 0; i < 5; ++i) {
+        f.filestorHandler->schedule(createPut(1234, i));
+    }
+    auto lock0 = f.filestorHandler->getNextMessage(f.stripeId);
+    ASSERT_TRUE(lock0.first.get());
+    EXPECT_EQ(2u, f.filestorHandler->fetch_batchable_operations(*lock0.first, 2).size());
+    EXPECT_EQ(2u, f.filestorHandler->getQueueSize());
+    EXPECT_TRUE(f.filestorHandler->fetch_batchable_operations(*lock0.first, 0).empty());
+}
+
+TEST_F(PersistenceQueueTest, no_operations_are_batched_under_shared_lock) {
+    Fixture f(*this);
+
+    f.filestorHandler->schedule(createGet(1234));
+    f.filestorHandler->schedule(createPut(1234, 0));
+    auto lock0 = f.filestorHandler->getNextMessage(f.stripeId);
+    ASSERT_TRUE(lock0.first.get());
+    EXPECT_EQ(api::LockingRequirements::Shared, lock0.first->lockingRequirements());
+    EXPECT_TRUE(f.filestorHandler->fetch_batchable_operations(*lock0.first, 10).empty());
+    EXPECT_EQ(1u, f.filestorHandler->getQueueSize());
+}
+
+TEST_F(PersistenceQueueTest, conditional_operations_are_not_batched) {
+    Fixture f(*this);
+
+    f.filestorHandler->schedule(createPut(1234, 0));
+    auto conditional = createPut(1234, 1);
+    static_cast<api::PutCommand&>(*conditional).setCondition(api::TestAndSetCondition("testdoctype1"));
+    f.filestorHandler->schedule(conditional);
+    f.filestorHandler->schedule(createPut(1234, 2));
+    auto lock0 = f.filestorHandler->getNextMessage(f.stripeId);
+    ASSERT_TRUE(lock0.first.get());
+    EXPECT_TRUE(f.filestorHandler->fetch_batchable_operations(*lock0.first, 10).empty());
+}
+
 } // namespace storage
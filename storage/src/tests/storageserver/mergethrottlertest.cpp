@@ -1445,6 +1445,54 @@ TEST_F(MergeThrottlerTest, backpressure_evicts_all_queued_merges) {
     EXPECT_EQ(ReturnCode::BUSY, dynamic_cast<const MergeBucketReply&>(*reply).getResult().getResult());
 }
 
+TEST_F(MergeThrottlerTest, merges_exceeding_byte_budget_are_queued) {
+    _throttlers[0]->set_max_merge_bytes(1000);
+
+    std::vector<uint64_t> estimated_bytes({800, 300, 100});
+    for (uint32_t i = 0; i < estimated_bytes.size(); ++i) {
+        auto cmd = MergeBuilder(document::BucketId(32, 0xf00000 + i)).create();
+        cmd->setEstimatedMergeBytes(estimated_bytes[i]);
+        _topLinks[0]->sendDown(cmd);
+    }
+
+    // First merge fits the budget and is forwarded. The second does not fit
+    // and blocks the third, even though the third would have fit on its own.
+    _topLinks[0]->waitForMessage(MessageType::MERGEBUCKET, _messageWaitTime);
+    waitUntilMergeQueueIs(*_throttlers[0], 2, _messageWaitTime);
+    EXPECT_EQ(1, _throttlers[0]->getActiveMerges().size());
+    EXPECT_EQ(800, _throttlers[0]->getActiveMergeBytes());
+    EXPECT_EQ(800, _throttlers[0]->getMetrics().active_merge_bytes.getLast());
+
+    // Completing the active merge frees the budget for the queued merges.
+    auto fwd = _topLinks[0]->getAndRemoveMessage(MessageType::MERGEBUCKET);
+    auto reply = std::make_shared<MergeBucketReply>(dynamic_cast<const MergeBucketCommand&>(*fwd));
+    _topLinks[0]->sendDown(reply);
+
+    _topLinks[0]->waitForMessages(3, _messageWaitTime); // 1 reply, 2 merges
+    waitUntilMergeQueueIs(*_throttlers[0], 0, _messageWaitTime);
+    EXPECT_EQ(400, _throttlers[0]->getActiveMergeBytes());
+    EXPECT_EQ(800, _throttlers[0]->getMetrics().merged_bytes.getValue());
+
+    // The estimate must follow the merge through the chain so that the budget
+    // is also enforced on downstream nodes.
+    _topLinks[0]->reset();
+    _throttlers[0]->set_max_merge_bytes(0);
+    _throttlers[1]->set_max_merge_bytes(1000);
+    for (uint32_t i = 0; i < 2; ++i) {
+        auto cmd = MergeBuilder(document::BucketId(32, 0xf10000 + i)).create();
+        cmd->setEstimatedMergeBytes(estimated_bytes[i]);
+        _topLinks[0]->sendDown(cmd);
+        _topLinks[0]->waitForMessage(MessageType::MERGEBUCKET, _messageWaitTime);
+        auto chained = _topLinks[0]->getAndRemoveMessage(MessageType::MERGEBUCKET);
+        EXPECT_EQ(estimated_bytes[i], dynamic_cast<const MergeBucketCommand&>(*chained).getEstimatedMergeBytes());
+        _topLinks[1]->sendDown(chained);
+    }
+    _topLinks[1]->waitForMessage(MessageType::MERGEBUCKET, _messageWaitTime);
+    waitUntilMergeQueueIs(*_throttlers[1], 1, _messageWaitTime);
+    EXPECT_EQ(1, _throttlers[1]->getActiveMerges().size());
+    EXPECT_EQ(800, _throttlers[1]->getActiveMergeBytes());
+}
+
 // TODO test message queue aborting (use rendezvous functionality--make guard)
 
 } // namespace storage
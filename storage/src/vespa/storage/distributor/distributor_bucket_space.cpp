@@ -85,7 +85,9 @@ void
 DistributorBucketSpace::set_pending_cluster_state(std::shared_ptr<const lib::ClusterState> pending_cluster_state)
 {
     _pending_cluster_state = std::move(pending_cluster_state);
-    clear();
+    // Ideal nodes only depend on the current cluster state and distribution,
+    // so they stay valid until one of those change.
+    _ownerships.clear();
     enumerate_available_nodes();
 }
 
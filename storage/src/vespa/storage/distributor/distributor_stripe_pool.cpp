@@ -74,6 +74,10 @@ TickableStripe& DistributorStripePool::stripe_of_key(uint64_t key) noexcept {
     return stripe_thread(stripe_of_bucket_key(key, _n_stripe_bits)).stripe();
 }
 
+size_t DistributorStripePool::stripe_index_of_key(uint64_t key) const noexcept {
+    return stripe_of_bucket_key(key, _n_stripe_bits);
+}
+
 void DistributorStripePool::notify_stripe_event_has_triggered(size_t stripe_idx) noexcept {
     if (_single_threaded_test_mode) {
         return;
@@ -86,6 +86,7 @@ public:
     void notify_stripe_event_has_triggered(size_t stripe_idx) noexcept;
     [[nodiscard]] const TickableStripe& stripe_of_key(uint64_t key) const noexcept;
     [[nodiscard]] TickableStripe& stripe_of_key(uint64_t key) noexcept;
+    [[nodiscard]] size_t stripe_index_of_key(uint64_t key) const noexcept;
     [[nodiscard]] size_t stripe_count() const noexcept { return _stripes.size(); }
     [[nodiscard]] bool is_stopped() const noexcept { return _stopped; }
 
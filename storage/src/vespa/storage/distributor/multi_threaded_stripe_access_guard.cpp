@@ -3,6 +3,10 @@
 #include "distributor_stripe.h"
 #include "distributor_stripe_pool.h"
 #include "distributor_stripe_thread.h"
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <exception>
 
 namespace storage::distributor {
 
@@ -70,10 +74,14 @@ MultiThreadedStripeAccessGuard::remove_superfluous_buckets(document::BucketSpace
                                                            const lib::ClusterState& new_state,
                                                            bool is_distribution_change)
 {
-    PotentialDataLossReport report;
-    for_each_stripe([&](TickableStripe& stripe) {
-        report.merge(stripe.remove_superfluous_buckets(bucket_space, new_state, is_distribution_change));
+    std::vector<PotentialDataLossReport> stripe_reports(_stripe_pool.stripe_count());
+    for_each_stripe_in_parallel([&](size_t stripe_idx, TickableStripe& stripe) {
+        stripe_reports[stripe_idx] = stripe.remove_superfluous_buckets(bucket_space, new_state, is_distribution_change);
     });
+    PotentialDataLossReport report;
+    for (const auto& stripe_report : stripe_reports) {
+        report.merge(stripe_report);
+    }
     return report;
 }
 
@@ -89,23 +97,19 @@ MultiThreadedStripeAccessGuard::merge_entries_into_db(document::BucketSpace buck
     if (entries.empty()) {
         return;
     }
-    std::vector<dbtransition::Entry> stripe_entries;
-    stripe_entries.reserve(entries.size() / _stripe_pool.stripe_count());
-    auto* curr_stripe = &_stripe_pool.stripe_of_key(entries[0].bucket_key);
-    stripe_entries.push_back(entries[0]);
-    for (size_t i = 1; i < entries.size(); ++i) {
-        const auto& entry = entries[i];
-        auto* next_stripe = &_stripe_pool.stripe_of_key(entry.bucket_key);
-        if (curr_stripe != next_stripe) {
-            curr_stripe->merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
-                                               new_state, storage_up_states, outdated_nodes, stripe_entries);
-            stripe_entries.clear();
-        }
-        curr_stripe = next_stripe;
-        stripe_entries.push_back(entry);
+    std::vector<std::vector<dbtransition::Entry>> stripe_entries(_stripe_pool.stripe_count());
+    for (auto& per_stripe : stripe_entries) {
+        per_stripe.reserve(entries.size() / _stripe_pool.stripe_count());
     }
-    curr_stripe->merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
-                                       new_state, storage_up_states, outdated_nodes, stripe_entries);
+    for (const auto& entry : entries) {
+        stripe_entries[_stripe_pool.stripe_index_of_key(entry.bucket_key)].push_back(entry);
+    }
+    for_each_stripe_in_parallel([&](size_t stripe_idx, TickableStripe& stripe) {
+        if (!stripe_entries[stripe_idx].empty()) {
+            stripe.merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
+                                         new_state, storage_up_states, outdated_nodes, stripe_entries[stripe_idx]);
+        }
+    });
 }
 
 void MultiThreadedStripeAccessGuard::update_read_snapshot_before_db_pruning() {
@@ -173,6 +177,41 @@ void MultiThreadedStripeAccessGuard::for_each_stripe(Func&& f) const {
     }
 }
 
+template <typename Func>
+void MultiThreadedStripeAccessGuard::for_each_stripe_in_parallel(Func&& f) {
+    // All stripe threads are parked and stripes do not share any mutable state
+    // (they run concurrently in normal operation), so each stripe can safely
+    // be processed by its own thread while the guard is held.
+    const size_t n_stripes = _stripe_pool.stripe_count();
+    std::vector<std::exception_ptr> errors(n_stripes);
+    auto run_stripe = [this, &f, &errors](size_t i) noexcept {
+        try {
+            f(i, _stripe_pool.stripe_thread(i).stripe());
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    if (n_stripes > 1) {
+        auto& executor = _accessor.helper_executor();
+        for (size_t i = 1; i < n_stripes; ++i) {
+            auto rejected = executor.execute(vespalib::makeLambdaTask([&run_stripe, i] { run_stripe(i); }));
+            if (rejected) {
+                rejected->run();
+            }
+        }
+        run_stripe(0);
+        // Tasks reference f and errors, so always wait for all of them before returning.
+        executor.sync();
+    } else {
+        run_stripe(0);
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 std::unique_ptr<StripeAccessGuard> MultiThreadedStripeAccessor::rendezvous_and_hold_all() {
     // For sanity checking of invariant of only one guard being allowed at any given time.
     assert(!_guard_held);
@@ -180,9 +219,19 @@ std::unique_ptr<StripeAccessGuard> MultiThreadedStripeAccessor::rendezvous_and_h
     return std::make_unique<MultiThreadedStripeAccessGuard>(*this, _stripe_pool);
 }
 
+MultiThreadedStripeAccessor::~MultiThreadedStripeAccessor() = default;
+
 void MultiThreadedStripeAccessor::mark_guard_released() {
     assert(_guard_held);
     _guard_held = false;
 }
 
+vespalib::ThreadStackExecutor& MultiThreadedStripeAccessor::helper_executor() {
+    // Created on first use since the stripe count is not known until the pool has been started.
+    if (!_helper_executor) {
+        _helper_executor = std::make_unique<vespalib::ThreadStackExecutor>(_stripe_pool.stripe_count() - 1, 256_Ki);
+    }
+    return *_helper_executor;
+}
+
 }
@@ -2,6 +2,9 @@
 #pragma once
 
 #include "stripe_access_guard.h"
+#include <memory>
+
+namespace vespalib { class ThreadStackExecutor; }
 
 namespace storage::distributor {
 
@@ -65,6 +68,12 @@ private:
 
     template <typename Func>
     void for_each_stripe(Func&& f) const;
+
+    // Calls f(stripe_index, stripe) for all stripes concurrently on the accessor's
+    // helper executor and the calling thread, and returns once all are done.
+    // The first exception thrown by f (if any) is rethrown on the calling thread.
+    template <typename Func>
+    void for_each_stripe_in_parallel(Func&& f);
 };
 
 /**
@@ -72,20 +81,23 @@ private:
  * in the provided stripe pool.
  */
 class MultiThreadedStripeAccessor : public StripeAccessor {
-    DistributorStripePool& _stripe_pool;
-    bool                   _guard_held;
+    DistributorStripePool&                        _stripe_pool;
+    std::unique_ptr<vespalib::ThreadStackExecutor> _helper_executor;
+    bool                                          _guard_held;
 
     friend class MultiThreadedStripeAccessGuard;
 public:
     explicit MultiThreadedStripeAccessor(DistributorStripePool& stripe_pool)
         : _stripe_pool(stripe_pool),
+          _helper_executor(),
           _guard_held(false)
     {}
-    ~MultiThreadedStripeAccessor() override = default;
+    ~MultiThreadedStripeAccessor() override;
 
     std::unique_ptr<StripeAccessGuard> rendezvous_and_hold_all() override;
 private:
     void mark_guard_released();
+    vespalib::ThreadStackExecutor& helper_executor();
 };
 
 }
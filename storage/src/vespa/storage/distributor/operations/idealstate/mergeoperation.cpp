@@ -7,6 +7,7 @@
 #include <vespa/storage/distributor/pendingmessagetracker.h>
 #include <vespa/vdslib/distribution/distribution.h>
 #include <vespa/vdslib/state/clusterstate.h>
+#include <algorithm>
 #include <array>
 
 #include <vespa/log/bufferedlogger.h>
@@ -137,9 +138,13 @@ MergeOperation::onStart(DistributorStripeMessageSender& sender)
                            getBucketId(),
                            _limiter,
                            nodes);
+    uint64_t estimated_merge_bytes = 0;
     for (uint32_t i=0; i<nodes.size(); ++i) {
         _mnodes.push_back(api::MergeBucketCommand::Node(
                 nodes[i]._nodeIndex, nodes[i]._sourceOnly));
+        // A merge never needs to move more data than the largest replica holds.
+        estimated_merge_bytes = std::max(estimated_merge_bytes,
+                                         uint64_t(nodes[i]._copy->getTotalDocumentSize()));
     }
 
     if (_mnodes.size() > 1) {
@@ -148,6 +153,7 @@ MergeOperation::onStart(DistributorStripeMessageSender& sender)
                 _mnodes,
                 _manager->operation_context().generate_unique_timestamp(),
                 clusterState.getVersion());
+        msg->setEstimatedMergeBytes(estimated_merge_bytes);
 
         // Due to merge forwarding/chaining semantics, we must always send
         // the merge command to the lowest indexed storage node involved in
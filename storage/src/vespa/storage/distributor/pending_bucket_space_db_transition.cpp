@@ -8,6 +8,7 @@
 #include <vespa/vdslib/distribution/distribution.h>
 #include <vespa/vdslib/state/clusterstate.h>
 #include <algorithm>
+#include <cassert>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".pendingbucketspacedbtransition");
@@ -52,6 +53,33 @@ PendingBucketSpaceDbTransition::PendingBucketSpaceDbTransition(document::BucketS
 
 PendingBucketSpaceDbTransition::~PendingBucketSpaceDbTransition() = default;
 
+PendingBucketSpaceDbTransition::DbMerger::DbMerger(api::Timestamp creation_timestamp,
+                                                   const lib::Distribution& distribution,
+                                                   const lib::ClusterState& new_state,
+                                                   const char* storage_up_states,
+                                                   const std::unordered_set<uint16_t>& outdated_nodes,
+                                                   const std::vector<dbtransition::Entry>& entries)
+    : _creation_timestamp(creation_timestamp),
+      _distribution(distribution),
+      _new_state(new_state),
+      _storage_up_states(storage_up_states),
+      _outdated_nodes(outdated_nodes),
+      _entries(entries),
+      _iter(0),
+      _ideal_nodes(),
+      _ideal_nodes_iter(0)
+{
+    std::vector<document::BucketId> buckets;
+    for (uint32_t i = 0; i < _entries.size(); ++i) {
+        if ((i == 0) || (_entries[i].bucket_key != _entries[i - 1].bucket_key)) {
+            buckets.push_back(_entries[i].bucket_id());
+        }
+    }
+    _distribution.getIdealStorageNodes(_new_state, buckets, _ideal_nodes, _storage_up_states);
+}
+
+PendingBucketSpaceDbTransition::DbMerger::~DbMerger() = default;
+
 PendingBucketSpaceDbTransition::Range
 PendingBucketSpaceDbTransition::DbMerger::skipAllForSameBucket()
 {
@@ -88,11 +116,9 @@ PendingBucketSpaceDbTransition::DbMerger::insertInfo(BucketDatabase::Entry& info
     std::vector<BucketCopy> copiesToAddOrUpdate(
             getCopiesThatAreNewOrAltered(info, range));
 
-    std::vector<uint16_t> order(
-            _distribution.getIdealStorageNodes(
-                    _new_state,
-                    _entries[range.first].bucket_id(),
-                    _storage_up_states));
+    // Each bucket range is inserted exactly once, in entry order.
+    assert(_ideal_nodes_iter < _ideal_nodes.size());
+    const std::vector<uint16_t>& order(_ideal_nodes[_ideal_nodes_iter++]);
     info->addNodes(copiesToAddOrUpdate, order, TrustedUpdate::DEFER);
 }
 
@@ -79,22 +79,18 @@ public:
         const std::unordered_set<uint16_t>& _outdated_nodes; // TODO hash_set
         const std::vector<dbtransition::Entry>& _entries;
         uint32_t _iter;
+        // Ideal nodes of each distinct bucket in _entries, in order, calculated
+        // as one batch since adjacent buckets mostly share the same seeds.
+        std::vector<std::vector<uint16_t>> _ideal_nodes;
+        uint32_t _ideal_nodes_iter;
     public:
         DbMerger(api::Timestamp creation_timestamp,
                  const lib::Distribution& distribution,
                  const lib::ClusterState& new_state,
                  const char* storage_up_states,
                  const std::unordered_set<uint16_t>& outdated_nodes,
-                 const std::vector<dbtransition::Entry>& entries)
-            : _creation_timestamp(creation_timestamp),
-              _distribution(distribution),
-              _new_state(new_state),
-              _storage_up_states(storage_up_states),
-              _outdated_nodes(outdated_nodes),
-              _entries(entries),
-              _iter(0)
-        {}
-        ~DbMerger() override = default;
+                 const std::vector<dbtransition::Entry>& entries);
+        ~DbMerger() override;
 
         BucketDatabase::MergingProcessor::Result merge(BucketDatabase::Merger&) override;
         void insert_remaining_at_end(BucketDatabase::TrailingInserter&) override;
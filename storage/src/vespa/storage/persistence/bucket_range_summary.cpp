@@ -0,0 +1,72 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "bucket_range_summary.h"
+#include "mergehandler.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <algorithm>
+#include <cstring>
+
+namespace storage {
+
+namespace {
+
+uint64_t
+entry_hash(const api::GetBucketDiffCommand::Entry& entry) noexcept
+{
+    char key[2 * sizeof(uint64_t) + document::GlobalId::LENGTH];
+    uint64_t header[2] = { entry._timestamp, uint64_t(entry._flags & MergeHandler::DELETED) };
+    memcpy(key, header, sizeof(header));
+    memcpy(key + sizeof(header), entry._gid.get(), document::GlobalId::LENGTH);
+    return vespalib::hashValue(key, sizeof(key));
+}
+
+}
+
+BucketRangeSummary::BucketRangeSummary(const std::vector<Entry>& entries)
+    : _hashes(NUM_RANGES, 0)
+{
+    for (const auto& entry : entries) {
+        // Summing keeps the range hash independent of entry order.
+        _hashes[range_of(entry)] += entry_hash(entry);
+    }
+}
+
+BucketRangeSummary::~BucketRangeSummary() = default;
+
+uint32_t
+BucketRangeSummary::range_of(const Entry& entry) noexcept
+{
+    // Timestamps are mostly sequential; multiplicative hashing spreads them evenly.
+    return (entry._timestamp * 0x9E3779B97F4A7C15ul) >> 56;
+}
+
+void
+BucketRangeSummary::add_differing_ranges(const std::vector<uint64_t>& other, std::vector<uint32_t>& ranges) const
+{
+    std::vector<uint32_t> differing;
+    for (uint32_t i = 0; i < NUM_RANGES; ++i) {
+        if ((other.size() != NUM_RANGES) || (other[i] != _hashes[i])) {
+            differing.push_back(i);
+        }
+    }
+    std::vector<uint32_t> result;
+    result.reserve(ranges.size() + differing.size());
+    std::set_union(ranges.begin(), ranges.end(), differing.begin(), differing.end(), std::back_inserter(result));
+    ranges.swap(result);
+}
+
+void
+BucketRangeSummary::filter(std::vector<Entry>& entries, const std::vector<uint32_t>& ranges)
+{
+    std::vector<bool> keep(NUM_RANGES, false);
+    for (uint32_t range : ranges) {
+        if (range < NUM_RANGES) {
+            keep[range] = true;
+        }
+    }
+    auto last = std::remove_if(entries.begin(), entries.end(),
+                               [&keep](const Entry& entry) { return !keep[range_of(entry)]; });
+    entries.erase(last, entries.end());
+}
+
+}
@@ -0,0 +1,49 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/storageapi/message/bucket.h>
+#include <vector>
+
+namespace storage {
+
+/*
+ * Compact summary of the entries in a bucket copy, used by merge to
+ * find which parts of a bucket differ between the copies before any
+ * per entry metadata is exchanged.
+ *
+ * Entries are partitioned into a fixed number of ranges by a hash of
+ * their timestamp. Each range is summarized by an order independent
+ * hash of (timestamp, removed) for the entries within it, so copies
+ * with identical content in a range produce identical range hashes.
+ * Only entries in differing ranges need to be part of the bucket diff.
+ */
+class BucketRangeSummary
+{
+public:
+    using Entry = api::GetBucketDiffCommand::Entry;
+    static constexpr uint32_t NUM_RANGES = 256;
+
+    explicit BucketRangeSummary(const std::vector<Entry>& entries);
+    ~BucketRangeSummary();
+
+    const std::vector<uint64_t>& hashes() const noexcept { return _hashes; }
+
+    static uint32_t range_of(const Entry& entry) noexcept;
+
+    /*
+     * Adds the ranges where this summary differs from 'other' to the
+     * sorted range list 'ranges', keeping it sorted. A summary of
+     * unexpected size is treated as differing in all ranges.
+     */
+    void add_differing_ranges(const std::vector<uint64_t>& other, std::vector<uint32_t>& ranges) const;
+
+    /*
+     * Removes all entries outside the given sorted ranges.
+     */
+    static void filter(std::vector<Entry>& entries, const std::vector<uint32_t>& ranges);
+
+private:
+    std::vector<uint64_t> _hashes;
+};
+
+}
@@ -133,6 +133,17 @@ public:
      */
     virtual LockedMessage getNextMessage(uint32_t stripeId) = 0;
 
+    /**
+     * Used by file stor threads holding an exclusive lock on a bucket to take
+     * further queued puts and removes for the same bucket, so they can be
+     * processed under the same lock. At most max_ops operations are returned,
+     * in the order they were scheduled. Stops at the first queued operation
+     * for the bucket that cannot be batched, so no operation is reordered
+     * across it.
+     */
+    virtual std::vector<std::shared_ptr<api::StorageMessage>>
+    fetch_batchable_operations(const BucketLockInterface& lock, uint32_t max_ops) = 0;
+
     /**
      * Lock a bucket. By default, each file stor thread has the locks of all
      * buckets in their area of responsibility. If they need to access buckets
@@ -351,6 +351,15 @@ FileStorHandlerImpl::getNextMessage(uint32_t stripeId)
     return getNextMessage(stripeId, _getNextMessageTimeout);
 }
 
+std::vector<std::shared_ptr<api::StorageMessage>>
+FileStorHandlerImpl::fetch_batchable_operations(const BucketLockInterface& lock, uint32_t max_ops)
+{
+    if ((max_ops == 0) || (lock.lockingRequirements() != api::LockingRequirements::Exclusive)) {
+        return {};
+    }
+    return stripe(lock.getBucket()).fetch_batchable_operations(lock.getBucket(), max_ops);
+}
+
 std::shared_ptr<FileStorHandler::BucketLockInterface>
 FileStorHandlerImpl::Stripe::lock(const document::Bucket &bucket, api::LockingRequirements lockReq) {
     std::unique_lock guard(*_lock);
@@ -922,6 +931,49 @@ FileStorHandlerImpl::Stripe::getMessage(monitor_guard & guard, PriorityIdx & idx
     }
 }
 
+namespace {
+
+bool
+is_batchable_operation(const api::StorageMessage& msg) {
+    switch (msg.getType().getId()) {
+    case api::MessageType::PUT_ID:
+    case api::MessageType::REMOVE_ID:
+        // Conditions must be evaluated after all earlier operations have completed.
+        return !static_cast<const api::TestAndSetCommand&>(msg).getCondition().isPresent();
+    default: return false;
+    }
+}
+
+}
+
+std::vector<std::shared_ptr<api::StorageMessage>>
+FileStorHandlerImpl::Stripe::fetch_batchable_operations(const document::Bucket& bucket, uint32_t max_ops)
+{
+    std::vector<std::shared_ptr<api::StorageMessage>> batch;
+    std::vector<std::shared_ptr<api::StorageReply>> timed_out;
+    {
+        std::lock_guard guard(*_lock);
+        BucketIdx& idx(bmi::get<2>(*_queue));
+        // Operations for the same bucket are kept in scheduling order.
+        auto iter = idx.lower_bound(bucket);
+        while ((iter != idx.end()) && (iter->_bucket == bucket) && (batch.size() < max_ops)
+               && is_batchable_operation(*iter->_command))
+        {
+            std::chrono::milliseconds waitTime(uint64_t(iter->_timer.stop(_metrics->averageQueueWaitingTime)));
+            if (messageTimedOutInQueue(*iter->_command, waitTime)) {
+                timed_out.emplace_back(makeQueueTimeoutReply(*iter->_command));
+            } else {
+                batch.emplace_back(iter->_command);
+            }
+            iter = idx.erase(iter);
+        }
+    }
+    for (auto& reply : timed_out) {
+        _messageSender.sendReply(reply);
+    }
+    return batch;
+}
+
 void
 FileStorHandlerImpl::Stripe::waitUntilNoLocks() const
 {
@@ -1046,9 +1098,12 @@ FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
         entry._sharedLocks.erase(shared_iter);
     }
 
-    if (!entry._exclusiveLock && entry._sharedLocks.empty()) {
-        _lockedBuckets.erase(iter); // No more locks held
+    if (entry._exclusiveLock || !entry._sharedLocks.empty()) {
+        // Other shared locks still held; neither queued operations nor
+        // threads waiting for the bucket can make progress yet.
+        return;
     }
+    _lockedBuckets.erase(iter); // No more locks held
     guard.unlock();
     _cond->notify_all();
 }
@@ -129,6 +129,8 @@ public:
         void failOperations(const document::Bucket & bucket, const api::ReturnCode & code);
 
         FileStorHandler::LockedMessage getNextMessage(vespalib::duration timeout);
+        std::vector<std::shared_ptr<api::StorageMessage>> fetch_batchable_operations(const document::Bucket& bucket,
+                                                                                     uint32_t max_ops);
         void dumpQueue(std::ostream & os) const;
         void dumpActiveHtml(std::ostream & os) const;
         void dumpQueueHtml(std::ostream & os) const;
@@ -190,6 +192,8 @@ public:
     ScheduleAsyncResult schedule_and_get_next_async_message(const std::shared_ptr<api::StorageMessage>& msg) override;
 
     FileStorHandler::LockedMessage getNextMessage(uint32_t stripeId) override;
+    std::vector<std::shared_ptr<api::StorageMessage>>
+    fetch_batchable_operations(const BucketLockInterface& lock, uint32_t max_ops) override;
 
     void remapQueueAfterJoin(const RemapInfo& source, RemapInfo& target) override;
     void remapQueueAfterSplit(const RemapInfo& source, RemapInfo& target1, RemapInfo& target2) override;
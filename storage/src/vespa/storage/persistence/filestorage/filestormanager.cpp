@@ -195,7 +195,8 @@ FileStorManager::configure(std::unique_ptr<vespa::config::content::StorFilestorC
     if (!liveUpdate) {
         _config = std::move(config);
         size_t numThreads = _config->numThreads;
-        size_t numStripes = std::max(size_t(1u), numThreads / 2);
+        size_t numThreadsPerStripe = std::max(1, _config->numThreadsPerStripe);
+        size_t numStripes = std::max(size_t(1u), numThreads / numThreadsPerStripe);
         _metrics->initDiskMetrics(numStripes, computeAllPossibleHandlerThreads(*_config));
 
         _filestorHandler = std::make_unique<FileStorHandlerImpl>(numThreads, numStripes, *this, *_metrics, _compReg);
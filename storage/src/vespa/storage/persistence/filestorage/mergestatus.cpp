@@ -15,7 +15,8 @@ MergeStatus::MergeStatus(const framework::Clock& clock,
     : reply(), full_node_list(), nodeList(), maxTimestamp(0), diff(), pendingId(0),
       pendingGetDiff(), pendingApplyDiff(), timeout(0), startTime(clock),
       delayed_error(),
-      context(priority, traceLevel)
+      context(priority, traceLevel),
+      range_summary_entries()
 {}
 
 MergeStatus::~MergeStatus() = default;
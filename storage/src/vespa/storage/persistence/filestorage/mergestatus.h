@@ -29,6 +29,8 @@ public:
     framework::MilliSecTimer startTime;
     std::optional<std::future<vespalib::string>> delayed_error;
     spi::Context context;
+    // Local entries kept by the first node while range summaries are compared.
+    std::optional<std::vector<api::GetBucketDiffCommand::Entry>> range_summary_entries;
  	
     MergeStatus(const framework::Clock&, api::StorageMessage::Priority, uint32_t traceLevel);
     ~MergeStatus() override;
@@ -43,6 +45,7 @@ public:
     bool removeFromDiff(const std::vector<api::ApplyBucketDiffCommand::Entry>& part, uint16_t hasMask, const std::vector<api::MergeBucketCommand::Node> &nodes);
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
     bool isFirstNode() const { return static_cast<bool>(reply); }
+    bool isComparingRangeSummaries() const { return range_summary_entries.has_value(); }
     void set_delayed_error(std::future<vespalib::string>&& delayed_error_in);
     void check_delayed_error(api::ReturnCode &return_code);
 };
@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "mergehandler.h"
+#include "bucket_range_summary.h"
 #include "persistenceutil.h"
 #include "apply_bucket_diff_entry_complete.h"
 #include "apply_bucket_diff_state.h"
@@ -36,6 +37,7 @@ MergeHandler::MergeHandler(PersistenceUtil& env, spi::PersistenceProvider& spi,
       _maxChunkSize(maxChunkSize),
       _commonMergeChainOptimalizationMinimumSize(commonMergeChainOptimalizationMinimumSize),
       _async_apply_bucket_diff(async_apply_bucket_diff),
+      _merge_range_summaries(false),
       _executor(executor)
 {
 }
@@ -927,6 +929,13 @@ MergeHandler::handleMergeBucket(api::MergeBucketCommand& cmd, MessageTracker::UP
         return tracker;
     }
     _env._metrics.merge_handler_metrics.mergeMetadataReadLatency.addValue(s->startTime.getElapsedTimeAsDouble());
+    if (_merge_range_summaries.load(std::memory_order_relaxed)) {
+        // Compare range summaries first, keeping our entries until we know
+        // which ranges differ between the nodes.
+        cmd2->getRangeSummary() = BucketRangeSummary(cmd2->getDiff()).hashes();
+        s->range_summary_entries.emplace();
+        s->range_summary_entries->swap(cmd2->getDiff());
+    }
     LOG(spam, "Sending GetBucketDiff %" PRIu64 " for %s to next node %u "
         "with diff of %u entries.",
         cmd2->getMsgId(),
@@ -1094,8 +1103,17 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
         tracker->fail(api::ReturnCode::BUCKET_DELETED, "Bucket not found in buildBucketInfo step");
         return tracker;
     }
-    if (!mergeLists(remote, local, local)) {
-        LOG(error, "Diffing %s found suspect entries.", bucket.toString().c_str());
+    std::vector<uint32_t> ranges(cmd.getRanges());
+    if (cmd.isRangeSummaryOnly()) {
+        BucketRangeSummary(local).add_differing_ranges(cmd.getRangeSummary(), ranges);
+        local.clear();
+    } else {
+        if (!ranges.empty()) {
+            BucketRangeSummary::filter(local, ranges);
+        }
+        if (!mergeLists(remote, local, local)) {
+            LOG(error, "Diffing %s found suspect entries.", bucket.toString().c_str());
+        }
     }
     _env._metrics.merge_handler_metrics.mergeMetadataReadLatency.addValue(startTime.getElapsedTimeAsDouble());
 
@@ -1122,6 +1140,10 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
 
         auto reply = std::make_shared<api::GetBucketDiffReply>(cmd);
         reply->getDiff().swap(final);
+        if (cmd.isRangeSummaryOnly()) {
+            reply->getRanges().swap(ranges);
+            reply->setRangeSummaryCompared(true);
+        }
         tracker->setReply(std::move(reply));
     } else {
         // When not the last node in merge chain, we must save reply, and
@@ -1139,6 +1161,8 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
         auto cmd2 = std::make_shared<api::GetBucketDiffCommand>(bucket.getBucket(), cmd.getNodes(), cmd.getMaxTimestamp());
         cmd2->setAddress(createAddress(_cluster_context.cluster_name_ptr(), cmd.getNodes()[index + 1].index));
         cmd2->getDiff().swap(local);
+        cmd2->getRangeSummary() = cmd.getRangeSummary();
+        cmd2->getRanges().swap(ranges);
         cmd2->setPriority(cmd.getPriority());
         cmd2->setTimeout(cmd.getTimeout());
         s->pendingId = cmd2->getMsgId();
@@ -1152,6 +1176,37 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
     return tracker;
 }
 
+api::StorageReply::SP
+MergeHandler::handleRangeSummaryReply(const spi::Bucket& bucket, MergeStatus& status,
+                                      const api::GetBucketDiffReply& reply) const
+{
+    std::vector<api::GetBucketDiffCommand::Entry> local(std::move(*status.range_summary_entries));
+    status.range_summary_entries.reset();
+    if (reply.isRangeSummaryCompared() && reply.getRanges().empty()) {
+        LOG(debug, "Done with merge of %s. Range summaries are equal on all nodes.",
+            bucket.toString().c_str());
+        return status.reply;
+    }
+    auto cmd = std::make_shared<api::GetBucketDiffCommand>(bucket.getBucket(), status.nodeList,
+                                                           status.maxTimestamp.getTime());
+    // If some node did not compare the summaries, fall back to a full diff.
+    if (reply.isRangeSummaryCompared()) {
+        BucketRangeSummary::filter(local, reply.getRanges());
+        cmd->getRanges() = reply.getRanges();
+    }
+    LOG(spam, "Sending GetBucketDiff %" PRIu64 " for %s to next node %u "
+        "with diff of %zu entries in %zu differing ranges.",
+        cmd->getMsgId(), bucket.toString().c_str(), status.nodeList[1].index,
+        local.size(), reply.getRanges().size());
+    cmd->getDiff().swap(local);
+    cmd->setAddress(createAddress(_cluster_context.cluster_name_ptr(), status.nodeList[1].index));
+    cmd->setPriority(status.context.getPriority());
+    cmd->setTimeout(status.timeout);
+    status.pendingId = cmd->getMsgId();
+    _env._fileStorHandler.sendCommand(cmd);
+    return {};
+}
+
 void
 MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSender& sender) const
 {
@@ -1180,6 +1235,14 @@ MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSe
             if (reply.getResult().failed()) {
                 // We failed, so we should reply to the pending message.
                 replyToSend = s->reply;
+            } else if (s->isComparingRangeSummaries()) {
+                replyToSend = handleRangeSummaryReply(bucket, *s, reply);
+                if (!replyToSend) {
+                    clearState = false;
+                } else {
+                    _env._metrics.merge_handler_metrics.mergeLatencyTotal.addValue(
+                            s->startTime.getElapsedTimeAsDouble());
+                }
             } else {
                 // If we didn't fail, reply should have good content
                 // Sanity check for nodes
@@ -1209,6 +1272,8 @@ MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSe
                 "size %zu. Sending it on.",
                 bucket.toString().c_str(), reply.getDiff().size());
             s->pendingGetDiff->getDiff().swap(reply.getDiff());
+            s->pendingGetDiff->getRanges().swap(reply.getRanges());
+            s->pendingGetDiff->setRangeSummaryCompared(reply.isRangeSummaryCompared());
         }
     } catch (std::exception& e) {
         _env._fileStorHandler.clearMergeStatus(
@@ -1455,9 +1520,10 @@ MergeHandler::drain_async_writes()
 }
 
 void
-MergeHandler::configure(bool async_apply_bucket_diff) noexcept
+MergeHandler::configure(bool async_apply_bucket_diff, bool merge_range_summaries) noexcept
 {
     _async_apply_bucket_diff.store(async_apply_bucket_diff, std::memory_order_release);
+    _merge_range_summaries.store(merge_range_summaries, std::memory_order_release);
 }
 
 void
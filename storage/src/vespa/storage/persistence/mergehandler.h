@@ -79,7 +79,7 @@ public:
     MessageTrackerUP handleApplyBucketDiff(api::ApplyBucketDiffCommand&, MessageTrackerUP) const;
     void handleApplyBucketDiffReply(api::ApplyBucketDiffReply&, MessageSender&, MessageTrackerUP) const;
     void drain_async_writes();
-    void configure(bool async_apply_bucket_diff) noexcept;
+    void configure(bool async_apply_bucket_diff, bool merge_range_summaries) noexcept;
 
 private:
     const framework::Clock   &_clock;
@@ -90,9 +90,14 @@ private:
     const uint32_t            _maxChunkSize;
     const uint32_t            _commonMergeChainOptimalizationMinimumSize;
     std::atomic<bool>         _async_apply_bucket_diff;
+    std::atomic<bool>         _merge_range_summaries;
     vespalib::ISequencedTaskExecutor& _executor;
 
     MessageTrackerUP handleGetBucketDiffStage2(api::GetBucketDiffCommand&, MessageTrackerUP) const;
+    /** Starts the diff of differing ranges, or returns a reply if no range differs */
+    api::StorageReply::SP handleRangeSummaryReply(const spi::Bucket& bucket,
+                                                  MergeStatus& status,
+                                                  const api::GetBucketDiffReply& reply) const;
     /** Returns a reply if merge is complete */
     api::StorageReply::SP processBucketMerge(const spi::Bucket& bucket,
                                              MergeStatus& status,
@@ -23,7 +23,8 @@ PersistenceHandler::PersistenceHandler(vespalib::ISequencedTaskExecutor & sequen
                     cfg.asyncApplyBucketDiff),
       _asyncHandler(_env, provider, bucketOwnershipNotifier, sequencedExecutor, component.getBucketIdFactory()),
       _splitJoinHandler(_env, provider, bucketOwnershipNotifier, cfg.enableMultibitSplitOptimalization),
-      _simpleHandler(_env, provider)
+      _simpleHandler(_env, provider),
+      _max_feed_op_batch_size(std::max(1, cfg.maxFeedOpBatchSize))
 {
 }
 
@@ -141,19 +142,45 @@ PersistenceHandler::processLockedMessage(FileStorHandler::LockedMessage lock) co
     LOG(debug, "NodeIndex %d, ptr=%p", _env._nodeIndex, lock.second.get());
     api::StorageMessage & msg(*lock.second);
 
+    auto bucket_lock = std::move(lock.first);
+    uint32_t max_batch_size = _max_feed_op_batch_size.load(std::memory_order_relaxed);
+    std::vector<std::shared_ptr<api::StorageMessage>> batch;
+    if ((max_batch_size > 1) && bucket_lock && is_batchable(msg)) {
+        batch = _env._fileStorHandler.fetch_batchable_operations(*bucket_lock, max_batch_size - 1);
+    }
     // Important: we _copy_ the message shared_ptr instead of moving to ensure that `msg` remains
     // valid even if the tracker is destroyed by an exception in processMessage().
-    auto tracker = std::make_unique<MessageTracker>(framework::MilliSecTimer(_clock), _env, _env._fileStorHandler, std::move(lock.first), lock.second);
+    auto tracker = std::make_unique<MessageTracker>(framework::MilliSecTimer(_clock), _env, _env._fileStorHandler, bucket_lock, lock.second);
     tracker = processMessage(msg, std::move(tracker));
     if (tracker) {
         tracker->sendReply();
     }
+    if (batch.empty()) {
+        return;
+    }
+    // The bucket lock is shared by all trackers and released when the last operation completes.
+    _env._metrics.batchingSize.addValue(batch.size() + 1);
+    for (auto& batched : batch) {
+        tracker = std::make_unique<MessageTracker>(framework::MilliSecTimer(_clock), _env, _env._fileStorHandler, bucket_lock, batched);
+        tracker = processMessage(*batched, std::move(tracker));
+        if (tracker) {
+            tracker->sendReply();
+        }
+    }
+}
+
+bool
+PersistenceHandler::is_batchable(const api::StorageMessage& msg) noexcept
+{
+    auto id = msg.getType().getId();
+    return ((id == api::MessageType::PUT_ID) || (id == api::MessageType::REMOVE_ID));
 }
 
 void
 PersistenceHandler::configure(vespa::config::content::StorFilestorConfig& config) noexcept
 {
-    _mergeHandler.configure(config.asyncApplyBucketDiff);
+    _mergeHandler.configure(config.asyncApplyBucketDiff, config.mergeRangeSummaries);
+    _max_feed_op_batch_size.store(std::max(1, config.maxFeedOpBatchSize), std::memory_order_relaxed);
 }
 
 }
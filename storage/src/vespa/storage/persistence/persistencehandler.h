@@ -11,6 +11,7 @@
 #include <vespa/storage/common/storagecomponent.h>
 #include <vespa/vespalib/util/isequencedtaskexecutor.h>
 #include <vespa/config-stor-filestor.h>
+#include <atomic>
 
 namespace storage {
 
@@ -42,6 +43,7 @@ private:
     MessageTracker::UP handleReply(api::StorageReply&, MessageTracker::UP) const;
 
     MessageTracker::UP processMessage(api::StorageMessage& msg, MessageTracker::UP tracker) const;
+    static bool is_batchable(const api::StorageMessage& msg) noexcept;
 
     const framework::Clock  & _clock;
     PersistenceUtil           _env;
@@ -50,6 +52,7 @@ private:
     AsyncHandler              _asyncHandler;
     SplitJoinHandler          _splitJoinHandler;
     SimpleMessageHandler      _simpleHandler;
+    std::atomic<uint32_t>     _max_feed_op_batch_size;
 };
 
 } // storage
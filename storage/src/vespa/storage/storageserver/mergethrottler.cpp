@@ -49,6 +49,7 @@ MergeThrottler::ChainedMergeState::ChainedMergeState()
     : _cmd(),
       _cmdString(),
       _clusterStateVersion(0),
+      _estimatedBytes(0),
       _inCycle(false),
       _executingLocally(false),
       _unwinding(false),
@@ -60,6 +61,7 @@ MergeThrottler::ChainedMergeState::ChainedMergeState(const api::StorageMessage::
     : _cmd(cmd),
       _cmdString(cmd->toString()),
       _clusterStateVersion(static_cast<const api::MergeBucketCommand&>(*cmd).getClusterStateVersion()),
+      _estimatedBytes(static_cast<const api::MergeBucketCommand&>(*cmd).getEstimatedMergeBytes()),
       _inCycle(false),
       _executingLocally(executing),
       _unwinding(false),
@@ -74,6 +76,8 @@ MergeThrottler::Metrics::Metrics(metrics::MetricSet* owner)
       queueSize("queuesize", {}, "Length of merge queue", this),
       active_window_size("active_window_size", {}, "Number of merges active within the pending window size", this),
       bounced_due_to_back_pressure("bounced_due_to_back_pressure", {}, "Number of merges bounced due to resource exhaustion back-pressure", this),
+      active_merge_bytes("active_merge_bytes", {}, "Estimated number of bytes to be transferred by active merges", this),
+      merged_bytes("merged_bytes", {}, "Estimated number of bytes transferred by successfully completed merges", this),
       chaining("mergechains", this),
       local("locallyexecutedmerges", this)
 { }
@@ -181,6 +185,8 @@ MergeThrottler::MergeThrottler(
       _queue(),
       _maxQueueSize(1024),
       _throttlePolicy(std::make_unique<mbus::StaticThrottlePolicy>()),
+      _maxMergeBytes(0),
+      _activeMergeBytes(0),
       _queueSequence(0),
       _messageLock(),
       _stateLock(),
@@ -212,6 +218,9 @@ MergeThrottler::configure(std::unique_ptr<vespa::config::content::core::StorServ
     if (newConfig->maxMergeQueueSize < 0) {
         throw config::InvalidConfigException("Max merge queue size cannot be less than 0");
     }
+    if (newConfig->maxMergeBytesPerNode < 0) {
+        throw config::InvalidConfigException("Max merge bytes per node cannot be less than 0");
+    }
     if (newConfig->resourceExhaustionMergeBackPressureDurationSecs < 0.0) {
         throw config::InvalidConfigException("Merge back-pressure duration cannot be less than 0");
     }
@@ -225,6 +234,7 @@ MergeThrottler::configure(std::unique_ptr<vespa::config::content::core::StorServ
     LOG(debug, "Setting new max queue size to %d",
         newConfig->maxMergeQueueSize);
     _maxQueueSize = newConfig->maxMergeQueueSize;
+    _maxMergeBytes = newConfig->maxMergeBytesPerNode;
     _backpressure_duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
             std::chrono::duration<double>(newConfig->resourceExhaustionMergeBackPressureDurationSecs));
     _disable_queue_limits_for_chained_merges = newConfig->disableQueueLimitsForChainedMerges;
@@ -331,6 +341,8 @@ MergeThrottler::onFlush(bool /*downwards*/)
     LOG(debug, "Flushed %zu unfinished or pending merge operations", flushable.size());
 
     _merges.clear();
+    _activeMergeBytes = 0;
+    update_active_merge_bytes_metric();
     _queue.clear();
     _messagesUp.clear();
     _messagesDown.clear();
@@ -358,6 +370,7 @@ MergeThrottler::forwardCommandToNode(
     fwdMerge->setSourceIndex(mergeCmd.getSourceIndex());
     fwdMerge->setPriority(mergeCmd.getPriority());
     fwdMerge->setTimeout(mergeCmd.getTimeout());
+    fwdMerge->setEstimatedMergeBytes(mergeCmd.getEstimatedMergeBytes());
     msgGuard.sendUp(fwdMerge);
 }
 
@@ -366,8 +379,11 @@ MergeThrottler::removeActiveMerge(ActiveMergeMap::iterator mergeIter)
 {
     LOG(debug, "Removed merge for %s from internal state",
         mergeIter->first.toString().c_str());
+    assert(_activeMergeBytes >= mergeIter->second.getEstimatedBytes());
+    _activeMergeBytes -= mergeIter->second.getEstimatedBytes();
     _merges.erase(mergeIter);
     update_active_merge_window_size_metric();
+    update_active_merge_bytes_metric();
 }
 
 api::StorageMessage::SP
@@ -407,6 +423,14 @@ MergeThrottler::canProcessNewMerge() const
     return _throttlePolicy->canSend(dummyMsg, _merges.size());
 }
 
+bool
+MergeThrottler::mergeFitsByteBudget(uint64_t estimatedBytes) const noexcept
+{
+    return ((_maxMergeBytes == 0)
+            || (_activeMergeBytes == 0)
+            || (_activeMergeBytes + estimatedBytes <= _maxMergeBytes));
+}
+
 bool
 MergeThrottler::isMergeAlreadyKnown(const api::StorageMessage::SP& msg) const
 {
@@ -522,6 +546,14 @@ MergeThrottler::attemptProcessNextQueuedMerge(
         assert(!_merges.empty());
         return false;
     }
+    // The highest priority merge waits for enough bytes to be freed up rather
+    // than letting smaller, lower priority merges go ahead of it.
+    if (!_queue.empty()
+        && !mergeFitsByteBudget(static_cast<const api::MergeBucketCommand&>(*_queue.begin()->_msg).getEstimatedMergeBytes()))
+    {
+        LOG(spam, "Merges queued, but the highest priority merge does not fit within the merge byte budget");
+        return false;
+    }
 
     api::StorageMessage::SP msg = getNextQueuedMerge();
     if (msg) {
@@ -716,7 +748,10 @@ MergeThrottler::handleMessageDown(
 
         if (isMergeAlreadyKnown(msg)) {
             processCycledMergeCommand(msg, msgGuard);
-        } else if (canProcessNewMerge()) {
+        } else if (canProcessNewMerge()
+                   && mergeFitsByteBudget(mergeCmd.getEstimatedMergeBytes())
+                   && ((_maxMergeBytes == 0) || _queue.empty()))
+        {
             processNewMergeCommand(msg, msgGuard);
         } else if ((_queue.size() < _maxQueueSize) || allow_merge_with_queue_full(mergeCmd)) {
             enqueueMerge(msg, msgGuard); // Queue for later processing
@@ -818,7 +853,9 @@ MergeThrottler::processNewMergeCommand(
     // merge throttling window.
     assert(_merges.find(mergeCmd.getBucket()) == _merges.end());
     auto state = _merges.emplace(mergeCmd.getBucket(), ChainedMergeState(msg)).first;
+    _activeMergeBytes += state->second.getEstimatedBytes();
     update_active_merge_window_size_metric();
+    update_active_merge_bytes_metric();
 
     LOG(debug, "Added merge %s to internal state",
         mergeCmd.toString().c_str());
@@ -1029,6 +1066,9 @@ MergeThrottler::processMergeReply(
                                         mergeReply.getResult().getMessage()));
     }
     _throttlePolicy->processReply(dummyReply);
+    if (mergeReply.getResult().success()) {
+        _metrics->merged_bytes.inc(mergeState.getEstimatedBytes());
+    }
 
     // Remove merge now that we've done our part to unwind the chain
     removeActiveMerge(mergeIter);
@@ -1255,6 +1295,17 @@ MergeThrottler::update_active_merge_window_size_metric() noexcept {
     _metrics->active_window_size.set(static_cast<int64_t>(_merges.size()));
 }
 
+void
+MergeThrottler::update_active_merge_bytes_metric() noexcept {
+    _metrics->active_merge_bytes.set(static_cast<int64_t>(_activeMergeBytes));
+}
+
+void
+MergeThrottler::set_max_merge_bytes(uint64_t max_bytes) noexcept {
+    std::lock_guard lock(_stateLock);
+    _maxMergeBytes = max_bytes;
+}
+
 void
 MergeThrottler::print(std::ostream& out, bool /*verbose*/,
                       const std::string& /*indent*/) const
@@ -1271,6 +1322,11 @@ MergeThrottler::reportHtmlStatus(std::ostream& out,
         out << "<p>Max pending: "
             << _throttlePolicy->getMaxPendingCount()
             << "</p>\n";
+        out << "<p>Estimated active merge bytes: " << _activeMergeBytes;
+        if (_maxMergeBytes != 0) {
+            out << " (max " << _maxMergeBytes << ")";
+        }
+        out << "</p>\n";
         out << "<p>Please see node metrics for performance numbers</p>\n";
         out << "<h3>Active merges ("
             << _merges.size()
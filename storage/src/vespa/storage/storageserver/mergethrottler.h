@@ -66,6 +66,8 @@ public:
         metrics::LongValueMetric queueSize;
         metrics::LongValueMetric active_window_size;
         metrics::LongCountMetric bounced_due_to_back_pressure;
+        metrics::LongValueMetric active_merge_bytes;
+        metrics::LongCountMetric merged_bytes;
         MergeOperationMetrics chaining;
         MergeOperationMetrics local;
 
@@ -107,6 +109,7 @@ private:
         api::StorageMessage::SP _cmd;
         std::string _cmdString; // For being able to print message even when we don't own it
         uint64_t _clusterStateVersion;
+        uint64_t _estimatedBytes;
         bool _inCycle;
         bool _executingLocally;
         bool _unwinding;
@@ -142,6 +145,7 @@ private:
         void setAborted(bool aborted) { _aborted = aborted; }
 
         const std::string& getMergeCmdString() const { return _cmdString; }
+        uint64_t getEstimatedBytes() const { return _estimatedBytes; }
     };
 
     typedef std::map<document::Bucket, ChainedMergeState> ActiveMergeMap;
@@ -163,6 +167,8 @@ private:
     MergePriorityQueue _queue;
     std::size_t _maxQueueSize;
     mbus::StaticThrottlePolicy::UP _throttlePolicy;
+    uint64_t _maxMergeBytes; // 0 means no limit
+    uint64_t _activeMergeBytes; // Sum of estimated bytes of all active merges
     uint64_t _queueSequence; // TODO: move into a stable priority queue class
     mutable std::mutex _messageLock;
     std::condition_variable _messageCond;
@@ -221,6 +227,9 @@ public:
 
     Metrics& getMetrics() { return *_metrics; }
     std::size_t getMaxQueueSize() const { return _maxQueueSize; }
+    // For unit testing only
+    void set_max_merge_bytes(uint64_t max_bytes) noexcept;
+    uint64_t getActiveMergeBytes() const { return _activeMergeBytes; }
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
     void reportHtmlStatus(std::ostream&, const framework::HttpUrlPath&) const override;
 private:
@@ -347,6 +356,14 @@ private:
      */
     bool canProcessNewMerge() const;
 
+    /**
+     * @return true if a merge estimated to transfer the given number of bytes
+     * fits within the per node byte budget. A merge is always allowed when no
+     * other merges are active, so that merges of buckets larger than the
+     * budget cannot be starved.
+     */
+    bool mergeFitsByteBudget(uint64_t estimatedBytes) const noexcept;
+
     bool merge_is_backpressure_throttled(const api::MergeBucketCommand& cmd) const;
     void bounce_backpressure_throttled_merge(const api::MergeBucketCommand& cmd, MessageGuard& guard);
     bool merge_has_this_node_as_source_only_node(const api::MergeBucketCommand& cmd) const;
@@ -394,6 +411,7 @@ private:
     void markActiveMergesAsAborted(uint32_t minimumStateVersion);
 
     void update_active_merge_window_size_metric() noexcept;
+    void update_active_merge_bytes_metric() noexcept;
 
     // const function, but metrics are mutable
     void updateOperationMetrics(
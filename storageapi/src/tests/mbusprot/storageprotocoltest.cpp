@@ -460,7 +460,7 @@ TEST_P(StorageProtocolTest, delete_bucket) {
 
 TEST_P(StorageProtocolTest, merge_bucket) {
     typedef api::MergeBucketCommand::Node Node;
-    std::vector<Node> nodes;
+    std::vector<api::MergeBucketCommand::Node> nodes;
     nodes.push_back(Node(4, false));
     nodes.push_back(Node(13, true));
     nodes.push_back(Node(26, true));
@@ -487,6 +487,21 @@ TEST_P(StorageProtocolTest, merge_bucket) {
     EXPECT_EQ(chain, reply2->getChain());
 }
 
+TEST_P(StorageProtocolTest, merge_bucket_estimated_bytes) {
+    // Only supported on protocol version 7+. Older versions leave the estimate unknown.
+    if (GetParam().getMajor() < 7) {
+        return;
+    }
+    std::vector<api::MergeBucketCommand::Node> nodes;
+    nodes.push_back(4);
+    nodes.push_back(13);
+    auto cmd = std::make_shared<MergeBucketCommand>(_bucket, nodes, Timestamp(1234), 567);
+    EXPECT_EQ(0u, cmd->getEstimatedMergeBytes());
+    cmd->setEstimatedMergeBytes(123456789012ULL);
+    auto cmd2 = copyCommand(cmd);
+    EXPECT_EQ(123456789012ULL, cmd2->getEstimatedMergeBytes());
+}
+
 TEST_P(StorageProtocolTest, split_bucket) {
     auto cmd = std::make_shared<SplitBucketCommand>(_bucket);
     EXPECT_EQ(0u, cmd->getMinSplitBits());
@@ -650,6 +665,31 @@ TEST_P(StorageProtocolTest, get_bucket_diff) {
     EXPECT_EQ(Timestamp(1056), reply2->getMaxTimestamp());
 }
 
+TEST_P(StorageProtocolTest, get_bucket_diff_range_summary) {
+    // Only supported on protocol version 7+. Merges fall back to a full diff on older versions.
+    if (GetParam().getMajor() < 7) {
+        return;
+    }
+    std::vector<api::MergeBucketCommand::Node> nodes;
+    nodes.push_back(4);
+    nodes.push_back(13);
+
+    auto cmd = std::make_shared<GetBucketDiffCommand>(_bucket, nodes, 1056);
+    cmd->getRangeSummary() = {11, 0, 0xffffffffffffffffULL};
+    cmd->getRanges() = {2, 5};
+    auto cmd2 = copyCommand(cmd);
+    EXPECT_TRUE(cmd2->isRangeSummaryOnly());
+    EXPECT_EQ(cmd->getRangeSummary(), cmd2->getRangeSummary());
+    EXPECT_EQ(cmd->getRanges(), cmd2->getRanges());
+
+    auto reply = std::make_shared<GetBucketDiffReply>(*cmd2);
+    reply->getRanges() = {1, 2, 5};
+    reply->setRangeSummaryCompared(true);
+    auto reply2 = copyReply(reply);
+    EXPECT_EQ((std::vector<uint32_t>{1, 2, 5}), reply2->getRanges());
+    EXPECT_TRUE(reply2->isRangeSummaryCompared());
+}
+
 namespace {
 
 ApplyBucketDiffCommand::Entry dummy_apply_entry() {
@@ -769,6 +769,7 @@ void ProtocolSerialization7::onEncode(GBBuf& buf, const api::MergeBucketCommand&
         for (uint16_t chain_node : msg.getChain()) {
             req.add_node_chain(chain_node);
         }
+        req.set_estimated_merge_bytes(msg.getEstimatedMergeBytes());
     });
 }
 
@@ -787,6 +788,7 @@ api::StorageCommand::UP ProtocolSerialization7::onDecodeMergeBucketCommand(BBuf&
             chain.emplace_back(node);
         }
         cmd->setChain(std::move(chain));
+        cmd->setEstimatedMergeBytes(req.estimated_merge_bytes());
         return cmd;
     });
 }
@@ -869,12 +871,16 @@ void ProtocolSerialization7::onEncode(GBBuf& buf, const api::GetBucketDiffComman
         set_merge_nodes(*req.mutable_nodes(), msg.getNodes());
         req.set_max_timestamp(msg.getMaxTimestamp());
         fill_proto_meta_diff(*req.mutable_diff(), msg.getDiff());
+        req.mutable_range_summary()->Add(msg.getRangeSummary().begin(), msg.getRangeSummary().end());
+        req.mutable_ranges()->Add(msg.getRanges().begin(), msg.getRanges().end());
     });
 }
 
 void ProtocolSerialization7::onEncode(GBBuf& buf, const api::GetBucketDiffReply& msg) const {
     encode_bucket_response<protobuf::GetBucketDiffResponse>(buf, msg, [&](auto& res) {
         fill_proto_meta_diff(*res.mutable_diff(), msg.getDiff());
+        res.mutable_ranges()->Add(msg.getRanges().begin(), msg.getRanges().end());
+        res.set_range_summary_compared(msg.isRangeSummaryCompared());
     });
 }
 
@@ -883,6 +889,8 @@ api::StorageCommand::UP ProtocolSerialization7::onDecodeGetBucketDiffCommand(BBu
         auto nodes = get_merge_nodes(req.nodes());
         auto cmd = std::make_unique<api::GetBucketDiffCommand>(bucket, std::move(nodes), req.max_timestamp());
         fill_api_meta_diff(cmd->getDiff(), req.diff());
+        cmd->getRangeSummary().assign(req.range_summary().begin(), req.range_summary().end());
+        cmd->getRanges().assign(req.ranges().begin(), req.ranges().end());
         return cmd;
     });
 }
@@ -891,6 +899,8 @@ api::StorageReply::UP ProtocolSerialization7::onDecodeGetBucketDiffReply(const S
     return decode_bucket_response<protobuf::GetBucketDiffResponse>(buf, [&](auto& res) {
         auto reply = std::make_unique<api::GetBucketDiffReply>(static_cast<const api::GetBucketDiffCommand&>(cmd));
         fill_api_meta_diff(reply->getDiff(), res.diff());
+        reply->getRanges().assign(res.ranges().begin(), res.ranges().end());
+        reply->setRangeSummaryCompared(res.range_summary_compared());
         return reply;
     });
 }
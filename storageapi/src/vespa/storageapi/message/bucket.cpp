@@ -107,7 +107,8 @@ MergeBucketCommand::MergeBucketCommand(
       _nodes(nodes),
       _maxTimestamp(maxTimestamp),
       _clusterStateVersion(clusterStateVersion),
-      _chain(chain)
+      _chain(chain),
+      _estimatedMergeBytes(0)
 {}
 
 MergeBucketCommand::~MergeBucketCommand() = default;
@@ -210,7 +211,10 @@ GetBucketDiffCommand::GetBucketDiffCommand(
         Timestamp maxTimestamp)
     : BucketCommand(MessageType::GETBUCKETDIFF, bucket),
       _nodes(nodes),
-      _maxTimestamp(maxTimestamp)
+      _maxTimestamp(maxTimestamp),
+      _diff(),
+      _rangeSummary(),
+      _ranges()
 {}
 
 GetBucketDiffCommand::~GetBucketDiffCommand() = default;
@@ -226,7 +230,10 @@ GetBucketDiffCommand::print(std::ostream& out, bool verbose,
         out << _nodes[i];
     }
     
-    if (_diff.empty()) {
+    if (isRangeSummaryOnly()) {
+        out << "], range summary of " << _rangeSummary.size() << " ranges, "
+            << _ranges.size() << " differing";
+    } else if (_diff.empty()) {
         out << "], no entries";
     } else if (verbose) {
         out << "],";
@@ -238,6 +245,9 @@ GetBucketDiffCommand::print(std::ostream& out, bool verbose,
         out << ", " << _diff.size() << " entries";
         out << ", id " << _msgId;
     }
+    if (!isRangeSummaryOnly() && !_ranges.empty()) {
+        out << ", restricted to " << _ranges.size() << " ranges";
+    }
     out << ")";
     if (verbose) {
         out << " : ";
@@ -249,7 +259,9 @@ GetBucketDiffReply::GetBucketDiffReply(const GetBucketDiffCommand& cmd)
     : BucketReply(cmd),
       _nodes(cmd.getNodes()),
       _maxTimestamp(cmd.getMaxTimestamp()),
-      _diff(cmd.getDiff())
+      _diff(cmd.getDiff()),
+      _ranges(cmd.getRanges()),
+      _rangeSummaryCompared(false)
 {}
 
 GetBucketDiffReply::~GetBucketDiffReply() = default;
@@ -276,6 +288,9 @@ GetBucketDiffReply::print(std::ostream& out, bool verbose,
         out << ", " << _diff.size() << " entries";
         out << ", id " << _msgId;
     }
+    if (_rangeSummaryCompared) {
+        out << ", " << _ranges.size() << " differing ranges";
+    }
     out << ")";
     if (verbose) {
         out << " : ";
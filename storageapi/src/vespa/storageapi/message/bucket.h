@@ -118,6 +118,7 @@ private:
     Timestamp _maxTimestamp;
     uint32_t _clusterStateVersion;
     std::vector<uint16_t> _chain;
+    uint64_t _estimatedMergeBytes;
 
 public:
     MergeBucketCommand(const document::Bucket &bucket,
@@ -133,6 +134,12 @@ public:
     uint32_t getClusterStateVersion() const { return _clusterStateVersion; }
     void setClusterStateVersion(uint32_t version) { _clusterStateVersion = version; }
     void setChain(const std::vector<uint16_t>& chain) { _chain = chain; }
+    /**
+     * Estimate of the number of bytes the merge may transfer, as set by the
+     * distributor from the bucket info of the replicas. 0 if unknown.
+     */
+    uint64_t getEstimatedMergeBytes() const { return _estimatedMergeBytes; }
+    void setEstimatedMergeBytes(uint64_t bytes) { _estimatedMergeBytes = bytes; }
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
     DECLARE_STORAGECOMMAND(MergeBucketCommand, onMergeBucket)
 };
@@ -196,6 +203,8 @@ private:
     std::vector<Node> _nodes;
     Timestamp _maxTimestamp;
     std::vector<Entry> _diff;
+    std::vector<uint64_t> _rangeSummary;
+    std::vector<uint32_t> _ranges;
 
 public:
     GetBucketDiffCommand(const document::Bucket &bucket,
@@ -208,6 +217,24 @@ public:
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
 
+    /**
+     * Per range hashes of the bucket content on the first node in the
+     * chain. When set, the command only compares range summaries and
+     * carries no entries; the ranges found to differ are accumulated in
+     * getRanges() and returned in the reply.
+     */
+    const std::vector<uint64_t>& getRangeSummary() const { return _rangeSummary; }
+    std::vector<uint64_t>& getRangeSummary() { return _rangeSummary; }
+    bool isRangeSummaryOnly() const { return !_rangeSummary.empty(); }
+
+    /**
+     * Sorted range indexes. For a range summary command these are the
+     * ranges found to differ so far. Otherwise, if non-empty, only
+     * entries within these ranges are part of the diff.
+     */
+    const std::vector<uint32_t>& getRanges() const { return _ranges; }
+    std::vector<uint32_t>& getRanges() { return _ranges; }
+
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
     DECLARE_STORAGECOMMAND(GetBucketDiffCommand, onGetBucketDiff)
@@ -228,6 +255,8 @@ private:
     std::vector<Node> _nodes;
     Timestamp _maxTimestamp;
     std::vector<Entry> _diff;
+    std::vector<uint32_t> _ranges;
+    bool _rangeSummaryCompared;
 
 public:
     explicit GetBucketDiffReply(const GetBucketDiffCommand& cmd);
@@ -237,6 +266,12 @@ public:
     Timestamp getMaxTimestamp() const { return _maxTimestamp; }
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
+    /** Ranges that differ between the nodes, as reply to a range summary command. */
+    const std::vector<uint32_t>& getRanges() const { return _ranges; }
+    std::vector<uint32_t>& getRanges() { return _ranges; }
+    /** Whether all nodes compared the range summary, and getRanges() is thus complete. */
+    bool isRangeSummaryCompared() const { return _rangeSummaryCompared; }
+    void setRangeSummaryCompared(bool compared) { _rangeSummaryCompared = compared; }
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
     DECLARE_STORAGEREPLY(GetBucketDiffReply, onGetBucketDiffReply)
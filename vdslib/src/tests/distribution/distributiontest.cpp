@@ -17,6 +17,7 @@
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <fstream>
@@ -974,6 +975,30 @@ TEST(DistributionTest, test_hierarchical_distribute_less_than_redundancy)
     }
 }
 
+TEST(DistributionTest, batch_ideal_storage_nodes_match_single_bucket_calculation)
+{
+    Distribution distr("redundancy 3\n" + groupConfig);
+    ClusterState state("bits:8 storage:6 .1.s:d .2.c:0.5 .4.s:r");
+    std::vector<document::BucketId> buckets;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        uint32_t used_bits = 8 + (i % 30);
+        buckets.emplace_back(used_bits, (uint64_t(i) * 0x9E3779B97F4A7C15ULL));
+    }
+    buckets.emplace_back(40, 0x12345678abcdULL);
+    buckets.emplace_back(40, 0x22345678abcdULL);
+    std::sort(buckets.begin(), buckets.end(), [](const auto& a, const auto& b) {
+        return a.toKey() < b.toKey();
+    });
+    for (const char* up_states : {"uim", "ui", "uri"}) {
+        std::vector<std::vector<uint16_t>> results;
+        distr.getIdealStorageNodes(state, buckets, results, up_states);
+        ASSERT_EQ(buckets.size(), results.size());
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            EXPECT_EQ(distr.getIdealStorageNodes(state, buckets[i], up_states), results[i]) << buckets[i].toString();
+        }
+    }
+}
+
 TEST(DistributionTest, wildcard_top_level_distribution_gives_expected_node_results) {
     std::string raw_config = R"(redundancy 2
 initial_redundancy 2
@@ -358,15 +358,31 @@ Distribution::allDistributorsDown(const Group& g, const ClusterState& cs)
     return true;
 }
 
+std::vector<double>
+Distribution::getNodeCapacities(const NodeType& nodeType,
+                                const ClusterState& clusterState,
+                                const char* upStates) const
+{
+    std::vector<double> capacities(_node2Group.size(), -1.0);
+    for (uint32_t i = 0; i < capacities.size(); ++i) {
+        const NodeState& nodeState(clusterState.getNodeState(Node(nodeType, i)));
+        if (nodeState.getState().oneOf(upStates)) {
+            capacities[i] = (nodeState.getCapacity() != vespalib::Double(1.0))
+                    ? nodeState.getCapacity().getValue() : 1.0;
+        }
+    }
+    return capacities;
+}
+
+template <typename NodeCapacity>
 void
 Distribution::getIdealNodes(const NodeType& nodeType,
                             const ClusterState& clusterState,
                             const document::BucketId& bucket,
                             std::vector<uint16_t>& resultNodes,
-                            const char* upStates,
+                            NodeCapacity nodeCapacity,
                             uint16_t redundancy) const
 {
-    if (redundancy == DEFAULT_REDUNDANCY) redundancy = _redundancy;
     resultNodes.clear();
     if (redundancy == 0) return;
 
@@ -412,8 +428,8 @@ Distribution::getIdealNodes(const NodeType& nodeType,
             // Verify that the node is legal target before starting to grab
             // random number. Helps worst case of having to start new random
             // seed if the node that is out of order is illegal anyways.
-            const NodeState& nodeState(clusterState.getNodeState(Node(nodeType, nodes[j])));
-            if (!nodeState.getState().oneOf(upStates)) continue;
+            double capacity = nodeCapacity(nodes[j]);
+            if (capacity < 0.0) continue;
             // Get the score from the random number generator. Make sure we
             // pick correct random number. Optimize for the case where we
             // pick in rising order.
@@ -429,8 +445,8 @@ Distribution::getIdealNodes(const NodeType& nodeType,
             }
             double score = random.nextDouble();
             ++randomIndex;
-            if (nodeState.getCapacity() != vespalib::Double(1.0)) {
-                score = std::pow(score, 1.0 / nodeState.getCapacity().getValue());
+            if (capacity != 1.0) {
+                score = std::pow(score, 1.0 / capacity);
             }
             if (score > tmpResults.back()._score) {
                 insertOrdered(tmpResults, ScoredNode(score, nodes[j]));
@@ -444,6 +460,56 @@ Distribution::getIdealNodes(const NodeType& nodeType,
     }
 }
 
+void
+Distribution::getIdealNodes(const NodeType& nodeType,
+                            const ClusterState& clusterState,
+                            const document::BucketId& bucket,
+                            std::vector<uint16_t>& resultNodes,
+                            const char* upStates,
+                            uint16_t redundancy) const
+{
+    if (redundancy == DEFAULT_REDUNDANCY) redundancy = _redundancy;
+    auto nodeCapacity = [&nodeType, &clusterState, upStates](uint16_t index) {
+        const NodeState& nodeState(clusterState.getNodeState(Node(nodeType, index)));
+        if (!nodeState.getState().oneOf(upStates)) {
+            return -1.0;
+        }
+        return (nodeState.getCapacity() != vespalib::Double(1.0))
+                ? nodeState.getCapacity().getValue() : 1.0;
+    };
+    getIdealNodes(nodeType, clusterState, bucket, resultNodes, nodeCapacity, redundancy);
+}
+
+void
+Distribution::getIdealStorageNodes(const ClusterState& state,
+                                   const std::vector<document::BucketId>& buckets,
+                                   std::vector<std::vector<uint16_t>>& results,
+                                   const char* upStates) const
+{
+    results.clear();
+    results.resize(buckets.size());
+    const std::vector<double> capacities(getNodeCapacities(NodeType::STORAGE, state, upStates));
+    auto nodeCapacity = [&capacities](uint16_t index) {
+        return (index < capacities.size()) ? capacities[index] : -1.0;
+    };
+    const uint32_t groupSeedMask = _distributionBitMasks[state.getDistributionBitCount()];
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        const document::BucketId& bucket(buckets[i]);
+        // The ideal nodes only depend on the bucket through the group and
+        // storage seeds, so they can be reused while both are unchanged.
+        if ((i > 0) && (bucket.getUsedBits() >= state.getDistributionBitCount())
+            && (buckets[i - 1].getUsedBits() >= state.getDistributionBitCount())
+            && ((static_cast<uint32_t>(bucket.getRawId()) & groupSeedMask)
+                == (static_cast<uint32_t>(buckets[i - 1].getRawId()) & groupSeedMask))
+            && (getStorageSeed(bucket, state) == getStorageSeed(buckets[i - 1], state)))
+        {
+            results[i] = results[i - 1];
+            continue;
+        }
+        getIdealNodes(NodeType::STORAGE, state, bucket, results[i], nodeCapacity, _redundancy);
+    }
+}
+
 Distribution::ConfigWrapper
 Distribution::getDefaultDistributionConfig(uint16_t redundancy, uint16_t nodeCount)
 {
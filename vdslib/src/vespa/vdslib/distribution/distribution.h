@@ -86,6 +86,23 @@ private:
                                           const ClusterState& clusterState,
                                           const Group& parent) const;
 
+    /**
+     * Capacity of each node in the node graph, or a negative value if the
+     * node is not in one of the given up states. Lets batch calculations
+     * look up node states once rather than once per bucket.
+     */
+    std::vector<double> getNodeCapacities(const NodeType&, const ClusterState&,
+                                          const char* upStates) const;
+
+    /**
+     * Calculates ideal nodes using the given function to get the capacity
+     * of a node, which returns a negative value for nodes that are down.
+     */
+    template <typename NodeCapacity>
+    void getIdealNodes(const NodeType&, const ClusterState&,
+                       const document::BucketId&, std::vector<uint16_t>& nodes,
+                       NodeCapacity nodeCapacity, uint16_t redundancy) const;
+
     /**
      * Since distribution object may be used often in ideal state calculations
      * we'd like to avoid locking using it. Thus we don't support live config.
@@ -137,6 +154,19 @@ public:
             const ClusterState&, const document::BucketId&,
             const char* upStates = "uim") const;
 
+    /**
+     * Batch version of getIdealStorageNodes(). Buckets should be sorted by
+     * bucket key, so that buckets mapping to the same super bucket are
+     * adjacent. Node states are looked up once for the whole batch, and
+     * the ideal nodes are only calculated again when the seeds used differ
+     * from those of the previous bucket. results[i] holds the ideal nodes
+     * of buckets[i].
+     */
+    void getIdealStorageNodes(
+            const ClusterState&, const std::vector<document::BucketId>& buckets,
+            std::vector<std::vector<uint16_t>>& results,
+            const char* upStates = "uim") const;
+
     /** Simplified wrapper for getIdealNodes() */
     uint16_t getIdealDistributorNode(
             const ClusterState&, const document::BucketId&,
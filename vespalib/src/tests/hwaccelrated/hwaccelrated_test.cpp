@@ -37,4 +37,47 @@ TEST("test euclidean distance") {
     verifyEuclideanDistance<double >(genericAccelrator);
 }
 
+size_t simpleJsonEncodeSkip(const char * str, size_t sz) {
+    for (size_t i(0); i < sz; i++) {
+        uint8_t c = str[i];
+        if ((c < 0x20) || (c == '"') || (c == '\\')) {
+            return i;
+        }
+    }
+    return sz;
+}
+
+size_t simpleJsonDecodeSkip(const char * str, size_t sz) {
+    for (size_t i(0); i < sz; i++) {
+        char c = str[i];
+        if ((c == '\0') || (c == '"') || (c == '\'') || (c == '\\')) {
+            return i;
+        }
+    }
+    return sz;
+}
+
+void verifyJsonSkip(const hwaccelrated::IAccelrated & accel) {
+    srand(1);
+    std::vector<char> buf(300);
+    for (size_t n(0); n < 2000; n++) {
+        for (char & c : buf) {
+            c = 0x20 + rand()%0x60;
+        }
+        size_t offset = rand()%64;
+        size_t sz = rand()%(buf.size() - offset);
+        if ((n % 4) != 0) {
+            buf[offset + rand()%(sz + 1)] = "\"\\'\0\n\x1f\xff"[rand()%7];
+        }
+        EXPECT_EQUAL(simpleJsonEncodeSkip(&buf[offset], sz), accel.jsonEncodeSkip(&buf[offset], sz));
+        EXPECT_EQUAL(simpleJsonDecodeSkip(&buf[offset], sz), accel.jsonDecodeSkip(&buf[offset], sz));
+    }
+}
+
+TEST("test json skip") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifyJsonSkip(genericAccelrator);
+    verifyJsonSkip(hwaccelrated::IAccelrated::getAccelerator());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -41,7 +41,9 @@ struct Fixture {
     Selector<Context> selector;
     std::vector<SocketPair> sockets;
     std::vector<Context> contexts;
-    Fixture(size_t size, bool read_enabled, bool write_enabled) : wakeup(false), selector(), sockets(), contexts() {
+    Fixture(size_t size, bool read_enabled, bool write_enabled, bool io_uring = false)
+        : wakeup(false), selector(io_uring), sockets(), contexts()
+    {
         for (size_t i = 0; i < size; ++i) {
             sockets.push_back(SocketPair::create());
             contexts.push_back(Context(sockets.back().a.get()));
@@ -107,7 +109,7 @@ constexpr std::pair<bool,bool> in   = std::make_pair(true,  false);
 constexpr std::pair<bool,bool> out  = std::make_pair(false, true);
 constexpr std::pair<bool,bool> both = std::make_pair(true,  true);
 
-TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
+void verify_basic_events(Fixture &f1) {
     TEST_DO(f1.reset().poll().verify(false, {out}));
     EXPECT_TRUE(f1.write(0, "test"));
     TEST_DO(f1.reset().poll().verify(false, {both}));
@@ -123,6 +125,14 @@ TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
     TEST_DO(f1.reset().poll().verify(false, {both}));
 }
 
+TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
+    TEST_DO(verify_basic_events(f1));
+}
+
+TEST_F("require that basic events trigger correctly (io_uring)", Fixture(1, true, true, true)) {
+    TEST_DO(verify_basic_events(f1));
+}
+
 TEST_FFF("require that sources can be added with some events disabled",
          Fixture(1, true, false), Fixture(1, false, true), Fixture(1, false, false))
 {
@@ -140,7 +150,7 @@ TEST_FFF("require that sources can be added with some events disabled",
     TEST_DO(f3.reset().poll().verify(false, {both}));
 }
 
-TEST_F("require that multiple sources can be selected on", Fixture(5, true, false)) {
+void verify_multiple_sources(Fixture &f1) {
     TEST_DO(f1.reset().poll(10).verify(false, {none, none, none, none, none}));
     EXPECT_TRUE(f1.write(1, "test"));
     EXPECT_TRUE(f1.write(3, "test"));
@@ -152,7 +162,15 @@ TEST_F("require that multiple sources can be selected on", Fixture(5, true, fals
     TEST_DO(f1.reset().poll(10).verify(false, {none, none, none, none, none}));
 }
 
-TEST_F("require that removed sources no longer produce events", Fixture(2, true, true)) {
+TEST_F("require that multiple sources can be selected on", Fixture(5, true, false)) {
+    TEST_DO(verify_multiple_sources(f1));
+}
+
+TEST_F("require that multiple sources can be selected on (io_uring)", Fixture(5, true, false, true)) {
+    TEST_DO(verify_multiple_sources(f1));
+}
+
+void verify_removed_sources(Fixture &f1) {
     TEST_DO(f1.reset().poll().verify(false, {out, out}));
     EXPECT_TRUE(f1.write(0, "test"));
     EXPECT_TRUE(f1.write(1, "test"));
@@ -161,6 +179,14 @@ TEST_F("require that removed sources no longer produce events", Fixture(2, true,
     TEST_DO(f1.reset().poll().verify(false, {none, both}));
 }
 
+TEST_F("require that removed sources no longer produce events", Fixture(2, true, true)) {
+    TEST_DO(verify_removed_sources(f1));
+}
+
+TEST_F("require that removed sources no longer produce events (io_uring)", Fixture(2, true, true, true)) {
+    TEST_DO(verify_removed_sources(f1));
+}
+
 TEST_F("require that filling the output buffer disables write events", Fixture(1, true, true)) {
     EXPECT_TRUE(f1.write(0, "test"));
     TEST_DO(f1.reset().poll().verify(false, {both}));
@@ -191,6 +217,15 @@ TEST_MT_FF("require that selection criteria can be changed while waiting for eve
     }
 }
 
+TEST_MT_FF("require that selection criteria can be changed while waiting for events (io_uring)", 2, Fixture(1, true, false, true), TimeBomb(60)) {
+    if (thread_id == 0) {
+        TEST_DO(f1.reset().poll().verify(false, {out}));
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        f1.update(0, true, true);
+    }
+}
+
 TEST_MT_FF("require that selection sources can be added while waiting for events", 2, Fixture(0, true, false), TimeBomb(60)) {
     if (thread_id == 0) {
         TEST_DO(f1.reset().poll().verify(false, {}));
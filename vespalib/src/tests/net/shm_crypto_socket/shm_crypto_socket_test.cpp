@@ -0,0 +1,244 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/testkit/time_bomb.h>
+#include <vespa/vespalib/net/crypto_engine.h>
+#include <vespa/vespalib/net/shm_crypto_engine.h>
+#include <vespa/vespalib/net/sync_crypto_socket.h>
+#include <vespa/vespalib/net/server_socket.h>
+#include <vespa/vespalib/net/socket_handle.h>
+#include <vespa/vespalib/net/socket_spec.h>
+#include <vespa/vespalib/net/socket_utils.h>
+#include <vespa/vespalib/data/smart_buffer.h>
+#include <sys/socket.h>
+
+using namespace vespalib;
+
+constexpr size_t small_ring = 4096;
+
+SocketHandle connect_sockets(bool is_server, ServerSocket &server_socket) {
+    if (is_server) {
+        return server_socket.accept();
+    } else {
+        return SocketSpec(server_socket.address().spec()).client_address().connect();
+    }
+}
+
+SyncCryptoSocket::UP make_socket(bool is_server, ServerSocket &server_socket, CryptoEngine &engine) {
+    SocketHandle handle = connect_sockets(is_server, server_socket);
+    handle.set_blocking(false);
+    return is_server
+        ? SyncCryptoSocket::create_server(engine, std::move(handle))
+        : SyncCryptoSocket::create_client(engine, std::move(handle), SocketSpec::invalid);
+}
+
+vespalib::string make_data(size_t size, size_t seed) {
+    vespalib::string data;
+    for (size_t i = 0; i < size; ++i) {
+        data.push_back('a' + ((i * 7 + seed) % 26));
+    }
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+
+vespalib::string read_bytes(SyncCryptoSocket &socket, size_t wanted_bytes) {
+    SmartBuffer read_buffer(wanted_bytes);
+    while (read_buffer.obtain().size < wanted_bytes) {
+        auto chunk = read_buffer.reserve(wanted_bytes - read_buffer.obtain().size);
+        auto res = socket.read(chunk.data, chunk.size);
+        ASSERT_TRUE(res > 0);
+        read_buffer.commit(res);
+    }
+    auto data = read_buffer.obtain();
+    return vespalib::string(data.data, wanted_bytes);
+}
+
+void read_EOF(SyncCryptoSocket &socket) {
+    char buf[16];
+    auto res = socket.read(buf, sizeof(buf));
+    ASSERT_EQUAL(res, 0);
+}
+
+void write_bytes(SyncCryptoSocket &socket, const vespalib::string &message) {
+    auto res = socket.write(message.data(), message.size());
+    ASSERT_EQUAL(size_t(res), message.size());
+}
+
+void write_EOF(SyncCryptoSocket &socket) {
+    ASSERT_EQUAL(socket.half_close(), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+void verify_socket_io(SyncCryptoSocket &socket, bool is_server) {
+    vespalib::string client_message = "please pick up, I need to talk to you";
+    vespalib::string server_message = "hello, this is the server speaking";
+    if (is_server) {
+        vespalib::string read = read_bytes(socket, client_message.size());
+        write_bytes(socket, server_message);
+        EXPECT_EQUAL(client_message, read);
+    } else {
+        write_bytes(socket, client_message);
+        vespalib::string read = read_bytes(socket, server_message.size());
+        EXPECT_EQUAL(server_message, read);
+    }
+}
+
+void verify_graceful_shutdown(SyncCryptoSocket &socket, bool is_server) {
+    if (is_server) {
+        TEST_DO(write_EOF(socket));
+        TEST_DO(read_EOF(socket));
+        TEST_DO(read_EOF(socket));
+    } else {
+        TEST_DO(read_EOF(socket));
+        TEST_DO(read_EOF(socket));
+        TEST_DO(write_EOF(socket));
+    }
+}
+
+// echo many messages of varying size; with a small ring this also
+// moves data through the socket when the ring is full
+void verify_bulk_io(SyncCryptoSocket &socket, bool is_server) {
+    size_t sizes[] = { 1, 17, 1000, 4000, 4096, 5000, 65536, 300000 };
+    for (size_t i = 0; i < 64; ++i) {
+        size_t size = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+        vespalib::string data = make_data(size, i);
+        if (is_server) {
+            vespalib::string read = read_bytes(socket, size);
+            write_bytes(socket, read);
+            ASSERT_EQUAL(data, read);
+        } else {
+            write_bytes(socket, data);
+            vespalib::string read = read_bytes(socket, size);
+            ASSERT_EQUAL(data, read);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+TEST("require that tcp connections to localhost are local") {
+    ServerSocket server_socket("tcp/0");
+    SocketHandle client = connect_sockets(false, server_socket);
+    SocketHandle server = connect_sockets(true, server_socket);
+    EXPECT_TRUE(ShmCryptoEngine::is_local_peer(client.get()));
+    EXPECT_TRUE(ShmCryptoEngine::is_local_peer(server.get()));
+}
+
+TEST("require that unix domain sockets are not local peers") {
+    int sockets[2];
+    ASSERT_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    SocketHandle client(sockets[0]);
+    SocketHandle server(sockets[1]);
+    EXPECT_FALSE(ShmCryptoEngine::is_local_peer(client.get()));
+    EXPECT_FALSE(ShmCryptoEngine::is_local_peer(server.get()));
+}
+
+// a server socket whose port is advertised as accepting shared memory connections
+struct Listener {
+    ServerSocket server_socket;
+    ShmCryptoEngine engine;
+    explicit Listener(CryptoEngine::SP wrapped, size_t ring_size = ShmCryptoEngine::default_ring_size)
+        : server_socket("tcp/0"), engine(std::move(wrapped), ring_size)
+    {
+        engine.server_listening(port());
+    }
+    int port() const { return server_socket.address().port(); }
+};
+
+TEST("require that listening servers advertise shared memory while listening") {
+    Listener listener(std::make_shared<NullCryptoEngine>());
+    EXPECT_TRUE(ShmCryptoEngine::is_advertised(listener.port()));
+    listener.engine.server_closed(listener.port());
+    EXPECT_FALSE(ShmCryptoEngine::is_advertised(listener.port()));
+}
+
+TEST("require that servers always using tls do not advertise shared memory") {
+    struct TlsOnly : NullCryptoEngine {
+        bool always_use_tls_when_server() const override { return true; }
+    };
+    Listener listener(std::make_shared<TlsOnly>());
+    EXPECT_FALSE(ShmCryptoEngine::is_advertised(listener.port()));
+}
+
+TEST("require that advertisements are removed when the engine is destroyed") {
+    ServerSocket server_socket("tcp/0");
+    int port = server_socket.address().port();
+    {
+        ShmCryptoEngine engine(std::make_shared<NullCryptoEngine>());
+        engine.server_listening(port);
+        EXPECT_TRUE(ShmCryptoEngine::is_advertised(port));
+    }
+    EXPECT_FALSE(ShmCryptoEngine::is_advertised(port));
+}
+
+TEST_MT_FF("require that shared memory socket io works", 2,
+           Listener(std::make_shared<NullCryptoEngine>()), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    auto socket = make_socket(is_server, f1.server_socket, f1.engine);
+    ASSERT_TRUE(socket);
+    TEST_DO(verify_socket_io(*socket, is_server));
+    TEST_DO(verify_graceful_shutdown(*socket, is_server));
+}
+
+TEST_MT_FF("require that shared memory socket io works when rings fill up", 2,
+           Listener(std::make_shared<NullCryptoEngine>(), small_ring), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    auto socket = make_socket(is_server, f1.server_socket, f1.engine);
+    ASSERT_TRUE(socket);
+    TEST_DO(verify_bulk_io(*socket, is_server));
+    TEST_DO(verify_graceful_shutdown(*socket, is_server));
+}
+
+TEST_MT_FF("require that local clients send shared memory greeting to advertising servers", 2,
+           Listener(std::make_shared<NullCryptoEngine>()), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    if (is_server) {
+        NullCryptoEngine plain;
+        auto socket = make_socket(is_server, f1.server_socket, plain);
+        ASSERT_TRUE(socket);
+        EXPECT_EQUAL(read_bytes(*socket, 8), vespalib::string("VESPASHM"));
+    } else {
+        auto socket = make_socket(is_server, f1.server_socket, f1.engine);
+        EXPECT_FALSE(socket); // no acknowledgement
+    }
+}
+
+TEST_MT_FFF("require that clients fall back to plain connections for servers not using shared memory", 2,
+            ServerSocket("tcp/0"), ShmCryptoEngine(std::make_shared<NullCryptoEngine>()), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    NullCryptoEngine plain;
+    auto socket = make_socket(is_server, f1, is_server ? static_cast<CryptoEngine &>(plain) : f2);
+    ASSERT_TRUE(socket);
+    TEST_DO(verify_socket_io(*socket, is_server));
+    TEST_DO(verify_graceful_shutdown(*socket, is_server));
+}
+
+TEST_MT_FF("require that server accepts plain clients", 2,
+           Listener(std::make_shared<NullCryptoEngine>()), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    NullCryptoEngine plain;
+    auto socket = make_socket(is_server, f1.server_socket, is_server ? static_cast<CryptoEngine &>(f1.engine) : plain);
+    ASSERT_TRUE(socket);
+    TEST_DO(verify_socket_io(*socket, is_server));
+    TEST_DO(verify_graceful_shutdown(*socket, is_server));
+}
+
+TEST_MT_FF("require that shared memory sockets work with xor crypto engine fallback", 2,
+           Listener(std::make_shared<XorCryptoEngine>()), TimeBomb(60))
+{
+    bool is_server = (thread_id == 0);
+    XorCryptoEngine xor_engine;
+    auto socket = make_socket(is_server, f1.server_socket, is_server ? static_cast<CryptoEngine &>(f1.engine) : xor_engine);
+    ASSERT_TRUE(socket);
+    TEST_DO(verify_socket_io(*socket, is_server));
+    TEST_DO(verify_graceful_shutdown(*socket, is_server));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
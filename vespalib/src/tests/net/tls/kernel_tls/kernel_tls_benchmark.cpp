@@ -0,0 +1,92 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/testkit/time_bomb.h>
+#include <vespa/vespalib/net/tls/tls_crypto_engine.h>
+#include <vespa/vespalib/net/tls/transport_security_options.h>
+#include <vespa/vespalib/net/sync_crypto_socket.h>
+#include <vespa/vespalib/net/server_socket.h>
+#include <vespa/vespalib/net/socket_address.h>
+#include <vespa/vespalib/net/socket_spec.h>
+#include <vespa/vespalib/test/make_tls_options_for_testing.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <chrono>
+#include <vector>
+
+using namespace vespalib;
+using namespace vespalib::net::tls;
+using namespace vespalib::test;
+
+TransportSecurityOptions make_options(bool enable_kernel_tls) {
+    auto base = make_tls_options_for_testing();
+    return TransportSecurityOptions(TransportSecurityOptions::Params()
+                                            .ca_certs_pem(base.ca_certs_pem())
+                                            .cert_chain_pem(base.cert_chain_pem())
+                                            .private_key_pem(base.private_key_pem())
+                                            .authorized_peers(base.authorized_peers())
+                                            .enable_kernel_tls(enable_kernel_tls));
+}
+
+// Kernel TLS only applies to TCP sockets, so talk over loopback rather than a socket pair
+struct Fixture {
+    TlsCryptoEngine engine;
+    ServerSocket    server;
+    explicit Fixture(bool enable_kernel_tls)
+        : engine(make_options(enable_kernel_tls)),
+          server(0)
+    {}
+    SyncCryptoSocket::UP connect() {
+        auto addr = SocketSpec::from_host_port("localhost", server.address().port()).client_address();
+        return SyncCryptoSocket::create_client(engine, addr.connect(), local_spec);
+    }
+    SyncCryptoSocket::UP accept() {
+        return SyncCryptoSocket::create_server(engine, server.accept());
+    }
+};
+
+std::vector<char> make_data(size_t size) {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i * 7 + (i >> 13));
+    }
+    return data;
+}
+
+void measure_throughput(Fixture &f, bool is_server, const char *name) {
+    constexpr size_t total = 256_Mi;
+    auto chunk = make_data(1_Mi);
+    if (is_server) {
+        auto socket = f.accept();
+        ASSERT_TRUE(socket);
+        std::vector<char> buf(256_Ki);
+        size_t received = 0;
+        auto before = std::chrono::steady_clock::now();
+        for (ssize_t res = socket->read(buf.data(), buf.size()); res > 0; res = socket->read(buf.data(), buf.size())) {
+            received += res;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - before).count();
+        EXPECT_EQUAL(received, total);
+        EXPECT_EQUAL(socket->half_close(), 0);
+        fprintf(stderr, "%s: %zu MiB in %.3f s (%.1f MiB/s)\n", name, total / 1_Mi, secs, (total / 1_Mi) / secs);
+    } else {
+        auto socket = f.connect();
+        ASSERT_TRUE(socket);
+        for (size_t sent = 0; sent < total; sent += chunk.size()) {
+            ASSERT_EQUAL(socket->write(chunk.data(), chunk.size()), ssize_t(chunk.size()));
+        }
+        EXPECT_EQUAL(socket->half_close(), 0);
+        // wait for the server to see all data; closing with unread data (session tickets) resets the connection
+        std::vector<char> buf(4_Ki);
+        while (socket->read(buf.data(), buf.size()) > 0) {}
+    }
+}
+
+TEST_MT_FF("benchmark loopback throughput with user space TLS", 2, Fixture(false), TimeBomb(120)) {
+    TEST_DO(measure_throughput(f1, (thread_id == 0), "user space TLS"));
+}
+
+TEST_MT_FF("benchmark loopback throughput with kernel TLS offload", 2, Fixture(true), TimeBomb(120)) {
+    TEST_DO(measure_throughput(f1, (thread_id == 0), "kernel TLS"));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
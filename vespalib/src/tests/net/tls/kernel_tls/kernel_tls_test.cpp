@@ -0,0 +1,111 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/testkit/time_bomb.h>
+#include <vespa/vespalib/net/tls/kernel_tls.h>
+#include <vespa/vespalib/net/tls/tls_crypto_engine.h>
+#include <vespa/vespalib/net/tls/transport_security_options.h>
+#include <vespa/vespalib/net/sync_crypto_socket.h>
+#include <vespa/vespalib/net/server_socket.h>
+#include <vespa/vespalib/net/socket_address.h>
+#include <vespa/vespalib/net/socket_spec.h>
+#include <vespa/vespalib/test/make_tls_options_for_testing.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <vector>
+
+using namespace vespalib;
+using namespace vespalib::net::tls;
+using namespace vespalib::test;
+
+TransportSecurityOptions make_options(bool enable_kernel_tls) {
+    auto base = make_tls_options_for_testing();
+    return TransportSecurityOptions(TransportSecurityOptions::Params()
+                                            .ca_certs_pem(base.ca_certs_pem())
+                                            .cert_chain_pem(base.cert_chain_pem())
+                                            .private_key_pem(base.private_key_pem())
+                                            .authorized_peers(base.authorized_peers())
+                                            .enable_kernel_tls(enable_kernel_tls));
+}
+
+// Kernel TLS only applies to TCP sockets, so talk over loopback rather than a socket pair
+struct Fixture {
+    TlsCryptoEngine engine;
+    ServerSocket    server;
+    explicit Fixture(bool enable_kernel_tls)
+        : engine(make_options(enable_kernel_tls)),
+          server(0)
+    {}
+    SyncCryptoSocket::UP connect() {
+        auto addr = SocketSpec::from_host_port("localhost", server.address().port()).client_address();
+        return SyncCryptoSocket::create_client(engine, addr.connect(), local_spec);
+    }
+    SyncCryptoSocket::UP accept() {
+        return SyncCryptoSocket::create_server(engine, server.accept());
+    }
+};
+
+std::vector<char> make_data(size_t size) {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(i * 7 + (i >> 13));
+    }
+    return data;
+}
+
+void write_all(SyncCryptoSocket &socket, const std::vector<char> &data) {
+    for (size_t pos = 0; pos < data.size(); pos += 1_Mi) {
+        size_t len = std::min(size_t(1_Mi), data.size() - pos);
+        ASSERT_EQUAL(socket.write(data.data() + pos, len), ssize_t(len));
+    }
+}
+
+std::vector<char> read_until_eof(SyncCryptoSocket &socket) {
+    std::vector<char> data;
+    std::vector<char> buf(256_Ki);
+    for (;;) {
+        auto res = socket.read(buf.data(), buf.size());
+        ASSERT_TRUE(res >= 0);
+        if (res == 0) {
+            return data;
+        }
+        data.insert(data.end(), buf.data(), buf.data() + res);
+    }
+}
+
+void verify_transfer(Fixture &f, bool is_server, bool expect_kernel_tls) {
+    auto client_data = make_data(5_Mi + 3);
+    auto server_data = make_data(3_Mi + 5);
+    if (is_server) {
+        auto socket = f.accept();
+        ASSERT_TRUE(socket);
+        EXPECT_EQUAL(socket->is_kernel_tls_tx_enabled(), expect_kernel_tls);
+        auto got = read_until_eof(*socket);
+        EXPECT_TRUE(got == client_data);
+        write_all(*socket, server_data);
+        EXPECT_EQUAL(socket->half_close(), 0);
+    } else {
+        auto socket = f.connect();
+        ASSERT_TRUE(socket);
+        EXPECT_EQUAL(socket->is_kernel_tls_tx_enabled(), expect_kernel_tls);
+        write_all(*socket, client_data);
+        EXPECT_EQUAL(socket->half_close(), 0);
+        auto got = read_until_eof(*socket);
+        EXPECT_TRUE(got == server_data);
+    }
+}
+
+TEST_MT_FF("require that data and graceful shutdown survive user space TLS", 2, Fixture(false), TimeBomb(60)) {
+    TEST_DO(verify_transfer(f1, (thread_id == 0), false));
+}
+
+TEST_MT_FF("require that data and graceful shutdown survive kernel TLS offload", 2, Fixture(true), TimeBomb(60)) {
+    if (!KernelTls::is_supported()) {
+        if (thread_id == 0) {
+            fprintf(stderr, "WARNING: skipping kernel TLS offload test since the kernel lacks TLS support\n");
+        }
+        return;
+    }
+    TEST_DO(verify_transfer(f1, (thread_id == 0), true));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -190,6 +190,23 @@ TEST("hostname validation can be explicitly enabled") {
     EXPECT_FALSE(read_options_from_json_string(json)->disable_hostname_validation());
 }
 
+TEST("kernel TLS offload is disabled by default") {
+    const char* json = R"({"files":{"private-key":"dummy_privkey.txt",
+                                    "certificates":"dummy_certs.txt",
+                                    "ca-certificates":"dummy_ca_certs.txt"}})";
+    EXPECT_FALSE(read_options_from_json_string(json)->enable_kernel_tls());
+}
+
+TEST("kernel TLS offload can be enabled and survives redaction of the private key") {
+    const char* json = R"({"files":{"private-key":"dummy_privkey.txt",
+                                    "certificates":"dummy_certs.txt",
+                                    "ca-certificates":"dummy_ca_certs.txt"},
+                           "enable-kernel-tls": true})";
+    auto opts = read_options_from_json_string(json);
+    EXPECT_TRUE(opts->enable_kernel_tls());
+    EXPECT_TRUE(opts->copy_without_private_key().enable_kernel_tls());
+}
+
 TEST("unknown fields are ignored at parse-time") {
     const char* json = R"({"files":{"private-key":"dummy_privkey.txt",
                                     "certificates":"dummy_certs.txt",
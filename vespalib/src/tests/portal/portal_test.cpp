@@ -13,6 +13,9 @@
 #include <vespa/vespalib/net/tls/maybe_tls_crypto_engine.h>
 #include <vespa/vespalib/test/make_tls_options_for_testing.h>
 #include <vespa/vespalib/util/latch.h>
+#include <vespa/vespalib/util/signalhandler.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <set>
 
 using namespace vespalib;
 using namespace vespalib::test;
@@ -60,6 +63,52 @@ vespalib::string make_expected_response(const vespalib::string &content_type, co
                                  "%s", content_type.c_str(), content.size(), content.c_str());
 }
 
+vespalib::string make_expected_stream_header(const vespalib::string &content_type) {
+    return vespalib::make_string("HTTP/1.1 200 OK\r\n"
+                                 "Connection: close\r\n"
+                                 "Content-Type: %s\r\n"
+                                 "Transfer-Encoding: chunked\r\n"
+                                 "X-XSS-Protection: 1; mode=block\r\n"
+                                 "X-Frame-Options: DENY\r\n"
+                                 "Content-Security-Policy: default-src 'none'\r\n"
+                                 "X-Content-Type-Options: nosniff\r\n"
+                                 "Cache-Control: no-store\r\n"
+                                 "Pragma: no-cache\r\n"
+                                 "\r\n", content_type.c_str());
+}
+
+// decode a chunked body; returns false if it is malformed or not terminated
+bool dechunk(vespalib::stringref body, vespalib::string &content, size_t &num_chunks) {
+    content.clear();
+    num_chunks = 0;
+    size_t pos = 0;
+    for (;;) {
+        size_t eol = body.find("\r\n", pos);
+        if (eol == vespalib::stringref::npos) {
+            return false;
+        }
+        size_t len = strtoul(vespalib::string(body.substr(pos, eol - pos)).c_str(), nullptr, 16);
+        pos = eol + 2;
+        if ((pos + len + 2) > body.size() || body.substr(pos + len, 2) != "\r\n") {
+            return false;
+        }
+        if (len == 0) {
+            return ((pos + 2) == body.size());
+        }
+        content.append(body.substr(pos, len));
+        pos += len + 2;
+        ++num_chunks;
+    }
+}
+
+vespalib::string make_stream_content(size_t size) {
+    vespalib::string content;
+    for (size_t i = 0; i < size; ++i) {
+        content.push_back('a' + (i % 26));
+    }
+    return content;
+}
+
 vespalib::string make_expected_error(int code, const vespalib::string &message) {
     return vespalib::make_string("HTTP/1.1 %d %s\r\n"
                                  "Connection: close\r\n"
@@ -355,6 +404,130 @@ TEST_MT_FFF("require that portal destruction waits for request completion", 3,
 
 //-----------------------------------------------------------------------------
 
+TEST("require that portal can use multiple reactors") {
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+    MyGetHandler handler([&](Portal::GetRequest request)
+                         {
+                             {
+                                 std::lock_guard guard(lock);
+                                 threads.insert(std::this_thread::get_id());
+                             }
+                             request.respond_with_content("text/plain", "hello");
+                         });
+    auto portal = Portal::create(null_crypto(), 0, 4);
+    EXPECT_EQUAL(portal->num_reactors(), 4u);
+    EXPECT_GREATER(portal->listen_port(), 0);
+    auto bound = portal->bind("/test", handler);
+    for (size_t i = 0; i < 64; ++i) {
+        EXPECT_EQUAL(fetch(portal->listen_port(), null_crypto(), "/test"), make_expected_response("text/plain", "hello"));
+    }
+    // connections are spread by the kernel; 64 of them ending up on the same reactor is very unlikely
+    std::lock_guard guard(lock);
+    EXPECT_GREATER(threads.size(), 1u);
+}
+
+TEST("require that GET responses can be streamed with various encryption strategies") {
+    auto content = make_stream_content(1_Mi + 17);
+    MyGetHandler handler([&](Portal::GetRequest request)
+                         {
+                             auto stream = request.respond_with_stream("text/plain");
+                             EXPECT_TRUE(!request.active());
+                             for (size_t pos = 0; pos < content.size(); pos += 1000) {
+                                 stream.write(vespalib::stringref(content).substr(pos, 1000));
+                             }
+                             EXPECT_TRUE(!stream.failed());
+                         });
+    for (const Encryption &crypto: crypto_list) {
+        fprintf(stderr, "... testing streamed GET with encryption: '%s'\n", crypto.name.c_str());
+        auto portal = Portal::create(crypto.engine, 0);
+        auto bound = portal->bind("/test", handler);
+        auto result = fetch(portal->listen_port(), crypto.engine, "/test");
+        auto header = make_expected_stream_header("text/plain");
+        ASSERT_GREATER(result.size(), header.size());
+        EXPECT_EQUAL(result.substr(0, header.size()), header);
+        vespalib::string body;
+        size_t num_chunks = 0;
+        ASSERT_TRUE(dechunk(vespalib::stringref(result).substr(header.size()), body, num_chunks));
+        EXPECT_TRUE(body == content);
+        EXPECT_GREATER(num_chunks, 1u);
+    }
+}
+
+TEST("require that an empty stream gives an empty chunked response") {
+    auto portal = Portal::create(null_crypto(), 0);
+    MyGetHandler handler([](Portal::GetRequest request)
+                         {
+                             auto stream = request.respond_with_stream("application/json");
+                             stream.finish();
+                             EXPECT_TRUE(!stream.active());
+                         });
+    auto bound = portal->bind("/test", handler);
+    auto result = fetch(portal->listen_port(), null_crypto(), "/test");
+    EXPECT_EQUAL(result, make_expected_stream_header("application/json") + "0\r\n\r\n");
+}
+
+TEST_MT_FF("require that GET responses can be streamed from another thread", 2,
+           LatchedFixture(), TimeBomb(60))
+{
+    if (thread_id == 0) {
+        Portal::GetRequest req = f1.latch.read();
+        f1.exit_callback.countDown();
+        auto stream = req.respond_with_stream("text/plain");
+        std::this_thread::sleep_for(5ms);
+        stream.write("hello ");
+        stream.write("world");
+    } else {
+        auto result = fetch(f1.portal->listen_port(), null_crypto(), "/test");
+        EXPECT_EQUAL(result, make_expected_stream_header("text/plain") + "b\r\nhello world\r\n0\r\n\r\n");
+    }
+}
+
+TEST("require that a stalled stream leaves the reactor alone and fails when the client goes away") {
+    SignalHandler::PIPE.ignore();
+    Gate done;
+    std::atomic<bool> failed(false);
+    std::thread producer;
+    MyGetHandler slow_handler([&](Portal::GetRequest request)
+                              {
+                                  producer = std::thread([&done,&failed,req = std::move(request)]() mutable
+                                                         {
+                                                             auto stream = req.respond_with_stream("text/plain");
+                                                             auto chunk = make_stream_content(64_Ki);
+                                                             for (size_t i = 0; (i < 16_Ki) && !stream.failed(); ++i) {
+                                                                 stream.write(chunk);
+                                                             }
+                                                             failed = stream.failed();
+                                                             done.countDown();
+                                                         });
+                              });
+    MyGetHandler fast_handler([](Portal::GetRequest request)
+                              {
+                                  request.respond_with_content("text/plain", "hello");
+                              });
+    auto portal = Portal::create(null_crypto(), 0);
+    auto slow = portal->bind("/slow", slow_handler);
+    auto fast = portal->bind("/fast", fast_handler);
+    {
+        auto socket = SocketSpec::from_port(portal->listen_port()).client_address().connect();
+        auto conn = SyncCryptoSocket::create_client(*null_crypto(), std::move(socket), local_spec);
+        vespalib::string req = "GET /slow HTTP/1.1\r\n"
+                               "Host: localhost\r\n"
+                               "\r\n";
+        ASSERT_EQUAL(conn->write(req.data(), req.size()), ssize_t(req.size()));
+        char buf[1024];
+        EXPECT_GREATER(conn->read(buf, sizeof(buf)), 0);
+        // the producer is held back while the client is not reading, but the reactor is free
+        EXPECT_EQUAL(fetch(portal->listen_port(), null_crypto(), "/fast"), make_expected_response("text/plain", "hello"));
+        EXPECT_TRUE(!done.await(10ms));
+    }
+    EXPECT_TRUE(done.await(60s));
+    EXPECT_TRUE(failed);
+    producer.join();
+}
+
+//-----------------------------------------------------------------------------
+
 TEST("require that query parameters can be inspected") {
     auto portal = Portal::create(null_crypto(), 0);
     MyGetHandler handler([](Portal::GetRequest request)
@@ -0,0 +1,68 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_view.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <fstream>
+#include <sstream>
+
+using namespace vespalib::slime::convenience;
+using namespace vespalib::slime;
+using vespalib::SimpleBuffer;
+using vespalib::BenchmarkTimer;
+
+const double budget = 2.0;
+
+struct Blob {
+    SimpleBuffer buf;
+    Blob() : buf() {
+        std::ifstream file(TEST_PATH("large_json.txt").c_str());
+        ASSERT_TRUE(file.is_open());
+        std::stringstream json;
+        json << file.rdbuf();
+        Slime slime;
+        ASSERT_TRUE(JsonFormat::decode(json.str(), slime) > 0);
+        BinaryFormat::encode(slime, buf);
+    }
+};
+
+// read a few fields, like a summary fetch selecting some of them
+int64_t read_fields(const Inspector &root) {
+    const Inspector &type = root["documenttype"][0];
+    return type["id"].asLong() + type["name"].asString().size + type["datatype"].entries();
+}
+
+void report(const char *name, double seconds, size_t bytes) {
+    fprintf(stderr, "%s: %g us per blob, %g MB/s\n", name, seconds * 1000.0 * 1000.0, (bytes / seconds) / (1000.0 * 1000.0));
+}
+
+TEST_F("decode binary slime and read a few fields", Blob()) {
+    Memory mem = f1.buf.get();
+    int64_t sum_full = 0;
+    int64_t sum_view = 0;
+    double full = BenchmarkTimer::benchmark([&]() {
+                                                Slime slime;
+                                                BinaryFormat::decode(mem, slime);
+                                                sum_full += read_fields(slime.get());
+                                            }, budget);
+    double view = BenchmarkTimer::benchmark([&]() {
+                                                BinaryView binary_view(mem);
+                                                sum_view += read_fields(binary_view.get());
+                                            }, budget);
+    EXPECT_TRUE(sum_full > 0);
+    EXPECT_TRUE(sum_view > 0);
+    fprintf(stderr, "blob size: %zu bytes\n", mem.size);
+    report("BinaryFormat::decode", full, mem.size);
+    report("BinaryView", view, mem.size);
+}
+
+TEST_F("verify that view and decoded slime agree", Blob()) {
+    Slime slime;
+    BinaryFormat::decode(f1.buf.get(), slime);
+    BinaryView view(f1.buf.get());
+    EXPECT_EQUAL(slime.get(), view.get());
+    EXPECT_EQUAL(read_fields(slime.get()), read_fields(view.get()));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,83 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using namespace vespalib::slime::convenience;
+using namespace vespalib::slime;
+using vespalib::SimpleBuffer;
+using vespalib::BenchmarkTimer;
+using vespalib::make_string;
+
+const double budget = 2.0;
+
+// text snippets of a typical search result, with the occasional character needing escaping
+const char *words[] = { "the", "search", "engine", "returns", "documents", "ranked", "by", "relevance",
+                        "\"quoted\"", "summary", "fields", "with", "highlighted", "terms", "line\nbreak",
+                        "and", "dynamic", "snippets", "C:\\path", "of", "varying", "length" };
+
+vespalib::string make_text(size_t num_words, size_t seed) {
+    vespalib::string text;
+    for (size_t i = 0; i < num_words; ++i) {
+        if (i > 0) {
+            text.push_back(' ');
+        }
+        text.append(words[(seed + i * 7) % (sizeof(words) / sizeof(words[0]))]);
+    }
+    return text;
+}
+
+// a result page with 100 hits, each with a few short and one long string field
+struct Docsums {
+    Slime slime;
+    SimpleBuffer json;
+    Docsums() : slime(), json() {
+        Cursor &hits = slime.setObject().setArray("hits");
+        for (size_t i = 0; i < 100; ++i) {
+            Cursor &hit = hits.addObject();
+            hit.setString("id", make_string("id:ns:doctype::document-%zu", i));
+            hit.setDouble("relevance", 100.125 - i * 0.25);
+            Cursor &fields = hit.setObject("fields");
+            fields.setString("title", make_text(8, i));
+            fields.setString("url", make_string("https://www.example.com/some/path/to/document/%zu.html", i));
+            fields.setLong("timestamp", 1600000000 + i);
+            fields.setString("body", make_text(200, i));
+        }
+        JsonFormat::encode(slime, json, true);
+    }
+};
+
+void report(const char *name, double seconds, size_t bytes) {
+    fprintf(stderr, "%s: %g us per result, %g MB/s\n", name, seconds * 1000.0 * 1000.0, (bytes / seconds) / (1000.0 * 1000.0));
+}
+
+TEST_F("encode and decode docsums as json", Docsums()) {
+    size_t size = f1.json.get().size;
+    size_t sum_encoded = 0;
+    size_t sum_decoded = 0;
+    SimpleBuffer buf; // reused to avoid measuring buffer growth
+    double encode = BenchmarkTimer::benchmark([&]() {
+                                                  JsonFormat::encode(f1.slime, buf, true);
+                                                  sum_encoded += buf.get().size;
+                                                  buf.evict(buf.get().size);
+                                              }, budget);
+    double decode = BenchmarkTimer::benchmark([&]() {
+                                                  Slime slime;
+                                                  sum_decoded += JsonFormat::decode(f1.json.get(), slime);
+                                              }, budget);
+    EXPECT_TRUE(sum_encoded > 0);
+    EXPECT_TRUE(sum_decoded > 0);
+    fprintf(stderr, "json size: %zu bytes\n", size);
+    report("JsonFormat::encode", encode, size);
+    report("JsonFormat::decode", decode, size);
+}
+
+TEST_F("verify that docsums survive a json round trip", Docsums()) {
+    Slime slime;
+    EXPECT_EQUAL(f1.json.get().size, JsonFormat::decode(f1.json.get(), slime));
+    EXPECT_EQUAL(f1.slime, slime);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,140 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_view.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+
+using namespace vespalib::slime::convenience;
+using namespace vespalib::slime;
+using namespace vespalib;
+
+Slime from_json(const vespalib::string &json) {
+    Slime slime;
+    EXPECT_TRUE(JsonFormat::decode(json, slime) > 0);
+    return slime;
+}
+
+SimpleBuffer encode(const Slime &slime) {
+    SimpleBuffer buf;
+    BinaryFormat::encode(slime, buf);
+    return buf;
+}
+
+void verify_same(const vespalib::string &json) {
+    Slime expect = from_json(json);
+    SimpleBuffer buf = encode(expect);
+    BinaryView view(buf.get());
+    EXPECT_TRUE(view.get().valid());
+    EXPECT_EQUAL(expect.get(), view.get());
+    EXPECT_EQUAL(view.used(), buf.get().size);
+    EXPECT_FALSE(view.failed());
+}
+
+TEST("require that view exposes the same values as the decoded slime") {
+    TEST_DO(verify_same("null"));
+    TEST_DO(verify_same("true"));
+    TEST_DO(verify_same("false"));
+    TEST_DO(verify_same("-123456789"));
+    TEST_DO(verify_same("3.5"));
+    TEST_DO(verify_same("\"foo\""));
+    TEST_DO(verify_same("[]"));
+    TEST_DO(verify_same("{}"));
+    TEST_DO(verify_same("[1,[2,[3,[]]],{a:{}}]"));
+    TEST_DO(verify_same("{a:1,b:[true,null,\"x\"],c:{a:2.5,d:{b:[{}]}},e:\"long enough string to need a size byte\"}"));
+}
+
+TEST("require that strings and data are not copied") {
+    Slime slime;
+    Cursor &obj = slime.setObject();
+    obj.setString("str", "string value");
+    obj.setData("data", Memory("data value"));
+    SimpleBuffer buf = encode(slime);
+    BinaryView view(buf.get());
+    Memory str = view.get()["str"].asString();
+    Memory data = view.get()["data"].asData();
+    EXPECT_EQUAL(str.make_string(), "string value");
+    EXPECT_EQUAL(data.make_string(), "data value");
+    EXPECT_TRUE(str.data > buf.get().data && str.data < buf.get().data + buf.get().size);
+    EXPECT_TRUE(data.data > buf.get().data && data.data < buf.get().data + buf.get().size);
+}
+
+TEST("require that fields can be looked up by name and symbol") {
+    Slime slime = from_json("{a:1,b:{c:2},d:[3,4]}");
+    SimpleBuffer buf = encode(slime);
+    BinaryView view(buf.get());
+    const Inspector &root = view.get();
+    EXPECT_EQUAL(root.fields(), 3u);
+    EXPECT_EQUAL(root.children(), 3u);
+    EXPECT_EQUAL(root.entries(), 0u);
+    EXPECT_EQUAL(root["a"].asLong(), 1);
+    EXPECT_EQUAL(root["b"]["c"].asLong(), 2);
+    EXPECT_EQUAL(root["d"][1].asLong(), 4);
+    EXPECT_EQUAL(root["d"].entries(), 2u);
+    EXPECT_FALSE(root["x"].valid());
+    EXPECT_FALSE(root["d"][2].valid());
+    EXPECT_FALSE(root["a"]["c"].valid());
+    EXPECT_EQUAL(view.symbols(), slime.symbols());
+    Symbol sym_c = slime.lookup("c");
+    EXPECT_EQUAL(view.inspect(sym_c).make_string(), "c");
+    EXPECT_EQUAL(root["b"][sym_c].asLong(), 2);
+}
+
+TEST("require that numbers convert like in slime") {
+    Slime slime = from_json("{l:7,d:2.75}");
+    SimpleBuffer buf = encode(slime);
+    BinaryView view(buf.get());
+    EXPECT_EQUAL(view.get()["l"].asDouble(), 7.0);
+    EXPECT_EQUAL(view.get()["d"].asLong(), 2);
+    EXPECT_EQUAL(view.get()["l"].asString().size, 0u);
+    EXPECT_FALSE(view.get()["l"].asBool());
+}
+
+TEST("require that to string gives json") {
+    Slime slime = from_json("{a:[1,\"x\"]}");
+    SimpleBuffer buf = encode(slime);
+    BinaryView view(buf.get());
+    EXPECT_EQUAL(view.get().toString(), slime.get().toString());
+}
+
+TEST("require that fields without symbol names can be looked up by symbol") {
+    Slime slime;
+    Symbol my_sym(42);
+    slime.setObject().setLong(my_sym, 100);
+    SimpleBuffer buf = encode(slime);
+    BinaryView view(buf.get());
+    EXPECT_EQUAL(view.symbols(), 0u);
+    EXPECT_EQUAL(view.get()[my_sym].asLong(), 100);
+    EXPECT_EQUAL(view.inspect(my_sym).size, 0u);
+}
+
+TEST("require that decode failure gives invalid root") {
+    SimpleBuffer buf;
+    buf.add(char(0)); // empty symbol table, but no value
+    BinaryView view(buf.get());
+    EXPECT_FALSE(view.get().valid());
+    EXPECT_TRUE(view.failed());
+    EXPECT_EQUAL(view.used(), 0u);
+}
+
+TEST("require that truncated input fails") {
+    Slime slime = from_json("{a:[1,2,3],b:\"foo\"}");
+    SimpleBuffer buf = encode(slime);
+    for (size_t len = 0; len < buf.get().size; ++len) {
+        BinaryView view(Memory(buf.get().data, len));
+        EXPECT_FALSE(view.get().valid());
+        EXPECT_TRUE(view.failed());
+    }
+}
+
+TEST("require that bogus container sizes fail without allocating") {
+    SimpleBuffer buf;
+    buf.add(char(0)); // empty symbol table
+    buf.add(binary_format::encode_type_and_meta(ARRAY::ID, 0));
+    char *pos = buf.reserve(10).data;
+    buf.commit(binary_format::encode_cmpr_ulong(pos, uint64_t(1) << 60));
+    BinaryView view(buf.get());
+    EXPECT_FALSE(view.get().valid());
+    EXPECT_TRUE(view.failed());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -420,4 +420,85 @@ TEST("require that multiple adjacent values can be decoded from a single input")
     EXPECT_EQUAL(input.obtain().size, 0u);
 }
 
+std::string escape_json(const std::string &str) {
+    std::string out("\"");
+    for (char c: str) {
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\b': out.append("\\b"); break;
+        case '\f': out.append("\\f"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char tmp[8];
+                snprintf(tmp, sizeof(tmp), "\\u%04X", (unsigned char)c);
+                out.append(tmp);
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+// hands out the underlying memory a few bytes at a time
+struct ChunkedInput : Input {
+    Memory data;
+    size_t chunk;
+    size_t pos;
+    ChunkedInput(Memory data_in, size_t chunk_in) : data(data_in), chunk(chunk_in), pos(0) {}
+    Memory obtain() override { return Memory(data.data + pos, std::min(chunk, data.size - pos)); }
+    Input &evict(size_t bytes) override { pos += bytes; return *this; }
+};
+
+TEST("require that strings with special characters at any position are encoded and decoded") {
+    const char specials[] = { '"', '\\', '\'', '\n', '\x01', '\x1f', 'x' };
+    for (size_t len = 1; len <= 130; ++len) {
+        for (char special: specials) {
+            for (size_t pos = 0; pos < len; ++pos) {
+                std::string str(len, 'a');
+                str[pos] = special;
+                Slime slime;
+                slime.setString(str);
+                std::string json = make_json(slime, true);
+                ASSERT_EQUAL(escape_json(str), json);
+                Slime decoded;
+                ASSERT_EQUAL(json.size(), vespalib::slime::JsonFormat::decode(json, decoded));
+                ASSERT_EQUAL(str, decoded.get().asString().make_string());
+            }
+        }
+    }
+}
+
+TEST("require that plain string runs may span input chunks") {
+    std::string str;
+    for (size_t i = 0; i < 500; ++i) {
+        str.push_back('a' + (i % 26));
+        if ((i % 37) == 0) {
+            str.append((i % 2) ? "\"" : "'");
+        }
+    }
+    std::string dq_json = escape_json(str);
+    std::string sq_json("'");
+    for (char c: dq_json.substr(1, dq_json.size() - 2)) {
+        if (c == '\'') {
+            sq_json.push_back('\\');
+        }
+        sq_json.push_back(c);
+    }
+    sq_json.push_back('\'');
+    for (size_t chunk: {1, 3, 16, 64, 1000}) {
+        for (const std::string &json: {dq_json, sq_json}) {
+            ChunkedInput input(Memory(json), chunk);
+            Slime slime;
+            EXPECT_EQUAL(json.size(), vespalib::slime::JsonFormat::decode(input, slime));
+            EXPECT_EQUAL(str, slime.get().asString().make_string());
+        }
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
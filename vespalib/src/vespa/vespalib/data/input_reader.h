@@ -86,6 +86,30 @@ public:
         return 0;
     }
 
+    /**
+     * Look at the bytes currently available. More input is requested
+     * from the underlying Input only if everything obtained so far
+     * has been consumed (see obtain). The bytes are not consumed; use
+     * skip to consume (a prefix of) them.
+     *
+     * @return Memory referencing the available bytes, empty if and
+     *         only if there is no more input data available
+     **/
+    Memory peek() {
+        size_t bytes = obtain();
+        return Memory(data(), bytes);
+    }
+
+    /**
+     * Consume bytes previously returned by peek.
+     *
+     * @param bytes the number of bytes to consume, at most the size
+     *              of the last peek
+     **/
+    void skip(size_t bytes) {
+        _pos += bytes;
+    }
+
     /**
      * Try to unread a single byte. This will work for data that is
      * read, but not yet evicted. Note that after eof is found (the
@@ -0,0 +1,317 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "binary_view.h"
+#include "binary_format.h"
+#include "json_format.h"
+#include "nix_value.h"
+#include "array_traverser.h"
+#include "object_traverser.h"
+#include <vespa/vespalib/data/memory_input.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.data.slime.binary_view");
+
+namespace vespalib::slime {
+
+using namespace binary_format;
+
+namespace {
+
+Type
+type_from_id(uint32_t id)
+{
+    switch (id) {
+    case NIX::ID:    return NIX::instance;
+    case BOOL::ID:   return BOOL::instance;
+    case LONG::ID:   return LONG::instance;
+    case DOUBLE::ID: return DOUBLE::instance;
+    case STRING::ID: return STRING::instance;
+    case DATA::ID:   return DATA::instance;
+    case ARRAY::ID:  return ARRAY::instance;
+    case OBJECT::ID: return OBJECT::instance;
+    }
+    LOG_ABORT("should not be reached");
+}
+
+} // namespace vespalib::slime::<unnamed>
+
+struct BinaryView::Indexer {
+    BinaryView  &view;
+    InputReader &in;
+
+    Indexer(BinaryView &view_in, InputReader &in_in) : view(view_in), in(in_in) {}
+
+    void set(size_t slot, uint32_t type, uint32_t symbol, uint64_t value, size_t size) {
+        view._nodes[slot] = Node(&view, type, symbol, value, size);
+    }
+
+    // number of children that can possibly be encoded in the rest of the buffer
+    bool check_children(uint64_t size) {
+        if (size > in.obtain()) {
+            in.fail("container size exceeds remaining input");
+            return false;
+        }
+        return true;
+    }
+
+    void decodeSymbolTable() {
+        uint64_t numSymbols = read_cmpr_ulong(in);
+        if (!check_children(numSymbols)) {
+            return;
+        }
+        view._symbols.reserve(numSymbols);
+        for (size_t i = 0; i < numSymbols && !in.failed(); ++i) {
+            uint64_t size = read_cmpr_ulong(in);
+            view._symbols.push_back(in.read(size));
+        }
+    }
+
+    void decodeBytes(size_t slot, uint32_t type, uint32_t symbol, uint32_t meta) {
+        uint64_t size = read_size(in, meta);
+        Memory bytes = in.read(size);
+        set(slot, type, symbol, bytes.data - view._buffer.data, size);
+    }
+
+    void decodeArray(size_t slot, uint32_t symbol, uint32_t meta) {
+        uint64_t size = read_size(in, meta);
+        if (!check_children(size)) {
+            return;
+        }
+        size_t first = view._nodes.size();
+        view._nodes.resize(first + size);
+        set(slot, ARRAY::ID, symbol, first, size);
+        for (size_t i = 0; i < size && !in.failed(); ++i) {
+            decodeValue(first + i, Symbol().getValue());
+        }
+    }
+
+    void decodeObject(size_t slot, uint32_t symbol, uint32_t meta) {
+        uint64_t size = read_size(in, meta);
+        if (!check_children(size)) {
+            return;
+        }
+        size_t first = view._nodes.size();
+        view._nodes.resize(first + size);
+        set(slot, OBJECT::ID, symbol, first, size);
+        for (size_t i = 0; i < size && !in.failed(); ++i) {
+            decodeValue(first + i, read_cmpr_ulong(in));
+        }
+    }
+
+    void decodeValue(size_t slot, uint32_t symbol) {
+        char byte = in.read();
+        uint32_t type = decode_type(byte);
+        uint32_t meta = decode_meta(byte);
+        switch (type) {
+        case NIX::ID:    return set(slot, type, symbol, 0, 0);
+        case BOOL::ID:   return set(slot, type, symbol, (meta != 0) ? 1 : 0, 0);
+        case LONG::ID:   return set(slot, type, symbol, read_bytes<false>(in, meta), 0);
+        case DOUBLE::ID: return set(slot, type, symbol, read_bytes<true>(in, meta), 0);
+        case STRING::ID: return decodeBytes(slot, type, symbol, meta);
+        case DATA::ID:   return decodeBytes(slot, type, symbol, meta);
+        case ARRAY::ID:  return decodeArray(slot, symbol, meta);
+        case OBJECT::ID: return decodeObject(slot, symbol, meta);
+        }
+        LOG_ABORT("should not be reached");
+    }
+};
+
+Type
+BinaryView::Node::type() const
+{
+    return type_from_id(_type);
+}
+
+size_t
+BinaryView::Node::children() const
+{
+    return ((_type == ARRAY::ID) || (_type == OBJECT::ID)) ? _size : 0;
+}
+
+size_t
+BinaryView::Node::entries() const
+{
+    return (_type == ARRAY::ID) ? _size : 0;
+}
+
+size_t
+BinaryView::Node::fields() const
+{
+    return (_type == OBJECT::ID) ? _size : 0;
+}
+
+bool
+BinaryView::Node::asBool() const
+{
+    return (_type == BOOL::ID) && (_value != 0);
+}
+
+int64_t
+BinaryView::Node::asLong() const
+{
+    switch (_type) {
+    case LONG::ID:   return decode_zigzag(_value);
+    case DOUBLE::ID: return decode_double(_value);
+    }
+    return 0;
+}
+
+double
+BinaryView::Node::asDouble() const
+{
+    switch (_type) {
+    case LONG::ID:   return decode_zigzag(_value);
+    case DOUBLE::ID: return decode_double(_value);
+    }
+    return 0.0;
+}
+
+Memory
+BinaryView::Node::asString() const
+{
+    return (_type == STRING::ID) ? Memory(_view->_buffer.data + _value, _size) : Memory();
+}
+
+Memory
+BinaryView::Node::asData() const
+{
+    return (_type == DATA::ID) ? Memory(_view->_buffer.data + _value, _size) : Memory();
+}
+
+void
+BinaryView::Node::traverse(ArrayTraverser &at) const
+{
+    if (_type == ARRAY::ID) {
+        for (size_t i = 0; i < _size; ++i) {
+            at.entry(i, child(i));
+        }
+    }
+}
+
+void
+BinaryView::Node::traverse(ObjectSymbolTraverser &ot) const
+{
+    if (_type == OBJECT::ID) {
+        for (size_t i = 0; i < _size; ++i) {
+            const Node &field = child(i);
+            ot.field(Symbol(field._symbol), field);
+        }
+    }
+}
+
+void
+BinaryView::Node::traverse(ObjectTraverser &ot) const
+{
+    if (_type == OBJECT::ID) {
+        for (size_t i = 0; i < _size; ++i) {
+            const Node &field = child(i);
+            ot.field(_view->inspect(Symbol(field._symbol)), field);
+        }
+    }
+}
+
+vespalib::string
+BinaryView::Node::toString() const
+{
+    SimpleBuffer buf;
+    JsonFormat::encode(*this, buf, false);
+    return buf.get().make_string();
+}
+
+Inspector &
+BinaryView::Node::operator[](size_t idx) const
+{
+    if ((_type == ARRAY::ID) && (idx < _size)) {
+        return const_cast<Node &>(child(idx));
+    }
+    return *NixValue::invalid();
+}
+
+Inspector &
+BinaryView::Node::operator[](Symbol sym) const
+{
+    if (_type == OBJECT::ID) {
+        for (size_t i = 0; i < _size; ++i) {
+            const Node &field = child(i);
+            if (field._symbol == sym.getValue()) {
+                return const_cast<Node &>(field);
+            }
+        }
+    }
+    return *NixValue::invalid();
+}
+
+Inspector &
+BinaryView::Node::operator[](Memory name) const
+{
+    if (_type == OBJECT::ID) {
+        for (size_t i = 0; i < _size; ++i) {
+            const Node &field = child(i);
+            if (_view->inspect(Symbol(field._symbol)) == name) {
+                return const_cast<Node &>(field);
+            }
+        }
+    }
+    return *NixValue::invalid();
+}
+
+BinaryView::BinaryView(Memory buffer)
+    : _buffer(buffer),
+      _indexed(false),
+      _used(0),
+      _error(),
+      _symbols(),
+      _nodes()
+{
+}
+
+BinaryView::~BinaryView() = default;
+
+void
+BinaryView::build_index()
+{
+    MemoryInput memory_input(_buffer);
+    InputReader input(memory_input);
+    Indexer indexer(*this, input);
+    indexer.decodeSymbolTable();
+    if (!input.failed()) {
+        _nodes.resize(1);
+        indexer.decodeValue(0, Symbol().getValue());
+    }
+    if (input.failed()) {
+        _error = input.get_error_message();
+        _symbols.clear();
+        _nodes.clear();
+    } else {
+        _used = input.get_offset();
+    }
+    _indexed = true;
+}
+
+const Inspector &
+BinaryView::get()
+{
+    if (!_indexed) {
+        build_index();
+    }
+    if (_nodes.empty()) {
+        return *NixValue::invalid();
+    }
+    return _nodes[0];
+}
+
+size_t
+BinaryView::used()
+{
+    get();
+    return _used;
+}
+
+Memory
+BinaryView::inspect(Symbol symbol) const
+{
+    return (symbol.getValue() < _symbols.size()) ? _symbols[symbol.getValue()] : Memory();
+}
+
+} // namespace vespalib::slime
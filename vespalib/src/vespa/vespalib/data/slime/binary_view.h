@@ -0,0 +1,106 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "inspector.h"
+#include <vespa/vespalib/stllike/string.h>
+#include <vector>
+
+namespace vespalib::slime {
+
+/**
+ * Read-only view of a Slime object encoded with BinaryFormat. Instead
+ * of building a Slime tree, the first call to get() builds a compact
+ * index of all values in the buffer (one fixed size entry per value,
+ * with the children of each array/object stored next to each other)
+ * and exposes it through the Inspector interface. Strings, data and
+ * symbol names are not copied; the Memory objects returned refer
+ * directly into the encoded buffer, which must outlive the view.
+ *
+ * Use this when only a few fields of a large blob are needed. Any
+ * field lookup by name is a linear scan over the fields of the
+ * object in question. Building the index is not thread-safe, but the
+ * Inspectors obtained after that may be shared freely.
+ **/
+class BinaryView
+{
+private:
+    class Node final : public Inspector {
+    private:
+        const BinaryView *_view;
+        uint32_t          _type;
+        uint32_t          _symbol;
+        uint64_t          _value; // raw bits, buffer offset or index of first child
+        size_t            _size;  // number of bytes or children
+        const Node &child(size_t idx) const { return _view->_nodes[_value + idx]; }
+    public:
+        Node() noexcept : _view(nullptr), _type(0), _symbol(0), _value(0), _size(0) {}
+        Node(const BinaryView *view, uint32_t type, uint32_t symbol, uint64_t value, size_t size) noexcept
+            : _view(view), _type(type), _symbol(symbol), _value(value), _size(size) {}
+
+        bool valid() const override { return true; }
+        Type type() const override;
+        size_t children() const override;
+        size_t entries() const override;
+        size_t fields() const override;
+
+        bool asBool() const override;
+        int64_t asLong() const override;
+        double asDouble() const override;
+        Memory asString() const override;
+        Memory asData() const override;
+
+        void traverse(ArrayTraverser &at) const override;
+        void traverse(ObjectSymbolTraverser &ot) const override;
+        void traverse(ObjectTraverser &ot) const override;
+
+        vespalib::string toString() const override;
+
+        Inspector &operator[](size_t idx) const override;
+        Inspector &operator[](Symbol sym) const override;
+        Inspector &operator[](Memory name) const override;
+    };
+
+    struct Indexer;
+
+    Memory              _buffer;
+    bool                _indexed;
+    size_t              _used;
+    vespalib::string    _error;
+    std::vector<Memory> _symbols;
+    std::vector<Node>   _nodes;
+
+    void build_index();
+
+public:
+    explicit BinaryView(Memory buffer);
+    BinaryView(const BinaryView &) = delete;
+    BinaryView &operator=(const BinaryView &) = delete;
+    ~BinaryView();
+
+    /**
+     * Obtain the root value, building the index on first call. An
+     * invalid Inspector is returned if the buffer could not be
+     * decoded.
+     **/
+    const Inspector &get();
+
+    /**
+     * Number of bytes making up the encoded Slime object, or 0 if
+     * decoding failed. Builds the index if not already done.
+     **/
+    size_t used();
+
+    bool failed() const { return !_error.empty(); }
+    const vespalib::string &get_error_message() const { return _error; }
+
+    size_t symbols() const { return _symbols.size(); }
+
+    /**
+     * Name of the given symbol, or an empty Memory for symbols not
+     * present in the symbol table of the buffer.
+     **/
+    Memory inspect(Symbol symbol) const;
+};
+
+} // namespace vespalib::slime
@@ -5,6 +5,7 @@
 #include "inserter.h"
 #include "slime.h"
 #include <vespa/vespalib/data/memory_input.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <vespa/vespalib/locale/c.h>
 #include <cmath>
 #include <sstream>
@@ -45,11 +46,12 @@ struct JsonEncoder : public ArrayTraverser,
                      public ObjectTraverser
 {
     OutputWriter &out;
+    const hwaccelrated::IAccelrated &accel;
     int level;
     bool head;
 
     JsonEncoder(OutputWriter &out_in)
-        : out(out_in), level(0), head(true) {}
+        : out(out_in), accel(hwaccelrated::IAccelrated::getAccelerator()), level(0), head(true) {}
 
     void openScope(char c) {
         out.write(c);
@@ -101,8 +103,16 @@ struct JsonEncoder : public ArrayTraverser,
         *p++ = '"';
         const char *pos = memory.data;
         const char *end = memory.data + memory.size;
-        for (; pos < end; ++pos) {
-            uint8_t c = *pos;
+        while (pos < end) {
+            size_t plain = accel.jsonEncodeSkip(pos, end - pos);
+            memcpy(p, pos, plain);
+            p += plain;
+            pos += plain;
+            len += plain;
+            if (pos == end) {
+                break;
+            }
+            uint8_t c = *pos++;
             switch(c) {
             case '"':  *p++ = '\\'; *p++ = '"';  len += 2; break;
             case '\\': *p++ = '\\'; *p++ = '\\'; len += 2; break;
@@ -111,14 +121,10 @@ struct JsonEncoder : public ArrayTraverser,
             case '\n': *p++ = '\\'; *p++ = 'n';  len += 2; break;
             case '\r': *p++ = '\\'; *p++ = 'r';  len += 2; break;
             case '\t': *p++ = '\\'; *p++ = 't';  len += 2; break;
-            default:
-                if (c > 0x1f) {
-                    *p++ = c; ++len;
-                } else { // requires escaping according to RFC 4627
-                    *p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
-                    *p++ = hex[(c >> 4) & 0xf]; *p++ = hex[c & 0xf];
-                    len += 6;
-                }
+            default: // requires escaping according to RFC 4627
+                *p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
+                *p++ = hex[(c >> 4) & 0xf]; *p++ = hex[c & 0xf];
+                len += 6;
             }
         }
         *p = '"';
@@ -200,16 +206,28 @@ JsonEncoder<COMPACT>::field(const Memory &symbol_name, const Inspector &inspecto
 
 struct JsonDecoder {
     InputReader &in;
+    const hwaccelrated::IAccelrated &accel;
     char c;
     vespalib::string key;
     vespalib::string value;
 
-    JsonDecoder(InputReader &reader) : in(reader), c(in.read()), key(), value() {}
+    JsonDecoder(InputReader &reader)
+        : in(reader), accel(hwaccelrated::IAccelrated::getAccelerator()), c(in.read()), key(), value() {}
 
     void next() {
         c = in.try_read();
     }
 
+    // append c and the following plain string characters available in the input buffer
+    void readPlain(vespalib::string &str) {
+        str.push_back(c);
+        Memory avail = in.peek();
+        size_t plain = accel.jsonDecodeSkip(avail.data, avail.size);
+        str.append(avail.data, plain);
+        in.skip(plain);
+        next();
+    }
+
     bool skip(char x) {
         if (c != x) {
             return false;
@@ -347,16 +365,14 @@ JsonDecoder::readString(vespalib::string &str)
                 next();
                 return;
             } else {
-                str.push_back(c);
-                next();
+                readPlain(str);
             }
             break;
         case '\0':
             in.fail("unterminated string");
             return;
         default:
-            str.push_back(c);
-            next();
+            readPlain(str);
             break;
         }
     }
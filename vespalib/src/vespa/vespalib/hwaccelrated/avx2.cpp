@@ -30,4 +30,14 @@ Avx2Accelrator::or64(size_t offset, const std::vector<std::pair<const void *, bo
     helper::orChunks<32u, 2u>(offset, src, dest);
 }
 
+size_t
+Avx2Accelrator::jsonEncodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<32u>(str, sz, helper::JsonEncodeSpecial());
+}
+
+size_t
+Avx2Accelrator::jsonDecodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<32u>(str, sz, helper::JsonDecodeSpecial());
+}
+
 }
@@ -17,6 +17,8 @@ public:
     double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const override;
     void and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const override;
     void or64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const override;
+    size_t jsonEncodeSkip(const char * str, size_t sz) const override;
+    size_t jsonDecodeSkip(const char * str, size_t sz) const override;
 };
 
 }
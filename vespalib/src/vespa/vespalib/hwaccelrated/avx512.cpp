@@ -42,4 +42,14 @@ Avx512Accelrator::or64(size_t offset, const std::vector<std::pair<const void *,
     helper::orChunks<64, 1>(offset, src, dest);
 }
 
+size_t
+Avx512Accelrator::jsonEncodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<64u>(str, sz, helper::JsonEncodeSpecial());
+}
+
+size_t
+Avx512Accelrator::jsonDecodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<64u>(str, sz, helper::JsonDecodeSpecial());
+}
+
 }
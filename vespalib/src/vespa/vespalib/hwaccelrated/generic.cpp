@@ -175,4 +175,14 @@ GenericAccelrator::or64(size_t offset, const std::vector<std::pair<const void *,
     helper::orChunks<16,4>(offset, src, dest);
 }
 
+size_t
+GenericAccelrator::jsonEncodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<16u>(str, sz, helper::JsonEncodeSpecial());
+}
+
+size_t
+GenericAccelrator::jsonDecodeSkip(const char * str, size_t sz) const {
+    return helper::skipPlainBytes<16u>(str, sz, helper::JsonDecodeSpecial());
+}
+
 }
@@ -8,6 +8,7 @@
 #endif
 #include <vespa/vespalib/util/memory.h>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
 #include <vespa/log/log.h>
@@ -220,6 +221,40 @@ verifyAnd64(const IAccelrated & accel) {
     }
 }
 
+void
+verifyJsonSkip(const IAccelrated & accel, const char * buf, size_t sz, size_t pos, uint8_t c)
+{
+    bool encodeHit = (pos < sz) && ((c < 0x20) || (c == '"') || (c == '\\'));
+    bool decodeHit = (pos < sz) && ((c == 0) || (c == '"') || (c == '\'') || (c == '\\'));
+    if ((accel.jsonEncodeSkip(buf, sz) != (encodeHit ? pos : sz)) ||
+        (accel.jsonDecodeSkip(buf, sz) != (decodeHit ? pos : sz)))
+    {
+        fprintf(stderr, "Accelrator is not computing json skip correctly. sz=%zu, pos=%zu, c=0x%02x\n", sz, pos, c);
+        LOG_ABORT("should not be reached");
+    }
+}
+
+void
+verifyJsonSkip(const IAccelrated & accel)
+{
+    const char specials[] = { '\0', '\n', '\x1f', '"', '\'', '\\', ' ', '\xff' };
+    char buf[130];
+    memset(buf, 'a', sizeof(buf));
+    for (size_t sz(0); sz < sizeof(buf); sz++) {
+        // varying sz moves both ends across all vector block boundaries
+        for (size_t pos : {size_t(0), size_t(1), sz / 2, sz - 1, sz}) {
+            if (pos >= sizeof(buf)) {
+                continue;
+            }
+            for (char special : specials) {
+                buf[pos] = special;
+                verifyJsonSkip(accel, buf, sz, pos, special);
+            }
+            buf[pos] = 'a';
+        }
+    }
+}
+
 class RuntimeVerificator
 {
 public:
@@ -235,6 +270,7 @@ private:
         verifyPopulationCount(accelrated);
         verifyAnd64(accelrated);
         verifyOr64(accelrated);
+        verifyJsonSkip(accelrated);
     }
 };
 
@@ -34,6 +34,10 @@ public:
     virtual void and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const = 0;
     // OR 64 bytes from multiple, optionally inverted sources
     virtual void or64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const = 0;
+    // Number of leading bytes that may be put in a JSON string as is (no control characters, '"' or '\\')
+    virtual size_t jsonEncodeSkip(const char * str, size_t sz) const = 0;
+    // Number of leading bytes that contain no quotes ('"' or '\''), '\\' or zero bytes
+    virtual size_t jsonDecodeSkip(const char * str, size_t sz) const = 0;
 
     static const IAccelrated & getAccelerator() __attribute__((noinline));
 };
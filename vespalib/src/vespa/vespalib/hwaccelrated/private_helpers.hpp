@@ -74,5 +74,52 @@ orChunks(size_t offset, const std::vector<std::pair<const void *, bool>> & src,
     }
 }
 
+// Matches the bytes that must be escaped in a JSON string
+struct JsonEncodeSpecial {
+    template <typename V>
+    auto operator()(V c) const { return (c < 0x20) | (c == '"') | (c == '\\'); }
+};
+
+// Matches the bytes ending a run of plain characters in a quoted JSON string
+struct JsonDecodeSpecial {
+    template <typename V>
+    auto operator()(V c) const { return (c == '"') | (c == '\'') | (c == '\\') | (c == 0); }
+};
+
+/**
+ * Count the leading bytes for which the predicate is false. Blocks of
+ * VectorSize bytes are checked using vector comparisons, within the
+ * block holding the first match only the 8 bytes around it are
+ * checked byte by byte.
+ **/
+template<unsigned VectorSize, typename IsSpecial>
+size_t
+skipPlainBytes(const char * str, size_t sz, IsSpecial isSpecial) {
+    typedef uint8_t Bytes __attribute__ ((vector_size (VectorSize)));
+    typedef uint64_t Words __attribute__ ((vector_size (VectorSize)));
+    size_t i(0);
+    for (; (i + VectorSize) <= sz; i += VectorSize) {
+        Bytes bytes;
+        memcpy(&bytes, str + i, VectorSize);
+        Words hits = reinterpret_cast<Words>(isSpecial(bytes));
+        uint64_t any(0);
+        for (size_t n=0; n < VectorSize/sizeof(uint64_t); n++) {
+            any |= hits[n];
+        }
+        if (any != 0) {
+            for (size_t n=0; hits[n] == 0; n++) {
+                i += sizeof(uint64_t);
+            }
+            break;
+        }
+    }
+    for (; i < sz; i++) {
+        if (isSpecial(uint8_t(str[i]))) {
+            return i;
+        }
+    }
+    return sz;
+}
+
 }
 }
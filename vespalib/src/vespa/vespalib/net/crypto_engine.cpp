@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "crypto_engine.h"
+#include "shm_crypto_engine.h"
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <vespa/vespalib/crypto/crypto_exception.h>
 #include <vespa/vespalib/net/tls/authorization_mode.h>
@@ -51,6 +52,7 @@ public:
     ssize_t read(char *buf, size_t len) override { return _socket.read(buf, len); }
     ssize_t drain(char *, size_t) override { return 0; }
     ssize_t write(const char *buf, size_t len) override { return _socket.write(buf, len); }
+    ssize_t writev(const struct iovec *iov, int iovcnt) override { return _socket.writev(iov, iovcnt); }
     ssize_t flush() override { return 0; }
     ssize_t half_close() override { return _socket.half_close(); }
     void drop_empty_buffers() override {}
@@ -235,9 +237,21 @@ CryptoEngine::SP create_default_crypto_engine() {
     return tls;
 }
 
+CryptoEngine::SP maybe_use_shared_memory(CryptoEngine::SP engine) {
+    const char *env = getenv("VESPA_SHM_LOCAL_TRANSPORT");
+    vespalib::string shm = env ? env : "";
+    if (shm == "true") {
+        LOG(debug, "Using shared memory transport for connections to local peers");
+        return std::make_shared<ShmCryptoEngine>(std::move(engine));
+    } else if (!shm.empty() && (shm != "false")) {
+        LOG(warning, "bad shared memory transport setting specified: '%s' (ignoring)", shm.c_str());
+    }
+    return engine;
+}
+
 CryptoEngine::SP try_create_default_crypto_engine() {
     try {
-        return create_default_crypto_engine();
+        return maybe_use_shared_memory(create_default_crypto_engine());
     } catch (crypto::CryptoException &e) {
         LOG(error, "failed to create default crypto engine: %s", e.what());
         std::_Exit(78);
@@ -246,6 +260,9 @@ CryptoEngine::SP try_create_default_crypto_engine() {
 
 } // namespace vespalib::<unnamed>
 
+void CryptoEngine::server_listening(int) {}
+void CryptoEngine::server_closed(int) {}
+
 CryptoEngine::~CryptoEngine() = default;
 
 CryptoEngine::SP
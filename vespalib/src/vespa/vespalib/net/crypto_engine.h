@@ -23,6 +23,9 @@ struct CryptoEngine {
     virtual bool always_use_tls_when_server() const = 0;
     virtual CryptoSocket::UP create_client_crypto_socket(SocketHandle socket, const SocketSpec &spec) = 0;
     virtual CryptoSocket::UP create_server_crypto_socket(SocketHandle socket) = 0;
+    // called by servers using this engine when they start and stop listening on a port
+    virtual void server_listening(int port);
+    virtual void server_closed(int port);
     virtual ~CryptoEngine();
     static CryptoEngine::SP get_default();
 };
@@ -1,9 +1,36 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "crypto_socket.h"
+#include <sys/uio.h>
 
 namespace vespalib {
 
 CryptoSocket::~CryptoSocket() = default;
 
+ssize_t
+CryptoSocket::writev(const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t res = write(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+        if (res < 0) {
+            return (total > 0) ? total : res;
+        }
+        total += res;
+        if (size_t(res) < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+bool
+CryptoSocket::is_kernel_tls_tx_enabled() const
+{
+    return false;
+}
+
 } // namespace vespalib
@@ -5,6 +5,8 @@
 #include <memory>
 #include <cstdlib>
 
+struct iovec;
+
 namespace vespalib {
 
 /**
@@ -85,6 +87,16 @@ struct CryptoSocket {
      **/
     virtual ssize_t write(const char *buf, size_t len) = 0;
 
+    /**
+     * Gather version of write, writing the given buffers in order as
+     * if they were a single buffer. The semantics are the same as
+     * with a normal socket writev; fewer bytes than the sum of the
+     * buffer sizes may be written. The default implementation calls
+     * write for one buffer at a time until one of them is not
+     * written completely.
+     **/
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
     /**
      * Try to flush data in the write pipeline that is not dependent
      * on data not yet written by the application into the underlying
@@ -143,6 +155,14 @@ struct CryptoSocket {
      **/
     virtual void drop_empty_buffers() = 0;
 
+    /**
+     * Returns true if outgoing data is encrypted by the kernel
+     * (kernel TLS offload) rather than by this socket. Only
+     * meaningful after the handshake has completed. The default
+     * implementation returns false.
+     **/
+    virtual bool is_kernel_tls_tx_enabled() const;
+
     virtual ~CryptoSocket();
 };
 
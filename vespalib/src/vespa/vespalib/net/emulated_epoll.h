@@ -35,6 +35,7 @@ private:
     std::map<int, epoll_event> _monitored;
 public:
     Epoll();
+    explicit Epoll(bool use_io_uring) : Epoll() { (void) use_io_uring; } // io_uring is linux only
     ~Epoll();
     void add(int fd, void *ctx, bool read, bool write);
     void update(int fd, void *ctx, bool read, bool write);
@@ -0,0 +1,313 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "io_uring_poll.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.net.io_uring_poll");
+
+namespace vespalib {
+
+namespace {
+
+constexpr uint32_t ring_size = 1024;
+
+uint32_t maybe(uint32_t value, bool yes) { return yes ? value : 0; }
+
+uint64_t make_user_data(int fd, uint32_t tag) { return (uint64_t(uint32_t(fd)) << 32) | tag; }
+
+template <typename T> T load_acquire(const T *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+template <typename T> void store_release(T *p, T v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+int sys_io_uring_setup(uint32_t entries, io_uring_params *params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int sys_io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, const void *arg, size_t arg_size) {
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+void *map_ring(int fd, size_t size, off_t offset) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return (ptr == MAP_FAILED) ? nullptr : ptr;
+}
+
+} // namespace vespalib::<unnamed>
+
+/**
+ * The memory shared with the kernel for a single io_uring instance.
+ **/
+struct IoUringPoll::Ring {
+    int           fd;
+    void         *sq_ptr;
+    size_t        sq_size;
+    void         *cq_ptr;
+    size_t        cq_size;
+    io_uring_sqe *sqes;
+    size_t        sqes_size;
+    uint32_t     *sq_head;
+    uint32_t     *sq_tail;
+    uint32_t      sq_mask;
+    uint32_t      sq_entries;
+    uint32_t     *sq_array;
+    uint32_t     *cq_head;
+    uint32_t     *cq_tail;
+    uint32_t      cq_mask;
+    io_uring_cqe *cqes;
+
+    Ring() : fd(-1), sq_ptr(nullptr), sq_size(0), cq_ptr(nullptr), cq_size(0), sqes(nullptr), sqes_size(0),
+             sq_head(nullptr), sq_tail(nullptr), sq_mask(0), sq_entries(0), sq_array(nullptr),
+             cq_head(nullptr), cq_tail(nullptr), cq_mask(0), cqes(nullptr) {}
+    ~Ring() {
+        if (sqes != nullptr) {
+            munmap(sqes, sqes_size);
+        }
+        if ((cq_ptr != nullptr) && (cq_ptr != sq_ptr)) {
+            munmap(cq_ptr, cq_size);
+        }
+        if (sq_ptr != nullptr) {
+            munmap(sq_ptr, sq_size);
+        }
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+    bool init(uint32_t entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = sys_io_uring_setup(entries, &params);
+        if (fd == -1) {
+            LOG(debug, "io_uring_setup failed: %s", strerror(errno));
+            return false;
+        }
+        // NODROP: poll completions must never be lost on a full completion ring
+        // EXT_ARG: we need to wait for completions with a timeout without a timeout request
+        if (((params.features & IORING_FEAT_NODROP) == 0) || ((params.features & IORING_FEAT_EXT_ARG) == 0)) {
+            LOG(debug, "io_uring lacks required features (features = 0x%x)", params.features);
+            return false;
+        }
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        sq_ptr = map_ring(fd, sq_size, IORING_OFF_SQ_RING);
+        if (sq_ptr == nullptr) {
+            return false;
+        }
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+            cq_ptr = sq_ptr;
+        } else if ((cq_ptr = map_ring(fd, cq_size, IORING_OFF_CQ_RING)) == nullptr) {
+            return false;
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe *>(map_ring(fd, sqes_size, IORING_OFF_SQES));
+        if (sqes == nullptr) {
+            return false;
+        }
+        char *sq = static_cast<char *>(sq_ptr);
+        char *cq = static_cast<char *>(cq_ptr);
+        sq_head = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        sq_array = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+    uint32_t unsubmitted() const { return *sq_tail - load_acquire(sq_head); }
+    void submit() {
+        uint32_t cnt = unsubmitted();
+        if (cnt > 0) {
+            sys_io_uring_enter(fd, cnt, 0, 0, nullptr, 0);
+        }
+    }
+    // only the thread holding the lock of the owning IoUringPoll may produce submissions
+    io_uring_sqe &next_sqe() {
+        while (unsubmitted() >= sq_entries) {
+            submit();
+        }
+        uint32_t idx = *sq_tail & sq_mask;
+        sq_array[idx] = idx;
+        memset(&sqes[idx], 0, sizeof(io_uring_sqe));
+        return sqes[idx];
+    }
+    void commit_sqe() { store_release(sq_tail, *sq_tail + 1); }
+};
+
+IoUringPoll::IoUringPoll(std::unique_ptr<Ring> ring)
+    : _ring(std::move(ring)),
+      _lock(),
+      _sources(),
+      _fired(),
+      _next_tag(0),
+      _waiting(false)
+{
+}
+
+std::unique_ptr<IoUringPoll>
+IoUringPoll::create()
+{
+    auto ring = std::make_unique<Ring>();
+    if (!ring->init(ring_size)) {
+        return {};
+    }
+    return std::unique_ptr<IoUringPoll>(new IoUringPoll(std::move(ring)));
+}
+
+IoUringPoll::~IoUringPoll() = default;
+
+IoUringPoll::Source &
+IoUringPoll::source(int fd)
+{
+    if (size_t(fd) >= _sources.size()) {
+        _sources.resize(std::max(size_t(fd) + 1, _sources.size() * 2));
+    }
+    return _sources[fd];
+}
+
+void
+IoUringPoll::arm(int fd, Source &src)
+{
+    if (++_next_tag == 0) {
+        ++_next_tag;
+    }
+    src.tag = _next_tag;
+    src.armed = true;
+    io_uring_sqe &sqe = _ring->next_sqe();
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = src.events;
+    sqe.user_data = make_user_data(fd, src.tag);
+    _ring->commit_sqe();
+}
+
+void
+IoUringPoll::disarm(int fd, Source &src)
+{
+    if (src.armed) {
+        // the cancelled request (or an event that beat the cancellation) completes with a stale tag
+        io_uring_sqe &sqe = _ring->next_sqe();
+        sqe.opcode = IORING_OP_POLL_REMOVE;
+        sqe.fd = -1;
+        sqe.addr = make_user_data(fd, src.tag);
+        sqe.user_data = 0;
+        _ring->commit_sqe();
+        src.armed = false;
+    }
+    src.tag = 0;
+}
+
+void
+IoUringPoll::submit_if_waiting()
+{
+    if (_waiting) {
+        _ring->submit();
+    }
+}
+
+void
+IoUringPoll::add(int fd, void *ctx, bool read, bool write)
+{
+    std::lock_guard guard(_lock);
+    Source &src = source(fd);
+    src = Source();
+    src.ctx = ctx;
+    src.events = maybe(POLLIN, read) | maybe(POLLOUT, write);
+    if (src.events != 0) {
+        arm(fd, src);
+    }
+    submit_if_waiting();
+}
+
+void
+IoUringPoll::update(int fd, void *ctx, bool read, bool write)
+{
+    std::lock_guard guard(_lock);
+    Source &src = source(fd);
+    uint32_t events = maybe(POLLIN, read) | maybe(POLLOUT, write);
+    if ((src.ctx == ctx) && (src.events == events)) {
+        return;
+    }
+    disarm(fd, src);
+    src.ctx = ctx;
+    src.events = events;
+    if (src.events != 0) {
+        arm(fd, src);
+    }
+    submit_if_waiting();
+}
+
+void
+IoUringPoll::remove(int fd)
+{
+    std::lock_guard guard(_lock);
+    Source &src = source(fd);
+    disarm(fd, src);
+    src = Source();
+    submit_if_waiting();
+}
+
+size_t
+IoUringPoll::wait(epoll_event *events, size_t max_events, int timeout_ms)
+{
+    uint32_t to_submit;
+    {
+        std::lock_guard guard(_lock);
+        for (int fd: _fired) {
+            Source &src = _sources[fd];
+            if (!src.armed && (src.events != 0)) {
+                arm(fd, src);
+            }
+        }
+        _fired.clear();
+        to_submit = _ring->unsubmitted();
+        _waiting = true;
+    }
+    __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+    }
+    uint32_t min_complete = (timeout_ms != 0) ? 1 : 0;
+    // ETIME, EINTR and friends simply mean there is less (or nothing) to harvest
+    sys_io_uring_enter(_ring->fd, to_submit, min_complete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    std::lock_guard guard(_lock);
+    _waiting = false;
+    size_t num_events = 0;
+    uint32_t head = *_ring->cq_head;
+    uint32_t tail = load_acquire(_ring->cq_tail);
+    for (; (head != tail) && (num_events < max_events); ++head) {
+        const io_uring_cqe &cqe = _ring->cqes[head & _ring->cq_mask];
+        if (cqe.user_data == 0) {
+            continue;
+        }
+        int fd = int(cqe.user_data >> 32);
+        uint32_t tag = uint32_t(cqe.user_data);
+        if ((size_t(fd) >= _sources.size()) || (_sources[fd].tag != tag)) {
+            continue; // the source was changed or removed after this poll was submitted
+        }
+        Source &src = _sources[fd];
+        src.armed = false;
+        _fired.push_back(fd);
+        events[num_events].events = (cqe.res < 0) ? uint32_t(EPOLLERR) : uint32_t(cqe.res);
+        events[num_events].data.ptr = src.ctx;
+        ++num_events;
+    }
+    store_release(_ring->cq_head, head);
+    return num_events;
+}
+
+}
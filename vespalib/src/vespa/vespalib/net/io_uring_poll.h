@@ -0,0 +1,62 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <sys/epoll.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * Readiness notification on top of io_uring with the same interface
+ * as Epoll. Each selected file descriptor has a single one-shot poll
+ * request in the ring that is re-armed after it has fired, which
+ * keeps the level-triggered semantics of epoll. Changes to the
+ * selection set are queued in the submission ring and handed to the
+ * kernel by the same io_uring_enter call that waits for events, so
+ * enabling and disabling write events does not cost a system call of
+ * its own. Changes made by other threads while a wait is in progress
+ * are submitted right away.
+ *
+ * Use the create function to construct instances; it returns an
+ * empty pointer if the running kernel does not support the io_uring
+ * features needed (or io_uring is disabled).
+ **/
+class IoUringPoll
+{
+private:
+    struct Source {
+        void     *ctx;
+        uint32_t  events; // poll mask selected for, 0 when nothing is selected
+        uint32_t  tag;    // identifies the last poll request, 0 when its completion is not wanted
+        bool      armed;  // a poll request is in flight
+        Source() : ctx(nullptr), events(0), tag(0), armed(false) {}
+    };
+    struct Ring;
+
+    std::unique_ptr<Ring> _ring;
+    std::mutex            _lock;
+    std::vector<Source>   _sources; // indexed by file descriptor
+    std::vector<int>      _fired;   // file descriptors to re-arm before waiting again
+    uint32_t              _next_tag;
+    bool                  _waiting;
+
+    explicit IoUringPoll(std::unique_ptr<Ring> ring);
+    Source &source(int fd);
+    void arm(int fd, Source &src);
+    void disarm(int fd, Source &src);
+    void submit_if_waiting();
+
+public:
+    static std::unique_ptr<IoUringPoll> create();
+    ~IoUringPoll();
+    void add(int fd, void *ctx, bool read, bool write);
+    void update(int fd, void *ctx, bool read, bool write);
+    void remove(int fd);
+    size_t wait(epoll_event *events, size_t max_events, int timeout_ms);
+};
+
+}
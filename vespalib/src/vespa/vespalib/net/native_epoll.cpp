@@ -1,10 +1,13 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "native_epoll.h"
+#include "io_uring_poll.h"
 #include <cassert>
 #include <cerrno>
+#include <cstring>
 #include <unistd.h>
 #include <vespa/log/log.h>
+LOG_SETUP(".vespalib.net.native_epoll");
 
 namespace vespalib {
 
@@ -22,20 +25,36 @@ void check(int res) {
 
 }
 
-Epoll::Epoll()
-    : _epoll_fd(epoll_create1(0))
+Epoll::Epoll(bool use_io_uring)
+    : _epoll_fd(-1),
+      _io_uring()
 {
-    assert(_epoll_fd != -1);
+    if (use_io_uring) {
+        _io_uring = IoUringPoll::create();
+        if (!_io_uring) {
+            LOG(warning, "io_uring is not available, falling back to epoll");
+        }
+    }
+    if (!_io_uring) {
+        _epoll_fd = epoll_create1(0);
+        assert(_epoll_fd != -1);
+    }
 }
 
 Epoll::~Epoll()
 {
-    close(_epoll_fd);
+    if (_epoll_fd != -1) {
+        close(_epoll_fd);
+    }
 }
 
 void
 Epoll::add(int fd, void *ctx, bool read, bool write)
 {
+    if (_io_uring) {
+        _io_uring->add(fd, ctx, read, write);
+        return;
+    }
     epoll_event evt;
     evt.events = maybe(EPOLLIN, read) | maybe(EPOLLOUT, write);
     evt.data.ptr = ctx;
@@ -45,6 +64,10 @@ Epoll::add(int fd, void *ctx, bool read, bool write)
 void
 Epoll::update(int fd, void *ctx, bool read, bool write)
 {
+    if (_io_uring) {
+        _io_uring->update(fd, ctx, read, write);
+        return;
+    }
     epoll_event evt;
     evt.events = maybe(EPOLLIN, read) | maybe(EPOLLOUT, write);
     evt.data.ptr = ctx;
@@ -54,6 +77,10 @@ Epoll::update(int fd, void *ctx, bool read, bool write)
 void
 Epoll::remove(int fd)
 {
+    if (_io_uring) {
+        _io_uring->remove(fd);
+        return;
+    }
     epoll_event evt;
     memset(&evt, 0, sizeof(evt));
     check(epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, &evt));
@@ -62,6 +89,9 @@ Epoll::remove(int fd)
 size_t
 Epoll::wait(epoll_event *events, size_t max_events, int timeout_ms)
 {
+    if (_io_uring) {
+        return _io_uring->wait(events, max_events, timeout_ms);
+    }
     int res = epoll_wait(_epoll_fd, events, max_events, timeout_ms);
     return std::max(res, 0);
 }
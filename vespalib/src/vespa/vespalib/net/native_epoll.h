@@ -3,19 +3,25 @@
 #pragma once
 
 #include <sys/epoll.h>
+#include <memory>
 
 namespace vespalib {
 
+class IoUringPoll;
+
 /**
  * The Epoll class is a thin wrapper around the epoll related system
- * calls.
+ * calls. It may optionally be backed by io_uring (see IoUringPoll),
+ * in which case it falls back to epoll if io_uring is not available.
  **/
 class Epoll
 {
 private:
     int _epoll_fd;
+    std::unique_ptr<IoUringPoll> _io_uring;
 public:
-    Epoll();
+    Epoll() : Epoll(false) {}
+    explicit Epoll(bool use_io_uring);
     ~Epoll();
     void add(int fd, void *ctx, bool read, bool write);
     void update(int fd, void *ctx, bool read, bool write);
@@ -41,8 +41,9 @@ private:
     WakeupPipe  _wakeup_pipe;
     EpollEvents _events;
 public:
-    Selector()
-        : _epoll(), _wakeup_pipe(), _events(4096)
+    Selector() : Selector(false) {}
+    explicit Selector(bool use_io_uring)
+        : _epoll(use_io_uring), _wakeup_pipe(), _events(4096)
     {
         _epoll.add(_wakeup_pipe.get_read_fd(), nullptr, true, false);    
     }
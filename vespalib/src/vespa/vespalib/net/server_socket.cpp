@@ -23,6 +23,13 @@ SocketHandle adjust_blocking(SocketHandle handle, bool value) {
     }
 }
 
+SocketHandle listen(const SocketAddress &addr, bool reuse_port) {
+    return addr.listen(500, [reuse_port](SocketHandle &handle)
+                       {
+                           return (!reuse_port || handle.set_reuse_port(true));
+                       });
+}
+
 bool is_blocked(int err) { return ((err == EWOULDBLOCK) || (err == EAGAIN)); }
 
 bool is_socket(const vespalib::string &path) {
@@ -43,8 +50,8 @@ ServerSocket::cleanup()
     }
 }
 
-ServerSocket::ServerSocket(const SocketSpec &spec)
-    : _handle(adjust_blocking(spec.server_address().listen(), false)),
+ServerSocket::ServerSocket(const SocketSpec &spec, bool reuse_port)
+    : _handle(adjust_blocking(listen(spec.server_address(), reuse_port), false)),
       _path(spec.path()),
       _blocking(true),
       _shutdown(false)
@@ -53,7 +60,7 @@ ServerSocket::ServerSocket(const SocketSpec &spec)
         if (!spec.client_address().connect_async().valid()) {
             LOG(warning, "removing old socket: '%s'", _path.c_str());
             unlink(_path.c_str());
-            _handle = spec.server_address().listen();
+            _handle = listen(spec.server_address(), reuse_port);
         }
     }
     if (!_handle.valid()) {
@@ -21,7 +21,9 @@ private:
     void cleanup();
 public:
     ServerSocket() : _handle(), _path() {}
-    explicit ServerSocket(const SocketSpec &spec);
+    explicit ServerSocket(const SocketSpec &spec) : ServerSocket(spec, false) {}
+    // with reuse_port, several server sockets may listen to the same port (SO_REUSEPORT)
+    ServerSocket(const SocketSpec &spec, bool reuse_port);
     explicit ServerSocket(const vespalib::string &spec);
     explicit ServerSocket(int port);
     ServerSocket(ServerSocket &&rhs);
@@ -0,0 +1,922 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "shm_crypto_engine.h"
+#include "socket_address.h"
+#include "socket_spec.h"
+#include <vespa/vespalib/net/tls/statistics.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.net.shm_crypto_engine");
+
+namespace vespalib {
+
+namespace {
+
+constexpr char shm_magic[8] = {'V', 'E', 'S', 'P', 'A', 'S', 'H', 'M'};
+constexpr uint32_t shm_version = 1;
+constexpr char shm_dir[] = "/dev/shm/";
+constexpr char shm_prefix[] = "vespa-shm-transport.";
+constexpr char advert_prefix[] = "vespa-shm-server.";
+constexpr uint32_t max_name_size = 128;
+constexpr size_t hello_header_size = sizeof(shm_magic) + sizeof(uint32_t);
+constexpr char ack_byte = 'A';
+constexpr char doorbell_byte = 'D';
+
+std::atomic<uint64_t> next_segment_id(0);
+
+// One direction of a connection. The writer owns head, doorbells,
+// socket_limit and closed, the reader owns tail and waiting.
+struct Ring {
+    alignas(64) std::atomic<uint64_t> head;         // bytes put into the ring
+    std::atomic<uint64_t>             doorbells;    // doorbells sent on the socket
+    std::atomic<uint64_t>             socket_limit; // data bytes announced for the socket
+    std::atomic<uint32_t>             closed;       // the writer has half-closed
+    alignas(64) std::atomic<uint64_t> tail;         // bytes taken out of the ring
+    std::atomic<uint32_t>             waiting;      // the reader is about to wait for the socket
+};
+
+struct Segment {
+    char                  magic[8];
+    uint32_t              version;
+    uint32_t              ring_size;
+    std::atomic<uint32_t> accepted;
+    Ring                  rings[2]; // client to server, server to client
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+constexpr size_t data_offset = (sizeof(Segment) + 63) & ~size_t(63);
+
+// Records are 16 byte aligned, so a header never wraps around the end of a ring
+struct Record {
+    static constexpr uint32_t DATA   = 1; // 'size' bytes of data follow
+    static constexpr uint32_t SOCKET = 2; // data continues on the socket after 'arg' doorbells in total
+    static constexpr uint32_t RESUME = 3; // data continues here after 'arg' bytes read from the socket in total
+    uint32_t type;
+    uint32_t size;
+    uint64_t arg;
+};
+static_assert(sizeof(Record) == 16);
+
+constexpr size_t align_record(size_t size) { return (size + 15) & ~size_t(15); }
+
+bool is_blocked(ssize_t res, int error) {
+    return ((res < 0) && ((error == EWOULDBLOCK) || (error == EAGAIN)));
+}
+
+ssize_t fail_with(int error) {
+    errno = error;
+    return -1;
+}
+
+ssize_t recv_some(int fd, char *buf, size_t len, int flags) {
+    for (;;) {
+        ssize_t res = ::recv(fd, buf, len, flags);
+        if ((res >= 0) || (errno != EINTR)) {
+            return res;
+        }
+    }
+}
+
+vespalib::string advert_path(int port) {
+    return make_string("%s%s%d", shm_dir, advert_prefix, port);
+}
+
+bool is_own_file(int fd) {
+    struct stat info;
+    return ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode) && (info.st_uid == geteuid()));
+}
+
+bool is_valid_name(const vespalib::string &name) {
+    size_t prefix_size = strlen(shm_prefix);
+    return ((name.size() > prefix_size) &&
+            (memcmp(name.data(), shm_prefix, prefix_size) == 0) &&
+            (name.find('/') == vespalib::string::npos));
+}
+
+/**
+ * A mapped shared memory segment holding the rings of a single
+ * connection. The creator removes the name when the peer has mapped
+ * the segment (or when giving up), the peer removes it right after
+ * mapping it.
+ **/
+class SharedSegment
+{
+private:
+    vespalib::string _name;
+    void            *_addr;
+    size_t           _size;
+    bool             _linked;
+
+    SharedSegment(const vespalib::string &name, void *addr, size_t size, bool linked)
+        : _name(name), _addr(addr), _size(size), _linked(linked) {}
+    static vespalib::string path_of(const vespalib::string &name) { return shm_dir + name; }
+
+public:
+    using UP = std::unique_ptr<SharedSegment>;
+    SharedSegment(const SharedSegment &) = delete;
+    SharedSegment &operator=(const SharedSegment &) = delete;
+    ~SharedSegment() {
+        unlink();
+        munmap(_addr, _size);
+    }
+
+    static UP create(size_t ring_size) {
+        uint64_t nonce = std::chrono::steady_clock::now().time_since_epoch().count();
+        vespalib::string name = make_string("%s%d.%" PRIu64 ".%" PRIu64, shm_prefix, getpid(),
+                                            next_segment_id.fetch_add(1, std::memory_order_relaxed), nonce);
+        vespalib::string path = path_of(name);
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            LOG(debug, "could not create shared memory segment '%s': %s", path.c_str(), strerror(errno));
+            return UP();
+        }
+        size_t size = data_offset + 2 * ring_size;
+        void *addr = MAP_FAILED;
+        if (ftruncate(fd, size) == 0) {
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (addr == MAP_FAILED) {
+            LOG(debug, "could not map shared memory segment '%s': %s", path.c_str(), strerror(errno));
+            ::unlink(path.c_str());
+            return UP();
+        }
+        Segment *segment = new (addr) Segment();
+        memcpy(segment->magic, shm_magic, sizeof(shm_magic));
+        segment->version = shm_version;
+        segment->ring_size = ring_size;
+        return UP(new SharedSegment(name, addr, size, true));
+    }
+
+    static UP open(const vespalib::string &name) {
+        if (!is_valid_name(name)) {
+            return UP();
+        }
+        vespalib::string path = path_of(name);
+        int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC | O_NOFOLLOW);
+        if (fd < 0) {
+            LOG(debug, "could not open shared memory segment '%s': %s", path.c_str(), strerror(errno));
+            return UP();
+        }
+        struct stat info;
+        void *addr = MAP_FAILED;
+        size_t size = 0;
+        if ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode) && (info.st_uid == geteuid()) &&
+            (size_t(info.st_size) > data_offset))
+        {
+            size = info.st_size;
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return UP();
+        }
+        UP result(new SharedSegment(name, addr, size, false));
+        const Segment &segment = result->segment();
+        size_t ring_size = segment.ring_size;
+        uint32_t expect = 0;
+        if ((memcmp(segment.magic, shm_magic, sizeof(shm_magic)) != 0) ||
+            (segment.version != shm_version) ||
+            (ring_size < 4096) || ((ring_size & (ring_size - 1)) != 0) ||
+            ((data_offset + 2 * ring_size) != size) ||
+            !result->segment().accepted.compare_exchange_strong(expect, 1))
+        {
+            LOG(warning, "rejected shared memory segment '%s'", path.c_str());
+            return UP();
+        }
+        ::unlink(path.c_str());
+        return result;
+    }
+
+    void unlink() {
+        if (_linked) {
+            ::unlink(path_of(_name).c_str());
+            _linked = false;
+        }
+    }
+    const vespalib::string &name() const { return _name; }
+    Segment &segment() const { return *static_cast<Segment *>(_addr); }
+    size_t ring_size() const { return segment().ring_size; }
+    Ring &ring(size_t idx) const { return segment().rings[idx]; }
+    char *data(size_t idx) const { return static_cast<char *>(_addr) + data_offset + idx * ring_size(); }
+};
+
+/**
+ * Writing end of a ring. Data is put into the ring while there is
+ * room for it. When the ring is full, a SOCKET record is put into it
+ * and data is written to the socket instead, until the reader has
+ * emptied at least half of the ring. Socket data is announced (in
+ * socket_limit) before it is written, so the reader never reads
+ * doorbells as data. A partially written announcement is completed
+ * by the following writes.
+ **/
+class RingWriter
+{
+private:
+    Ring         &_ring;
+    char         *_data;
+    size_t        _size;
+    SocketHandle &_socket;
+    uint64_t      _head;
+    uint64_t      _doorbells;
+    bool          _doorbell_pending;
+    bool          _socket_mode;
+    uint64_t      _announced;
+    uint64_t      _sent;
+
+    void put(const char *src, size_t len) {
+        size_t offset = (_head & (_size - 1));
+        size_t first = std::min(len, _size - offset);
+        memcpy(_data + offset, src, first);
+        memcpy(_data, src + first, len - first);
+        _head += len;
+    }
+    void put_record(uint32_t type, uint32_t size, uint64_t arg) {
+        Record record{type, size, arg};
+        put(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+    size_t free_space() const {
+        return (_size - (_head - _ring.tail.load(std::memory_order_acquire)));
+    }
+    // largest data record that still leaves room for a SOCKET record
+    size_t data_room() const {
+        size_t space = free_space();
+        return (space >= (3 * sizeof(Record))) ? ((space - 2 * sizeof(Record)) & ~size_t(15)) : 0;
+    }
+    bool send_doorbell() {
+        if (_doorbell_pending) {
+            if (_socket.write(&doorbell_byte, 1) != 1) {
+                return false;
+            }
+            _doorbell_pending = false;
+        }
+        return true;
+    }
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((_ring.waiting.load(std::memory_order_relaxed) != 0) &&
+            (_ring.waiting.exchange(0, std::memory_order_relaxed) != 0))
+        {
+            _ring.doorbells.store(++_doorbells, std::memory_order_release);
+            _doorbell_pending = true;
+            send_doorbell();
+        }
+    }
+    void publish() {
+        _ring.head.store(_head, std::memory_order_release);
+        notify();
+    }
+
+public:
+    RingWriter(Ring &ring, char *data, size_t size, SocketHandle &socket)
+        : _ring(ring), _data(data), _size(size), _socket(socket), _head(0), _doorbells(0),
+          _doorbell_pending(false), _socket_mode(false), _announced(0), _sent(0) {}
+
+    ssize_t write(const struct iovec *iov, int iovcnt) {
+        size_t len = 0;
+        for (int i = 0; i < iovcnt; ++i) {
+            len += iov[i].iov_len;
+        }
+        if (len == 0) {
+            return 0;
+        }
+        if (_socket_mode && (_sent == _announced) && (free_space() >= (_size / 2))) {
+            put_record(Record::RESUME, 0, _sent);
+            _socket_mode = false;
+            publish();
+        }
+        if (!_socket_mode) {
+            if (size_t room = data_room(); room > 0) {
+                size_t size = std::min(len, room);
+                put_record(Record::DATA, size, 0);
+                for (int i = 0, left = size; left > 0; ++i) {
+                    size_t chunk = std::min(size_t(left), iov[i].iov_len);
+                    put(static_cast<const char *>(iov[i].iov_base), chunk);
+                    left -= chunk;
+                }
+                _head += (align_record(size) - size);
+                publish();
+                return size;
+            }
+            // no doorbell; the data written to the socket wakes the reader
+            put_record(Record::SOCKET, 0, _doorbells);
+            _ring.head.store(_head, std::memory_order_release);
+            _socket_mode = true;
+        }
+        if (!send_doorbell()) {
+            return -1;
+        }
+        if (_sent == _announced) {
+            _announced += len;
+            _ring.socket_limit.store(_announced, std::memory_order_release);
+        }
+        while (iov->iov_len == 0) {
+            ++iov;
+        }
+        ssize_t res = _socket.write(static_cast<const char *>(iov->iov_base),
+                                    std::min(iov->iov_len, size_t(_announced - _sent)));
+        if (res > 0) {
+            _sent += res;
+        }
+        return res;
+    }
+
+    ssize_t flush() {
+        return send_doorbell() ? 0 : -1;
+    }
+
+    ssize_t half_close() {
+        if (!send_doorbell()) {
+            return -1;
+        }
+        // no doorbell; shutting down the socket wakes the reader
+        _ring.closed.store(1, std::memory_order_release);
+        return _socket.half_close();
+    }
+};
+
+/**
+ * Reading end of a ring. Doorbells are only read from the socket
+ * when the ring has been emptied, and only as many as the writer has
+ * announced, so that they can not be confused with data sent on the
+ * socket.
+ **/
+class RingReader
+{
+private:
+    Ring       &_ring;
+    const char *_data;
+    size_t      _size;
+    int         _fd;
+    uint64_t    _tail;
+    size_t      _data_left;        // of the current DATA record
+    size_t      _padding;          // after the current DATA record
+    uint64_t    _doorbells;        // doorbells read from the socket
+    bool        _socket_mode;
+    uint64_t    _socket_doorbells; // doorbells sent before the socket data
+    uint64_t    _received;         // data bytes read from the socket
+    bool        _resume_seen;
+    uint64_t    _resume_at;        // socket data bytes sent before the RESUME
+    bool        _broken;
+
+    void get(char *dst, size_t len) {
+        size_t offset = (_tail & (_size - 1));
+        size_t first = std::min(len, _size - offset);
+        memcpy(dst, _data + offset, first);
+        memcpy(dst + first, _data, len - first);
+        _tail += len;
+    }
+
+    bool ring_is_empty() const {
+        return (_ring.head.load(std::memory_order_acquire) == _tail);
+    }
+
+    // copy data from the ring, following control records until the data continues on the socket
+    size_t copy(char *buf, size_t len) {
+        size_t done = 0;
+        uint64_t head = _ring.head.load(std::memory_order_acquire);
+        while (!_socket_mode && !_broken) {
+            if (_data_left > 0) {
+                if (done == len) {
+                    break;
+                }
+                size_t chunk = std::min(len - done, _data_left);
+                get(buf + done, chunk);
+                done += chunk;
+                _data_left -= chunk;
+                if (_data_left == 0) {
+                    _tail += _padding;
+                }
+            } else if (_tail == head) {
+                break;
+            } else {
+                Record record;
+                get(reinterpret_cast<char *>(&record), sizeof(record));
+                if (record.type == Record::DATA) {
+                    _data_left = record.size;
+                    _padding = align_record(record.size) - record.size;
+                } else if (record.type == Record::SOCKET) {
+                    _socket_mode = true;
+                    _socket_doorbells = record.arg;
+                } else {
+                    _broken = true;
+                }
+            }
+        }
+        _ring.tail.store(_tail, std::memory_order_release);
+        if ((done > 0) && (_ring.waiting.load(std::memory_order_relaxed) != 0)) {
+            _ring.waiting.store(0, std::memory_order_relaxed);
+        }
+        return done;
+    }
+
+    // look for the record telling where the socket data ends
+    void check_resume() {
+        if (_resume_seen || ring_is_empty()) {
+            return;
+        }
+        Record record;
+        get(reinterpret_cast<char *>(&record), sizeof(record));
+        if ((record.type != Record::RESUME) || (record.arg < _received)) {
+            _broken = true;
+            return;
+        }
+        _ring.tail.store(_tail, std::memory_order_release);
+        _resume_seen = true;
+        _resume_at = record.arg;
+    }
+
+    // doorbells that may be read from the socket without risking reading data
+    uint64_t readable_doorbells() const {
+        uint64_t doorbells = _ring.doorbells.load(std::memory_order_acquire);
+        return (!_socket_mode && (_data_left == 0) && ring_is_empty()) ? doorbells : _doorbells;
+    }
+
+    ssize_t skip_doorbells(uint64_t target, int flags) {
+        char tmp[64];
+        while (_doorbells < target) {
+            ssize_t res = recv_some(_fd, tmp, std::min(sizeof(tmp), size_t(target - _doorbells)), flags);
+            if (res <= 0) {
+                return res;
+            }
+            _doorbells += res;
+        }
+        return 1;
+    }
+
+    // announce that we are about to wait, returns false if data arrived meanwhile
+    bool prepare_wait() {
+        _ring.waiting.store(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ring_is_empty()) {
+            _ring.waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+public:
+    RingReader(Ring &ring, const char *data, size_t size, int fd)
+        : _ring(ring), _data(data), _size(size), _fd(fd), _tail(0), _data_left(0), _padding(0),
+          _doorbells(0), _socket_mode(false), _socket_doorbells(0), _received(0),
+          _resume_seen(false), _resume_at(0), _broken(false) {}
+
+    ssize_t read(char *buf, size_t len) {
+        bool progress = false;
+        bool peeked = false;
+        for (;;) {
+            if (_broken) {
+                return fail_with(EPROTO);
+            }
+            if (!_socket_mode) {
+                size_t done = copy(buf, len);
+                if (done > 0) {
+                    skip_doorbells(readable_doorbells(), MSG_DONTWAIT); // avoid a spurious wakeup
+                    return done;
+                }
+                if (_socket_mode || _broken) {
+                    continue;
+                }
+                if (uint64_t target = readable_doorbells(); target > _doorbells) {
+                    ssize_t res = skip_doorbells(target, 0);
+                    if (res <= 0) {
+                        return res;
+                    }
+                    progress = true;
+                    continue;
+                }
+            } else {
+                if (_doorbells < _socket_doorbells) {
+                    ssize_t res = skip_doorbells(_socket_doorbells, 0);
+                    if (res <= 0) {
+                        return res;
+                    }
+                    continue;
+                }
+                // the limit may include data sent after the next RESUME, so load it first
+                uint64_t limit = _ring.socket_limit.load(std::memory_order_acquire);
+                check_resume();
+                if (_broken) {
+                    continue;
+                }
+                if (_resume_seen) {
+                    limit = _resume_at;
+                }
+                if (_received < limit) {
+                    ssize_t res = recv_some(_fd, buf, std::min(len, size_t(limit - _received)), 0);
+                    if (res > 0) {
+                        _received += res;
+                    }
+                    return res;
+                }
+                if (_resume_seen) {
+                    _resume_seen = false;
+                    _socket_mode = false;
+                    continue;
+                }
+            }
+            if (_ring.closed.load(std::memory_order_acquire) && ring_is_empty()) {
+                // consume all doorbells to avoid resetting the connection on close
+                ssize_t res = skip_doorbells(_ring.doorbells.load(std::memory_order_acquire), 0);
+                return (res < 0) ? res : 0;
+            }
+            if (!prepare_wait()) {
+                continue;
+            }
+            if (progress) {
+                return fail_with(EWOULDBLOCK);
+            }
+            // nothing to read; wait (if blocking) and check for EOF
+            char tmp;
+            ssize_t res = recv_some(_fd, &tmp, 1, MSG_PEEK);
+            if (res <= 0) {
+                return res;
+            }
+            if (peeked) {
+                return fail_with(EPROTO); // bytes on the socket we do not know about
+            }
+            peeked = true;
+        }
+    }
+
+    // like read, but never touches the socket; returning 0 means the
+    // socket will become readable when there is more to read
+    ssize_t drain(char *buf, size_t len) {
+        for (;;) {
+            if (_broken) {
+                return fail_with(EPROTO);
+            }
+            if (!_socket_mode) {
+                size_t done = copy(buf, len);
+                if (done > 0) {
+                    return done;
+                }
+                if (_socket_mode || _broken) {
+                    continue;
+                }
+            } else {
+                if (_doorbells < _socket_doorbells) {
+                    return 0;
+                }
+                uint64_t limit = _ring.socket_limit.load(std::memory_order_acquire);
+                check_resume();
+                if (_broken) {
+                    continue;
+                }
+                if (_resume_seen) {
+                    limit = _resume_at;
+                }
+                if (_received < limit) {
+                    return 0;
+                }
+                if (_resume_seen) {
+                    _resume_seen = false;
+                    _socket_mode = false;
+                    continue;
+                }
+            }
+            // the writer rings the doorbell for data (or a RESUME) put into the ring after this
+            if (prepare_wait()) {
+                return 0;
+            }
+        }
+    }
+};
+
+/**
+ * Socket moving connection data through a shared memory segment
+ * after the initial greeting (client) and acknowledgement (server)
+ * has been exchanged on the real socket.
+ **/
+class ShmCryptoSocket : public CryptoSocket
+{
+private:
+    enum class State { SEND_HELLO, RECV_ACK, SEND_ACK, DONE };
+
+    SocketHandle       _socket;
+    SharedSegment::UP  _segment;
+    State              _state;
+    vespalib::string   _hello;
+    size_t             _hello_pos;
+    RingReader         _reader;
+    RingWriter         _writer;
+
+    static vespalib::string make_hello(const vespalib::string &name) {
+        vespalib::string hello(shm_magic, sizeof(shm_magic));
+        uint32_t name_size = name.size();
+        hello.append(reinterpret_cast<const char *>(&name_size), sizeof(name_size));
+        hello.append(name);
+        return hello;
+    }
+
+public:
+    ShmCryptoSocket(SocketHandle socket, SharedSegment::UP segment, bool is_server)
+        : _socket(std::move(socket)),
+          _segment(std::move(segment)),
+          _state(is_server ? State::SEND_ACK : State::SEND_HELLO),
+          _hello(is_server ? vespalib::string() : make_hello(_segment->name())),
+          _hello_pos(0),
+          _reader(_segment->ring(is_server ? 0 : 1), _segment->data(is_server ? 0 : 1),
+                  _segment->ring_size(), _socket.get()),
+          _writer(_segment->ring(is_server ? 1 : 0), _segment->data(is_server ? 1 : 0),
+                  _segment->ring_size(), _socket)
+    {
+        // doorbells must not be held back waiting for the previous one to be acknowledged
+        _socket.set_nodelay(true);
+    }
+    int get_fd() const override { return _socket.get(); }
+    HandshakeResult handshake() override {
+        if (_state == State::SEND_HELLO) {
+            ssize_t res = _socket.write(_hello.data() + _hello_pos, _hello.size() - _hello_pos);
+            if (is_blocked(res, errno)) {
+                return HandshakeResult::NEED_WRITE;
+            }
+            if (res <= 0) {
+                return HandshakeResult::FAIL;
+            }
+            _hello_pos += res;
+            if (_hello_pos < _hello.size()) {
+                return HandshakeResult::NEED_WRITE;
+            }
+            _state = State::RECV_ACK;
+        }
+        if (_state == State::RECV_ACK) {
+            char ack = 0;
+            ssize_t res = _socket.read(&ack, 1);
+            if (is_blocked(res, errno)) {
+                return HandshakeResult::NEED_READ;
+            }
+            if ((res != 1) || (ack != ack_byte)) {
+                return HandshakeResult::FAIL;
+            }
+            _segment->unlink();
+            _state = State::DONE;
+        }
+        if (_state == State::SEND_ACK) {
+            ssize_t res = _socket.write(&ack_byte, 1);
+            if (is_blocked(res, errno)) {
+                return HandshakeResult::NEED_WRITE;
+            }
+            if (res != 1) {
+                return HandshakeResult::FAIL;
+            }
+            _state = State::DONE;
+        }
+        return HandshakeResult::DONE;
+    }
+    void do_handshake_work() override {}
+    size_t min_read_buffer_size() const override { return 1; }
+    ssize_t read(char *buf, size_t len) override { return _reader.read(buf, len); }
+    ssize_t drain(char *buf, size_t len) override { return _reader.drain(buf, len); }
+    ssize_t write(const char *buf, size_t len) override {
+        struct iovec iov = { const_cast<char *>(buf), len };
+        return _writer.write(&iov, 1);
+    }
+    ssize_t writev(const struct iovec *iov, int iovcnt) override { return _writer.write(iov, iovcnt); }
+    ssize_t flush() override { return _writer.flush(); }
+    ssize_t half_close() override { return _writer.half_close(); }
+    void drop_empty_buffers() override {}
+};
+
+/**
+ * Decides how to handle a connection during the first handshake
+ * step, replacing itself with the appropriate socket. Clients check
+ * whether the (now connected) peer is a server on this host
+ * advertising shared memory, servers whether the client starts with
+ * the shared memory greeting.
+ **/
+class SelectingCryptoSocket : public CryptoSocket
+{
+private:
+    CryptoSocket::UP &_self;
+    SocketHandle      _socket;
+    CryptoEngine::SP  _engine;
+    size_t            _ring_size;
+    bool              _is_server;
+    SocketSpec        _spec;
+
+    HandshakeResult replace_with(CryptoSocket::UP socket) {
+        CryptoSocket::UP &self = _self; // need copy due to self destruction
+        self = std::move(socket);
+        return self->handshake();
+    }
+
+    HandshakeResult select_client() {
+        if (ShmCryptoEngine::is_local_peer(_socket.get()) &&
+            ShmCryptoEngine::is_advertised(SocketAddress::peer_address(_socket.get()).port()))
+        {
+            if (auto segment = SharedSegment::create(_ring_size)) {
+                net::tls::ConnectionStatistics::get(false).inc_insecure_connections();
+                return replace_with(std::make_unique<ShmCryptoSocket>(std::move(_socket), std::move(segment), false));
+            }
+        }
+        return replace_with(_engine->create_client_crypto_socket(std::move(_socket), _spec));
+    }
+
+    HandshakeResult select_server() {
+        char hello[hello_header_size + max_name_size];
+        ssize_t res = recv_some(_socket.get(), hello, hello_header_size, MSG_PEEK);
+        if (res <= 0) {
+            return is_blocked(res, errno) ? HandshakeResult::NEED_READ : HandshakeResult::FAIL;
+        }
+        if (memcmp(hello, shm_magic, std::min(size_t(res), sizeof(shm_magic))) != 0) {
+            return replace_with(_engine->create_server_crypto_socket(std::move(_socket)));
+        }
+        if (size_t(res) < hello_header_size) {
+            return HandshakeResult::NEED_READ;
+        }
+        uint32_t name_size = 0;
+        memcpy(&name_size, hello + sizeof(shm_magic), sizeof(name_size));
+        if ((name_size == 0) || (name_size > max_name_size)) {
+            return HandshakeResult::FAIL;
+        }
+        size_t hello_size = hello_header_size + name_size;
+        res = recv_some(_socket.get(), hello, hello_size, MSG_PEEK);
+        if (size_t(res) < hello_size) {
+            return ((res > 0) || is_blocked(res, errno)) ? HandshakeResult::NEED_READ : HandshakeResult::FAIL;
+        }
+        if ((recv_some(_socket.get(), hello, hello_size, 0) != ssize_t(hello_size)) ||
+            !ShmCryptoEngine::is_local_peer(_socket.get()))
+        {
+            return HandshakeResult::FAIL;
+        }
+        auto segment = SharedSegment::open(vespalib::string(hello + hello_header_size, name_size));
+        if (!segment) {
+            return HandshakeResult::FAIL;
+        }
+        net::tls::ConnectionStatistics::get(true).inc_insecure_connections();
+        return replace_with(std::make_unique<ShmCryptoSocket>(std::move(_socket), std::move(segment), true));
+    }
+
+public:
+    SelectingCryptoSocket(CryptoSocket::UP &self, SocketHandle socket, CryptoEngine::SP engine,
+                          size_t ring_size, bool is_server, const SocketSpec &spec)
+        : _self(self), _socket(std::move(socket)), _engine(std::move(engine)),
+          _ring_size(ring_size), _is_server(is_server), _spec(spec) {}
+    int get_fd() const override { return _socket.get(); }
+    HandshakeResult handshake() override { return _is_server ? select_server() : select_client(); }
+    void do_handshake_work() override {}
+    size_t min_read_buffer_size() const override { return 1; }
+    ssize_t read(char *, size_t) override { return fail_with(EINVAL); }
+    ssize_t drain(char *, size_t) override { return 0; }
+    ssize_t write(const char *, size_t) override { return fail_with(EINVAL); }
+    ssize_t flush() override { return 0; }
+    ssize_t half_close() override { return _socket.half_close(); }
+    void drop_empty_buffers() override {}
+};
+
+/**
+ * Stable owner of the socket handling a connection, forwarding to
+ * whatever socket the connection ended up using.
+ **/
+class ForwardingCryptoSocket : public CryptoSocket
+{
+private:
+    CryptoSocket::UP _socket;
+public:
+    ForwardingCryptoSocket(SocketHandle socket, CryptoEngine::SP engine, size_t ring_size,
+                           bool is_server, const SocketSpec &spec)
+        : _socket(std::make_unique<SelectingCryptoSocket>(_socket, std::move(socket), std::move(engine),
+                                                          ring_size, is_server, spec)) {}
+    int get_fd() const override { return _socket->get_fd(); }
+    HandshakeResult handshake() override { return _socket->handshake(); }
+    void do_handshake_work() override { _socket->do_handshake_work(); }
+    size_t min_read_buffer_size() const override { return _socket->min_read_buffer_size(); }
+    ssize_t read(char *buf, size_t len) override { return _socket->read(buf, len); }
+    ssize_t drain(char *buf, size_t len) override { return _socket->drain(buf, len); }
+    ssize_t write(const char *buf, size_t len) override { return _socket->write(buf, len); }
+    ssize_t writev(const struct iovec *iov, int iovcnt) override { return _socket->writev(iov, iovcnt); }
+    ssize_t flush() override { return _socket->flush(); }
+    ssize_t half_close() override { return _socket->half_close(); }
+    void drop_empty_buffers() override { _socket->drop_empty_buffers(); }
+    bool is_kernel_tls_tx_enabled() const override { return _socket->is_kernel_tls_tx_enabled(); }
+};
+
+size_t ring_size_from(size_t wanted) {
+    size_t size = 4096;
+    while (size < wanted) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace vespalib::<unnamed>
+
+ShmCryptoEngine::ShmCryptoEngine(CryptoEngine::SP engine, size_t ring_size)
+    : _engine(std::move(engine)),
+      _ring_size(ring_size_from(ring_size))
+{
+}
+
+ShmCryptoEngine::~ShmCryptoEngine()
+{
+    for (const auto &entry: _advertised) {
+        ::unlink(advert_path(entry.first).c_str());
+        close(entry.second);
+    }
+}
+
+CryptoSocket::UP
+ShmCryptoEngine::create_client_crypto_socket(SocketHandle socket, const SocketSpec &spec)
+{
+    if (_engine->use_tls_when_client()) {
+        return _engine->create_client_crypto_socket(std::move(socket), spec);
+    }
+    // the socket may still be connecting; the peer is checked during handshake
+    return std::make_unique<ForwardingCryptoSocket>(std::move(socket), _engine, _ring_size, false, spec);
+}
+
+CryptoSocket::UP
+ShmCryptoEngine::create_server_crypto_socket(SocketHandle socket)
+{
+    if (_engine->always_use_tls_when_server()) {
+        return _engine->create_server_crypto_socket(std::move(socket));
+    }
+    return std::make_unique<ForwardingCryptoSocket>(std::move(socket), _engine, _ring_size, true, SocketSpec::invalid);
+}
+
+void
+ShmCryptoEngine::server_listening(int port)
+{
+    _engine->server_listening(port);
+    if ((port <= 0) || _engine->always_use_tls_when_server()) {
+        return;
+    }
+    vespalib::string path = advert_path(port);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+    struct stat linked;
+    struct stat locked;
+    if ((fd < 0) || !is_own_file(fd) || (flock(fd, LOCK_EX | LOCK_NB) != 0) ||
+        (stat(path.c_str(), &linked) != 0) || (fstat(fd, &locked) != 0) ||
+        (linked.st_ino != locked.st_ino) || (linked.st_dev != locked.st_dev))
+    {
+        LOG(debug, "could not advertise shared memory transport for port %d: %s", port, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    std::lock_guard guard(_lock);
+    if (!_advertised.emplace(port, fd).second) {
+        close(fd);
+    }
+}
+
+void
+ShmCryptoEngine::server_closed(int port)
+{
+    int fd = -1;
+    {
+        std::lock_guard guard(_lock);
+        auto pos = _advertised.find(port);
+        if (pos != _advertised.end()) {
+            fd = pos->second;
+            _advertised.erase(pos);
+        }
+    }
+    if (fd >= 0) {
+        ::unlink(advert_path(port).c_str());
+        close(fd);
+    }
+    _engine->server_closed(port);
+}
+
+bool
+ShmCryptoEngine::is_advertised(int port)
+{
+    int fd = ::open(advert_path(port).c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    // the advertising server keeps an exclusive lock while listening
+    bool result = (is_own_file(fd) && (flock(fd, LOCK_SH | LOCK_NB) != 0) && (errno == EWOULDBLOCK));
+    close(fd);
+    return result;
+}
+
+bool
+ShmCryptoEngine::is_local_peer(int fd)
+{
+    SocketAddress peer = SocketAddress::peer_address(fd);
+    if (!peer.is_ipv4() && !peer.is_ipv6()) {
+        return false;
+    }
+    return (peer.ip_address() == SocketAddress::address_of(fd).ip_address());
+}
+
+} // namespace vespalib
@@ -0,0 +1,64 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "crypto_engine.h"
+#include <map>
+#include <mutex>
+
+namespace vespalib {
+
+/**
+ * Crypto engine moving the data of connections between processes on
+ * the same host through ring buffers in shared memory instead of
+ * through the kernel socket layer. It wraps another crypto engine
+ * which is used for all other connections.
+ *
+ * A server using this engine advertises each port it listens on
+ * (see server_listening) with a file in /dev/shm that it keeps
+ * locked for as long as it listens. When connecting to a peer on the
+ * same host (the peer address being the same as the local address,
+ * typically tcp/localhost) whose port is advertised by a live server
+ * run by the same user, the client creates a shared memory segment
+ * (in /dev/shm) for the connection and sends its name over the newly
+ * connected socket. The server side recognizes this greeting, maps
+ * the segment and removes its name. All other connections are handed
+ * to the wrapped engine, so a server using this engine accepts any
+ * client the wrapped engine accepts, and a client using it falls
+ * back to the wrapped engine when talking to servers not using it.
+ * Connections that would use TLS with the wrapped engine are never
+ * moved to shared memory.
+ *
+ * The socket is kept for the lifetime of the connection. Transport
+ * threads wait for it to become readable, and a single byte (a
+ * doorbell) is sent on it when data is put into a ring whose reader
+ * has announced that it is about to wait. Closing the socket (or the
+ * peer crashing) is detected as usual. When a ring is full, data is
+ * sent directly on the socket until the reader has caught up, giving
+ * normal flow control.
+ **/
+class ShmCryptoEngine : public CryptoEngine
+{
+private:
+    CryptoEngine::SP   _engine;
+    size_t             _ring_size;
+    std::mutex         _lock;
+    std::map<int, int> _advertised; // port -> locked advertisement file
+public:
+    static constexpr size_t default_ring_size = 256 * 1024;
+    explicit ShmCryptoEngine(CryptoEngine::SP engine, size_t ring_size = default_ring_size);
+    ~ShmCryptoEngine() override;
+    bool use_tls_when_client() const override { return _engine->use_tls_when_client(); }
+    bool always_use_tls_when_server() const override { return _engine->always_use_tls_when_server(); }
+    CryptoSocket::UP create_client_crypto_socket(SocketHandle socket, const SocketSpec &spec) override;
+    CryptoSocket::UP create_server_crypto_socket(SocketHandle socket) override;
+    void server_listening(int port) override;
+    void server_closed(int port) override;
+
+    // does a live server on this host advertise shared memory for the given port?
+    static bool is_advertised(int port);
+    // is the peer of the given connected socket on this host?
+    static bool is_local_peer(int fd);
+};
+
+} // namespace vespalib
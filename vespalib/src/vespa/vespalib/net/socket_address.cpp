@@ -166,11 +166,11 @@ SocketAddress::connect(const std::function<bool(SocketHandle&)> &tweak) const
 }
 
 SocketHandle
-SocketAddress::listen(int backlog) const
+SocketAddress::listen(int backlog, const std::function<bool(SocketHandle&)> &tweak) const
 {
     if (valid()) {
         SocketHandle handle(socket(_addr.ss_family, SOCK_STREAM, 0));
-        if (handle.valid()) {
+        if (handle.valid() && tweak(handle)) {
             if (is_ipv6()) {
                 handle.set_ipv6_only(false);
             }
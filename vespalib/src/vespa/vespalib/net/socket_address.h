@@ -52,7 +52,10 @@ public:
     SocketHandle connect_async() const {
         return connect([](SocketHandle &handle){ return handle.set_blocking(false); });
     }
-    SocketHandle listen(int backlog = 500) const;
+    SocketHandle listen(int backlog, const std::function<bool(SocketHandle&)> &tweak) const;
+    SocketHandle listen(int backlog = 500) const {
+        return listen(backlog, [](SocketHandle&) noexcept { return true; });
+    }
     static SocketAddress address_of(int sockfd);
     static SocketAddress peer_address(int sockfd);
     static std::vector<SocketAddress> resolve(int port, const char *node = nullptr);
@@ -5,6 +5,8 @@
 #include "socket_options.h"
 #include <unistd.h>
 
+struct iovec;
+
 namespace vespalib {
 
 /**
@@ -51,12 +53,14 @@ public:
     bool set_blocking(bool value) { return SocketOptions::set_blocking(_fd, value); }
     bool set_nodelay(bool value) { return SocketOptions::set_nodelay(_fd, value); }
     bool set_reuse_addr(bool value) { return SocketOptions::set_reuse_addr(_fd, value); }
+    bool set_reuse_port(bool value) { return SocketOptions::set_reuse_port(_fd, value); }
     bool set_ipv6_only(bool value) { return SocketOptions::set_ipv6_only(_fd, value); }
     bool set_keepalive(bool value) { return SocketOptions::set_keepalive(_fd, value); }
     bool set_linger(bool enable, int value) { return SocketOptions::set_linger(_fd, enable, value); }
 
     ssize_t read(char *buf, size_t len);
     ssize_t write(const char *buf, size_t len);
+    ssize_t writev(const struct iovec *iov, int iovcnt);
     SocketHandle accept();
     void shutdown();
     int half_close();
@@ -48,6 +48,12 @@ SocketOptions::set_reuse_addr(int fd, bool value)
     return set_bool_opt(fd, SOL_SOCKET, SO_REUSEADDR, value);
 }
 
+bool
+SocketOptions::set_reuse_port(int fd, bool value)
+{
+    return set_bool_opt(fd, SOL_SOCKET, SO_REUSEPORT, value);
+}
+
 bool
 SocketOptions::set_ipv6_only(int fd, bool value)
 {
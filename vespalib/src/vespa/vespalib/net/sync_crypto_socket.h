@@ -31,6 +31,7 @@ public:
     ssize_t read(char *buf, size_t len);
     ssize_t write(const char *buf, size_t len);
     ssize_t half_close();
+    bool is_kernel_tls_tx_enabled() const { return _socket->is_kernel_tls_tx_enabled(); }
     static UP create_client(CryptoEngine &engine, SocketHandle socket, const SocketSpec &spec);
     static UP create_server(CryptoEngine &engine, SocketHandle socket);
 };
@@ -1,11 +1,21 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "crypto_codec.h"
+#include "transport_security_options.h"
 #include <vespa/vespalib/net/tls/impl/openssl_crypto_codec_impl.h>
 #include <vespa/vespalib/net/tls/impl/openssl_tls_context_impl.h>
 #include <cassert>
 
 namespace vespalib::net::tls {
 
+KernelTlsParams::KernelTlsParams() noexcept = default;
+KernelTlsParams::KernelTlsParams(KernelTlsParams&&) noexcept = default;
+KernelTlsParams& KernelTlsParams::operator=(KernelTlsParams&&) noexcept = default;
+
+KernelTlsParams::~KernelTlsParams() {
+    secure_memzero(key.data(), key.size());
+    secure_memzero(iv.data(), iv.size());
+}
+
 std::unique_ptr<CryptoCodec>
 CryptoCodec::create_default_client_codec(std::shared_ptr<TlsContext> ctx,
                                          const SocketSpec& peer_spec,
@@ -3,6 +3,8 @@
 
 #include <vespa/vespalib/net/socket_address.h>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace vespalib { class SocketSpec; }
 
@@ -52,6 +54,24 @@ struct DecodeResult {
     bool frame_decoded_ok() const noexcept { return (state == State::OK); }
 };
 
+/*
+ * Session state needed to let the kernel (kTLS) encrypt outgoing records on
+ * behalf of a codec whose handshake has completed. Key material is zeroed out
+ * on destruction.
+ */
+struct KernelTlsParams {
+    uint16_t protocol_version = 0;        // As on the wire, e.g. 0x0304 for TLSv1.3
+    uint16_t cipher_suite = 0;            // IANA cipher suite id, e.g. 0x1301 for TLS_AES_128_GCM_SHA256
+    std::vector<unsigned char> key;
+    std::vector<unsigned char> iv;        // Full per-record nonce base (salt + implicit IV)
+    uint64_t record_sequence_number = 0;  // Sequence number of the next record to be sent
+
+    KernelTlsParams() noexcept;
+    KernelTlsParams(KernelTlsParams&&) noexcept;
+    KernelTlsParams& operator=(KernelTlsParams&&) noexcept;
+    ~KernelTlsParams();
+};
+
 struct TlsContext;
 
 // TODO move to different namespace, not dependent on TLS?
@@ -175,6 +195,22 @@ public:
      */
     virtual EncodeResult half_close(char* ciphertext, size_t ciphertext_size) noexcept = 0;
 
+    /*
+     * Hands over encryption of outgoing data to the kernel. Returns the state
+     * needed to set up kTLS transmission if the codec was configured to allow
+     * it and the negotiated session can be offloaded, otherwise nothing. The
+     * state is only returned once.
+     *
+     * If the caller installs the returned state on its socket, all further
+     * outgoing data must be written to the socket as plaintext, and encode()
+     * and half_close() must no longer be called. decode() keeps working as
+     * before.
+     *
+     * Precondition: handshake must be completed and all data produced by it
+     *               must have been sent to the peer.
+     */
+    virtual std::optional<KernelTlsParams> take_kernel_tls_tx_params() noexcept { return {}; }
+
     /*
      * Creates an implementation defined CryptoCodec that provides at least TLSv1.2
      * compliant handshaking and full duplex data transfer.
@@ -1,6 +1,7 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "crypto_codec_adapter.h"
+#include "kernel_tls.h"
 #include <assert.h>
 
 namespace vespalib::net::tls {
@@ -31,6 +32,22 @@ CryptoCodecAdapter::hs_try_fill()
     }
 }
 
+CryptoSocket::HandshakeResult
+CryptoCodecAdapter::hs_finish()
+{
+    auto flush_res = hs_try_flush();
+    if (flush_res != HandshakeResult::DONE) {
+        return flush_res;
+    }
+    // All handshake output has reached the socket, so any records written
+    // from now on may be encrypted by the kernel instead.
+    auto params = _codec->take_kernel_tls_tx_params();
+    if (params.has_value()) {
+        _kernel_tls_tx = KernelTls::enable_tx(_socket.get(), *params);
+    }
+    return HandshakeResult::DONE;
+}
+
 ssize_t
 CryptoCodecAdapter::fill_input()
 {
@@ -77,7 +94,7 @@ CryptoCodecAdapter::handshake()
         _output.commit(hs_res.bytes_produced);
         switch (hs_res.state) {
         case ::vespalib::net::tls::HandshakeResult::State::Failed: return HandshakeResult::FAIL;
-        case ::vespalib::net::tls::HandshakeResult::State::Done: return hs_try_flush();
+        case ::vespalib::net::tls::HandshakeResult::State::Done: return hs_finish();
         case ::vespalib::net::tls::HandshakeResult::State::NeedsWork: return HandshakeResult::NEED_WORK;
         case ::vespalib::net::tls::HandshakeResult::State::NeedsMorePeerData:
             auto flush_res = hs_try_flush();
@@ -141,6 +158,9 @@ CryptoCodecAdapter::drain(char *buf, size_t len)
 ssize_t
 CryptoCodecAdapter::write(const char *buf, size_t len)
 {
+    if (_kernel_tls_tx) {
+        return _socket.write(buf, len);
+    }
     if (_output.obtain().size >= _codec->min_encode_buffer_size()) {
         if (flush() < 0) {
             return -1;
@@ -160,6 +180,15 @@ CryptoCodecAdapter::write(const char *buf, size_t len)
     return res.bytes_consumed;
 }
 
+ssize_t
+CryptoCodecAdapter::writev(const struct iovec *iov, int iovcnt)
+{
+    if (_kernel_tls_tx) {
+        return _socket.writev(iov, iovcnt);
+    }
+    return TlsCryptoSocket::writev(iov, iovcnt);
+}
+
 ssize_t
 CryptoCodecAdapter::flush()
 {
@@ -184,6 +213,15 @@ CryptoCodecAdapter::half_close()
     if (flush_res < 0) {
         return flush_res;
     }
+    if (_kernel_tls_tx) {
+        if (!_encoded_tls_close) {
+            if (KernelTls::send_close_notify(_socket.get()) < 0) {
+                return -1;
+            }
+            _encoded_tls_close = true;
+        }
+        return _socket.half_close();
+    }
     if (!_encoded_tls_close) {
         auto dst = _output.reserve(_codec->min_encode_buffer_size());
         auto res = _codec->half_close(dst.data, dst.size);
@@ -23,18 +23,20 @@ private:
     std::unique_ptr<CryptoCodec> _codec;
     bool                         _got_tls_close;
     bool                         _encoded_tls_close;
+    bool                         _kernel_tls_tx; // the kernel encrypts everything we write
 
     bool is_blocked(ssize_t res, int error) const {
         return ((res < 0) && ((error == EWOULDBLOCK) || (error == EAGAIN)));
     }
     HandshakeResult hs_try_flush();
     HandshakeResult hs_try_fill();
+    HandshakeResult hs_finish();
     ssize_t fill_input(); // -1/0/1 -> error/eof/ok
     ssize_t flush_all();  // -1/0 -> error/ok
 public:
     CryptoCodecAdapter(SocketHandle socket, std::unique_ptr<CryptoCodec> codec)
         : _input(0), _output(0), _socket(std::move(socket)), _codec(std::move(codec)),
-          _got_tls_close(false), _encoded_tls_close(false) {}
+          _got_tls_close(false), _encoded_tls_close(false), _kernel_tls_tx(false) {}
     void inject_read_data(const char *buf, size_t len) override;
     int get_fd() const override { return _socket.get(); }
     HandshakeResult handshake() override;
@@ -43,9 +45,11 @@ public:
     ssize_t read(char *buf, size_t len) override;
     ssize_t drain(char *, size_t) override;
     ssize_t write(const char *buf, size_t len) override;
+    ssize_t writev(const struct iovec *iov, int iovcnt) override;
     ssize_t flush() override;
     ssize_t half_close() override;
     void drop_empty_buffers() override;
+    bool is_kernel_tls_tx_enabled() const override { return _kernel_tls_tx; }
 };
 
 } // namespace vespalib::net::tls
@@ -11,11 +11,15 @@
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <cstring>
+#include <string>
 
 #include <openssl/ssl.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
 #include <openssl/pem.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
 
 #include <vespa/log/bufferedlogger.h>
 LOG_SETUP(".vespalib.net.tls.openssl_crypto_codec_impl");
@@ -161,6 +165,66 @@ vespalib::string ssl_error_from_stack() {
     return vespalib::string(buf);
 }
 
+struct EvpPkeyCtxDeleter {
+    void operator()(::EVP_PKEY_CTX* ctx) const noexcept {
+        ::EVP_PKEY_CTX_free(ctx);
+    }
+};
+using EvpPkeyCtxPtr = std::unique_ptr<::EVP_PKEY_CTX, EvpPkeyCtxDeleter>;
+
+int hex_value(char c) noexcept {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    } else if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    } else if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool decode_hex(const char* hex, std::vector<unsigned char>& out) {
+    out.clear();
+    for (; (hex[0] != '\0') && (hex[0] != ' '); hex += 2) {
+        int hi = hex_value(hex[0]);
+        int lo = (hi >= 0) ? hex_value(hex[1]) : -1;
+        if (lo < 0) {
+            secure_memzero(out.data(), out.size());
+            out.clear();
+            return false;
+        }
+        out.push_back(static_cast<unsigned char>((hi << 4) | lo));
+    }
+    return !out.empty();
+}
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+// HKDF-Expand-Label from RFC 8446 section 7.1, with an empty context.
+bool hkdf_expand_label(const ::EVP_MD* md, const std::vector<unsigned char>& secret,
+                       const char* label, size_t out_len, std::vector<unsigned char>& out)
+{
+    std::string full_label = std::string("tls13 ") + label;
+    std::vector<unsigned char> info;
+    info.push_back(static_cast<unsigned char>(out_len >> 8));
+    info.push_back(static_cast<unsigned char>(out_len & 0xff));
+    info.push_back(static_cast<unsigned char>(full_label.size()));
+    info.insert(info.end(), full_label.begin(), full_label.end());
+    info.push_back(0);
+    EvpPkeyCtxPtr ctx(::EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr));
+    if (!ctx || (::EVP_PKEY_derive_init(ctx.get()) != 1)
+        || (::EVP_PKEY_CTX_hkdf_mode(ctx.get(), EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) != 1)
+        || (::EVP_PKEY_CTX_set_hkdf_md(ctx.get(), md) != 1)
+        || (::EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), secret.data(), static_cast<int>(secret.size())) != 1)
+        || (::EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), info.data(), static_cast<int>(info.size())) != 1))
+    {
+        return false;
+    }
+    out.resize(out_len);
+    size_t derived_len = out_len;
+    return ((::EVP_PKEY_derive(ctx.get(), out.data(), &derived_len) == 1) && (derived_len == out_len));
+}
+#endif
+
 void log_ssl_error(const char* source, const SocketAddress& peer_address, int ssl_error) {
     // Buffer the emitted log messages on the peer's IP address. This prevents a single misbehaving
     // client from flooding our logs, while at the same time ensuring that logs for other clients
@@ -183,7 +247,8 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
       _ssl(::SSL_new(_ctx->native_context())),
       _mode(mode),
       _deferred_handshake_params(),
-      _deferred_handshake_result()
+      _deferred_handshake_result(),
+      _tx_traffic_secret()
 {
     if (!_ssl) {
         throw CryptoException("Failed to create new SSL from SSL_CTX");
@@ -234,7 +299,9 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
     }
 }
 
-OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() = default;
+OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() {
+    secure_memzero(_tx_traffic_secret.data(), _tx_traffic_secret.size());
+}
 
 std::unique_ptr<OpenSslCryptoCodecImpl>
 OpenSslCryptoCodecImpl::make_client_codec(std::shared_ptr<OpenSslTlsContextImpl> ctx,
@@ -483,6 +550,57 @@ EncodeResult OpenSslCryptoCodecImpl::half_close(char* ciphertext, size_t ciphert
     return encoded_bytes(0, static_cast<size_t>(pending_after - pending_before));
 }
 
+void OpenSslCryptoCodecImpl::handle_key_log_line(const char* line) noexcept {
+    // Format is "<label> <client random> <secret>", all but the label in hex
+    const char* label = (_mode == Mode::Client) ? "CLIENT_TRAFFIC_SECRET_0 " : "SERVER_TRAFFIC_SECRET_0 ";
+    if (strncmp(line, label, strlen(label)) != 0) {
+        return;
+    }
+    const char* secret_hex = strchr(line + strlen(label), ' ');
+    if ((secret_hex == nullptr) || !decode_hex(secret_hex + 1, _tx_traffic_secret)) {
+        LOG(warning, "Unable to parse traffic secret for connection with '%s'; kernel TLS will not be used",
+            _peer_address.spec().c_str());
+    }
+}
+
+std::optional<KernelTlsParams> OpenSslCryptoCodecImpl::take_kernel_tls_tx_params() noexcept {
+    if (_tx_traffic_secret.empty()) {
+        return {};
+    }
+    std::vector<unsigned char> secret;
+    secret.swap(_tx_traffic_secret);
+    std::optional<KernelTlsParams> result;
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    if (SSL_is_init_finished(_ssl.get()) && (SSL_version(_ssl.get()) == TLS1_3_VERSION)) {
+        const ::SSL_CIPHER* cipher = ::SSL_get_current_cipher(_ssl.get());
+        const uint16_t cipher_suite = (cipher != nullptr) ? ::SSL_CIPHER_get_protocol_id(cipher) : 0;
+        const ::EVP_MD* md = nullptr;
+        size_t key_len = 0;
+        switch (cipher_suite) {
+        case 0x1301: md = ::EVP_sha256(); key_len = 16; break; // TLS_AES_128_GCM_SHA256
+        case 0x1302: md = ::EVP_sha384(); key_len = 32; break; // TLS_AES_256_GCM_SHA384
+        case 0x1303: md = ::EVP_sha256(); key_len = 32; break; // TLS_CHACHA20_POLY1305_SHA256
+        default: break;
+        }
+        KernelTlsParams params;
+        params.protocol_version = TLS1_3_VERSION;
+        params.cipher_suite = cipher_suite;
+        // With session tickets disabled, no records have been sent with this secret yet.
+        params.record_sequence_number = 0;
+        if ((md != nullptr) && hkdf_expand_label(md, secret, "key", key_len, params.key)
+            && hkdf_expand_label(md, secret, "iv", 12, params.iv))
+        {
+            result = std::move(params);
+        } else {
+            LOG(debug, "Cipher suite 0x%04x with '%s' can not be offloaded to the kernel",
+                cipher_suite, _peer_address.spec().c_str());
+        }
+    }
+#endif
+    secure_memzero(secret.data(), secret.size());
+    return result;
+}
+
 }
 
 // External references:
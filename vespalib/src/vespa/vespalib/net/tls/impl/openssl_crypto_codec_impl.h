@@ -8,6 +8,7 @@
 #include <vespa/vespalib/net/tls/crypto_codec.h>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace vespalib::net::tls { struct TlsContext; }
 
@@ -55,6 +56,8 @@ class OpenSslCryptoCodecImpl : public CryptoCodec {
     Mode           _mode;
     std::optional<DeferredHandshakeParams> _deferred_handshake_params;
     std::optional<HandshakeResult>         _deferred_handshake_result;
+    // Our own TLSv1.3 application traffic secret, only captured if kernel TLS is enabled
+    std::vector<unsigned char>             _tx_traffic_secret;
 public:
     ~OpenSslCryptoCodecImpl() override;
 
@@ -94,6 +97,10 @@ public:
     DecodeResult decode(const char* ciphertext, size_t ciphertext_size,
                         char* plaintext, size_t plaintext_size) noexcept override;
     EncodeResult half_close(char* ciphertext, size_t ciphertext_size) noexcept override;
+    std::optional<KernelTlsParams> take_kernel_tls_tx_params() noexcept override;
+
+    // Invoked by OpenSSL's key log callback with secrets as they are established during the handshake.
+    void handle_key_log_line(const char* line) noexcept;
 
     const SocketAddress& peer_address() const noexcept { return _peer_address; }
     /*
@@ -222,6 +222,9 @@ OpenSslTlsContextImpl::OpenSslTlsContextImpl(
     } else {
         set_accepted_cipher_suites(modern_iana_cipher_suites());
     }
+    if (ts_opts.enable_kernel_tls()) {
+        enable_kernel_tls_key_export();
+    }
 }
 
 OpenSslTlsContextImpl::~OpenSslTlsContextImpl() {
@@ -500,6 +503,28 @@ void OpenSslTlsContextImpl::enforce_peer_certificate_verification() {
     ::SSL_CTX_set_verify(_ctx.get(), SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, verify_cb_wrapper);
 }
 
+void OpenSslTlsContextImpl::keylog_cb_wrapper(const ::SSL* ssl, const char* line) {
+    void* data = SSL_get_app_data(ssl);
+    if (data != nullptr) {
+        static_cast<OpenSslCryptoCodecImpl*>(data)->handle_key_log_line(line);
+    }
+}
+
+void OpenSslTlsContextImpl::enable_kernel_tls_key_export() {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    // The kernel takes over the record sequence from where the handshake left it, so no
+    // records may be sent with the application traffic keys before the codec hands over.
+    // TLSv1.3 session tickets would be, and we never resume sessions anyway.
+    if (::SSL_CTX_set_num_tickets(_ctx.get(), 0) != 1) {
+        throw CryptoException("SSL_CTX_set_num_tickets");
+    }
+    // Despite the name, this is the only way OpenSSL exposes TLSv1.3 traffic secrets.
+    ::SSL_CTX_set_keylog_callback(_ctx.get(), keylog_cb_wrapper);
+#else
+    LOG(warning, "Kernel TLS offload requires OpenSSL 1.1.1 or newer; not enabled");
+#endif
+}
+
 void OpenSslTlsContextImpl::set_ssl_ctx_self_reference() {
     SSL_CTX_set_app_data(_ctx.get(), this);
 }
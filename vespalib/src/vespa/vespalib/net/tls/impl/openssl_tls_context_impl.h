@@ -46,10 +46,14 @@ private:
     void enforce_peer_certificate_verification();
     void set_ssl_ctx_self_reference();
     void set_accepted_cipher_suites(const std::vector<vespalib::string>& ciphers);
+    // Make traffic secrets available to codecs, so that they can hand encryption
+    // over to the kernel after the handshake (kTLS).
+    void enable_kernel_tls_key_export();
 
     bool verify_trusted_certificate(::X509_STORE_CTX* store_ctx, const SocketAddress& peer_address);
 
     static int verify_cb_wrapper(int preverified_ok, ::X509_STORE_CTX* store_ctx);
+    static void keylog_cb_wrapper(const ::SSL* ssl, const char* line);
 };
 
 }
@@ -0,0 +1,153 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "kernel_tls.h"
+#include "crypto_codec.h"
+#include "transport_security_options.h"
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.net.tls.kernel_tls");
+
+namespace vespalib::net::tls {
+
+#ifdef __linux__
+
+namespace {
+
+#ifndef SOL_TLS
+#  define SOL_TLS 282
+#endif
+
+constexpr unsigned char alert_record_type = 21;
+
+template <typename CryptoInfo>
+bool install(int fd, const KernelTlsParams& params, uint16_t cipher_type) {
+    CryptoInfo info;
+    memset(&info, 0, sizeof(info));
+    if ((params.key.size() != sizeof(info.key)) || (params.iv.size() != (sizeof(info.salt) + sizeof(info.iv)))) {
+        return false;
+    }
+    info.info.version = params.protocol_version;
+    info.info.cipher_type = cipher_type;
+    memcpy(info.key, params.key.data(), sizeof(info.key));
+    memcpy(info.salt, params.iv.data(), sizeof(info.salt));
+    memcpy(info.iv, params.iv.data() + sizeof(info.salt), sizeof(info.iv));
+    for (size_t i = 0; i < sizeof(info.rec_seq); ++i) { // big endian
+        info.rec_seq[i] = static_cast<unsigned char>(params.record_sequence_number >> (8 * (sizeof(info.rec_seq) - 1 - i)));
+    }
+    bool ok = (setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info)) == 0);
+    if (!ok) {
+        LOG(debug, "setsockopt(TLS_TX) failed: %s", strerror(errno));
+    }
+    secure_memzero(&info, sizeof(info));
+    return ok;
+}
+
+// chacha20-poly1305 uses the full nonce as IV and has no salt
+bool install_chacha(int fd, const KernelTlsParams& params) {
+    tls12_crypto_info_chacha20_poly1305 info;
+    memset(&info, 0, sizeof(info));
+    if ((params.key.size() != sizeof(info.key)) || (params.iv.size() != sizeof(info.iv))) {
+        return false;
+    }
+    info.info.version = params.protocol_version;
+    info.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+    memcpy(info.key, params.key.data(), sizeof(info.key));
+    memcpy(info.iv, params.iv.data(), sizeof(info.iv));
+    for (size_t i = 0; i < sizeof(info.rec_seq); ++i) { // big endian
+        info.rec_seq[i] = static_cast<unsigned char>(params.record_sequence_number >> (8 * (sizeof(info.rec_seq) - 1 - i)));
+    }
+    bool ok = (setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info)) == 0);
+    if (!ok) {
+        LOG(debug, "setsockopt(TLS_TX) failed: %s", strerror(errno));
+    }
+    secure_memzero(&info, sizeof(info));
+    return ok;
+}
+
+}
+
+bool
+KernelTls::is_supported()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    // The tls module refuses unconnected sockets, but only once it has been found
+    bool supported = ((setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0) || (errno == ENOTCONN));
+    close(fd);
+    return supported;
+}
+
+bool
+KernelTls::enable_tx(int fd, const KernelTlsParams& params)
+{
+    // Fails for anything but TCP sockets, and if the tls module is not available
+    if (setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+        LOG(debug, "setsockopt(TCP_ULP, \"tls\") failed: %s", strerror(errno));
+        return false;
+    }
+    switch (params.cipher_suite) {
+    case 0x1301: return install<tls12_crypto_info_aes_gcm_128>(fd, params, TLS_CIPHER_AES_GCM_128);
+    case 0x1302: return install<tls12_crypto_info_aes_gcm_256>(fd, params, TLS_CIPHER_AES_GCM_256);
+    case 0x1303: return install_chacha(fd, params);
+    default: return false;
+    }
+}
+
+ssize_t
+KernelTls::send_close_notify(int fd)
+{
+    unsigned char alert[2] = {1, 0}; // warning, close_notify
+    char cmsg_buf[CMSG_SPACE(sizeof(alert_record_type))];
+    memset(cmsg_buf, 0, sizeof(cmsg_buf));
+    iovec iov;
+    iov.iov_base = alert;
+    iov.iov_len = sizeof(alert);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsg_buf;
+    msg.msg_controllen = sizeof(cmsg_buf);
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(alert_record_type));
+    memcpy(CMSG_DATA(cmsg), &alert_record_type, sizeof(alert_record_type));
+    return sendmsg(fd, &msg, MSG_NOSIGNAL);
+}
+
+#else
+
+bool
+KernelTls::is_supported()
+{
+    return false;
+}
+
+bool
+KernelTls::enable_tx(int, const KernelTlsParams&)
+{
+    return false;
+}
+
+ssize_t
+KernelTls::send_close_notify(int)
+{
+    errno = ENOTSUP;
+    return -1;
+}
+
+#endif
+
+}
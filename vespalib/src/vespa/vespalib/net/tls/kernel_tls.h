@@ -0,0 +1,35 @@
+// Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <sys/types.h>
+
+namespace vespalib::net::tls {
+
+struct KernelTlsParams;
+
+/*
+ * Thin wrappers around the socket options used to make the kernel
+ * encrypt outgoing TLS records for a connected TCP socket (kTLS).
+ */
+struct KernelTls {
+    /*
+     * Returns true if the running kernel provides the tls module needed
+     * for enable_tx. Probes with an unconnected TCP socket.
+     */
+    static bool is_supported();
+
+    /*
+     * Installs transmit state on the socket. Returns false (leaving the socket
+     * usable as before) if the kernel, the socket type or the cipher suite
+     * does not support it.
+     */
+    static bool enable_tx(int fd, const KernelTlsParams& params);
+
+    /*
+     * Sends a close_notify alert on a socket with kernel TLS transmission
+     * enabled. Same return value semantics as write(2).
+     */
+    static ssize_t send_close_notify(int fd);
+};
+
+}
@@ -30,9 +30,11 @@ public:
     ssize_t read(char *buf, size_t len) override { return _socket->read(buf, len); }
     ssize_t drain(char *buf, size_t len) override { return _socket->drain(buf, len); }
     ssize_t write(const char *buf, size_t len) override { return _socket->write(buf, len); }
+    ssize_t writev(const struct iovec *iov, int iovcnt) override { return _socket->writev(iov, iovcnt); }
     ssize_t flush() override { return _socket->flush(); }
     ssize_t half_close() override { return _socket->half_close(); }
     void drop_empty_buffers() override { _socket->drop_empty_buffers(); }
+    bool is_kernel_tls_tx_enabled() const override { return _socket->is_kernel_tls_tx_enabled(); }
 };
 
 } // namespace vespalib
@@ -10,6 +10,9 @@ namespace vespalib::portal {
 namespace {
 
 constexpr size_t CHUNK_SIZE = 4_Ki;
+constexpr size_t STREAM_CHUNK_SIZE = 64_Ki;
+constexpr size_t STREAM_BUFFER_SIZE = 4 * STREAM_CHUNK_SIZE;
+constexpr std::chrono::seconds STREAM_WRITE_TIMEOUT(30);
 
 enum class ReadRes { OK, END, FAIL };
 enum class WriteRes { OK, BLOCKED, FAIL };
@@ -166,11 +169,25 @@ HttpConnection::do_wait()
 void
 HttpConnection::do_write_reply()
 {
-    if (write(*_socket, _output) == WriteRes::FAIL) {
-        return set_state(State::NOTIFY, false, false);
+    std::lock_guard guard(_lock);
+    if (!_stream_failed && (write(*_socket, _output) == WriteRes::FAIL)) {
+        fail_stream();
+    }
+    if (_streaming) {
+        _cond.notify_all();
     }
-    if (_output.obtain().size == 0) {
-        set_state(State::CLOSE, false, true);
+    if (_stream_failed) {
+        if (reply_done()) {
+            set_state(State::NOTIFY, false, false);
+        } else {
+            set_state(State::WRITE_REPLY, false, false); // the producer still uses this connection
+        }
+    } else if (_output.obtain().size == 0) {
+        if (reply_done()) {
+            set_state(State::CLOSE, false, true);
+        } else {
+            set_state(State::WRITE_REPLY, false, false); // until more is produced
+        }
     }
 }
 
@@ -189,12 +206,51 @@ HttpConnection::do_notify()
     return _handler(this); // callback is final touch
 }
 
+void
+HttpConnection::fail_stream()
+{
+    _stream_failed = true;
+    _output.evict(_output.obtain().size);
+}
+
+void
+HttpConnection::flush_chunk()
+{
+    auto chunk = _chunk.obtain();
+    if (chunk.size == 0) {
+        return;
+    }
+    std::unique_lock guard(_lock);
+    if (!_reactor.is_event_thread()) {
+        // the reactor cannot write while we are blocking it
+        auto writable = [this]{ return (_stream_failed || (_output.obtain().size < STREAM_BUFFER_SIZE)); };
+        if (!_cond.wait_for(guard, STREAM_WRITE_TIMEOUT, writable)) {
+            fail_stream();
+        }
+    }
+    if (!_stream_failed) {
+        OutputWriter dst(_output, CHUNK_SIZE);
+        dst.printf("%zx\r\n", chunk.size);
+        dst.write(chunk.data, chunk.size);
+        dst.printf("\r\n");
+        _token->update(false, true);
+    }
+    _chunk.evict(chunk.size);
+}
+
 HttpConnection::HttpConnection(HandleGuard guard, Reactor &reactor, CryptoSocket::UP socket, handler_fun_t handler)
     : _guard(std::move(guard)),
+      _reactor(reactor),
       _state(State::HANDSHAKE),
       _socket(std::move(socket)),
       _input(CHUNK_SIZE * 2),
       _output(CHUNK_SIZE * 2),
+      _chunk(0),
+      _lock(),
+      _cond(),
+      _streaming(false),
+      _stream_done(false),
+      _stream_failed(false),
       _request(),
       _handler(std::move(handler)),
       _reply_ready(false),
@@ -265,4 +321,44 @@ HttpConnection::respond_with_error(int code, const vespalib::string &msg)
     _token->update(false, true);
 }
 
+void
+HttpConnection::respond_with_stream(const vespalib::string &content_type)
+{
+    std::lock_guard guard(_lock);
+    {
+        OutputWriter dst(_output, CHUNK_SIZE);
+        dst.printf("HTTP/1.1 200 OK\r\n");
+        dst.printf("Connection: close\r\n");
+        dst.printf("Content-Type: %s\r\n", content_type.c_str());
+        dst.printf("Transfer-Encoding: chunked\r\n");
+        emit_http_security_headers(dst);
+        dst.printf("\r\n");
+    }
+    _streaming = true;
+    _reply_ready = true;
+    _token->update(false, true);
+}
+
+void
+HttpConnection::commit_stream(size_t bytes)
+{
+    _chunk.commit(bytes);
+    if (_chunk.obtain().size >= STREAM_CHUNK_SIZE) {
+        flush_chunk();
+    }
+}
+
+void
+HttpConnection::finish_stream()
+{
+    flush_chunk();
+    std::lock_guard guard(_lock);
+    if (!_stream_failed) {
+        OutputWriter dst(_output, CHUNK_SIZE);
+        dst.printf("0\r\n\r\n");
+    }
+    _stream_done = true;
+    _token->update(false, true); // the reactor may delete this connection from now on
+}
+
 } // namespace vespalib::portal
@@ -9,6 +9,8 @@
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <functional>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace vespalib::portal {
 
@@ -19,15 +21,22 @@ public:
 private:
     using handler_fun_t = std::function<void(HttpConnection*)>;
 
-    HandleGuard        _guard;
-    State              _state;
-    CryptoSocket::UP   _socket;
-    SmartBuffer        _input;
-    SmartBuffer        _output;
-    HttpRequest        _request;
-    handler_fun_t      _handler;
-    std::atomic<bool>  _reply_ready;
-    Reactor::Token::UP _token;
+    HandleGuard             _guard;
+    Reactor                &_reactor;
+    State                   _state;
+    CryptoSocket::UP        _socket;
+    SmartBuffer             _input;
+    SmartBuffer             _output;
+    SmartBuffer             _chunk;
+    std::mutex              _lock;           // protects _output and the stream flags while streaming
+    std::condition_variable _cond;           // signaled when the reactor has written streamed output
+    bool                    _streaming;
+    bool                    _stream_done;
+    std::atomic<bool>       _stream_failed;
+    HttpRequest             _request;
+    handler_fun_t           _handler;
+    std::atomic<bool>       _reply_ready;
+    Reactor::Token::UP      _token;
 
     void set_state(State state, bool read, bool write);
 
@@ -39,6 +48,10 @@ private:
     void do_close();
     void do_notify();
 
+    bool reply_done() const { return (!_streaming || _stream_done); }
+    void fail_stream();
+    void flush_chunk();
+
 public:
     using UP = std::unique_ptr<HttpConnection>;
     HttpConnection(HandleGuard guard, Reactor &reactor, CryptoSocket::UP socket, handler_fun_t handler);
@@ -50,6 +63,15 @@ public:
     void respond_with_content(const vespalib::string &content_type,
                               const vespalib::string &content);
     void respond_with_error(int code, const vespalib::string &msg);
+
+    // streamed (chunked) responses are produced by another thread and
+    // written by the reactor. The producer blocks while too much
+    // output is pending, unless it is the reactor thread itself.
+    void respond_with_stream(const vespalib::string &content_type);
+    WritableMemory reserve_stream(size_t bytes) { return _chunk.reserve(bytes); }
+    void commit_stream(size_t bytes);
+    bool stream_failed() const { return _stream_failed; }
+    void finish_stream();
 };
 
 } // namespace vespalib::portal
@@ -1,13 +1,14 @@
 // Copyright Yahoo. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "listener.h"
+#include <vespa/vespalib/net/socket_spec.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <cassert>
 
 namespace vespalib::portal {
 
-Listener::Listener(Reactor &reactor, int port, std::function<void(SocketHandle)> handler)
-    : _server_socket(port),
+Listener::Listener(Reactor &reactor, int port, bool reuse_port, std::function<void(SocketHandle)> handler)
+    : _server_socket(SocketSpec::from_port(port), reuse_port),
       _handler(std::move(handler)),
       _token()
 {
@@ -16,7 +16,9 @@ private:
     Reactor::Token::UP _token;
 public:
     using UP = std::unique_ptr<Listener>;
-    Listener(Reactor &reactor, int port, std::function<void(SocketHandle)> handler);
+    Listener(Reactor &reactor, int port, bool reuse_port, std::function<void(SocketHandle)> handler);
+    Listener(Reactor &reactor, int port, std::function<void(SocketHandle)> handler)
+        : Listener(reactor, port, false, std::move(handler)) {}
     ~Listener();
     int listen_port() const { return _server_socket.address().port(); }
     void handle_event(bool read, bool write) override;
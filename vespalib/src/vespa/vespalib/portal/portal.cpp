@@ -5,6 +5,7 @@
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/host_name.h>
 #include <cassert>
+#include <cstring>
 
 namespace vespalib {
 
@@ -93,6 +94,16 @@ Portal::GetRequest::respond_with_error(int code, const vespalib::string &msg)
     _conn = nullptr;
 }
 
+Portal::Stream
+Portal::GetRequest::respond_with_stream(const vespalib::string &content_type)
+{
+    assert(active());
+    _conn->respond_with_stream(content_type);
+    Stream stream(*_conn);
+    _conn = nullptr;
+    return stream;
+}
+
 Portal::GetRequest::~GetRequest()
 {
     if (active()) {
@@ -102,6 +113,51 @@ Portal::GetRequest::~GetRequest()
 
 Portal::GetHandler::~GetHandler() = default;
 
+bool
+Portal::Stream::failed() const
+{
+    assert(active());
+    return _conn->stream_failed();
+}
+
+WritableMemory
+Portal::Stream::reserve(size_t bytes)
+{
+    assert(active());
+    return _conn->reserve_stream(bytes);
+}
+
+Output &
+Portal::Stream::commit(size_t bytes)
+{
+    assert(active());
+    _conn->commit_stream(bytes);
+    return *this;
+}
+
+void
+Portal::Stream::write(vespalib::stringref data)
+{
+    auto chunk = reserve(data.size());
+    memcpy(chunk.data, data.data(), data.size());
+    commit(data.size());
+}
+
+void
+Portal::Stream::finish()
+{
+    assert(active());
+    _conn->finish_stream();
+    _conn = nullptr;
+}
+
+Portal::Stream::~Stream()
+{
+    if (active()) {
+        finish();
+    }
+}
+
 Portal::Token::UP
 Portal::make_token()
 {
@@ -139,11 +195,11 @@ Portal::evict_handle(uint64_t handle)
 }
 
 void
-Portal::handle_accept(portal::HandleGuard guard, SocketHandle socket)
+Portal::handle_accept(portal::HandleGuard guard, portal::Reactor &reactor, SocketHandle socket)
 {
     socket.set_blocking(false);
     socket.set_keepalive(true);
-    new HttpConnection(std::move(guard), _reactor, _crypto->create_server_crypto_socket(std::move(socket)),
+    new HttpConnection(std::move(guard), reactor, _crypto->create_server_crypto_socket(std::move(socket)),
                        [this](HttpConnection *conn)
                        {
                            handle_http(conn);
@@ -175,39 +231,46 @@ Portal::handle_http(portal::HttpConnection *conn)
     }
 }
 
-Portal::Portal(CryptoEngine::SP crypto, int port)
+Portal::Portal(CryptoEngine::SP crypto, int port, size_t num_reactors)
     : _crypto(std::move(crypto)),
-      _reactor(),
+      _reactors(),
       _handle_manager(),
       _conn_handle(_handle_manager.create()),
-      _listener(),
+      _listeners(),
       _lock(),
       _bind_list(),
       _my_host()
 {
-    _listener = std::make_unique<portal::Listener>(_reactor, port, 
-                                                   [this](SocketHandle socket)
-                                                   {
-                                                       auto guard = _handle_manager.lock(_conn_handle);
-                                                       if (guard.valid()) {
-                                                           handle_accept(std::move(guard), std::move(socket));
-                                                       }
-                                                   });
+    assert(num_reactors > 0);
+    bool reuse_port = (num_reactors > 1);
+    for (size_t i = 0; i < num_reactors; ++i) {
+        _reactors.push_back(std::make_unique<portal::Reactor>());
+        portal::Reactor &reactor = *_reactors.back();
+        int my_port = _listeners.empty() ? port : listen_port();
+        _listeners.push_back(std::make_unique<portal::Listener>(reactor, my_port, reuse_port,
+                                                                [this,&reactor](SocketHandle socket)
+                                                                {
+                                                                    auto guard = _handle_manager.lock(_conn_handle);
+                                                                    if (guard.valid()) {
+                                                                        handle_accept(std::move(guard), reactor, std::move(socket));
+                                                                    }
+                                                                }));
+    }
     _my_host = vespalib::make_string("%s:%d", HostName::get().c_str(), listen_port());
 }
 
 Portal::~Portal()
 {
-    _listener.reset();
+    _listeners.clear();
     _handle_manager.destroy(_conn_handle);
     assert(_handle_manager.empty());
     assert(_bind_list.empty());
 }
 
 Portal::SP
-Portal::create(CryptoEngine::SP crypto, int port)
+Portal::create(CryptoEngine::SP crypto, int port, size_t num_reactors)
 {
-    return Portal::SP(new Portal(std::move(crypto), port));
+    return Portal::SP(new Portal(std::move(crypto), port, num_reactors));
 }
 
 Portal::Token::UP
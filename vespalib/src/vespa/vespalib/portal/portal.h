@@ -6,6 +6,7 @@
 #include "reactor.h"
 #include "handle_manager.h"
 
+#include <vespa/vespalib/data/output.h>
 #include <vespa/vespalib/net/crypto_engine.h>
 #include <vespa/vespalib/net/crypto_socket.h>
 #include <vespa/vespalib/stllike/string.h>
@@ -14,13 +15,18 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace vespalib {
 
 namespace portal { class HttpConnection; }
 
 /**
- * Minimal HTTP server and connection establishment manager.
+ * Minimal HTTP server and connection establishment manager. The
+ * server may use several reactors (event loop threads), each with its
+ * own listening socket bound to the same port (SO_REUSEPORT), letting
+ * the kernel spread incoming connections across them. A slow handler
+ * then only delays connections owned by its own reactor.
  **/
 class Portal
 {
@@ -44,6 +50,40 @@ public:
         ~Token();
     };
 
+    /**
+     * The body of a response that is sent while it is being produced,
+     * using chunked transfer encoding. Produced data is handed to the
+     * reactor a chunk at a time, and the reactor writes it as the
+     * client accepts it. The producing thread blocks while too much
+     * data is pending, so large responses (like json rendered
+     * directly into the stream) never need to be kept in memory all
+     * at once. This requires producing from another thread than the
+     * one calling GetHandler::get; data produced by a reactor thread
+     * is buffered until it returns to the event loop. The response is
+     * completed by calling finish or by destructing the stream.
+     **/
+    class Stream : public Output {
+        friend class Portal;
+    private:
+        portal::HttpConnection *_conn;
+        Stream(portal::HttpConnection &conn) : _conn(&conn) {}
+    public:
+        Stream(const Stream &rhs) = delete;
+        Stream &operator=(const Stream &rhs) = delete;
+        Stream &operator=(Stream &&rhs) = delete;
+        Stream(Stream &&rhs) noexcept : _conn(rhs._conn) {
+            rhs._conn = nullptr;
+        }
+        bool active() const { return (_conn != nullptr); }
+        // the client is gone, any further data will be dropped
+        bool failed() const;
+        WritableMemory reserve(size_t bytes) override;
+        Output &commit(size_t bytes) override;
+        void write(vespalib::stringref data);
+        void finish();
+        ~Stream() override;
+    };
+
     class GetRequest {
         friend class Portal;
     private:
@@ -67,6 +107,7 @@ public:
         void respond_with_content(const vespalib::string &content_type,
                                   const vespalib::string &content);
         void respond_with_error(int code, const vespalib::string &msg);
+        Stream respond_with_stream(const vespalib::string &content_type);
         ~GetRequest();
     };
 
@@ -91,10 +132,10 @@ private:
     };
 
     CryptoEngine::SP       _crypto;
-    portal::Reactor        _reactor;
+    std::vector<std::unique_ptr<portal::Reactor>> _reactors;
     portal::HandleManager  _handle_manager;
     uint64_t               _conn_handle;
-    portal::Listener::UP   _listener;
+    std::vector<portal::Listener::UP> _listeners;
     std::mutex             _lock;
     std::vector<BindState> _bind_list;
     vespalib::string       _my_host;
@@ -105,14 +146,16 @@ private:
     portal::HandleGuard lookup_get_handler(const vespalib::string &uri, GetHandler *&handler);
     void evict_handle(uint64_t handle);
 
-    void handle_accept(portal::HandleGuard guard, SocketHandle socket);
+    void handle_accept(portal::HandleGuard guard, portal::Reactor &reactor, SocketHandle socket);
     void handle_http(portal::HttpConnection *conn);
 
-    Portal(CryptoEngine::SP crypto, int port);
+    Portal(CryptoEngine::SP crypto, int port, size_t num_reactors);
 public:
     ~Portal();
-    static SP create(CryptoEngine::SP crypto, int port);
-    int listen_port() const { return _listener->listen_port(); }
+    static SP create(CryptoEngine::SP crypto, int port) { return create(std::move(crypto), port, 1); }
+    static SP create(CryptoEngine::SP crypto, int port, size_t num_reactors);
+    size_t num_reactors() const { return _reactors.size(); }
+    int listen_port() const { return _listeners[0]->listen_port(); }
     const vespalib::string &my_host() const { return _my_host; }
     Token::UP bind(const vespalib::string &path_prefix, GetHandler &handler);
 };
@@ -34,7 +34,7 @@ Reactor::Token::~Token()
 void
 Reactor::cancel_token(const Token &)
 {
-    if (std::this_thread::get_id() == _thread.get_id()) {
+    if (is_event_thread()) {
         _skip_events = true;
     } else {
         std::unique_lock guard(_lock);
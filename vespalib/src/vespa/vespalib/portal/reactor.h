@@ -63,6 +63,7 @@ public:
     Reactor() : Reactor([]() noexcept { return -1; }) {}
     ~Reactor();
     Token::UP attach(EventHandler &handler, int fd, bool read, bool write);
+    bool is_event_thread() const { return (std::this_thread::get_id() == _thread.get_id()); }
 };
 
 } // namespace vespalib::portal